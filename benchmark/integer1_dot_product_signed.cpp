@@ -96,6 +96,24 @@ int main()
         fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
     }
 
+    {
+        auto p = get_init_vectors<mppp::integer<1>>();
+        constexpr auto name = "mppp::integer_accumulator<1>";
+
+        mppp::integer_accumulator<1> acc;
+
+        mppp_benchmark::simple_timer st;
+
+        for (auto i = 0ul; i < size; ++i) {
+            addmul(acc, p.first[i], p.second[i]);
+        }
+        const auto ret = acc.finalize();
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+
     {
         auto p = get_init_vectors<std::int_least64_t>();
         constexpr auto name = "std::int64_t";
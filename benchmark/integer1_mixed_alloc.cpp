@@ -0,0 +1,138 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#if defined(MPPP_BENCHMARK_BOOST)
+
+#include <boost/multiprecision/gmp.hpp>
+
+#endif
+
+#include <fmt/core.h>
+#include <fmt/ostream.h>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+
+#include "utils.hpp"
+
+// NOTE: this benchmark measures the performance of a workload
+// in which integers of widely different sizes (from 1 to 200 limbs)
+// are repeatedly created and destroyed.
+
+namespace
+{
+
+#if defined(MPPP_BENCHMARK_BOOST)
+
+using mpz_int = boost::multiprecision::number<boost::multiprecision::gmp_int, boost::multiprecision::et_off>;
+
+#endif
+
+std::mt19937 rng;
+
+constexpr auto size = 2000ul;
+
+constexpr auto nrounds = 1000ul;
+
+template <typename T>
+std::vector<T> get_init_vector()
+{
+    rng.seed(0);
+    std::uniform_int_distribution<unsigned> dist(1u, 200u);
+    std::vector<T> retval(size);
+    std::generate(retval.begin(), retval.end(), [&dist]() { return (T(1) << (dist(rng) * 64u - 1u)) - 1; });
+    return retval;
+}
+
+template <typename T>
+T run_workload(const std::vector<T> &v)
+{
+    T retval{0};
+    for (auto r = 0ul; r < nrounds; ++r) {
+        for (auto i = 0ul; i < size; ++i) {
+            // Sums and differences of random values. Each iteration
+            // creates and destroys temporaries of different sizes.
+            const auto &a = v[i];
+            const auto &b = v[(i * 7u + r) % size];
+            const auto &c = v[(i * 13u + r * 3u) % size];
+            retval += (a + b) - c;
+        }
+    }
+    return retval;
+}
+
+const auto benchmark_name = mppp_benchmark_name();
+
+} // namespace
+
+int main()
+{
+    fmt::print("Benchmark name: {}\n", benchmark_name);
+
+    // Warm up.
+    mppp_benchmark::warmup();
+
+    // Prepare the benchmark result data.
+    mppp_benchmark::data_t bdata;
+
+    {
+        const auto v = get_init_vector<mppp::integer<1>>();
+        constexpr auto name = "mppp::integer<1>";
+
+        mppp_benchmark::simple_timer st;
+
+        const auto ret = run_workload(v);
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+
+        mppp::free_integer_caches();
+    }
+
+    {
+        const auto v = get_init_vector<mppp::integer<1>>();
+        constexpr auto name = "mppp::integer<1> (no cache)";
+
+        const auto limits = mppp::get_integer_cache_limits();
+        mppp::set_integer_cache_limits(0, 0);
+
+        mppp_benchmark::simple_timer st;
+
+        const auto ret = run_workload(v);
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+
+        mppp::set_integer_cache_limits(limits.first, limits.second);
+    }
+
+#if defined(MPPP_BENCHMARK_BOOST)
+    {
+        const auto v = get_init_vector<mpz_int>();
+        constexpr auto name = "boost::gmp_int";
+
+        mppp_benchmark::simple_timer st;
+
+        const auto ret = run_workload(v);
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+#endif
+
+    // Write out the .py and .rst files.
+    mppp_benchmark::write_out(bdata, benchmark_name);
+}
@@ -90,6 +90,19 @@ int main()
         fmt::print(mppp_benchmark::res_print_format, name, runtime, v[0]);
     }
 
+    {
+        auto v = get_init_vector<mppp::integer<1>>();
+        constexpr auto name = "mppp::integer_sort<1>";
+
+        mppp_benchmark::simple_timer st;
+
+        mppp::integer_sort(v.begin(), v.end());
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, v[0]);
+    }
+
     {
         auto v = get_init_vector<std::uint_least64_t>();
         constexpr auto name = "std::uint64_t";
@@ -31,6 +31,7 @@
 
 #include <mp++/config.hpp>
 #include <mp++/integer.hpp>
+#include <mp++/integer_vector.hpp>
 
 #if defined(MPPP_BENCHMARK_BOOST)
 
@@ -98,6 +99,24 @@ int main()
         fmt::print(mppp_benchmark::res_print_format, name, runtime, std::get<3>(p)[size - 1u]);
     }
 
+    {
+        auto p = get_init_vectors<mppp::integer<1>>();
+        constexpr auto name = "mppp::integer_vector<1>";
+
+        const mppp::integer_vector<1> v0(std::get<0>(p).begin(), std::get<0>(p).end()),
+            v1(std::get<1>(p).begin(), std::get<1>(p).end()), v2(std::get<2>(p).begin(), std::get<2>(p).end());
+        mppp::integer_vector<1> v3(size);
+
+        mppp_benchmark::simple_timer st;
+
+        mul(v3, v0, v1);
+        add(v3, v2, v3);
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, v3.get(size - 1u));
+    }
+
     {
         auto p = get_init_vectors<std::int_least64_t>();
         constexpr auto name = "std::int64_t";
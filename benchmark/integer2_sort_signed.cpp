@@ -84,6 +84,19 @@ int main()
         fmt::print(mppp_benchmark::res_print_format, name, runtime, v[0]);
     }
 
+    {
+        auto v = get_init_vector<mppp::integer<2>>();
+        constexpr auto name = "mppp::integer_sort<2>";
+
+        mppp_benchmark::simple_timer st;
+
+        mppp::integer_sort(v.begin(), v.end());
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, v[0]);
+    }
+
 #if defined(MPPP_HAVE_GCC_INT128)
     {
         auto v = get_init_vector<__int128_t>();
@@ -0,0 +1,158 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/ostream.h>
+
+#include <mp++/config.hpp>
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "utils.hpp"
+
+namespace
+{
+
+std::mt19937 rng;
+
+constexpr auto size = 30000000ul;
+
+// The dividends, made of 2 random limbs.
+std::vector<mppp::integer<2>> get_init_vector()
+{
+    rng.seed(0);
+    std::uniform_int_distribution<::mp_limb_t> dist(0, GMP_NUMB_MAX);
+    std::vector<mppp::integer<2>> v(size);
+    std::generate(v.begin(), v.end(), [&dist]() {
+        mppp::integer<2> n;
+        for (auto i = 0; i < 2; ++i) {
+            n <<= GMP_NUMB_BITS;
+            n += dist(rng);
+        }
+        return n;
+    });
+    return v;
+}
+
+// A fixed divisor of nlimbs limbs.
+mppp::integer<2> get_divisor(int nlimbs)
+{
+    std::uniform_int_distribution<::mp_limb_t> dist(1, GMP_NUMB_MAX);
+    mppp::integer<2> d;
+    for (auto i = 0; i < nlimbs; ++i) {
+        d <<= GMP_NUMB_BITS;
+        d += dist(rng);
+    }
+    return d;
+}
+
+const auto benchmark_name = mppp_benchmark_name();
+
+} // namespace
+
+int main()
+{
+    fmt::print("Benchmark name: {}\n", benchmark_name);
+
+    // Warm up.
+    mppp_benchmark::warmup();
+
+    // Prepare the benchmark result data.
+    mppp_benchmark::data_t bdata;
+
+    {
+        const auto v1 = get_init_vector();
+        std::vector<mppp::integer<2>> v2(size);
+        const auto d = get_divisor(1);
+        
+        constexpr auto name = "mppp::integer<2> (1 limb)";
+
+        mppp::integer<2> ret(0);
+
+        mppp_benchmark::simple_timer st;
+
+        for (auto i = 0ul; i < size; ++i) {
+            tdiv_q(v2[i], v1[i], d);
+            ret += v2[i];
+        }
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+
+    {
+        const auto v1 = get_init_vector();
+        std::vector<mppp::integer<2>> v2(size);
+        const auto d = get_divisor(1);
+        const mppp::integer_divisor<2> dd(d);
+        constexpr auto name = "mppp::integer_divisor<2> (1 limb)";
+
+        mppp::integer<2> ret(0);
+
+        mppp_benchmark::simple_timer st;
+
+        for (auto i = 0ul; i < size; ++i) {
+            tdiv_q(v2[i], v1[i], dd);
+            ret += v2[i];
+        }
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+
+    {
+        const auto v1 = get_init_vector();
+        std::vector<mppp::integer<2>> v2(size);
+        const auto d = get_divisor(2);
+        
+        constexpr auto name = "mppp::integer<2> (2 limbs)";
+
+        mppp::integer<2> ret(0);
+
+        mppp_benchmark::simple_timer st;
+
+        for (auto i = 0ul; i < size; ++i) {
+            tdiv_q(v2[i], v1[i], d);
+            ret += v2[i];
+        }
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+
+    {
+        const auto v1 = get_init_vector();
+        std::vector<mppp::integer<2>> v2(size);
+        const auto d = get_divisor(2);
+        const mppp::integer_divisor<2> dd(d);
+        constexpr auto name = "mppp::integer_divisor<2> (2 limbs)";
+
+        mppp::integer<2> ret(0);
+
+        mppp_benchmark::simple_timer st;
+
+        for (auto i = 0ul; i < size; ++i) {
+            tdiv_q(v2[i], v1[i], dd);
+            ret += v2[i];
+        }
+
+        const auto runtime = st.elapsed();
+        bdata.emplace_back(name, runtime);
+        fmt::print(mppp_benchmark::res_print_format, name, runtime, ret);
+    }
+
+    // Write out the .py and .rst files.
+    mppp_benchmark::write_out(bdata, benchmark_name);
+}
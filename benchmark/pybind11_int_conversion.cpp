@@ -0,0 +1,190 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <string>
+
+#include <fmt/core.h>
+
+#if defined(__clang__) || defined(__GNUC__)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+#endif
+
+#include <pybind11/embed.h>
+#include <pybind11/pybind11.h>
+
+#if defined(__clang__) || defined(__GNUC__)
+
+#pragma GCC diagnostic pop
+
+#endif
+
+#include <mp++/extra/pybind11.hpp>
+#include <mp++/integer.hpp>
+
+#include "utils.hpp"
+
+namespace py = pybind11;
+
+namespace
+{
+
+// The number of conversions to run for each size.
+constexpr auto nconv = 10;
+
+// Past this size (in Python digits), we don't run the
+// benchmarks for the shift-add implementation (it takes too long).
+constexpr auto max_naive_size = 100000l;
+
+// The shift-add Python -> integer conversion algorithm that was
+// used in mp++ before the introduction of the bit-packing implementation.
+// It is here as a reference.
+mppp::integer<1> naive_py_to_int(const py::int_ &n)
+{
+    const auto *nptr = reinterpret_cast<const ::PyLongObject *>(n.ptr());
+
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION <= 11
+    const auto ob_size = nptr->ob_base.ob_size;
+    const auto *ob_digit = nptr->ob_digit;
+    auto abs_ob_size = static_cast<std::size_t>(ob_size < 0 ? -ob_size : ob_size);
+    const bool neg = ob_size < 0;
+#else
+    auto abs_ob_size = static_cast<std::size_t>(nptr->long_value.lv_tag >> 3);
+    const auto *ob_digit = nptr->long_value.ob_digit;
+    const auto neg = (nptr->long_value.lv_tag & 3) == 2;
+#endif
+
+    if (!abs_ob_size) {
+        return mppp::integer<1>{};
+    }
+
+    mppp::integer<1> retval{mppp::integer_bitcnt_t(static_cast<::mp_bitcnt_t>(PyLong_SHIFT * abs_ob_size))};
+    retval = ob_digit[--abs_ob_size];
+    while (abs_ob_size) {
+        retval <<= PyLong_SHIFT;
+        retval += ob_digit[--abs_ob_size];
+    }
+    if (neg) {
+        retval.neg();
+    }
+    return retval;
+}
+
+// The shift-add integer -> Python conversion algorithm that was
+// used in mp++ before the introduction of the direct-limb implementation.
+py::int_ naive_int_to_py(const mppp::integer<1> &src)
+{
+    if (src.is_zero()) {
+        return py::int_();
+    }
+    const ::mp_limb_t *ptr = src.is_static() ? src._get_union().g_st().m_limbs.data() : src._get_union().g_dy()._mp_d;
+    auto size = src.size();
+    const py::int_ nbits(GMP_NUMB_BITS);
+    py::int_ retval(ptr[--size] & GMP_NUMB_MASK);
+    while (size) {
+        retval = retval.attr("__lshift__")(nbits).attr("__add__")(py::int_(ptr[--size] & GMP_NUMB_MASK));
+    }
+    if (src.sgn() < 0) {
+        retval = retval.attr("__neg__")();
+    }
+    return retval;
+}
+
+const auto benchmark_name = mppp_benchmark_name();
+
+} // namespace
+
+int main()
+{
+    fmt::print("Benchmark name: {}\n", benchmark_name);
+
+    py::scoped_interpreter guard{};
+
+    mppp_pybind11::init();
+
+    const auto random_mod = py::module::import("random");
+    random_mod.attr("seed")(0);
+
+    // Prepare the benchmark result data.
+    mppp_benchmark::data_t bdata;
+
+    for (auto ndigits = 1l; ndigits <= 1000000l; ndigits *= 10) {
+        fmt::print("Size: {} Python digits\n", ndigits);
+
+        // Generate a random Python integer with the desired number of digits.
+        const py::int_ n = random_mod.attr("getrandbits")(ndigits * PyLong_SHIFT);
+
+        {
+            const auto name = fmt::format("py -> mppp, {} digits", ndigits);
+
+            mppp_benchmark::simple_timer st;
+
+            std::size_t res = 0;
+            for (auto i = 0; i < nconv; ++i) {
+                res += n.cast<mppp::integer<1>>().size();
+            }
+
+            const auto runtime = st.elapsed();
+            bdata.emplace_back(name, runtime);
+            fmt::print(mppp_benchmark::res_print_format, name, runtime, res);
+        }
+
+        if (ndigits <= max_naive_size) {
+            const auto name = fmt::format("py -> mppp (naive), {} digits", ndigits);
+
+            mppp_benchmark::simple_timer st;
+
+            std::size_t res = 0;
+            for (auto i = 0; i < nconv; ++i) {
+                res += naive_py_to_int(n).size();
+            }
+
+            const auto runtime = st.elapsed();
+            bdata.emplace_back(name, runtime);
+            fmt::print(mppp_benchmark::res_print_format, name, runtime, res);
+        }
+
+        const auto m = n.cast<mppp::integer<1>>();
+
+        {
+            const auto name = fmt::format("mppp -> py, {} digits", ndigits);
+
+            mppp_benchmark::simple_timer st;
+
+            std::size_t res = 0;
+            for (auto i = 0; i < nconv; ++i) {
+                res += py::cast(m).attr("bit_length")().cast<std::size_t>();
+            }
+
+            const auto runtime = st.elapsed();
+            bdata.emplace_back(name, runtime);
+            fmt::print(mppp_benchmark::res_print_format, name, runtime, res);
+        }
+
+        if (ndigits <= max_naive_size) {
+            const auto name = fmt::format("mppp -> py (naive), {} digits", ndigits);
+
+            mppp_benchmark::simple_timer st;
+
+            std::size_t res = 0;
+            for (auto i = 0; i < nconv; ++i) {
+                res += naive_int_to_py(m).attr("bit_length")().cast<std::size_t>();
+            }
+
+            const auto runtime = st.elapsed();
+            bdata.emplace_back(name, runtime);
+            fmt::print(mppp_benchmark::res_print_format, name, runtime, res);
+        }
+    }
+
+    // Write out the .py and .rst files.
+    mppp_benchmark::write_out(bdata, benchmark_name);
+}
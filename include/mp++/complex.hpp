@@ -52,6 +52,7 @@
 #include <mp++/integer.hpp>
 #include <mp++/rational.hpp>
 #include <mp++/real.hpp>
+#include <mp++/relocate.hpp>
 #include <mp++/type_name.hpp>
 
 #if defined(MPPP_WITH_QUADMATH)
@@ -221,12 +222,13 @@ class MPPP_DLL_PUBLIC complex
     template <typename Archive>
     void load(Archive &ar, unsigned)
     {
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS real re, im;
 
         ar >> re;
         ar >> im;
 
-        *this = complex{re, im};
+        mb.escape([&]() { *this = complex{re, im}; });
     }
     void load(boost::archive::binary_iarchive &, unsigned);
 
@@ -298,13 +300,9 @@ private:
         auto im = sizeof...(Args) ? real{real_kind::zero, 1, static_cast<::mpfr_prec_t>(args)...}
                                   : real{real_kind::zero, 1, re.get_prec()};
 
-        // Shallow-copy into this.
-        m_mpc.re[0] = *re.get_mpfr_t();
-        m_mpc.im[0] = *im.get_mpfr_t();
-
-        // Deactivate the temporaries.
-        re._get_mpfr_t()->_mpfr_d = nullptr;
-        im._get_mpfr_t()->_mpfr_d = nullptr;
+        // Move into this.
+        re.move_into(m_mpc.re[0]);
+        im.move_into(m_mpc.im[0]);
     }
     // From complex-valued interoperable types + optional precision.
     // NOTE: this will delegate to the ctors from real + imaginary parts.
@@ -347,13 +345,9 @@ private:
         // Init real-imaginary parts with the input prec.
         real rp{std::forward<T>(re), p}, ip{std::forward<U>(im), p};
 
-        // Shallow-copy into this.
-        m_mpc.re[0] = *rp.get_mpfr_t();
-        m_mpc.im[0] = *ip.get_mpfr_t();
-
-        // Deactivate the temporaries.
-        rp._get_mpfr_t()->_mpfr_d = nullptr;
-        ip._get_mpfr_t()->_mpfr_d = nullptr;
+        // Move into this.
+        rp.move_into(m_mpc.re[0]);
+        ip.move_into(m_mpc.im[0]);
     }
 
 public:
@@ -594,8 +588,7 @@ public:
 
         ~re_ref()
         {
-            mpc_realref(&m_c.m_mpc)[0] = *m_value.get_mpfr_t();
-            m_value._get_mpfr_t()->_mpfr_d = nullptr;
+            m_value.move_into(mpc_realref(&m_c.m_mpc)[0]);
         }
 
         real &operator*()
@@ -654,8 +647,7 @@ public:
 
         ~im_ref()
         {
-            mpc_imagref(&m_c.m_mpc)[0] = *m_value.get_mpfr_t();
-            m_value._get_mpfr_t()->_mpfr_d = nullptr;
+            m_value.move_into(mpc_imagref(&m_c.m_mpc)[0]);
         }
 
         real &operator*()
@@ -1415,20 +1407,22 @@ inline complex mpc_nary_op_return_impl(::mpfr_prec_t min_prec, const F &f, Arg0
               enable_if_t<conjunction<is_cvr_complex<T>, is_complex_interoperable<U>>::value, int> = 0>                \
     inline complex dispatch_##name(T &&a, const U &x)                                                                  \
     {                                                                                                                  \
+        const mpz_default_memory_binding mb;                                                                           \
         MPPP_MAYBE_TLS complex tmp;                                                                                    \
         tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));                                                   \
         tmp.set(x);                                                                                                    \
-        return dispatch_##name(std::forward<T>(a), tmp);                                                               \
+        return mb.escape([&]() { return dispatch_##name(std::forward<T>(a), tmp); });                                  \
     }                                                                                                                  \
     /* Only the second argument is complex. */                                                                         \
     template <typename T, typename U,                                                                                  \
               enable_if_t<conjunction<is_complex_interoperable<T>, is_cvr_complex<U>>::value, int> = 0>                \
     inline complex dispatch_##name(const T &x, U &&a)                                                                  \
     {                                                                                                                  \
+        const mpz_default_memory_binding mb;                                                                           \
         MPPP_MAYBE_TLS complex tmp;                                                                                    \
         tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));                                                   \
         tmp.set(x);                                                                                                    \
-        return dispatch_##name(tmp, std::forward<U>(a));                                                               \
+        return mb.escape([&]() { return dispatch_##name(tmp, std::forward<U>(a)); });                                  \
     }                                                                                                                  \
     }                                                                                                                  \
     /* The overload which returns the result. */                                                                       \
@@ -1810,11 +1804,12 @@ template <typename T, typename U,
           = 0>
 inline complex complex_pow_impl(T &&a, const U &x)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
 
-    return complex_pow_impl(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return complex_pow_impl(std::forward<T>(a), tmp); });
 }
 
 // Complex-(complex-valued interoperable types).
@@ -1822,11 +1817,12 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_cvr_complex<T>, is_cv_complex_interoperable<U>>::value, int> = 0>
 inline complex complex_pow_impl(T &&a, const U &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    return complex_pow_impl(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return complex_pow_impl(std::forward<T>(a), tmp); });
 }
 
 // (real-valued interoperable)-complex.
@@ -1834,11 +1830,12 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_rv_complex_interoperable<T>, is_cvr_complex<U>>::value, int> = 0>
 inline complex complex_pow_impl(const T &a, U &&c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(real_deduce_precision(a), c.get_prec()));
     tmp.set(a);
 
-    return complex_pow_impl(tmp, std::forward<U>(c));
+    return mb.escape([&]() { return complex_pow_impl(tmp, std::forward<U>(c)); });
 }
 
 // (complex-valued interoperable)-complex.
@@ -1846,11 +1843,12 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_cv_complex_interoperable<T>, is_cvr_complex<U>>::value, int> = 0>
 inline complex complex_pow_impl(const T &a, U &&c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(real_deduce_precision(a), c.get_prec()));
     tmp.set(a);
 
-    return complex_pow_impl(tmp, std::forward<U>(c));
+    return mb.escape([&]() { return complex_pow_impl(tmp, std::forward<U>(c)); });
 }
 
 // real-complex valued.
@@ -1859,6 +1857,7 @@ inline complex complex_pow_impl(const real &x, const T &c)
 {
     const auto p = c_max(x.get_prec(), real_deduce_precision(c));
 
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp1, tmp2;
 
     tmp1.set_prec(p);
@@ -1867,7 +1866,7 @@ inline complex complex_pow_impl(const real &x, const T &c)
     tmp2.set_prec(p);
     tmp2.set(c);
 
-    return complex_pow_impl(tmp1, tmp2);
+    return mb.escape([&]() { return complex_pow_impl(tmp1, tmp2); });
 }
 
 // complex valued-real.
@@ -1876,6 +1875,7 @@ inline complex complex_pow_impl(const T &c, const real &x)
 {
     const auto p = c_max(x.get_prec(), real_deduce_precision(c));
 
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp1, tmp2;
 
     tmp1.set_prec(p);
@@ -1884,7 +1884,7 @@ inline complex complex_pow_impl(const T &c, const real &x)
     tmp2.set_prec(p);
     tmp2.set(x);
 
-    return complex_pow_impl(tmp1, tmp2);
+    return mb.escape([&]() { return complex_pow_impl(tmp1, tmp2); });
 }
 
 } // namespace detail
@@ -2662,11 +2662,12 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_cvr_complex<T>, is_cv_complex_interoperable<U>>::value, int> = 0>
 inline complex dispatch_complex_binary_mul(T &&a, const U &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    return std::forward<T>(a) * tmp;
+    return mb.escape([&]() { return std::forward<T>(a) * tmp; });
 }
 
 // complex valued interoperable types-complex.
@@ -2779,11 +2780,12 @@ inline void dispatch_complex_in_place_mul(complex &a, const T &n)
 template <typename T, enable_if_t<is_cv_complex_interoperable<T>::value, int> = 0>
 inline void dispatch_complex_in_place_mul(complex &a, const T &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    dispatch_complex_in_place_mul(a, tmp);
+    mb.escape([&]() { dispatch_complex_in_place_mul(a, tmp); });
 }
 
 // complex interoperable-complex, or real-complex valued.
@@ -2876,11 +2878,12 @@ template <typename T, typename U,
           = 0>
 inline complex dispatch_complex_binary_div(const U &x, T &&a)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
 
-    return dispatch_complex_binary_div(tmp, std::forward<T>(a));
+    return mb.escape([&]() { return dispatch_complex_binary_div(tmp, std::forward<T>(a)); });
 }
 
 // complex-unsigned integral.
@@ -2938,11 +2941,12 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_cvr_complex<T>, is_cv_complex_interoperable<U>>::value, int> = 0>
 inline complex dispatch_complex_binary_div(T &&a, const U &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    return dispatch_complex_binary_div(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_complex_binary_div(std::forward<T>(a), tmp); });
 }
 
 // complex valued interoperable types-complex.
@@ -2950,17 +2954,19 @@ template <typename T, typename U,
           enable_if_t<conjunction<is_cvr_complex<T>, is_cv_complex_interoperable<U>>::value, int> = 0>
 inline complex dispatch_complex_binary_div(const U &c, T &&a)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    return dispatch_complex_binary_div(tmp, std::forward<T>(a));
+    return mb.escape([&]() { return dispatch_complex_binary_div(tmp, std::forward<T>(a)); });
 }
 
 // real-(std::complex or complex128).
 template <typename T, enable_if_t<is_cv_complex_interoperable<T>::value, int> = 0>
 inline complex dispatch_complex_binary_div(const real &x, const T &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp1, tmp2;
 
     const auto p = c_max(x.get_prec(), real_deduce_precision(c));
@@ -2971,7 +2977,7 @@ inline complex dispatch_complex_binary_div(const real &x, const T &c)
     tmp2.set_prec(p);
     tmp2.set(c);
 
-    return dispatch_complex_binary_div(tmp1, tmp2);
+    return mb.escape([&]() { return dispatch_complex_binary_div(tmp1, tmp2); });
 }
 
 // (std::complex or complex128)-real.
@@ -3056,11 +3062,12 @@ MPPP_DLL_PUBLIC void dispatch_complex_in_place_div(complex &, bool);
 template <typename T, enable_if_t<is_cv_complex_interoperable<T>::value, int> = 0>
 inline void dispatch_complex_in_place_div(complex &a, const T &c)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS complex tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(c)));
     tmp.set(c);
 
-    dispatch_complex_in_place_div(a, tmp);
+    mb.escape([&]() { dispatch_complex_in_place_div(a, tmp); });
 }
 
 // complex interoperable-complex, or real-complex valued.
@@ -3164,25 +3171,25 @@ inline namespace literals
 template <char... Chars>
 inline complex operator""_icr128()
 {
-    return complex{real{real_kind::zero, 128}, detail::real_literal_impl<Chars...>(128)};
+    return complex{real{real_kind::zero, 128}, detail::real_literal_cached<128, Chars...>()};
 }
 
 template <char... Chars>
 inline complex operator""_icr256()
 {
-    return complex{real{real_kind::zero, 256}, detail::real_literal_impl<Chars...>(256)};
+    return complex{real{real_kind::zero, 256}, detail::real_literal_cached<256, Chars...>()};
 }
 
 template <char... Chars>
 inline complex operator""_icr512()
 {
-    return complex{real{real_kind::zero, 512}, detail::real_literal_impl<Chars...>(512)};
+    return complex{real{real_kind::zero, 512}, detail::real_literal_cached<512, Chars...>()};
 }
 
 template <char... Chars>
 inline complex operator""_icr1024()
 {
-    return complex{real{real_kind::zero, 1024}, detail::real_literal_impl<Chars...>(1024)};
+    return complex{real{real_kind::zero, 1024}, detail::real_literal_cached<1024, Chars...>()};
 }
 
 } // namespace literals
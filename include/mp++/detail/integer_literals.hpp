@@ -234,6 +234,27 @@ constexpr Int digit_to_value(char c)
 
 #endif
 
+// Construct an integer from the char representation of a literal
+// at runtime.
+template <std::size_t SSize, std::size_t Size>
+inline integer<SSize> integer_literal_parse(const char (&arr)[Size])
+{
+    // Run the checks on the char sequence, and determine the base.
+    const auto base = integer_literal_check_str(arr);
+    assert(base == 2 || base == 8 || base == 10 || base == 16);
+
+    switch (base) {
+        case 2:
+            return integer<SSize>{arr + 2, arr + Size - 1u, 2};
+        case 8:
+            return integer<SSize>{arr + 1, arr + Size - 1u, 8};
+        case 16:
+            return integer<SSize>{arr + 2, arr + Size - 1u, 16};
+        default:
+            return integer<SSize>{arr};
+    }
+}
+
 template <std::size_t SSize, char... Chars>
 inline integer<SSize> integer_literal_impl()
 {
@@ -336,62 +357,75 @@ inline integer<SSize> integer_literal_impl()
             return retval;
         }();
 
-        // Turn the limb array into an integer.
-        // Start with the least significant limb.
-        integer<SSize> retval{limb_arr.arr[nlimbs - 1u]}, tmp;
-
-        // A couple of variables used only in base 10.
-        [[maybe_unused]] const auto factor10 = []() {
-            if constexpr (base == 10) {
-                return mppp::pow_ui(integer<SSize>{10}, nd_limb);
-            } else {
-                return 0;
+        // Turn the limb array into an integer. This requires
+        // several arithmetic operations, thus we do it only once
+        // and we return a copy of the cached value afterwards.
+        // NOTE: the initialisation of function-local statics is thread-safe.
+        // NOTE: the cached value lives until the end of the program, thus it
+        // must not draw from the memory resource which may be bound to
+        // the calling thread at the time of the first invocation.
+        static const integer<SSize> value = [&limb_arr]() {
+            const mpz_default_memory_binding mb;
+
+            // Start with the least significant limb.
+            integer<SSize> retval{limb_arr.arr[nlimbs - 1u]}, tmp;
+
+            // A couple of variables used only in base 10.
+            [[maybe_unused]] const auto factor10 = []() {
+                if constexpr (base == 10) {
+                    return mppp::pow_ui(integer<SSize>{10}, nd_limb);
+                } else {
+                    return 0;
+                }
+            }();
+            [[maybe_unused]] auto cur_factor10(factor10);
+
+            if constexpr (base != 10) {
+                // NOTE: for bases other than 10, we will use bit shifting below.
+                // Make sure that we can represent the max shift amount
+                // via std::size_t.
+                static_assert(nlimbs <= std::numeric_limits<std::size_t>::max()
+                                            / static_cast<unsigned>(std::numeric_limits<::mp_limb_t>::digits));
             }
-        }();
-        [[maybe_unused]] auto cur_factor10(factor10);
-
-        if constexpr (base != 10) {
-            // NOTE: for bases other than 10, we will use bit shifting below.
-            // Make sure that we can represent the max shift amount
-            // via std::size_t.
-            static_assert(nlimbs <= std::numeric_limits<std::size_t>::max()
-                                        / static_cast<unsigned>(std::numeric_limits<::mp_limb_t>::digits));
-        }
 
-        for (std::size_t i = nlimbs - 1u; i > 0u; --i) {
-            tmp = limb_arr.arr[i - 1u];
-
-            if constexpr (base == 2) {
-                tmp <<= (nd_limb * (nlimbs - i));
-            } else if constexpr (base == 8) {
-                tmp <<= (nd_limb * 3u * (nlimbs - i));
-            } else if constexpr (base == 16) {
-                tmp <<= (nd_limb * 4u * (nlimbs - i));
-            } else {
-                tmp *= cur_factor10;
-                cur_factor10 *= factor10;
+            for (std::size_t i = nlimbs - 1u; i > 0u; --i) {
+                tmp = limb_arr.arr[i - 1u];
+
+                if constexpr (base == 2) {
+                    tmp <<= (nd_limb * (nlimbs - i));
+                } else if constexpr (base == 8) {
+                    tmp <<= (nd_limb * 3u * (nlimbs - i));
+                } else if constexpr (base == 16) {
+                    tmp <<= (nd_limb * 4u * (nlimbs - i));
+                } else {
+                    tmp *= cur_factor10;
+                    cur_factor10 *= factor10;
+                }
+
+                retval += tmp;
             }
 
-            retval += tmp;
-        }
+            return retval;
+        }();
 
-        return retval;
+        return value;
     }
 #else
-    // Run the checks on the char sequence, and determine the base.
-    const auto base = integer_literal_check_str(arr);
-    assert(base == 2 || base == 8 || base == 10 || base == 16);
+    // Parse the literal only once, and return a copy
+    // of the cached value afterwards.
+    // NOTE: the initialisation of function-local statics is thread-safe.
+    // If the parsing throws, the initialisation will be attempted again
+    // on the next invocation.
+    // NOTE: the cached value lives until the end of the program, thus it
+    // must not draw from the memory resource which may be bound to
+    // the calling thread at the time of the first invocation.
+    static const integer<SSize> value = [&arr]() {
+        const mpz_default_memory_binding mb;
+
+        return integer_literal_parse<SSize>(arr);
+    }();
 
-    switch (base) {
-        case 2:
-            return integer<SSize>{arr + 2, arr + sizeof(arr) - 1, 2};
-        case 8:
-            return integer<SSize>{arr + 1, arr + sizeof(arr) - 1, 8};
-        case 16:
-            return integer<SSize>{arr + 2, arr + sizeof(arr) - 1, 16};
-        default:
-            return integer<SSize>{arr};
-    }
+    return value;
 #endif
 }
 
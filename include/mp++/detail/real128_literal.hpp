@@ -29,7 +29,11 @@ inline real128 operator""_rq()
         throw std::invalid_argument("A real128 cannot be constructed from binary or octal literals");
     }
 
-    return real128(arr);
+    // Parse the literal only once, and return a copy
+    // of the cached value afterwards.
+    static const real128 value(arr);
+
+    return value;
 }
 
 } // namespace literals
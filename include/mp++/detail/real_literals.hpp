@@ -42,6 +42,25 @@ inline real real_literal_impl(::mpfr_prec_t prec)
     return real{arr, base, prec};
 }
 
+// Parse the literal only once per precision, and return
+// a copy of the cached value afterwards.
+// NOTE: the initialisation of function-local statics is thread-safe,
+// and concurrent copies from a const real are fine. If the parsing
+// throws, the initialisation will be attempted again on the next
+// invocation. The cached value is built under the default allocation
+// functions, as it outlives any memory resource bound to the calling thread.
+template <::mpfr_prec_t Prec, char... Chars>
+inline real real_literal_cached()
+{
+    static const real value = []() {
+        const mpz_default_memory_binding mb;
+
+        return real_literal_impl<Chars...>(Prec);
+    }();
+
+    return value;
+}
+
 } // namespace detail
 
 inline namespace literals
@@ -50,25 +69,25 @@ inline namespace literals
 template <char... Chars>
 inline real operator""_r128()
 {
-    return detail::real_literal_impl<Chars...>(128);
+    return detail::real_literal_cached<128, Chars...>();
 }
 
 template <char... Chars>
 inline real operator""_r256()
 {
-    return detail::real_literal_impl<Chars...>(256);
+    return detail::real_literal_cached<256, Chars...>();
 }
 
 template <char... Chars>
 inline real operator""_r512()
 {
-    return detail::real_literal_impl<Chars...>(512);
+    return detail::real_literal_cached<512, Chars...>();
 }
 
 template <char... Chars>
 inline real operator""_r1024()
 {
-    return detail::real_literal_impl<Chars...>(1024);
+    return detail::real_literal_cached<1024, Chars...>();
 }
 
 } // namespace literals
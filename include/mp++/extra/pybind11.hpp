@@ -57,7 +57,6 @@ struct globals_ {
     static std::unique_ptr<py::object> mpf_isinf;
     static std::unique_ptr<py::object> mpf_isnan;
     static std::unique_ptr<py::object> fraction_class;
-    static std::unique_ptr<py::int_> gmp_numb_bits;
 };
 
 template <typename T>
@@ -84,9 +83,6 @@ std::unique_ptr<py::object> globals_<T>::mpf_isnan;
 template <typename T>
 std::unique_ptr<py::object> globals_<T>::fraction_class;
 
-template <typename T>
-std::unique_ptr<py::int_> globals_<T>::gmp_numb_bits;
-
 using globals = globals_<>;
 
 // Cleanup function to clear global variables
@@ -102,7 +98,6 @@ inline void cleanup()
     globals::mpf_isinf.reset();
     globals::mpf_isnan.reset();
     globals::fraction_class.reset();
-    globals::gmp_numb_bits.reset();
 }
 } // namespace detail
 
@@ -131,9 +126,6 @@ inline void init()
     // https://github.com/pybind/pybind11/pull/1169
     py::module::import("atexit").attr("register")(py::cpp_function(detail::cleanup));
 
-    // GMP bits setup.
-    detail::globals::gmp_numb_bits.reset(new py::int_(GMP_NUMB_BITS));
-
     // Detect and import mpmath bits.
     py::module mpmath_mod;
     bool have_mpmath = false;
@@ -243,18 +235,51 @@ inline mppp::integer<SSize> py_long_to_mppp_int(const ::PyLongObject *nptr)
     const auto nbits = static_cast<::mp_bitcnt_t>(static_cast<::mp_bitcnt_t>(PyLong_SHIFT) * abs_ob_size);
     // Construct the retval with the necessary number of bits.
     mppp::integer<SSize> retval{mppp::integer_bitcnt_t(nbits)};
-    // Init it with the first digit. The Python integer is nonzero, so this is safe.
-    retval = ob_digit[--abs_ob_size];
-    // Add the remaining limbs.
-    while (abs_ob_size) {
-        // NOTE: a possible optimisation here is to unroll the shifting in order to
-        // reduce the loop iterations.
-        retval <<= PyLong_SHIFT;
-        retval += ob_digit[--abs_ob_size];
-    }
-    // Negate if necessary.
-    if (neg) {
-        retval.neg();
+    // Fetch a pointer to the limbs of retval. If retval is static and SSize
+    // is small, the limbs have all been zeroed by the constructor.
+    auto &ru = retval._get_union();
+    ::mp_limb_t *rptr = ru.is_static() ? ru.g_st().m_limbs.data() : ru.g_dy()._mp_d;
+
+    // Pack the Python digits into the limbs, in a single pass.
+    // NOTE: the Python digits are stored in little-endian order,
+    // same as the GMP limbs. acc contains the bits of the limb being
+    // assembled, acc_bits is the number of bits currently in acc.
+    static_assert(PyLong_SHIFT < GMP_NUMB_BITS, "Invalid digit/limb sizes.");
+    std::size_t li = 0;
+    ::mp_limb_t acc = 0;
+    unsigned acc_bits = 0;
+    for (decltype(abs_ob_size) i = 0; i < abs_ob_size; ++i) {
+        const auto d = static_cast<::mp_limb_t>(ob_digit[i]);
+        // NOTE: the bits of d which do not fit in acc are discarded here,
+        // and they will be recovered below.
+        acc |= d << acc_bits;
+        acc_bits += unsigned(PyLong_SHIFT);
+        if (acc_bits >= unsigned(GMP_NUMB_BITS)) {
+            // The current limb is complete, write it out.
+            rptr[li++] = acc & GMP_NUMB_MASK;
+            // Init the next limb with the bits of d which were not
+            // written into the current limb (if any).
+            acc_bits -= unsigned(GMP_NUMB_BITS);
+            acc = acc_bits ? (d >> (unsigned(PyLong_SHIFT) - acc_bits)) : ::mp_limb_t(0);
+        }
+    }
+    if (acc_bits) {
+        // Write the last, partial limb.
+        rptr[li++] = acc & GMP_NUMB_MASK;
+    }
+    // NOTE: nbits is an upper bound for the number of bits of the
+    // result. Remove the most significant zero limbs, if any.
+    while (li && !rptr[li - 1u]) {
+        --li;
+    }
+    assert(li);
+    // Set the size. The size of the result is not greater than the size
+    // of the storage of retval, hence the cast is safe.
+    const auto new_size = static_cast<mppp::detail::mpz_size_t>(li);
+    if (ru.is_static()) {
+        ru.g_st()._mp_size = neg ? -new_size : new_size;
+    } else {
+        ru.g_dy()._mp_size = neg ? -new_size : new_size;
     }
     return retval;
 }
@@ -271,10 +296,8 @@ inline bool py_integer_to_mppp_int(mppp::integer<SSize> &rop, const ::PyObject *
 }
 
 // Convert mppp integer to a python integer.
-// NOTE: this can be improved via the direct C API at least in the following ways:
-// - pybind11 always stores long ints in int_, for Python 2 this is suboptimal,
-// - using the number protocol, https://docs.python.org/3.6/c-api/number.html,
-//   may be more efficient that calling int_ methods via pybind11.
+// NOTE: the Python integer is created directly via the (semi-private) C API,
+// and its digits are then written directly from the limbs of src.
 template <std::size_t SSize>
 inline py::int_ mppp_int_to_py(const mppp::integer<SSize> &src)
 {
@@ -285,19 +308,68 @@ inline py::int_ mppp_int_to_py(const mppp::integer<SSize> &src)
     // Get a pointer to the limbs.
     const ::mp_limb_t *ptr = src.is_static() ? src._get_union().g_st().m_limbs.data() : src._get_union().g_dy()._mp_d;
     // Get the size.
-    auto size = src.size();
+    const auto size = src.size();
     assert(size);
-    // Init the retval.
-    py::int_ retval(ptr[--size] & GMP_NUMB_MASK);
-    // Add the rest of the limbs arithmetically.
-    while (size) {
-        retval = retval.attr("__lshift__")(*mppp_pybind11::detail::globals::gmp_numb_bits)
-                     .attr("__add__")(py::int_(ptr[--size] & GMP_NUMB_MASK));
+    // Compute the number of Python digits needed to represent src.
+    const auto nbits = src.nbits();
+    const auto ndigits = nbits / unsigned(PyLong_SHIFT) + static_cast<std::size_t>(nbits % unsigned(PyLong_SHIFT) != 0u);
+    if (mppp_unlikely(ndigits > static_cast<std::make_unsigned<::Py_ssize_t>::type>(
+                          std::numeric_limits<::Py_ssize_t>::max()))) {
+        throw std::overflow_error("Overflow in the computation of the size of a Python integer");
+    }
+    // Create the Python integer.
+    auto *lptr = ::_PyLong_New(static_cast<::Py_ssize_t>(ndigits));
+    if (!lptr) {
+        throw py::error_already_set();
     }
+    // NOTE: take ownership immediately, so that lptr is released if
+    // something goes wrong below.
+    auto retval = py::reinterpret_steal<py::int_>(reinterpret_cast<::PyObject *>(lptr));
+
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION <= 11
+    auto *ob_digit = lptr->ob_digit;
+#else
+    auto *ob_digit = lptr->long_value.ob_digit;
+#endif
+
+    // Unpack the limbs into the Python digits, in a single pass.
+    // acc contains the bits of the current limb which have not been
+    // written out yet, acc_bits is their number.
+    static_assert(PyLong_SHIFT < GMP_NUMB_BITS, "Invalid digit/limb sizes.");
+    std::size_t li = 0;
+    ::mp_limb_t acc = 0;
+    unsigned acc_bits = 0;
+    for (std::size_t i = 0; i < ndigits; ++i) {
+        if (acc_bits >= unsigned(PyLong_SHIFT)) {
+            // We have enough bits to fill an entire digit.
+            ob_digit[i] = static_cast<::digit>(acc & PyLong_MASK);
+            acc >>= PyLong_SHIFT;
+            acc_bits -= unsigned(PyLong_SHIFT);
+        } else {
+            // The bits in acc are not enough, fetch the next limb (if any).
+            // NOTE: if there are no limbs left, the remaining bits
+            // in acc form the most significant digit.
+            const auto l = (li < size) ? (ptr[li++] & GMP_NUMB_MASK) : ::mp_limb_t(0);
+            ob_digit[i] = static_cast<::digit>((acc | (l << acc_bits)) & PyLong_MASK);
+            const auto nused = unsigned(PyLong_SHIFT) - acc_bits;
+            acc = l >> nused;
+            acc_bits = unsigned(GMP_NUMB_BITS) - nused;
+        }
+    }
+    assert(ob_digit[ndigits - 1u] != 0u);
+
     // Negate if needed.
     if (src.sgn() < 0) {
-        retval = retval.attr("__neg__")();
+#if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION <= 11
+        lptr->ob_base.ob_size = -lptr->ob_base.ob_size;
+#else
+        // NOTE: see the comments in py_long_to_mppp_int() regarding the
+        // layout of lv_tag. _PyLong_New() sets the sign bits to zero,
+        // which signals a positive value.
+        lptr->long_value.lv_tag = (lptr->long_value.lv_tag & ~static_cast<decltype(lptr->long_value.lv_tag)>(3)) | 2u;
+#endif
     }
+
     return retval;
 }
 
@@ -18,6 +18,9 @@ MPPP_BEGIN_NAMESPACE
 template <std::size_t>
 class integer;
 
+template <std::size_t>
+class integer_vector;
+
 template <std::size_t>
 class rational;
 
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
@@ -27,10 +28,13 @@
 #include <initializer_list>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <new>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -42,6 +46,12 @@
 
 #endif
 
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+#include <memory_resource>
+
+#endif
+
 #if defined(MPPP_WITH_BOOST_S11N)
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -69,6 +79,7 @@
 #include <mp++/detail/visibility.hpp>
 #include <mp++/exceptions.hpp>
 #include <mp++/fwd.hpp>
+#include <mp++/relocate.hpp>
 #include <mp++/type_name.hpp>
 
 #if defined(MPPP_WITH_MPFR)
@@ -111,12 +122,50 @@
 
 #endif
 
+// Carry intrinsics, used in the unrolled static kernels.
+#if (defined(__x86_64__) || defined(_M_X64)) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS
+
+#define MPPP_HAVE_ADDCARRY_U64
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+#else
+
+#include <immintrin.h>
+
+#endif
+
+#endif
+
+// The multiplication kernels based on the BMI2/ADX instructions (MULX, ADCX and ADOX).
+// These are implemented with inline assembly in the compiled part of the library,
+// and they are selected at load time if the CPU supports them.
+#if defined(__x86_64__) && defined(__GNUC__) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS && defined(MPPP_HAVE_GCC_INT128)
+
+#define MPPP_HAVE_ADX_KERNELS
+
+#endif
+
 MPPP_BEGIN_NAMESPACE
 
 // Strongly typed enum to represent a bit count in the constructor
 // of integer from number of bits.
 enum class integer_bitcnt_t : ::mp_bitcnt_t {};
 
+// Result type of the to_chars() functions.
+struct to_chars_result {
+    char *ptr;
+    std::errc ec;
+};
+
+// Result type of the from_chars() functions.
+struct from_chars_result {
+    const char *ptr;
+    std::errc ec;
+};
+
 namespace detail
 {
 
@@ -159,27 +208,79 @@ inline std::size_t get_mpz_size(const ::mpz_t n)
 // Structure for caching allocated arrays of limbs.
 // NOTE: needs to be public for testing purposes.
 struct MPPP_DLL_PUBLIC mpz_alloc_cache {
+    // Upper limit for the size of the arrays which can be cached.
+    static constexpr std::size_t max_size_limit = 64;
+    // Default values for the runtime limits below.
+    static constexpr std::size_t default_max_size = 10;
+    static constexpr std::size_t default_max_entries = 100;
     // Arrays up to this size will be cached.
-    static constexpr std::size_t max_size = 10;
+    std::size_t max_size;
     // Max number of arrays to cache for each size.
-    static constexpr std::size_t max_entries = 100;
-    // The actual cache.
-    std::array<std::array<::mp_limb_t *, max_entries>, max_size> caches;
+    std::size_t max_entries;
+    // The actual cache. This is a flat array of max_size * max_entries
+    // pointers, allocated on first use.
+    ::mp_limb_t **caches;
+    // The number of arrays which can be stored for each size in the fast
+    // path of mpz_clear_wrap(): max_entries if the storage has been allocated and
+    // the memory resources are not enabled, zero otherwise.
+    std::size_t capacity;
     // The number of arrays actually stored in each cache entry.
-    std::array<std::size_t, max_size> sizes;
+    std::array<std::size_t, max_size_limit> sizes;
+    // Number of size classes for the arrays larger than max_size. The size
+    // classes grow geometrically with 4 classes per power of two, from
+    // 8 limbs (class 0) to 1024 limbs (class n_classes - 1).
+    static constexpr std::size_t n_classes = 29;
+    // Max number of arrays to cache for each size class.
+    static constexpr std::size_t class_max_entries = 16;
+    // The arrays cached in each size class. The arrays of a size class
+    // are at least as large as the size of the class, and their actual
+    // size is stored in their first limb.
+    std::array<std::array<::mp_limb_t *, class_max_entries>, n_classes> class_caches;
+    // The number of arrays actually stored in each size class.
+    std::array<std::size_t, n_classes> class_sizes;
+    // Usage statistics: number of allocations served by the cache,
+    // number of allocations not served by the cache and number of
+    // deallocations which could not be stored in the cache.
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
     // NOTE: use round brackets init for the usual GCC 4.8 workaround.
-    // NOTE: this will zero initialise recursively both members: we will
-    // have all nullptrs in the caches, and all cache sizes will be zeroes.
-    constexpr mpz_alloc_cache() noexcept : caches(), sizes() {}
+    // NOTE: this will zero initialise recursively the sizes and class members.
+    constexpr mpz_alloc_cache() noexcept
+        : max_size(default_max_size), max_entries(default_max_entries), caches(nullptr), capacity(0), sizes(),
+          class_caches(), class_sizes(), hits(0), misses(0), evictions(0)
+    {
+    }
     mpz_alloc_cache(const mpz_alloc_cache &) = delete;
     mpz_alloc_cache(mpz_alloc_cache &&) = delete;
     mpz_alloc_cache &operator=(const mpz_alloc_cache &) = delete;
     mpz_alloc_cache &operator=(mpz_alloc_cache &&) = delete;
     // Clear the cache, deallocating all the data in the arrays.
     void clear() noexcept;
+    // Allocate the storage for the cache, if needed. Returns false
+    // if the allocation fails.
+    bool init_storage() noexcept;
+    // Init rop with at least nlimbs limbs, refilling the cache from the central depot
+    // if needed. Returns false if nlimbs is not in the range of the cache.
+    // NOTE: this is the slow path of the init from cache. In case of a cache
+    // miss in the range of the size classes, the size of the new array is rounded up
+    // to the size of the class, so that it can be cached in the same class when it is freed.
+    bool init_slow(mpz_struct_t &, std::size_t);
+    // Store the limbs of m in the cache if possible, otherwise free them.
+    // NOTE: this is the slow path of mpz_clear_wrap(), which allocates
+    // the storage of the cache if needed, moves arrays to the central depot
+    // when the cache is full and keeps track of the evictions.
+    void cache_or_clear(mpz_struct_t &);
+    // Move the content of the cache to the central depot, and
+    // then clear the cache.
+    void flush() noexcept;
+    // Clear the cache and set new limits.
+    void set_limits(std::size_t, std::size_t);
+    // Add to the cache up to n arrays of (at least) nlimbs limbs.
+    void prefill(std::size_t, std::size_t);
     ~mpz_alloc_cache()
     {
-        clear();
+        flush();
     }
 };
 
@@ -215,6 +316,87 @@ MPPP_DLL_PUBLIC void mpz_init_nbits(mpz_struct_t &, ::mp_bitcnt_t, std::size_t);
 // Thin wrapper around mpz_clear(): will add entry to cache if possible instead of clearing.
 MPPP_DLL_PUBLIC void mpz_clear_wrap(mpz_struct_t &);
 
+// The operations of a memory resource used for the
+// dynamic storage of integers.
+struct mpz_memory_resource_ops {
+    void *(*allocate)(void *, std::size_t);
+    void (*deallocate)(void *, void *, std::size_t);
+    // If true, the memory allocated from the resource is always reallocated
+    // from the same resource. Otherwise, it is reallocated from the resource
+    // bound to the thread performing the reallocation.
+    bool sticky;
+};
+
+// A type-erased memory resource. A null resource
+// represents the default allocation functions.
+struct mpz_memory_binding {
+    void *resource;
+    const mpz_memory_resource_ops *ops;
+};
+
+// Bind a memory resource to the calling thread. Returns the previous binding.
+MPPP_DLL_PUBLIC mpz_memory_binding mpz_exchange_memory_binding(const mpz_memory_binding &) noexcept;
+
+// Flag signalling if the GMP memory functions have been installed.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+MPPP_DLL_PUBLIC extern std::atomic<bool> mpz_memory_resources_flag;
+
+// Restore a binding on destruction.
+struct mpz_memory_binding_restorer {
+    explicit mpz_memory_binding_restorer(const mpz_memory_binding &b) : m_prev(b) {}
+    mpz_memory_binding_restorer(const mpz_memory_binding_restorer &) = delete;
+    mpz_memory_binding_restorer(mpz_memory_binding_restorer &&) = delete;
+    mpz_memory_binding_restorer &operator=(const mpz_memory_binding_restorer &) = delete;
+    mpz_memory_binding_restorer &operator=(mpz_memory_binding_restorer &&) = delete;
+    ~mpz_memory_binding_restorer()
+    {
+        mpz_exchange_memory_binding(m_prev);
+    }
+    mpz_memory_binding m_prev;
+};
+
+// Bind the default allocation functions to the calling thread for the lifetime of the object.
+// NOTE: this is used for the thread-local temporaries, whose storage is kept until the end of
+// the thread and thus must never be drawn from a memory resource, which may be released
+// or destroyed in the meantime.
+class mpz_default_memory_binding
+{
+public:
+    // NOTE: if the memory resources are not enabled, all allocations go
+    // through the default functions anyway: skip the (non-inline) exchange.
+    mpz_default_memory_binding()
+        : m_prev(mpz_memory_resources_flag.load(std::memory_order_relaxed)
+                     ? mpz_exchange_memory_binding({nullptr, nullptr})
+                     : mpz_memory_binding{nullptr, nullptr})
+    {
+    }
+    mpz_default_memory_binding(const mpz_default_memory_binding &) = delete;
+    mpz_default_memory_binding(mpz_default_memory_binding &&) = delete;
+    mpz_default_memory_binding &operator=(const mpz_default_memory_binding &) = delete;
+    mpz_default_memory_binding &operator=(mpz_default_memory_binding &&) = delete;
+    ~mpz_default_memory_binding()
+    {
+        if (m_prev.resource != nullptr) {
+            mpz_exchange_memory_binding(m_prev);
+        }
+    }
+    // Invoke f with the previous binding, e.g., to write into
+    // the return value the result of a computation performed
+    // on the thread-local temporaries.
+    template <typename F>
+    auto escape(F &&f) const -> decltype(std::forward<F>(f)())
+    {
+        if (m_prev.resource == nullptr) {
+            return std::forward<F>(f)();
+        }
+        const mpz_memory_binding_restorer r(mpz_exchange_memory_binding(m_prev));
+        return std::forward<F>(f)();
+    }
+
+private:
+    mpz_memory_binding m_prev;
+};
+
 // Combined init+set.
 inline void mpz_init_set_nlimbs(mpz_struct_t &m0, const mpz_struct_t &m1)
 {
@@ -233,6 +415,37 @@ inline std::string mpz_to_str(const mpz_struct_t *mpz, int base = 10)
     return tmp.data();
 }
 
+// Set the value of an mpz from a string in base base, with the same semantics as mpz_set_str().
+// Large values in non power of 2 bases are parsed in parallel.
+MPPP_DLL_PUBLIC int mpz_from_str(mpz_struct_t *, const char *, int);
+
+// Write the representation in base base of the nonnegative integer stored in the
+// limbs [p, p + size) into the range [first, last), prefixed by a minus sign if neg is true.
+// scratch must have space for at least size limbs, and dbuf for at least
+// size * GMP_NUMB_BITS + 1 chars.
+MPPP_DLL_PUBLIC to_chars_result limbs_to_chars(char *, char *, const ::mp_limb_t *, std::size_t, bool, int,
+                                               ::mp_limb_t *, unsigned char *);
+
+// Write the representation in base base of an mpz into the range [first, last).
+MPPP_DLL_PUBLIC to_chars_result mpz_to_chars(char *, char *, const mpz_struct_t *, int);
+
+// Return a pointer past the end of the sequence of valid digits in base base
+// at the beginning of the range [first, last).
+MPPP_DLL_PUBLIC const char *scan_digits(const char *, const char *, int);
+
+// Write into out the limbs of the value represented by the valid digits in base base
+// in the range [first, last), and return the number of limbs of the value. If the value
+// might need more than out_size limbs, nothing is written into out and out_size + 1 is returned.
+MPPP_DLL_PUBLIC std::size_t digits_to_limbs(::mp_limb_t *, std::size_t, const char *, const char *, int);
+
+// Size of the local limb buffer in the from_chars() implementation.
+// NOTE: digits_to_limbs() estimates the number of bits per digit by excess
+// (up to a factor of ~1.3, in base 5), the extra limbs ensure that the values
+// fitting in static storage are always converted in the local buffer.
+template <std::size_t SSize>
+using from_chars_nlimbs
+    = std::integral_constant<std::size_t, (SSize + SSize / 3u + 2u > 16u ? SSize + SSize / 3u + 2u : 16u)>;
+
 // Small wrapper to copy limbs.
 inline void copy_limbs(const ::mp_limb_t *begin, const ::mp_limb_t *end, ::mp_limb_t *out)
 {
@@ -260,6 +473,41 @@ inline ::mp_limb_t limb_add_overflow(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t *
     return *res < a;
 }
 
+// Add a, b and the carry cy (either 0 or 1), store the result in res, and return the carry out.
+inline ::mp_limb_t limb_add_carry(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t cy, ::mp_limb_t *res)
+{
+#if defined(MPPP_HAVE_ADDCARRY_U64)
+    // NOTE: mp_limb_t may not be the same type as unsigned long long,
+    // hence the temporary.
+    unsigned long long tmp; // NOLINT(cppcoreguidelines-init-variables)
+    const auto retval = _addcarry_u64(static_cast<unsigned char>(cy), a, b, &tmp);
+    *res = static_cast<::mp_limb_t>(tmp);
+    return retval;
+#else
+    // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+    ::mp_limb_t tmp;
+    const auto c1 = limb_add_overflow(a, b, &tmp);
+    const auto c2 = limb_add_overflow(tmp, cy, res);
+    return c1 | c2;
+#endif
+}
+
+// Subtract b and the borrow br (either 0 or 1) from a, store the result in res, and return the borrow out.
+inline ::mp_limb_t limb_sub_borrow(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t br, ::mp_limb_t *res)
+{
+#if defined(MPPP_HAVE_ADDCARRY_U64)
+    unsigned long long tmp; // NOLINT(cppcoreguidelines-init-variables)
+    const auto retval = _subborrow_u64(static_cast<unsigned char>(br), a, b, &tmp);
+    *res = static_cast<::mp_limb_t>(tmp);
+    return retval;
+#else
+    const auto tmp = a - b;
+    const auto b1 = static_cast<::mp_limb_t>(a < b), b2 = static_cast<::mp_limb_t>(tmp < br);
+    *res = tmp - br;
+    return b1 | b2;
+#endif
+}
+
 // Implementation of the function to count the number of leading zeroes
 // in an unsigned integral value for GCC/clang. The clz builtin is available
 // in all supported GCC/clang versions.
@@ -719,9 +967,10 @@ union integer_union {
             throw std::domain_error("Cannot construct an integer from the non-finite floating-point value "
                                     + to_string(x));
         }
+        const mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS mpz_raii tmp;
         mpz_set_d(&tmp.m_mpz, static_cast<double>(x));
-        dispatch_mpz_ctor(&tmp.m_mpz);
+        mb.escape([&]() { dispatch_mpz_ctor(&tmp.m_mpz); });
     }
 #if defined(MPPP_WITH_MPFR)
     // Construction from long double, requires MPFR.
@@ -733,6 +982,7 @@ union integer_union {
         }
         // NOTE: static checks for overflows and for the precision value are done in mpfr.hpp.
         constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        const mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
         MPPP_MAYBE_TLS mpz_raii tmp;
 #if defined(_MSC_VER)
@@ -741,7 +991,7 @@ union integer_union {
         ::mpfr_set_ld(&mpfr.m_mpfr, x, MPFR_RNDN);
 #endif
         ::mpfr_get_z(&tmp.m_mpz, &mpfr.m_mpfr, MPFR_RNDZ);
-        dispatch_mpz_ctor(&tmp.m_mpz);
+        mb.escape([&]() { dispatch_mpz_ctor(&tmp.m_mpz); });
     }
 #endif
     // The generic constructor.
@@ -759,8 +1009,9 @@ union integer_union {
                 "In the constructor of integer from string, a base of " + to_string(base)
                 + " was specified, but the only valid values are 0 and any value in the [2,62] range");
         }
+        const mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS mpz_raii mpz;
-        if (mppp_unlikely(mpz_set_str(&mpz.m_mpz, s, base))) {
+        if (mppp_unlikely(mpz_from_str(&mpz.m_mpz, s, base))) {
             if (base != 0) {
                 throw std::invalid_argument(std::string("The string '") + s + "' is not a valid integer in base "
                                             + to_string(base));
@@ -769,7 +1020,7 @@ union integer_union {
                                             + "' is not a valid integer in any supported base");
             }
         }
-        dispatch_mpz_ctor(&mpz.m_mpz);
+        mb.escape([&]() { dispatch_mpz_ctor(&mpz.m_mpz); });
     }
     // Constructor from C string and base.
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
@@ -1521,9 +1772,10 @@ private:
             throw std::domain_error("Cannot assign the non-finite floating-point value " + detail::to_string(x)
                                     + " to an integer");
         }
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpz_raii tmp;
         mpz_set_d(&tmp.m_mpz, static_cast<double>(x));
-        *this = &tmp.m_mpz;
+        mb.escape([&]() { *this = &tmp.m_mpz; });
     }
 #if defined(MPPP_WITH_MPFR)
     // Assignment from long double, requires MPFR.
@@ -1535,6 +1787,7 @@ private:
         }
         // NOTE: static checks for overflows and for the precision value are done in mpfr.hpp.
         constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
         MPPP_MAYBE_TLS detail::mpz_raii tmp;
 #if defined(_MSC_VER)
@@ -1543,7 +1796,7 @@ private:
         ::mpfr_set_ld(&mpfr.m_mpfr, x, MPFR_RNDN);
 #endif
         ::mpfr_get_z(&tmp.m_mpz, &mpfr.m_mpfr, MPFR_RNDZ);
-        *this = &tmp.m_mpz;
+        mb.escape([&]() { *this = &tmp.m_mpz; });
     }
 #endif
 
@@ -1729,10 +1982,18 @@ public:
                                         "2 and 62, but a value of "
                                         + detail::to_string(base) + " was provided instead");
         }
+        if (is_static()) {
+            // NOTE: for static integers, write the representation into a local
+            // buffer large enough for any value in any base (i.e., the
+            // number of bits plus the sign).
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<char, SSize * unsigned(GMP_NUMB_BITS) + 1u> buffer;
+            const auto res = to_chars(buffer.data(), buffer.data() + buffer.size(), *this, base);
+            assert(res.ec == std::errc{});
+            return std::string(buffer.data(), res.ptr);
+        }
         return detail::mpz_to_str(get_mpz_view(), base);
     }
-    // NOTE: maybe provide a member function to access the lower-level str conversion that writes to
-    // std::vector<char>?
 
 private:
     // Conversion to bool.
@@ -1906,6 +2167,7 @@ private:
     static std::pair<bool, T> mpz_float_conversion(const detail::mpz_struct_t &m)
     {
         constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
         ::mpfr_set_z(&mpfr.m_mpfr, &m, MPFR_RNDN);
 #if defined(_MSC_VER)
@@ -2721,14 +2983,74 @@ MPPP_CONCEPT_DECL integer_integral_op_types = are_integer_integral_op_types<T, U
 namespace detail
 {
 
+// The largest static size for which the unrolled static kernels are used.
+constexpr std::size_t integer_unrolled_max_size = 8;
+
+// Helper to detect if the unrolled static kernels can be used for a static size.
+template <typename SInt>
+using integer_static_use_unrolled = std::integral_constant<bool, !GMP_NAIL_BITS && SInt::s_size >= 3
+                                                                     && SInt::s_size <= integer_unrolled_max_size>;
+
 // Metaprogramming for selecting the algorithm for static addition. The selection happens via
-// an std::integral_constant with 3 possible values:
+// an std::integral_constant with 4 possible values:
 // - 0 (default case): use the GMP mpn functions,
 // - 1: selected when there are no nail bits and the static size is 1,
-// - 2: selected when there are no nail bits and the static size is 2.
+// - 2: selected when there are no nail bits and the static size is 2,
+// - 3: selected when there are no nail bits and the static size is between 3 and 8.
 template <typename SInt>
 using integer_static_add_algo = std::integral_constant<
-    int, (!GMP_NAIL_BITS && SInt::s_size == 1) ? 1 : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : 0)>;
+    int, (!GMP_NAIL_BITS && SInt::s_size == 1)
+             ? 1
+             : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : (integer_static_use_unrolled<SInt>::value ? 3 : 0))>;
+
+// Compile-time unrolled primitives operating on arrays of N limbs, starting from the limb at index I.
+// These are used in the static implementations for sizes 3 to 8, where they avoid the loop
+// and size overhead of the mpn functions.
+template <std::size_t I, std::size_t N>
+struct fixed_limbs {
+    // r = a + b + cy, returns the carry.
+    static ::mp_limb_t add(::mp_limb_t *r, const ::mp_limb_t *a, const ::mp_limb_t *b, ::mp_limb_t cy)
+    {
+        cy = limb_add_carry(a[I], b[I], cy, r + I);
+        return fixed_limbs<I + 1u, N>::add(r, a, b, cy);
+    }
+    // r = a - b - br, returns the borrow.
+    static ::mp_limb_t sub(::mp_limb_t *r, const ::mp_limb_t *a, const ::mp_limb_t *b, ::mp_limb_t br)
+    {
+        br = limb_sub_borrow(a[I], b[I], br, r + I);
+        return fixed_limbs<I + 1u, N>::sub(r, a, b, br);
+    }
+    // Load the asize limbs at p into r, zero-padding the remaining limbs.
+    // NOTE: the limbs of p above asize are never read, as for the non-optimised
+    // static sizes they may be uninitialised.
+    static void load(::mp_limb_t *r, const ::mp_limb_t *p, std::size_t asize)
+    {
+        r[I] = I < asize ? p[I] : ::mp_limb_t(0);
+        fixed_limbs<I + 1u, N>::load(r, p, asize);
+    }
+};
+
+template <std::size_t N>
+struct fixed_limbs<N, N> {
+    static ::mp_limb_t add(::mp_limb_t *, const ::mp_limb_t *, const ::mp_limb_t *, ::mp_limb_t cy)
+    {
+        return cy;
+    }
+    static ::mp_limb_t sub(::mp_limb_t *, const ::mp_limb_t *, const ::mp_limb_t *, ::mp_limb_t br)
+    {
+        return br;
+    }
+    static void load(::mp_limb_t *, const ::mp_limb_t *, std::size_t) {}
+};
+
+// Size of the value represented by the n limbs at p.
+inline std::size_t fixed_limbs_size(const ::mp_limb_t *p, std::size_t n)
+{
+    while (n != 0u && p[n - 1u] == 0u) {
+        --n;
+    }
+    return n;
+}
 
 // General implementation via mpn.
 // Small helper to compute the size after subtraction via mpn. s is a strictly positive size.
@@ -3016,6 +3338,45 @@ inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1
     return true;
 }
 
+// Unrolled implementation for static sizes 3 to 8.
+template <std::size_t SSize>
+inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                            const std::integral_constant<int, 3> &)
+{
+    using fl = fixed_limbs<0, SSize>;
+
+    // Load the operands into zero-padded local storage. This also
+    // takes care of overlapping arguments.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, SSize> a, b;
+    fl::load(a.data(), op1.m_limbs.data(), static_cast<std::size_t>(asize1));
+    fl::load(b.data(), op2.m_limbs.data(), static_cast<std::size_t>(asize2));
+
+    auto rdata = rop.m_limbs.data();
+    int sign = sign1;
+    if (sign1 == sign2) {
+        // NOTE: contrary to the mpn implementation, here we can detect overflow
+        // exactly, as we have not written anything into rop yet.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize> r;
+        if (mppp_unlikely(fl::add(r.data(), a.data(), b.data(), 0))) {
+            return false;
+        }
+        copy_limbs_no(r.data(), r.data() + SSize, rdata);
+    } else {
+        // Compute a - b, and, if that is negative, b - a.
+        // NOTE: this also includes the case in which only one of the operands is zero.
+        if (fl::sub(rdata, a.data(), b.data(), 0)) {
+            fl::sub(rdata, b.data(), a.data(), 0);
+            sign = sign2;
+        }
+    }
+    rop._mp_size = sign * static_cast<mpz_size_t>(fixed_limbs_size(rdata, SSize));
+
+    return true;
+}
+
 template <bool AddOrSub, std::size_t SSize>
 inline bool static_addsub(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
@@ -3057,7 +3418,9 @@ inline integer<SSize> &add(integer<SSize> &rop, const integer<SSize> &op1, const
         }
     }
     if (sr) {
-        rop._get_union().promote(SSize + 1u);
+        // NOTE: if one of the operands is dynamic, preallocate enough limbs for the
+        // result, so that mpz_add() does not need to reallocate.
+        rop._get_union().promote(s1 && s2 ? SSize + 1u : std::max(op1.size(), op2.size()) + 1u);
     }
     mpz_add(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
     return rop;
@@ -3273,9 +3636,10 @@ inline integer<SSize> &add_ui_impl(integer<SSize> &rop, const integer<SSize> &op
         // For the optimised version below to kick in we need to be sure we can safely convert
         // op2 to an ::mp_limb_t, modulo nail bits. Otherwise, we just call add() after converting
         // op2 to an integer.
+        const mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS integer<SSize> tmp;
         tmp = op2;
-        return add(rop, op1, tmp);
+        return mb.escape([&]() -> integer<SSize> & { return add(rop, op1, tmp); });
     }
     const bool s1 = op1.is_static();
     bool sr = rop.is_static();
@@ -3369,7 +3733,9 @@ inline integer<SSize> &sub(integer<SSize> &rop, const integer<SSize> &op1, const
         }
     }
     if (sr) {
-        rop._get_union().promote(SSize + 1u);
+        // NOTE: if one of the operands is dynamic, preallocate enough limbs for the
+        // result, so that mpz_sub() does not need to reallocate.
+        rop._get_union().promote(s1 && s2 ? SSize + 1u : std::max(op1.size(), op2.size()) + 1u);
     }
     mpz_sub(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
     return rop;
@@ -3383,9 +3749,10 @@ template <std::size_t SSize, typename T>
 inline integer<SSize> &sub_ui_impl(integer<SSize> &rop, const integer<SSize> &op1, const T &op2)
 {
     if (op2 > GMP_NUMB_MASK) {
+        const mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS integer<SSize> tmp;
         tmp = op2;
-        return sub(rop, op1, tmp);
+        return mb.escape([&]() -> integer<SSize> & { return sub(rop, op1, tmp); });
     }
     const bool s1 = op1.is_static();
     bool sr = rop.is_static();
@@ -3463,11 +3830,19 @@ using integer_have_dlimb_mul = std::integral_constant<bool,
 #endif
                                                       >;
 
+// Selection of the algorithm for static multiplication:
+// - 0 (default case): use the GMP mpn functions,
+// - 1: selected when the static size is 1 and the double-limb mul primitives are available,
+// - 2: selected when the static size is 2 and the double-limb mul primitives are available,
+// - 3: selected when the static size is between 3 and 8, there are no nail bits and the double-limb mul
+//   primitives are available.
 template <typename SInt>
-using integer_static_mul_algo
-    = std::integral_constant<int, (SInt::s_size == 1 && integer_have_dlimb_mul::value)
-                                      ? 1
-                                      : ((SInt::s_size == 2 && integer_have_dlimb_mul::value) ? 2 : 0)>;
+using integer_static_mul_algo = std::integral_constant<
+    int, (SInt::s_size == 1 && integer_have_dlimb_mul::value)
+             ? 1
+             : ((SInt::s_size == 2 && integer_have_dlimb_mul::value)
+                    ? 2
+                    : ((integer_static_use_unrolled<SInt>::value && integer_have_dlimb_mul::value) ? 3 : 0))>;
 
 // mpn implementation.
 // NOTE: this function (and the other overloads) returns 0 in case of success, otherwise it returns a hint
@@ -3621,6 +3996,146 @@ inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSiz
     return 4u;
 }
 
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+
+// Compile-time unrolled multiplication primitives, see fixed_limbs.
+template <std::size_t I, std::size_t N>
+struct fixed_limbs_mul {
+    // r += a * l, with a consisting of N limbs. Returns the carry.
+    static ::mp_limb_t addmul_1(::mp_limb_t *r, const ::mp_limb_t *a, ::mp_limb_t l, ::mp_limb_t cy)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+        ::mp_limb_t hi;
+        const auto lo = dlimb_mul(a[I], l, &hi);
+        // NOTE: a[I] * l + r[I] + cy is at most B**2 - 1, thus hi cannot overflow.
+        hi += limb_add_overflow(lo, r[I], r + I);
+        hi += limb_add_overflow(r[I], cy, r + I);
+        return fixed_limbs_mul<I + 1u, N>::addmul_1(r, a, l, hi);
+    }
+};
+
+template <std::size_t N>
+struct fixed_limbs_mul<N, N> {
+    static ::mp_limb_t addmul_1(::mp_limb_t *, const ::mp_limb_t *, ::mp_limb_t, ::mp_limb_t cy)
+    {
+        return cy;
+    }
+};
+
+// Schoolbook multiplication of the K limbs at a by the asize2 limbs at b, starting from
+// the row I. r must have N + 1 zeroed limbs, and the product must fit in them, that is, K + asize2 <= N + 1.
+template <std::size_t I, std::size_t K, std::size_t N, bool = (I + K > N)>
+struct fixed_mul_rows {
+    static void run(::mp_limb_t *r, const ::mp_limb_t *a, const ::mp_limb_t *b, std::size_t asize2)
+    {
+        if (I == asize2) {
+            return;
+        }
+        r[I + K] = fixed_limbs_mul<0, K>::addmul_1(r + I, a, b[I], 0);
+        fixed_mul_rows<I + 1u, K, N>::run(r, a, b, asize2);
+    }
+};
+
+template <std::size_t I, std::size_t K, std::size_t N>
+struct fixed_mul_rows<I, K, N, true> {
+    static void run(::mp_limb_t *, const ::mp_limb_t *, const ::mp_limb_t *, std::size_t) {}
+};
+
+// Select at runtime the schoolbook multiplication
+// specialised for a first operand with asize1 == K limbs.
+template <std::size_t K, std::size_t N, bool = (K > N)>
+struct fixed_mul_dispatch {
+    static void run(::mp_limb_t *r, const ::mp_limb_t *a, std::size_t asize1, const ::mp_limb_t *b,
+                    std::size_t asize2)
+    {
+        if (asize1 == K) {
+            fixed_mul_rows<0, K, N>::run(r, a, b, asize2);
+        } else {
+            fixed_mul_dispatch<K + 1u, N>::run(r, a, asize1, b, asize2);
+        }
+    }
+};
+
+template <std::size_t K, std::size_t N>
+struct fixed_mul_dispatch<K, N, true> {
+    static void run(::mp_limb_t *, const ::mp_limb_t *, std::size_t, const ::mp_limb_t *, std::size_t)
+    {
+        // LCOV_EXCL_START
+        assert(false);
+        // LCOV_EXCL_STOP
+    }
+};
+
+#if defined(MPPP_HAVE_ADX_KERNELS)
+
+// Flag signalling whether the BMI2/ADX kernels are in use.
+// It is set at load time, after querying the CPU features.
+MPPP_DLL_PUBLIC extern const bool integer_use_adx_kernels;
+
+// BMI2/ADX counterpart of fixed_mul_dispatch, for asize1 up to integer_unrolled_max_size.
+MPPP_DLL_PUBLIC void fixed_mul_adx(::mp_limb_t *, const ::mp_limb_t *, std::size_t, const ::mp_limb_t *, std::size_t);
+
+#endif
+
+// Compute the product of the asize1 limbs at a by the asize2 limbs at b, with asize1 >= asize2,
+// into r, which must consist of N + 1 zeroed limbs.
+template <std::size_t N>
+inline void fixed_mul(::mp_limb_t *r, const ::mp_limb_t *a, std::size_t asize1, const ::mp_limb_t *b,
+                      std::size_t asize2)
+{
+    assert(asize1 >= asize2);
+#if defined(MPPP_HAVE_ADX_KERNELS)
+    // NOTE: for very small operands the BMI2/ADX kernels are not faster
+    // than the inline ones, and the out-of-line call is not worth it.
+    if (asize1 >= 3u && integer_use_adx_kernels) {
+        fixed_mul_adx(r, a, asize1, b, asize2);
+        return;
+    }
+#endif
+    fixed_mul_dispatch<1, N>::run(r, a, asize1, b, asize2);
+}
+
+// Unrolled implementation for static sizes 3 to 8.
+template <std::size_t SSize>
+inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                   mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                   const std::integral_constant<int, 3> &)
+{
+    // Handle zeroes.
+    if (mppp_unlikely(!sign1 || !sign2)) {
+        rop._mp_size = 0;
+        return 0u;
+    }
+    // NOTE: the product of two values with asize1 and asize2 limbs
+    // has at least asize1 + asize2 - 1 limbs.
+    const auto max_asize = static_cast<std::size_t>(asize1 + asize2);
+    if (max_asize > SSize + 1u) {
+        return max_asize;
+    }
+
+    // NOTE: use the larger operand as first operand, so that
+    // the number of rows in the schoolbook multiplication is minimised.
+    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
+    if (asize1 < asize2) {
+        std::swap(data1, data2);
+        std::swap(asize1, asize2);
+    }
+
+    // NOTE: the product is computed in local storage, which also takes
+    // care of overlapping arguments. As max_asize <= SSize + 1, the product fits in SSize + 1 limbs.
+    std::array<::mp_limb_t, SSize + 1u> r{};
+    fixed_mul<SSize>(r.data(), data1, static_cast<std::size_t>(asize1), data2, static_cast<std::size_t>(asize2));
+    if (r[SSize] != 0u) {
+        return max_asize;
+    }
+
+    copy_limbs_no(r.data(), r.data() + SSize, rop.m_limbs.data());
+    rop._mp_size = sign1 * sign2 * static_cast<mpz_size_t>(fixed_limbs_size(r.data(), SSize));
+    return 0u;
+}
+
+#endif
+
 template <std::size_t SSize>
 inline std::size_t static_mul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
@@ -3657,12 +4172,14 @@ inline integer<SSize> &mul(integer<SSize> &rop, const integer<SSize> &op1, const
         }
     }
     if (sr) {
-        // We use the size hint from the static_mul if available, otherwise a normal promotion will take place.
-        // NOTE: here the best way of proceeding would be to calculate the max size of the result based on
-        // the op1/op2 sizes, but for whatever reason this computation has disastrous performance consequences
-        // on micro-benchmarks. We need to understand if that's the case in real-world scenarios as well, and
-        // revisit this.
-        rop._get_union().promote(size_hint);
+        // We use the size hint from the static_mul if available. Otherwise, one of the operands
+        // is dynamic and we preallocate enough limbs for the result, so that mpz_mul() does not
+        // need to reallocate and the limbs can be recycled via the size classes of the cache.
+        // NOTE: in the past, computing the max size of the result from the op1/op2 sizes here
+        // had disastrous performance consequences on micro-benchmarks. With the size classes,
+        // the vec_mul and dot product benchmarks do not show such regressions (the static
+        // path is unaffected), but this should be revisited if they reappear.
+        rop._get_union().promote(size_hint != 0u ? size_hint : op1.size() + op2.size());
     }
     mpz_mul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
     return rop;
@@ -3675,9 +4192,12 @@ namespace detail
 // optimised addmul algos. Otherwise, use the mpn one.
 template <typename SInt>
 using integer_static_addmul_algo = std::integral_constant<
-    int, (integer_static_add_algo<SInt>::value == 2 && integer_static_mul_algo<SInt>::value == 2)
-             ? 2
-             : ((integer_static_add_algo<SInt>::value == 1 && integer_static_mul_algo<SInt>::value == 1) ? 1 : 0)>;
+    int, (integer_static_add_algo<SInt>::value == 3 && integer_static_mul_algo<SInt>::value == 3)
+             ? 3
+             : ((integer_static_add_algo<SInt>::value == 2 && integer_static_mul_algo<SInt>::value == 2)
+                    ? 2
+                    : ((integer_static_add_algo<SInt>::value == 1 && integer_static_mul_algo<SInt>::value == 1) ? 1
+                                                                                                                 : 0))>;
 
 // NOTE: same return value as mul: 0 for success, otherwise a hint for the size of the result.
 template <std::size_t SSize>
@@ -3869,6 +4389,60 @@ inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<S
     return 0u;
 }
 
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+
+// Unrolled implementation for static sizes 3 to 8.
+template <std::size_t SSize>
+inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                      const static_int<SSize> &op2, mpz_size_t asizer, mpz_size_t asize1,
+                                      mpz_size_t asize2, int signr, int sign1, int sign2,
+                                      const std::integral_constant<int, 3> &)
+{
+    // NOTE: nothing to do if the product is zero.
+    if (mppp_unlikely(!sign1 || !sign2)) {
+        return 0u;
+    }
+    const auto max_asize = static_cast<std::size_t>(asize1 + asize2);
+    if (max_asize > SSize + 1u) {
+        return max_asize + 1u;
+    }
+
+    // Compute the product in local storage, as in the mul implementation.
+    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
+    if (asize1 < asize2) {
+        std::swap(data1, data2);
+        std::swap(asize1, asize2);
+    }
+    std::array<::mp_limb_t, SSize + 1u> prod{};
+    fixed_mul<SSize>(prod.data(), data1, static_cast<std::size_t>(asize1), data2, static_cast<std::size_t>(asize2));
+    if (prod[SSize] != 0u) {
+        return max_asize + 1u;
+    }
+
+    using fl = fixed_limbs<0, SSize>;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, SSize> a, r;
+    fl::load(a.data(), rop.m_limbs.data(), static_cast<std::size_t>(asizer));
+
+    const auto signp = sign1 * sign2;
+    if (signr == signp || !signr) {
+        // NOTE: rop is left untouched in case of failure.
+        if (mppp_unlikely(fl::add(r.data(), a.data(), prod.data(), 0))) {
+            return SSize + 1u;
+        }
+        signr = signp;
+    } else if (fl::sub(r.data(), a.data(), prod.data(), 0)) {
+        fl::sub(r.data(), prod.data(), a.data(), 0);
+        signr = signp;
+    }
+    copy_limbs_no(r.data(), r.data() + SSize, rop.m_limbs.data());
+    rop._mp_size = signr * static_cast<mpz_size_t>(fixed_limbs_size(r.data(), SSize));
+
+    return 0u;
+}
+
+#endif
+
 template <bool AddOrSub, std::size_t SSize>
 inline std::size_t static_addsubmul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
@@ -4144,10 +4718,7 @@ namespace detail
 // static squaring. We'll be using the
 // double-limb mul primitives if available.
 template <typename SInt>
-using integer_static_sqr_algo
-    = std::integral_constant<int, (SInt::s_size == 1 && integer_have_dlimb_mul::value)
-                                      ? 1
-                                      : ((SInt::s_size == 2 && integer_have_dlimb_mul::value) ? 2 : 0)>;
+using integer_static_sqr_algo = std::integral_constant<int, integer_static_mul_algo<SInt>::value>;
 
 // mpn implementation.
 // NOTE: this function (and the other overloads) returns 0 in case of success, otherwise it returns a hint
@@ -4242,6 +4813,21 @@ inline std::size_t static_sqr_impl(static_int<SSize> &rop, const static_int<SSiz
     return 0;
 }
 
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+
+// Unrolled implementation for static sizes 3 to 8, via the unrolled multiplication.
+template <std::size_t SSize>
+inline std::size_t static_sqr_impl(static_int<SSize> &rop, const static_int<SSize> &op,
+                                   const std::integral_constant<int, 3> &)
+{
+    const auto asize = std::abs(op._mp_size);
+    const auto sign = integral_sign(op._mp_size);
+
+    return static_mul_impl(rop, op, op, asize, asize, sign, sign, std::integral_constant<int, 3>{});
+}
+
+#endif
+
 template <std::size_t SSize>
 inline std::size_t static_sqr(static_int<SSize> &rop, const static_int<SSize> &op)
 {
@@ -4406,6 +4992,11 @@ inline ::mp_limb_t static_sqrm_impl_1(::mp_limb_t op, ::mp_limb_t mod)
     return static_cast<::mp_limb_t>((dlimb_t(op) * op) % mod);
 }
 
+inline ::mp_limb_t static_mulm_impl_1(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t mod)
+{
+    return static_cast<::mp_limb_t>((dlimb_t(op1) * op2) % mod);
+}
+
 #endif
 
 // 1-limb optimization via dlimb.
@@ -4468,9 +5059,10 @@ inline integer<SSize> &sqrm(integer<SSize> &rop, const integer<SSize> &op, const
 
     // NOTE: use temp storage to avoid issues with overlapping
     // arguments.
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS detail::mpz_raii tmp;
     mpz_mul(&tmp.m_mpz, op.get_mpz_view(), op.get_mpz_view());
-    mpz_tdiv_r(&rop._get_union().g_dy(), &tmp.m_mpz, mod.get_mpz_view());
+    mb.escape([&]() { mpz_tdiv_r(&rop._get_union().g_dy(), &tmp.m_mpz, mod.get_mpz_view()); });
 
     return rop;
 }
@@ -4869,1080 +5461,1319 @@ inline integer<SSize> &tdiv_q(integer<SSize> &q, const integer<SSize> &n, const
     return q;
 }
 
+// Divisibility test.
+template <std::size_t SSize>
+inline bool divisible_p(const integer<SSize> &n, const integer<SSize> &d)
+{
+    // NOTE: following GMP, n is divisible by zero only if n is zero.
+    return mpz_divisible_p(n.get_mpz_view(), d.get_mpz_view()) != 0;
+}
+
 namespace detail
 {
 
-// mpn implementation.
-// NOTE: the Gcd flag specifies whether the divisor op2 is a strictly positive quantity.
-template <bool Gcd, std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                 const std::integral_constant<int, 0> &)
+// Compute -n**-1 modulo 2**GMP_NUMB_BITS for an odd limb n.
+inline ::mp_limb_t mont_neg_inverse(::mp_limb_t n)
 {
-    assert(!Gcd || sign2 == 1);
-    if (asize1 == 0) {
-        // Special casing if the numerator is zero (the mpn functions do not work with zero operands).
-        q._mp_size = 0;
-        return;
+    assert((n & 1u) != 0u);
+
+    // NOTE: Newton iteration. An odd n is its own inverse modulo 2**3,
+    // and each iteration doubles the number of correct low bits.
+    ::mp_limb_t inv = n;
+    for (unsigned nb = 3; nb < unsigned(GMP_NUMB_BITS); nb *= 2u) {
+        inv = static_cast<::mp_limb_t>(inv * static_cast<::mp_limb_t>(::mp_limb_t(2) - n * inv));
     }
-#if defined(MPPP_GMP_HAVE_MPN_DIVEXACT_1)
-    if (asize2 == 1) {
-        // Optimisation in case the dividend has only 1 limb.
-        // NOTE: overlapping arguments are fine here.
-        mpn_divexact_1(q.m_limbs.data(), op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
-        // Complete the quotient: compute size and sign.
-        q._mp_size = asize1 - asize2 + 1;
-        while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
-            --q._mp_size;
-        }
-        if (sign1 != (Gcd ? 1 : sign2)) {
-            q._mp_size = -q._mp_size;
-        }
-        return;
-    }
-#else
-    // Avoid compiler warnings for unused parameters.
-    ignore(sign1, sign2, asize2);
-#endif
-    // General implementation (via the mpz function).
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    const auto v1 = op1.get_mpz_view();
-    const auto v2 = op2.get_mpz_view();
-    mpz_divexact(&tmp.m_mpz, &v1, &v2);
-    // Copy over from the tmp struct into q.
-    q._mp_size = tmp.m_mpz._mp_size;
-    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + (q._mp_size >= 0 ? q._mp_size : -q._mp_size), q.m_limbs.data());
+
+    return static_cast<::mp_limb_t>(::mp_limb_t(0) - inv);
 }
 
-// 1-limb optimisation.
-template <bool Gcd, std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t, mpz_size_t, int sign1, int sign2, const std::integral_constant<int, 1> &)
+#if defined(MPPP_HAVE_DLIMB_T)
+
+static_assert(sizeof(dlimb_t) == 2u * sizeof(::mp_limb_t), "Invalid size for the double-limb type.");
+
+// Reciprocal of a normalised limb d (i.e., a limb with the most significant bit set):
+// floor((B**2 - 1) / d) - B, with B = 2**GMP_NUMB_BITS.
+inline ::mp_limb_t invert_limb(::mp_limb_t d)
 {
-    assert(!Gcd || sign2 == 1);
-    const ::mp_limb_t n = op1.m_limbs[0] & GMP_NUMB_MASK, d = op2.m_limbs[0] & GMP_NUMB_MASK, q_ = n / d;
-    // Write q.
-    q._mp_size = sign1 * (Gcd ? 1 : sign2) * (n >= d);
-    q.m_limbs[0] = q_;
+    assert((d >> (GMP_NUMB_BITS - 1)) == 1u);
+
+    // NOTE: B**2 - 1 - B * d == (B - 1 - d) * B + (B - 1).
+    return static_cast<::mp_limb_t>(((dlimb_t(static_cast<::mp_limb_t>(~d)) << GMP_NUMB_BITS) + GMP_NUMB_MAX) / d);
 }
 
-// 2-limbs optimisation.
-template <bool Gcd, std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                 const std::integral_constant<int, 2> &)
+// Division of (u1, u0) by the normalised limb d, given the reciprocal v = invert_limb(d).
+// The quotient is returned, the remainder is written into r. Requires u1 < d.
+// NOTE: this is algorithm 4 in Moller and Granlund, "Improved division by invariant integers".
+inline ::mp_limb_t div_2by1_preinv(::mp_limb_t &r, ::mp_limb_t u1, ::mp_limb_t u0, ::mp_limb_t d, ::mp_limb_t v)
 {
-    assert(!Gcd || sign2 == 1);
-    if (asize1 < 2 && asize2 < 2) {
-        // 1-limb optimisation.
-        const ::mp_limb_t n = op1.m_limbs[0], d = op2.m_limbs[0], q_ = n / d;
-        q._mp_size = sign1 * (Gcd ? 1 : sign2) * (n >= d);
-        q.m_limbs[0] = q_;
-        q.m_limbs[1] = 0u;
-        return;
+    assert(u1 < d);
+
+    // NOTE: this cannot overflow, as u1 * (B + v) + u0 < B**2.
+    const auto p = dlimb_t(v) * u1 + ((dlimb_t(u1) << GMP_NUMB_BITS) + u0);
+    auto q = static_cast<::mp_limb_t>(static_cast<::mp_limb_t>(p >> GMP_NUMB_BITS) + 1u);
+    const auto p_lo = static_cast<::mp_limb_t>(p);
+
+    r = static_cast<::mp_limb_t>(u0 - q * d);
+    // NOTE: this condition is unpredictable, use a mask
+    // instead of a branch.
+    const auto mask = static_cast<::mp_limb_t>(::mp_limb_t(0) - ::mp_limb_t(r > p_lo));
+    q = static_cast<::mp_limb_t>(q + mask);
+    r = static_cast<::mp_limb_t>(r + (mask & d));
+    if (mppp_unlikely(r >= d)) {
+        ++q;
+        r -= d;
     }
-    // General case.
-    // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
-    ::mp_limb_t q1, q2;
-    dlimb_tdiv_q(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2);
-    q._mp_size = sign1 * (Gcd ? 1 : sign2) * size_from_lohi(q1, q2);
-    q.m_limbs[0] = q1;
-    q.m_limbs[1] = q2;
+
+    return q;
 }
 
-template <std::size_t SSize>
-inline void static_divexact(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
+// Division of (u2, u1, u0) by the normalised 2-limb value (d1, d0), given the
+// reciprocal v = floor((B**3 - 1) / (d1, d0)) - B. The quotient is returned, the
+// remainder is written into (r1, r0). Requires (u2, u1) < (d1, d0).
+// NOTE: this is algorithm 5 in Moller and Granlund, "Improved division by invariant integers".
+inline ::mp_limb_t div_3by2_preinv(::mp_limb_t &r1, ::mp_limb_t &r0, ::mp_limb_t u2, ::mp_limb_t u1, ::mp_limb_t u0,
+                                   ::mp_limb_t d1, ::mp_limb_t d0, ::mp_limb_t v)
 {
-    const auto s1(op1._mp_size), s2(op2._mp_size);
-    const mpz_size_t asize1 = std::abs(s1), asize2 = std::abs(s2);
-    const int sign1 = integral_sign(s1), sign2 = integral_sign(s2);
-    // NOTE: op2 divides exactly op1, so either op1 is zero or the absolute size
-    // of op1 must not be smaller than op2's.
-    assert(asize1 == 0 || asize2 <= asize1);
-    // NOTE: use integer_static_div_algo for the algorithm selection.
-    static_divexact_impl<false>(q, op1, op2, asize1, asize2, sign1, sign2,
-                                integer_static_div_algo<static_int<SSize>>{});
-    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
-        // If we used the mpn functions, zero the unused limbs on top (if necessary).
-        // NOTE: as usual, potential of mpn use on optimised size.
-        q.zero_unused_limbs();
+    const auto d = (dlimb_t(d1) << GMP_NUMB_BITS) + d0;
+    const auto p = dlimb_t(v) * u2 + ((dlimb_t(u2) << GMP_NUMB_BITS) + u1);
+    auto q = static_cast<::mp_limb_t>(p >> GMP_NUMB_BITS);
+    const auto p_lo = static_cast<::mp_limb_t>(p);
+
+    // NOTE: the computation of the tentative remainder is done modulo B**2,
+    // which is guaranteed by the static assertion on the size of dlimb_t.
+    const auto t1 = static_cast<::mp_limb_t>(u1 - q * d1);
+    auto r = ((dlimb_t(t1) << GMP_NUMB_BITS) + u0) - dlimb_t(d0) * q - d;
+    ++q;
+
+    if (static_cast<::mp_limb_t>(r >> GMP_NUMB_BITS) >= p_lo) {
+        --q;
+        r += d;
     }
+    if (mppp_unlikely(r >= d)) {
+        ++q;
+        r -= d;
+    }
+
+    r1 = static_cast<::mp_limb_t>(r >> GMP_NUMB_BITS);
+    r0 = static_cast<::mp_limb_t>(r);
+
+    return q;
 }
+
+#endif
+
 } // namespace detail
 
-// Exact division (ternary version).
+// Precomputed divisor.
+// NOTE: if the divisor has 1 or 2 limbs and fits in the static storage,
+// the reciprocal of the normalised divisor is computed once at construction time
+// and divisions of static dividends are then performed via multiplications
+// (2-by-1 divisions for 1-limb divisors, 3-by-2 divisions for 2-limb divisors).
+// In all other cases, the usual division functions are invoked.
 template <std::size_t SSize>
-inline integer<SSize> &divexact(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
+class integer_divisor
 {
-    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sr) {
-            rop.set_zero();
+public:
+    // Constructor from divisor.
+    explicit integer_divisor(const integer<SSize> &d) : m_d(d)
+    {
+        if (mppp_unlikely(m_d.sgn() == 0)) {
+            throw zero_division_error("Cannot construct an integer divisor from zero");
         }
-        static_divexact(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
-        // Division can never fail.
-        return rop;
+
+#if defined(MPPP_HAVE_DLIMB_T)
+        const auto asize = m_d.size();
+        if (asize > 2u || asize > SSize) {
+            return;
+        }
+
+        m_nlimbs = asize;
+        m_sign = m_d.sgn();
+
+        const ::mp_limb_t *ptr
+            = m_d.is_static() ? m_d._get_union().g_st().m_limbs.data() : m_d._get_union().g_dy()._mp_d;
+        const auto hi = ptr[asize - 1u];
+
+        // Normalise the divisor.
+        m_shift = static_cast<unsigned>(unsigned(GMP_NUMB_BITS) - detail::limb_size_nbits(hi));
+        if (asize == 1u) {
+            m_dn[0] = static_cast<::mp_limb_t>(hi << m_shift);
+            m_inv = detail::invert_limb(m_dn[0]);
+
+            // Setup the constants for the divisibility test of 1-limb dividends:
+            // n is divisible by d = d_odd * 2**tz iff the low tz bits of n are zero and
+            // (n >> tz) * d_odd**-1 mod B <= (B - 1) / d_odd.
+            m_tz = static_cast<unsigned>(mpn_scan1(ptr, 0));
+            const auto d_odd = static_cast<::mp_limb_t>(hi >> m_tz);
+            m_odd_inv = static_cast<::mp_limb_t>(::mp_limb_t(0) - detail::mont_neg_inverse(d_odd));
+            m_odd_lim = static_cast<::mp_limb_t>(GMP_NUMB_MAX / d_odd);
+        } else {
+            m_dn[1] = m_shift ? static_cast<::mp_limb_t>((hi << m_shift) | (ptr[0] >> (GMP_NUMB_BITS - m_shift))) : hi;
+            m_dn[0] = static_cast<::mp_limb_t>(ptr[0] << m_shift);
+
+            // Compute the 3/2 reciprocal via mpz, this is done only once.
+            detail::mpz_raii tmp;
+            const detail::mpz_struct_t dn_view{2, 2, m_dn.data()};
+            mpz_set_ui(&tmp.m_mpz, 1u);
+            mpz_mul_2exp(&tmp.m_mpz, &tmp.m_mpz, static_cast<::mp_bitcnt_t>(3u * unsigned(GMP_NUMB_BITS)));
+            mpz_sub_ui(&tmp.m_mpz, &tmp.m_mpz, 1u);
+            mpz_tdiv_q(&tmp.m_mpz, &tmp.m_mpz, &dn_view);
+            // NOTE: the quotient is in the [B, 2 * B) range: the reciprocal is its low limb.
+            assert(tmp.m_mpz._mp_size == 2 && tmp.m_mpz._mp_d[1] == 1u);
+            m_inv = tmp.m_mpz._mp_d[0];
+        }
+#endif
     }
-    if (sr) {
-        rop._get_union().promote();
+
+    // Getter for the divisor.
+    MPPP_NODISCARD const integer<SSize> &get_divisor() const
+    {
+        return m_d;
     }
-    mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
-    return rop;
-}
 
-// Exact division (binary version).
-template <std::size_t SSize>
-inline integer<SSize> divexact(const integer<SSize> &n, const integer<SSize> &d)
-{
-    integer<SSize> retval;
-    divexact(retval, n, d);
-    return retval;
-}
+    // Truncated division with remainder.
+    void tdiv_qr(integer<SSize> &q, integer<SSize> &r, const integer<SSize> &n) const
+    {
+        if (mppp_unlikely(&q == &r)) {
+            throw std::invalid_argument("When performing a division with remainder, the quotient 'q' and the "
+                                        "remainder 'r' must be distinct objects");
+        }
 
-namespace detail
-{
+        if (!use_static(n)) {
+            mppp::tdiv_qr(q, r, n, m_d);
+            return;
+        }
 
-template <std::size_t SSize>
-inline void static_divexact_gcd(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
-{
-    const auto s1(op1._mp_size);
-    const mpz_size_t asize1 = std::abs(s1), asize2 = op2._mp_size;
-    const int sign1 = integral_sign(s1);
-    // NOTE: op2 divides exactly op1, so either op1 is zero or the absolute size
-    // of op1 must not be smaller than op2's.
-    assert(asize1 == 0 || asize2 <= asize1);
-    assert(asize2 > 0);
-    // NOTE: use integer_static_div_algo for the algorithm selection.
-    static_divexact_impl<true>(q, op1, op2, asize1, asize2, sign1, 1, integer_static_div_algo<static_int<SSize>>{});
-    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
-        // If we used the mpn functions, zero the unused limbs on top (if necessary).
-        // NOTE: as usual, potential of mpn use on optimised size.
-        q.zero_unused_limbs();
+        const auto asize = n.size();
+        const auto sign = n.sgn();
+        if (asize <= 1u && m_nlimbs == 1u) {
+            // NOTE: the most common case, handle it without
+            // going through the temporary buffers.
+            ::mp_limb_t r_ = 0;
+            const auto q_ = div_1(r_, asize == 0u ? ::mp_limb_t(0) : n._get_union().g_st().m_limbs[0]);
+            write_static_1(r, r_, sign);
+            write_static_1(q, q_, sign * m_sign);
+            return;
+        }
+        if (SSize >= 2u && asize == 2u) {
+            // NOTE: 2-limb dividends are also handled without loops.
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<::mp_limb_t, 2> q_limbs, r_limbs;
+            div_2(q_limbs.data(), r_limbs.data(), n._get_union().g_st().m_limbs.data());
+            write_static_2(r, r_limbs.data(), sign);
+            write_static_2(q, q_limbs.data(), sign * m_sign);
+            return;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize> q_limbs;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, 2> r_limbs;
+        static_div(q_limbs.data(), r_limbs.data(), n._get_union().g_st().m_limbs.data(), asize);
+
+        write_static(r, r_limbs.data(), m_nlimbs, sign);
+        write_static(q, q_limbs.data(), asize, sign * m_sign);
     }
-}
-} // namespace detail
+    // Truncated division without remainder.
+    integer<SSize> &tdiv_q(integer<SSize> &q, const integer<SSize> &n) const
+    {
+        if (!use_static(n)) {
+            return mppp::tdiv_q(q, n, m_d);
+        }
 
-// Exact division with positive divisor (ternary version).
-template <std::size_t SSize>
-inline integer<SSize> &divexact_gcd(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
-{
-    assert(d.sgn() > 0);
-    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sr) {
+        const auto asize = n.size();
+        const auto sign = n.sgn();
+        if (asize <= 1u && m_nlimbs == 1u) {
+            ::mp_limb_t r_ = 0;
+            const auto q_ = div_1(r_, asize == 0u ? ::mp_limb_t(0) : n._get_union().g_st().m_limbs[0]);
+            return write_static_1(q, q_, sign * m_sign);
+        }
+        if (SSize >= 2u && asize == 2u) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<::mp_limb_t, 2> q_limbs, r_limbs;
+            div_2(q_limbs.data(), r_limbs.data(), n._get_union().g_st().m_limbs.data());
+            return write_static_2(q, q_limbs.data(), sign * m_sign);
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize> q_limbs;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, 2> r_limbs;
+        static_div(q_limbs.data(), r_limbs.data(), n._get_union().g_st().m_limbs.data(), asize);
+
+        return write_static(q, q_limbs.data(), asize, sign * m_sign);
+    }
+    // Divisibility test.
+    MPPP_NODISCARD bool divisible_p(const integer<SSize> &n) const
+    {
+        if (m_nlimbs == 0u || !n.is_static()) {
+            return mppp::divisible_p(n, m_d);
+        }
+
+        const auto asize = n.size();
+        const ::mp_limb_t *ptr = n._get_union().g_st().m_limbs.data();
+        if (asize == 0u) {
+            return true;
+        }
+        if (asize == 1u && m_nlimbs == 1u) {
+            // Test via multiplication by the inverse of the odd part of the divisor.
+            const auto l = ptr[0];
+            if ((l & static_cast<::mp_limb_t>((::mp_limb_t(1) << m_tz) - 1u)) != 0u) {
+                return false;
+            }
+            return static_cast<::mp_limb_t>((l >> m_tz) * m_odd_inv) <= m_odd_lim;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize> q_limbs;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, 2> r_limbs;
+        static_div(q_limbs.data(), r_limbs.data(), ptr, asize);
+
+        return r_limbs[0] == 0u && (m_nlimbs == 1u || r_limbs[1] == 0u);
+    }
+
+private:
+    // Check if the division of n can use the precomputed reciprocal.
+    bool use_static(const integer<SSize> &n) const
+    {
+        return m_nlimbs != 0u && n.is_static();
+    }
+    // Divide the absolute value of the static dividend with asize limbs at np by the
+    // absolute value of the divisor. asize limbs of quotient will be written into qp, and m_nlimbs
+    // limbs of remainder into rp.
+    void static_div(::mp_limb_t *qp, ::mp_limb_t *rp, const ::mp_limb_t *np, std::size_t asize) const
+    {
+#if defined(MPPP_HAVE_DLIMB_T)
+        // The i-th limb of the normalised dividend, computed on the fly.
+        // NOTE: the double shift on the right avoids undefined behaviour when m_shift is zero.
+        const auto shift = m_shift;
+        auto norm_limb = [np, shift](std::size_t i) {
+            const auto hi = i < 1u ? ::mp_limb_t(0) : static_cast<::mp_limb_t>(np[i - 1u] >> 1);
+            return static_cast<::mp_limb_t>((np[i] << shift) | (hi >> (GMP_NUMB_BITS - 1u - shift)));
+        };
+        // The top limb of the normalised dividend (i.e., the bits shifted out of np[asize - 1]).
+        const auto top = asize == 0u ? ::mp_limb_t(0)
+                                     : static_cast<::mp_limb_t>((np[asize - 1u] >> 1) >> (GMP_NUMB_BITS - 1u - shift));
+
+        if (m_nlimbs == 1u) {
+            // NOTE: top < 2**m_shift <= m_dn[0].
+            auto r = top;
+            for (auto i = asize; i > 0u; --i) {
+                qp[i - 1u] = detail::div_2by1_preinv(r, r, norm_limb(i - 1u), m_dn[0], m_inv);
+            }
+            rp[0] = r >> shift;
+        } else {
+            if (asize < 2u) {
+                // The divisor is larger than the dividend.
+                std::fill(qp, qp + asize, ::mp_limb_t(0));
+                rp[0] = asize == 0u ? 0u : np[0];
+                rp[1] = 0u;
+                return;
+            }
+
+            // NOTE: as above, (top, u[asize - 1]) < (m_dn[1], m_dn[0]), because
+            // top < 2**m_shift and m_dn[1] >= B / 2.
+            auto r1 = top, r0 = norm_limb(asize - 1u);
+            for (auto i = asize - 1u; i > 0u; --i) {
+                qp[i - 1u] = detail::div_3by2_preinv(r1, r0, r1, r0, norm_limb(i - 1u), m_dn[1], m_dn[0], m_inv);
+            }
+            qp[asize - 1u] = 0u;
+            rp[0] = static_cast<::mp_limb_t>((r0 >> shift) | ((r1 << 1) << (GMP_NUMB_BITS - 1u - shift)));
+            rp[1] = r1 >> shift;
+        }
+#else
+        // LCOV_EXCL_START
+        // NOTE: this is never called if we don't have the double-limb type,
+        // as m_nlimbs will be zero.
+        (void)qp;
+        (void)rp;
+        (void)np;
+        (void)asize;
+        assert(false);
+        // LCOV_EXCL_STOP
+#endif
+    }
+    // Divide the 1-limb value l by the 1-limb divisor. The quotient
+    // is returned, the remainder is written into r.
+    ::mp_limb_t div_1(::mp_limb_t &r, ::mp_limb_t l) const
+    {
+#if defined(MPPP_HAVE_DLIMB_T)
+        // Normalise l into (u1, u0) and perform a single 2-by-1 division.
+        // NOTE: u1 < 2**m_shift <= m_dn[0]. The double shift on the right
+        // avoids undefined behaviour when m_shift is zero.
+        const auto u1 = static_cast<::mp_limb_t>((l >> 1) >> (GMP_NUMB_BITS - 1u - m_shift));
+        const auto u0 = static_cast<::mp_limb_t>(l << m_shift);
+        const auto q = detail::div_2by1_preinv(r, u1, u0, m_dn[0], m_inv);
+        r >>= m_shift;
+        return q;
+#else
+        // LCOV_EXCL_START
+        // NOTE: this is never called if we don't have the double-limb type,
+        // as m_nlimbs will be zero.
+        (void)r;
+        (void)l;
+        assert(false);
+        return 0;
+        // LCOV_EXCL_STOP
+#endif
+    }
+    // Divide the 2-limb value at np by the divisor. 2 limbs of
+    // quotient are written into qp, and 2 limbs of remainder into rp.
+    void div_2(::mp_limb_t *qp, ::mp_limb_t *rp, const ::mp_limb_t *np) const
+    {
+#if defined(MPPP_HAVE_DLIMB_T)
+        // The normalised dividend (u2, u1, u0).
+        // NOTE: the double shifts on the right avoid undefined behaviour when m_shift is zero.
+        const auto shift = m_shift;
+        const auto u2 = static_cast<::mp_limb_t>((np[1] >> 1) >> (GMP_NUMB_BITS - 1u - shift));
+        const auto u1 = static_cast<::mp_limb_t>((np[1] << shift) | ((np[0] >> 1) >> (GMP_NUMB_BITS - 1u - shift)));
+        const auto u0 = static_cast<::mp_limb_t>(np[0] << shift);
+
+        if (m_nlimbs == 1u) {
+            // NOTE: u2 < 2**m_shift <= m_dn[0].
+            ::mp_limb_t r = 0;
+            qp[1] = detail::div_2by1_preinv(r, u2, u1, m_dn[0], m_inv);
+            qp[0] = detail::div_2by1_preinv(r, r, u0, m_dn[0], m_inv);
+            rp[0] = r >> shift;
+            rp[1] = 0u;
+        } else {
+            // NOTE: (u2, u1) < (m_dn[1], m_dn[0]), because
+            // u2 < 2**m_shift and m_dn[1] >= B / 2.
+            ::mp_limb_t r1 = 0, r0 = 0;
+            qp[0] = detail::div_3by2_preinv(r1, r0, u2, u1, u0, m_dn[1], m_dn[0], m_inv);
+            qp[1] = 0u;
+            rp[0] = static_cast<::mp_limb_t>((r0 >> shift) | ((r1 << 1) << (GMP_NUMB_BITS - 1u - shift)));
+            rp[1] = r1 >> shift;
+        }
+#else
+        // LCOV_EXCL_START
+        (void)qp;
+        (void)rp;
+        (void)np;
+        assert(false);
+        // LCOV_EXCL_STOP
+#endif
+    }
+    // Write the limb l into rop, with the given sign.
+    static integer<SSize> &write_static_1(integer<SSize> &rop, ::mp_limb_t l, int sign)
+    {
+        if (!rop.is_static()) {
             rop.set_zero();
         }
-        static_divexact_gcd(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
-        // Division can never fail.
+        auto &st = rop._get_union().g_st();
+        st._mp_size = sign * static_cast<int>(l != 0u);
+        st.m_limbs[0] = l;
+        // NOTE: if l is zero, the first limb is already zeroed.
+        st.zero_upper_limbs(1);
         return rop;
     }
-    if (sr) {
-        rop._get_union().promote();
+    // Write the 2 limbs at p into rop, with the given sign. Requires SSize >= 2.
+    static integer<SSize> &write_static_2(integer<SSize> &rop, const ::mp_limb_t *p, int sign)
+    {
+        assert(SSize >= 2u);
+
+        if (!rop.is_static()) {
+            rop.set_zero();
+        }
+        auto &st = rop._get_union().g_st();
+        st._mp_size = sign * detail::size_from_lohi(p[0], p[1]);
+        auto *const limbs = st.m_limbs.data();
+        limbs[0] = p[0];
+        limbs[1] = p[1];
+        st.zero_upper_limbs(2);
+        return rop;
     }
-    // NOTE: there's no public mpz_divexact_gcd() function in GMP, just use
-    // mpz_divexact() directly.
-    mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
-    return rop;
+    // Write the size limbs at p into rop, with the given sign.
+    static integer<SSize> &write_static(integer<SSize> &rop, const ::mp_limb_t *p, std::size_t size, int sign)
+    {
+        while (size != 0u && p[size - 1u] == 0u) {
+            --size;
+        }
+        if (!rop.is_static()) {
+            rop.set_zero();
+        }
+        auto &st = rop._get_union().g_st();
+        detail::copy_limbs(p, p + size, st.m_limbs.data());
+        st._mp_size = static_cast<detail::mpz_size_t>(sign * static_cast<detail::mpz_size_t>(size));
+        st.zero_unused_limbs();
+        return rop;
+    }
+
+    integer<SSize> m_d;
+    // NOTE: m_nlimbs is zero if the precomputed
+    // division is not available for this divisor.
+    std::size_t m_nlimbs = 0;
+    int m_sign = 0;
+    unsigned m_shift = 0, m_tz = 0;
+    // The normalised divisor and its reciprocal.
+    std::array<::mp_limb_t, 2> m_dn{};
+    ::mp_limb_t m_inv = 0;
+    // Constants for the divisibility test.
+    ::mp_limb_t m_odd_inv = 0, m_odd_lim = 0;
+};
+
+// Truncated division with remainder by a precomputed divisor.
+template <std::size_t SSize>
+inline void tdiv_qr(integer<SSize> &q, integer<SSize> &r, const integer<SSize> &n, const integer_divisor<SSize> &d)
+{
+    d.tdiv_qr(q, r, n);
 }
 
-// Exact division with positive divisor (binary version).
+// Truncated division without remainder by a precomputed divisor.
 template <std::size_t SSize>
-inline integer<SSize> divexact_gcd(const integer<SSize> &n, const integer<SSize> &d)
+inline integer<SSize> &tdiv_q(integer<SSize> &q, const integer<SSize> &n, const integer_divisor<SSize> &d)
 {
-    integer<SSize> retval;
-    divexact_gcd(retval, n, d);
-    return retval;
+    return d.tdiv_q(q, n);
+}
+
+// Divisibility test with a precomputed divisor.
+template <std::size_t SSize>
+inline bool divisible_p(const integer<SSize> &n, const integer_divisor<SSize> &d)
+{
+    return d.divisible_p(n);
 }
 
 namespace detail
 {
 
-// mpn implementation.
+// Metaprogramming for selecting the algorithm used by integer_accumulator. The selection happens via
+// an std::integral_constant with 3 possible values:
+// - 0 (default case): the terms are accumulated into an integer via the usual arithmetic functions,
+// - 1: selected when there are no nail bits and the static size is 1. The product
+//   is computed on the limbs of the static operands without looking at their sizes,
+//   exploiting the fact that the unused limbs are guaranteed to be zero,
+// - 2: selected when there are no nail bits and the static size is greater than 1.
+// NOTE: for a static size of 2, computing the full 2x2 limbs product is slower
+// than looking at the sizes of the operands.
 template <std::size_t SSize>
-inline void static_tdiv_q_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
-{
-    static_assert(SSize > static_int<SSize>::opt_size, "Cannot use mpn functions for optimised static size.");
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        // If shift is zero, or the operand is zero, write n into rop and return.
-        rop = n;
-        return;
+using integer_accumulator_algo = std::integral_constant<int, GMP_NAIL_BITS ? 0 : (SSize == 1u ? 1 : 2)>;
+
+} // namespace detail
+
+// Accumulator for sums of integers and of products of integers.
+// NOTE: the accumulator stores the running sum as a two's complement value
+// with 2 * SSize + 1 limbs. The products of static operands fit in 2 * SSize limbs,
+// thus the extra limb provides room for at least 2**(GMP_NUMB_BITS - 1) terms before
+// the running sum can overflow. The terms are added to the running sum without
+// normalisation and without any branching on the sign, the size of the result or its storage class.
+// The carries between the limbs of the running sum are counted separately and
+// propagated only in finalize().
+// Terms involving dynamic operands (which are expected to be rare) are accumulated
+// separately into an integer, which is added to the running sum in finalize().
+template <std::size_t SSize>
+class integer_accumulator
+{
+    static constexpr std::size_t acc_size = 2u * SSize + 1u;
+
+public:
+    // Alias for the template parameter SSize.
+    static constexpr std::size_t ssize = SSize;
+    // Default constructor.
+    integer_accumulator() = default;
+
+    // Accumulate a product.
+    integer_accumulator &addmul(const integer<SSize> &a, const integer<SSize> &b)
+    {
+        addmul_impl(a, b, false, detail::integer_accumulator_algo<SSize>{});
+        return *this;
     }
-    // Finish setting up asize and sign.
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
+    // Accumulate the negated product.
+    integer_accumulator &submul(const integer<SSize> &a, const integer<SSize> &b)
+    {
+        addmul_impl(a, b, true, detail::integer_accumulator_algo<SSize>{});
+        return *this;
     }
-    // ls: number of entire limbs shifted.
-    // rs: effective shift that will be passed to the mpn function.
-    const auto ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
-    if (ls >= static_cast<std::size_t>(asize)) {
-        // If we shift by a number of entire limbs equal to or larger than the asize,
-        // the result will be zero.
-        rop._mp_size = 0;
-        return;
+    // Accumulate a value.
+    integer_accumulator &add(const integer<SSize> &n)
+    {
+        add_impl(n, false, detail::integer_accumulator_algo<SSize>{});
+        return *this;
     }
-    // The maximum new asize will be the old asize minus ls.
-    const mpz_size_t new_asize = asize - static_cast<mpz_size_t>(ls);
-    if (rs) {
-        // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
-        // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() <= n.m_limbs.data() + ls.
-        mpn_rshift(rop.m_limbs.data(), n.m_limbs.data() + ls, static_cast<::mp_size_t>(new_asize), unsigned(rs));
-    } else {
-        // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
-        // NOTE: std::move requires that the destination iterator is not within the input range.
-        // Here we are sure that ls > 0 because we don't have a remainder, and the zero shift case
-        // was already handled above.
-        assert(ls);
-        std::move(n.m_limbs.begin() + ls, n.m_limbs.begin() + asize, rop.m_limbs.begin());
+    // Accumulate the negated value.
+    integer_accumulator &sub(const integer<SSize> &n)
+    {
+        add_impl(n, true, detail::integer_accumulator_algo<SSize>{});
+        return *this;
     }
-    // Set the size. We need to check if the top limb is zero.
-    rop._mp_size = sign * (new_asize - ((rop.m_limbs[static_cast<std::size_t>(new_asize - 1)] & GMP_NUMB_MASK) == 0u));
-}
 
-// 1-limb optimisation.
-inline void static_tdiv_q_2exp(static_int<1> &rop, const static_int<1> &n, ::mp_bitcnt_t s)
-{
-    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
-    if (s == 0u || l == 0u) {
-        rop = n;
-        return;
+    // Compute the accumulated value.
+    integer<SSize> finalize() const
+    {
+        auto retval = finalize_impl(detail::integer_accumulator_algo<SSize>{});
+        if (m_spill.sgn() != 0) {
+            mppp::add(retval, retval, m_spill);
+            // NOTE: m_spill is usually in dynamic storage, make sure
+            // that the return value is static if possible.
+            retval.demote();
+        }
+        return retval;
     }
-    if (s >= unsigned(GMP_NUMB_BITS)) {
-        // We are shifting by the limb's bit size or greater, the result will be zero.
-        rop._mp_size = 0;
-        rop.m_limbs[0] = 0u;
-        return;
+    // Reset to zero.
+    void reset()
+    {
+        m_acc.fill(0u);
+        m_cy.fill(0u);
+        m_count = 0;
+        m_spill.set_zero();
     }
-    // Compute the result.
-    const auto res = l >> s;
-    // Size is the original one or zero.
-    rop._mp_size = static_cast<int>(res != 0u) * n._mp_size;
-    rop.m_limbs[0] = res;
-}
 
-// 2-limb optimisation.
-inline void static_tdiv_q_2exp(static_int<2> &rop, const static_int<2> &n, ::mp_bitcnt_t s)
-{
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        rop = n;
-        return;
-    }
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
+private:
+    // Implementations for the case in which the terms are accumulated into m_spill.
+    void addmul_impl(const integer<SSize> &a, const integer<SSize> &b, bool neg, const std::integral_constant<int, 0> &)
+    {
+        if (neg) {
+            mppp::submul(m_spill, a, b);
+        } else {
+            mppp::addmul(m_spill, a, b);
+        }
     }
-    // If shift is too large, zero the result and return.
-    static_assert(unsigned(GMP_NUMB_BITS) <= nl_max<unsigned>() / 2u, "Overflow error.");
-    if (s >= 2u * unsigned(GMP_NUMB_BITS)) {
-        rop._mp_size = 0;
-        rop.m_limbs[0u] = 0u;
-        rop.m_limbs[1u] = 0u;
-        return;
+    void add_impl(const integer<SSize> &n, bool neg, const std::integral_constant<int, 0> &)
+    {
+        if (neg) {
+            mppp::sub(m_spill, m_spill, n);
+        } else {
+            mppp::add(m_spill, m_spill, n);
+        }
     }
-    if (s >= unsigned(GMP_NUMB_BITS)) {
-        // NOTE: here the effective shift < GMP_NUMB_BITS, otherwise it would have been caught
-        // in the check above.
-        const auto lo = (n.m_limbs[1u] & GMP_NUMB_MASK) >> (s - unsigned(GMP_NUMB_BITS));
-        // The size could be zero or +-1, depending
-        // on the new content of m_limbs[0] and the previous
-        // sign of _mp_size.
-        rop._mp_size = static_cast<int>(lo != 0u) * sign;
-        rop.m_limbs[0u] = lo;
-        rop.m_limbs[1u] = 0u;
-        return;
+    integer<SSize> finalize_impl(const std::integral_constant<int, 0> &) const
+    {
+        return integer<SSize>{};
     }
-    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
-    // This represents the bits in hi that will be shifted down into lo.
-    // We move them up so we can add tmp to the new lo to account for them.
-    // NOTE: mask the final result to avoid spillover into potential nail bits.
-    const auto tmp = ((n.m_limbs[1u] & GMP_NUMB_MASK) << (unsigned(GMP_NUMB_BITS) - s)) & GMP_NUMB_MASK;
-    rop.m_limbs[0u] = ((n.m_limbs[0u] & GMP_NUMB_MASK) >> s) + tmp;
-    rop.m_limbs[1u] = (n.m_limbs[1u] & GMP_NUMB_MASK) >> s;
-    // The effective shift was less than 1 entire limb. The new asize must be the old one,
-    // or one less than that.
-    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-    rop._mp_size = sign * (asize - ((rop.m_limbs[std::size_t(asize - 1)] & GMP_NUMB_MASK) == 0u));
-}
-} // namespace detail
 
-// Ternary right shift.
-template <std::size_t SSize>
-inline integer<SSize> &tdiv_q_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
-{
-    const bool sn = n.is_static(), sr = rop.is_static();
-    if (mppp_likely(sn)) {
-        if (!sr) {
-            rop.set_zero();
+    // Add to the running sum the 2 * SSize limbs at p, negated if neg is true.
+    void acc_add(const ::mp_limb_t *p, bool neg)
+    {
+        // NOTE: the two's complement negation of p is ~p + 1,
+        // with ~p computed as p ^ mask. The + 1 and the carries
+        // are counted in m_cy, so that each limb of the running sum
+        // is updated independently of the others.
+        const auto mask = -static_cast<::mp_limb_t>(neg);
+        m_cy[0] += mask & 1u;
+        for (std::size_t i = 0; i < acc_size - 1u; ++i) {
+            m_cy[i + 1u] += detail::limb_add_carry(m_acc[i], p[i] ^ mask, 0, &m_acc[i]);
+        }
+        // NOTE: the sign extension of the term in the top limb is the mask.
+        // The carry out of the top limb is discarded.
+        m_acc[acc_size - 1u] += mask;
+    }
+    // Make sure there is room for another term in the running sum.
+    void acc_check()
+    {
+        if (mppp_unlikely(m_count == max_count)) {
+            // LCOV_EXCL_START
+            // NOTE: move the running sum into m_spill, and start again from zero.
+            mppp::add(m_spill, m_spill, finalize_impl(detail::integer_accumulator_algo<SSize>{}));
+            m_acc.fill(0u);
+            m_cy.fill(0u);
+            m_count = 0;
+            // LCOV_EXCL_STOP
         }
-        static_tdiv_q_2exp(rop._get_union().g_st(), n._get_union().g_st(), s);
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
+        ++m_count;
     }
-    mpz_tdiv_q_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
-    return rop;
-}
-
-namespace detail
-{
+    template <int Algo>
+    void addmul_impl(const integer<SSize> &a, const integer<SSize> &b, bool neg,
+                     const std::integral_constant<int, Algo> &)
+    {
+        if (mppp_unlikely(!a.is_static() || !b.is_static())) {
+            addmul_impl(a, b, neg, std::integral_constant<int, 0>{});
+            return;
+        }
+        acc_check();
 
-// mpn implementation.
-template <std::size_t SSize>
-inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2)
-{
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
-    }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
-    }
-    // The two sizes are equal, compare the absolute values.
-    const auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
-    if (asize) {
-        // NOTE: reduce the value of the comparison to the [-1, 1] range, so that
-        // if we need to negate it below we ensure not to run into overflows.
-        const int cmp_abs
-            = integral_sign(mpn_cmp(n1.m_limbs.data(), n2.m_limbs.data(), static_cast<::mp_size_t>(asize)));
-        // If the values are non-negative, return the comparison of the absolute values, otherwise invert it.
-        return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
+        const auto &st1 = a._get_union().g_st(), &st2 = b._get_union().g_st();
+        std::array<::mp_limb_t, 2u * SSize> prod{};
+        static_prod(prod.data(), st1, st2, std::integral_constant<int, Algo>{});
+        // NOTE: the product is negative if the operands have different signs. If one operand
+        // is zero, the product is zero and its sign does not matter.
+        acc_add(prod.data(), ((st1._mp_size ^ st2._mp_size) < 0) != neg);
     }
-    // Both operands are zero.
-    // NOTE: we do this special casing in order to avoid calling mpn_cmp() on zero operands. It seems to
-    // work, but the official GMP docs say one is not supposed to call mpn functions on zero operands.
-    return 0;
-}
+    template <int Algo>
+    void add_impl(const integer<SSize> &n, bool neg, const std::integral_constant<int, Algo> &)
+    {
+        if (mppp_unlikely(!n.is_static())) {
+            add_impl(n, neg, std::integral_constant<int, 0>{});
+            return;
+        }
+        acc_check();
 
-// 1-limb optimisation.
-inline int static_cmp(const static_int<1> &n1, const static_int<1> &n2)
-{
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
+        const auto &st = n._get_union().g_st();
+        std::array<::mp_limb_t, 2u * SSize> p{};
+        detail::fixed_limbs<0, SSize>::load(p.data(), st.m_limbs.data(), static_cast<std::size_t>(st.abs_size()));
+        acc_add(p.data(), (st._mp_size < 0) != neg);
     }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
+    // Products of static operands into the 2 * SSize zeroed limbs at p.
+    static void static_prod(::mp_limb_t *p, const detail::static_int<SSize> &st1, const detail::static_int<SSize> &st2,
+                            const std::integral_constant<int, 1> &)
+    {
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+        p[0] = detail::dlimb_mul(st1.m_limbs[0], st2.m_limbs[0], p + 1);
+#else
+        p[1] = mpn_mul_1(p, st1.m_limbs.data(), 1, st2.m_limbs[0]);
+#endif
     }
-    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-    int cmp_abs = (n1.m_limbs[0u] & GMP_NUMB_MASK) > (n2.m_limbs[0u] & GMP_NUMB_MASK);
-    if (cmp_abs == 0) {
-        cmp_abs = -static_cast<int>((n1.m_limbs[0u] & GMP_NUMB_MASK) < (n2.m_limbs[0u] & GMP_NUMB_MASK));
+    static void static_prod(::mp_limb_t *p, const detail::static_int<SSize> &st1, const detail::static_int<SSize> &st2,
+                            const std::integral_constant<int, 2> &)
+    {
+        auto asize1 = static_cast<std::size_t>(st1.abs_size()), asize2 = static_cast<std::size_t>(st2.abs_size());
+        if (asize1 == 0u || asize2 == 0u) {
+            return;
+        }
+        auto data1 = st1.m_limbs.data(), data2 = st2.m_limbs.data();
+        if (asize1 < asize2) {
+            std::swap(data1, data2);
+            std::swap(asize1, asize2);
+        }
+        static_prod_sized(p, data1, asize1, data2, asize2,
+                          std::integral_constant<bool, detail::integer_unrolled_max_size >= SSize
+                                                           && detail::integer_have_dlimb_mul::value>{});
     }
-    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
-}
-
-// 2-limb optimisation.
-inline int static_cmp(const static_int<2> &n1, const static_int<2> &n2)
-{
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
+    static void static_prod_sized(::mp_limb_t *p, const ::mp_limb_t *data1, std::size_t asize1,
+                                  const ::mp_limb_t *data2, std::size_t asize2, const std::false_type &)
+    {
+        mpn_mul(p, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
     }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+    static void static_prod_sized(::mp_limb_t *p, const ::mp_limb_t *data1, std::size_t asize1,
+                                  const ::mp_limb_t *data2, std::size_t asize2, const std::true_type &)
+    {
+        detail::fixed_mul<2u * SSize - 1u>(p, data1, asize1, data2, asize2);
     }
-    auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
-    while (asize != 0) {
-        --asize;
-        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) > (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
-            return (n1._mp_size >= 0) ? 1 : -1;
+#endif
+    template <int Algo>
+    integer<SSize> finalize_impl(const std::integral_constant<int, Algo> &) const
+    {
+        // Propagate the carries.
+        std::array<::mp_limb_t, acc_size> acc; // NOLINT(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        detail::fixed_limbs<0, acc_size>::add(acc.data(), m_acc.data(), m_cy.data(), 0);
+        const bool neg = (acc[acc_size - 1u] >> (GMP_NUMB_BITS - 1)) != 0u;
+        if (neg) {
+            ::mp_limb_t cy = 1;
+            for (auto &l : acc) {
+                cy = detail::limb_add_carry(~l, 0, cy, &l);
+            }
         }
-        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) < (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
-            return (n1._mp_size >= 0) ? -1 : 1;
+        integer<SSize> retval{acc.data(), detail::fixed_limbs_size(acc.data(), acc_size)};
+        if (neg) {
+            retval.neg();
         }
+        return retval;
     }
-    return 0;
-}
-} // namespace detail
 
-// Comparison function.
+    // NOTE: flush the running sum into m_spill before it can overflow.
+    static constexpr ::mp_limb_t max_count = GMP_NUMB_MAX >> 1;
+
+    std::array<::mp_limb_t, acc_size> m_acc{};
+    // NOTE: m_cy[i] counts the carries into the limb at index i of m_acc.
+    std::array<::mp_limb_t, acc_size> m_cy{};
+    ::mp_limb_t m_count = 0;
+    integer<SSize> m_spill;
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
 template <std::size_t SSize>
-inline int cmp(const integer<SSize> &op1, const integer<SSize> &op2)
+constexpr std::size_t integer_accumulator<SSize>::acc_size;
+
+template <std::size_t SSize>
+constexpr std::size_t integer_accumulator<SSize>::ssize;
+
+template <std::size_t SSize>
+constexpr ::mp_limb_t integer_accumulator<SSize>::max_count;
+
+#endif
+
+// Accumulate a product.
+template <std::size_t SSize>
+inline integer_accumulator<SSize> &addmul(integer_accumulator<SSize> &acc, const integer<SSize> &a,
+                                          const integer<SSize> &b)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
-    if (mppp_likely(s1 && s2)) {
-        return static_cmp(op1._get_union().g_st(), op2._get_union().g_st());
-    }
-    return mpz_cmp(op1.get_mpz_view(), op2.get_mpz_view());
+    return acc.addmul(a, b);
 }
 
-// Sign function.
+// Accumulate the negated product.
 template <std::size_t SSize>
-inline int sgn(const integer<SSize> &n)
+inline integer_accumulator<SSize> &submul(integer_accumulator<SSize> &acc, const integer<SSize> &a,
+                                          const integer<SSize> &b)
 {
-    return n.sgn();
+    return acc.submul(a, b);
 }
 
-// Test if integer is odd.
+// Accumulate a value.
 template <std::size_t SSize>
-inline bool odd_p(const integer<SSize> &n)
+inline integer_accumulator<SSize> &add(integer_accumulator<SSize> &acc, const integer<SSize> &n)
 {
-    return n.odd_p();
+    return acc.add(n);
 }
 
-// Test if integer is even.
+// Accumulate the negated value.
 template <std::size_t SSize>
-inline bool even_p(const integer<SSize> &n)
+inline integer_accumulator<SSize> &sub(integer_accumulator<SSize> &acc, const integer<SSize> &n)
 {
-    return n.even_p();
+    return acc.sub(n);
 }
 
-// Test if an integer is zero.
-template <std::size_t SSize>
-inline bool is_zero(const integer<SSize> &n)
+namespace detail
 {
-    return n.is_zero();
-}
 
-// Test if an integer is equal to one.
-template <std::size_t SSize>
-inline bool is_one(const integer<SSize> &n)
+// mpn implementation.
+// NOTE: the Gcd flag specifies whether the divisor op2 is a strictly positive quantity.
+template <bool Gcd, std::size_t SSize>
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                 const std::integral_constant<int, 0> &)
 {
-    return n.is_one();
+    assert(!Gcd || sign2 == 1);
+    if (asize1 == 0) {
+        // Special casing if the numerator is zero (the mpn functions do not work with zero operands).
+        q._mp_size = 0;
+        return;
+    }
+#if defined(MPPP_GMP_HAVE_MPN_DIVEXACT_1)
+    if (asize2 == 1) {
+        // Optimisation in case the dividend has only 1 limb.
+        // NOTE: overlapping arguments are fine here.
+        mpn_divexact_1(q.m_limbs.data(), op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
+        // Complete the quotient: compute size and sign.
+        q._mp_size = asize1 - asize2 + 1;
+        while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
+            --q._mp_size;
+        }
+        if (sign1 != (Gcd ? 1 : sign2)) {
+            q._mp_size = -q._mp_size;
+        }
+        return;
+    }
+#else
+    // Avoid compiler warnings for unused parameters.
+    ignore(sign1, sign2, asize2);
+#endif
+    // General implementation (via the mpz function).
+    const mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    const auto v1 = op1.get_mpz_view();
+    const auto v2 = op2.get_mpz_view();
+    mpz_divexact(&tmp.m_mpz, &v1, &v2);
+    // Copy over from the tmp struct into q.
+    q._mp_size = tmp.m_mpz._mp_size;
+    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + (q._mp_size >= 0 ? q._mp_size : -q._mp_size), q.m_limbs.data());
 }
 
-// Test if an integer is equal to minus one.
-template <std::size_t SSize>
-inline bool is_negative_one(const integer<SSize> &n)
+// 1-limb optimisation.
+template <bool Gcd, std::size_t SSize>
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t, mpz_size_t, int sign1, int sign2, const std::integral_constant<int, 1> &)
 {
-    return n.is_negative_one();
+    assert(!Gcd || sign2 == 1);
+    const ::mp_limb_t n = op1.m_limbs[0] & GMP_NUMB_MASK, d = op2.m_limbs[0] & GMP_NUMB_MASK, q_ = n / d;
+    // Write q.
+    q._mp_size = sign1 * (Gcd ? 1 : sign2) * (n >= d);
+    q.m_limbs[0] = q_;
 }
 
-namespace detail
+// 2-limbs optimisation.
+template <bool Gcd, std::size_t SSize>
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                 const std::integral_constant<int, 2> &)
 {
+    assert(!Gcd || sign2 == 1);
+    if (asize1 < 2 && asize2 < 2) {
+        // 1-limb optimisation.
+        const ::mp_limb_t n = op1.m_limbs[0], d = op2.m_limbs[0], q_ = n / d;
+        q._mp_size = sign1 * (Gcd ? 1 : sign2) * (n >= d);
+        q.m_limbs[0] = q_;
+        q.m_limbs[1] = 0u;
+        return;
+    }
+    // General case.
+    // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+    ::mp_limb_t q1, q2;
+    dlimb_tdiv_q(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2);
+    q._mp_size = sign1 * (Gcd ? 1 : sign2) * size_from_lohi(q1, q2);
+    q.m_limbs[0] = q1;
+    q.m_limbs[1] = q2;
+}
 
-// 1-limb implementation.
-inline bool static_not_impl(static_int<1> &rop, const static_int<1> &op, mpz_size_t, int sign)
+template <std::size_t SSize>
+inline void static_divexact(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
-    const ::mp_limb_t l = op.m_limbs[0] & GMP_NUMB_MASK;
-    if (sign >= 0) {
-        if (mppp_unlikely(l == GMP_NUMB_MAX)) {
-            // NOTting would overflow the limb.
-            return false;
-        }
-        rop._mp_size = -1;
-        rop.m_limbs[0] = l + 1u;
-        return true;
+    const auto s1(op1._mp_size), s2(op2._mp_size);
+    const mpz_size_t asize1 = std::abs(s1), asize2 = std::abs(s2);
+    const int sign1 = integral_sign(s1), sign2 = integral_sign(s2);
+    // NOTE: op2 divides exactly op1, so either op1 is zero or the absolute size
+    // of op1 must not be smaller than op2's.
+    assert(asize1 == 0 || asize2 <= asize1);
+    // NOTE: use integer_static_div_algo for the algorithm selection.
+    static_divexact_impl<false>(q, op1, op2, asize1, asize2, sign1, sign2,
+                                integer_static_div_algo<static_int<SSize>>{});
+    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
+        // If we used the mpn functions, zero the unused limbs on top (if necessary).
+        // NOTE: as usual, potential of mpn use on optimised size.
+        q.zero_unused_limbs();
     }
-    // Size can be zero or 1.
-    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-    rop._mp_size = l != 1u;
-    rop.m_limbs[0] = l - 1u;
-    return true;
 }
+} // namespace detail
 
-// 2-limbs implementation.
-inline bool static_not_impl(static_int<2> &rop, const static_int<2> &op, mpz_size_t, int sign)
+// Exact division (ternary version).
+template <std::size_t SSize>
+inline integer<SSize> &divexact(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
 {
-    const ::mp_limb_t lo = op.m_limbs[0] & GMP_NUMB_MASK, hi = op.m_limbs[1] & GMP_NUMB_MASK;
-    if (sign >= 0) {
-        if (mppp_unlikely(lo == GMP_NUMB_MAX && hi == GMP_NUMB_MAX)) {
-            // The static has the maximum possible value, NOT will overflow it.
-            return false;
+    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
         }
-        const ::mp_limb_t new_lo = (lo + 1u) & GMP_NUMB_MASK, new_hi = hi + unsigned(lo == GMP_NUMB_MAX);
-        // asize can be -1 or -2, never zero.
-        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-        rop._mp_size = -1 - (new_hi != 0u);
-        rop.m_limbs[0] = new_lo;
-        rop.m_limbs[1] = new_hi;
-        return true;
+        static_divexact(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
+        // Division can never fail.
+        return rop;
     }
-    const ::mp_limb_t new_lo = (lo - 1u) & GMP_NUMB_MASK, new_hi = hi - unsigned(lo == 0u);
-    // Size could be 0, 1 or 2.
-    rop._mp_size = size_from_lohi(new_lo, new_hi);
-    rop.m_limbs[0] = new_lo;
-    rop.m_limbs[1] = new_hi;
-    return true;
+    if (sr) {
+        rop._get_union().promote();
+    }
+    mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
+    return rop;
 }
 
-// n-limbs implementation.
+// Exact division (binary version).
 template <std::size_t SSize>
-inline bool static_not_impl(static_int<SSize> &rop, const static_int<SSize> &op, mpz_size_t asize, int sign)
+inline integer<SSize> divexact(const integer<SSize> &n, const integer<SSize> &d)
 {
-    auto data = op.m_limbs.data();
-    if (sign >= 0) {
-        if (mppp_unlikely(static_cast<mpz_size_t>(SSize) == asize && std::all_of(data, data + asize, [](::mp_limb_t l) {
-                              return (l & GMP_NUMB_MASK) == GMP_NUMB_MAX;
-                          }))) {
-            // If the current size is the max possible static size, and the value
-            // is the max possible value, then we will overflow.
-            return false;
-        }
-        if (sign) {
-            const auto cy
-                = static_cast<mpz_size_t>(mpn_add_1(rop.m_limbs.data(), data, static_cast<::mp_size_t>(asize), 1));
-            if (cy) {
-                // If there's a carry, we'll need to write into the upper limb.
-                assert(asize < static_cast<mpz_size_t>(SSize));
-                rop.m_limbs[static_cast<std::size_t>(asize)] = 1;
-            }
-            rop._mp_size = -asize - cy;
-        } else {
-            // Special case zero, as mpn functions don't want zero operands.
-            rop.m_limbs[0] = 1;
-            rop._mp_size = -1;
-        }
-        return true;
-    }
-    mpn_sub_1(rop.m_limbs.data(), data, static_cast<::mp_size_t>(asize), 1);
-    // Size will be the original asize minus possibly 1, if the original topmost limb
-    // has become zero.
-    rop._mp_size
-        = asize - static_cast<mpz_size_t>((rop.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK) == 0u);
-    return true;
+    integer<SSize> retval;
+    divexact(retval, n, d);
+    return retval;
 }
 
+namespace detail
+{
+
 template <std::size_t SSize>
-inline bool static_not(static_int<SSize> &rop, const static_int<SSize> &op)
+inline void static_divexact_gcd(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
-    mpz_size_t asize = op._mp_size;
-    int sign = asize != 0;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
+    const auto s1(op1._mp_size);
+    const mpz_size_t asize1 = std::abs(s1), asize2 = op2._mp_size;
+    const int sign1 = integral_sign(s1);
+    // NOTE: op2 divides exactly op1, so either op1 is zero or the absolute size
+    // of op1 must not be smaller than op2's.
+    assert(asize1 == 0 || asize2 <= asize1);
+    assert(asize2 > 0);
+    // NOTE: use integer_static_div_algo for the algorithm selection.
+    static_divexact_impl<true>(q, op1, op2, asize1, asize2, sign1, 1, integer_static_div_algo<static_int<SSize>>{});
+    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
+        // If we used the mpn functions, zero the unused limbs on top (if necessary).
+        // NOTE: as usual, potential of mpn use on optimised size.
+        q.zero_unused_limbs();
     }
-    // NOTE: currently the implementation dispatches only on the static size: there's no need to
-    // zero upper limbs as mpn functions are never used in case of optimised size.
-    return static_not_impl(rop, op, asize, sign);
 }
 } // namespace detail
 
-// Bitwise NOT.
+// Exact division with positive divisor (ternary version).
 template <std::size_t SSize>
-inline integer<SSize> &bitwise_not(integer<SSize> &rop, const integer<SSize> &op)
+inline integer<SSize> &divexact_gcd(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
 {
-    bool sr = rop.is_static();
-    const bool s = op.is_static();
-    if (mppp_likely(s)) {
+    assert(d.sgn() > 0);
+    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
+    if (mppp_likely(s1 && s2)) {
         if (!sr) {
             rop.set_zero();
-            sr = true;
-        }
-        if (mppp_likely(static_not(rop._get_union().g_st(), op._get_union().g_st()))) {
-            return rop;
         }
+        static_divexact_gcd(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
+        // Division can never fail.
+        return rop;
     }
     if (sr) {
         rop._get_union().promote();
     }
-    mpz_com(&rop._get_union().g_dy(), op.get_mpz_view());
+    // NOTE: there's no public mpz_divexact_gcd() function in GMP, just use
+    // mpz_divexact() directly.
+    mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
     return rop;
 }
 
+// Exact division with positive divisor (binary version).
+template <std::size_t SSize>
+inline integer<SSize> divexact_gcd(const integer<SSize> &n, const integer<SSize> &d)
+{
+    integer<SSize> retval;
+    divexact_gcd(retval, n, d);
+    return retval;
+}
+
 namespace detail
 {
 
-// 1-limb implementation.
-inline void static_ior_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
-                            mpz_size_t, int sign1, int sign2)
+// mpn implementation.
+template <std::size_t SSize>
+inline void static_tdiv_q_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
 {
-    const ::mp_limb_t l1 = op1.m_limbs[0] & GMP_NUMB_MASK, l2 = op2.m_limbs[0] & GMP_NUMB_MASK;
-    if (sign1 >= 0 && sign2 >= 0) {
-        // The easy case: both are nonnegative.
-        // NOTE: no need to mask, as we masked l1 and l2 already, and OR
-        // won't turn on any upper bit.
-        ::mp_limb_t ret = l1 | l2;
-        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-        rop._mp_size = ret != 0u;
-        rop.m_limbs[0] = ret;
+    static_assert(SSize > static_int<SSize>::opt_size, "Cannot use mpn functions for optimised static size.");
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        // If shift is zero, or the operand is zero, write n into rop and return.
+        rop = n;
         return;
     }
-    // NOTE: my understanding is the following:
-    // - the size of the operands is considered to be their real bit size, rounded up to GMP_NUMB_BITS,
-    //   plus a phantom sign bit on top due to the fake two's complement representation for negative numbers.
-    //   We never need to represent explicitly this fake bit;
-    // - the size of the result will be the max operand size.
-    // For instance, for ORing 25 and -5 we start like this:
-    // (0) ... 0 1 1 0 0 1 | <-- 25 (5 "real bits", plus a fake bit on top at index GMP_NUMB_BITS)
-    // (0) ... 0 0 0 1 0 1   <-- 5
-    // We do the two's complement of 5 to produce -5:
-    // (0) ... 0 1 1 0 0 1 | <-- 25
-    // (1) ... 1 1 1 0 1 1   <-- -5 (in two's complement)
-    // ---------------
-    // (1) ... 1 1 1 0 1 1
-    // The result has the sign bit set, thus it's a negative number. We take again
-    // the two's complement to get its absolute value:
-    // (0) ... 0 0 0 1 0 1
-    // So the final result is -5.
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOTE: at least 1 of the operands is strictly negative, so the result
-    // has to be negative as well (because of ORing the sign bits).
-    rop._mp_size = -1;
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u:
-            // op1 negative, op2 nonnegative.
-            // NOTE: here we know that the values we are 2sc-ing are not zero
-            // (they are strictly negative). The complement will turn on
-            // the nail bits, which will remain turned on after the ORing.
-            // The final 2sc will set them back to zero, so no need to mask.
-            rop.m_limbs[0] = ~((~l1 + 1u) | l2) + 1u;
-            break;
-        case 2u:
-            // op1 nonnegative, op2 negative.
-            rop.m_limbs[0] = ~((~l2 + 1u) | l1) + 1u;
-            break;
-        case 3u:
-            // Both negative.
-            rop.m_limbs[0] = ~((~l1 + 1u) | (~l2 + 1u)) + 1u;
-            break;
+    // Finish setting up asize and sign.
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
+    }
+    // ls: number of entire limbs shifted.
+    // rs: effective shift that will be passed to the mpn function.
+    const auto ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
+    if (ls >= static_cast<std::size_t>(asize)) {
+        // If we shift by a number of entire limbs equal to or larger than the asize,
+        // the result will be zero.
+        rop._mp_size = 0;
+        return;
+    }
+    // The maximum new asize will be the old asize minus ls.
+    const mpz_size_t new_asize = asize - static_cast<mpz_size_t>(ls);
+    if (rs) {
+        // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
+        // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() <= n.m_limbs.data() + ls.
+        mpn_rshift(rop.m_limbs.data(), n.m_limbs.data() + ls, static_cast<::mp_size_t>(new_asize), unsigned(rs));
+    } else {
+        // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
+        // NOTE: std::move requires that the destination iterator is not within the input range.
+        // Here we are sure that ls > 0 because we don't have a remainder, and the zero shift case
+        // was already handled above.
+        assert(ls);
+        std::move(n.m_limbs.begin() + ls, n.m_limbs.begin() + asize, rop.m_limbs.begin());
     }
+    // Set the size. We need to check if the top limb is zero.
+    rop._mp_size = sign * (new_asize - ((rop.m_limbs[static_cast<std::size_t>(new_asize - 1)] & GMP_NUMB_MASK) == 0u));
 }
 
-// Small helper to compute the two's complement of a nonzero 2-limbs static integer.
-inline void twosc(std::array<::mp_limb_t, 2> &arr, ::mp_limb_t lo, ::mp_limb_t hi)
+// 1-limb optimisation.
+inline void static_tdiv_q_2exp(static_int<1> &rop, const static_int<1> &n, ::mp_bitcnt_t s)
 {
-    assert(hi != 0u || lo != 0u);
-    arr[0] = (~lo + 1u) & GMP_NUMB_MASK;
-    arr[1] = (~hi + unsigned(lo == 0u)) & GMP_NUMB_MASK;
+    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
+    if (s == 0u || l == 0u) {
+        rop = n;
+        return;
+    }
+    if (s >= unsigned(GMP_NUMB_BITS)) {
+        // We are shifting by the limb's bit size or greater, the result will be zero.
+        rop._mp_size = 0;
+        rop.m_limbs[0] = 0u;
+        return;
+    }
+    // Compute the result.
+    const auto res = l >> s;
+    // Size is the original one or zero.
+    rop._mp_size = static_cast<int>(res != 0u) * n._mp_size;
+    rop.m_limbs[0] = res;
 }
 
-// 2-limbs implementation.
-inline void static_ior_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
-                            mpz_size_t, int sign1, int sign2)
+// 2-limb optimisation.
+inline void static_tdiv_q_2exp(static_int<2> &rop, const static_int<2> &n, ::mp_bitcnt_t s)
 {
-    const ::mp_limb_t lo1 = (op1.m_limbs[0] & GMP_NUMB_MASK), hi1 = (op1.m_limbs[1] & GMP_NUMB_MASK),
-                      lo2 = (op2.m_limbs[0] & GMP_NUMB_MASK), hi2 = (op2.m_limbs[1] & GMP_NUMB_MASK);
-    if (sign1 >= 0 && sign2 >= 0) {
-        // The easy case: both are nonnegative.
-        const ::mp_limb_t lo = lo1 | lo2, hi = hi1 | hi2;
-        rop._mp_size = size_from_lohi(lo, hi);
-        rop.m_limbs[0] = lo;
-        rop.m_limbs[1] = hi;
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        rop = n;
         return;
     }
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
-    std::array<::mp_limb_t, 2> tmp1, tmp2;
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u:
-            // op1 negative, op2 nonnegative.
-            twosc(tmp1, lo1, hi1);
-            // NOTE: here lo2, hi2 and the 2 limbs in tmp1 have already
-            // been masked for nail bits.
-            twosc(rop.m_limbs, tmp1[0] | lo2, tmp1[1] | hi2);
-            break;
-        case 2u:
-            // op1 nonnegative, op2 negative.
-            twosc(tmp2, lo2, hi2);
-            twosc(rop.m_limbs, tmp2[0] | lo1, tmp2[1] | hi1);
-            break;
-        case 3u:
-            // Both negative.
-            twosc(tmp1, lo1, hi1);
-            twosc(tmp2, lo2, hi2);
-            twosc(rop.m_limbs, tmp1[0] | tmp2[0], tmp1[1] | tmp2[1]);
-            break;
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
     }
-    // Size is -1 or -2: we could have 1-limb operands, and even with
-    // 2-limbs operands, the final 2sc - in case of negative values - could
-    // zero out the upper limb.
+    // If shift is too large, zero the result and return.
+    static_assert(unsigned(GMP_NUMB_BITS) <= nl_max<unsigned>() / 2u, "Overflow error.");
+    if (s >= 2u * unsigned(GMP_NUMB_BITS)) {
+        rop._mp_size = 0;
+        rop.m_limbs[0u] = 0u;
+        rop.m_limbs[1u] = 0u;
+        return;
+    }
+    if (s >= unsigned(GMP_NUMB_BITS)) {
+        // NOTE: here the effective shift < GMP_NUMB_BITS, otherwise it would have been caught
+        // in the check above.
+        const auto lo = (n.m_limbs[1u] & GMP_NUMB_MASK) >> (s - unsigned(GMP_NUMB_BITS));
+        // The size could be zero or +-1, depending
+        // on the new content of m_limbs[0] and the previous
+        // sign of _mp_size.
+        rop._mp_size = static_cast<int>(lo != 0u) * sign;
+        rop.m_limbs[0u] = lo;
+        rop.m_limbs[1u] = 0u;
+        return;
+    }
+    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
+    // This represents the bits in hi that will be shifted down into lo.
+    // We move them up so we can add tmp to the new lo to account for them.
+    // NOTE: mask the final result to avoid spillover into potential nail bits.
+    const auto tmp = ((n.m_limbs[1u] & GMP_NUMB_MASK) << (unsigned(GMP_NUMB_BITS) - s)) & GMP_NUMB_MASK;
+    rop.m_limbs[0u] = ((n.m_limbs[0u] & GMP_NUMB_MASK) >> s) + tmp;
+    rop.m_limbs[1u] = (n.m_limbs[1u] & GMP_NUMB_MASK) >> s;
+    // The effective shift was less than 1 entire limb. The new asize must be the old one,
+    // or one less than that.
     // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-    rop._mp_size = -2 + (rop.m_limbs[1] == 0u);
+    rop._mp_size = sign * (asize - ((rop.m_limbs[std::size_t(asize - 1)] & GMP_NUMB_MASK) == 0u));
 }
+} // namespace detail
 
-// Compute the two's complement of an n-limbs nonzero integer. The new size of
-// the integer will be returned.
-inline mpz_size_t twosc(::mp_limb_t *rop, const ::mp_limb_t *sp, mpz_size_t n)
+// Ternary right shift.
+template <std::size_t SSize>
+inline integer<SSize> &tdiv_q_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
 {
-    // Make sure the size is nonzero, and the value is nonzero as well.
-    assert(n > 0);
-    assert(std::any_of(sp, sp + n, [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) != 0u; }));
-    // Create a copy so we can compare to the original value later.
-    auto size = n;
-    // Flip the bits.
-    mpn_com(rop, sp, static_cast<::mp_size_t>(size));
-    // Compute the new size.
-    if ((rop[size - 1] & GMP_NUMB_MASK) == 0u) {
-        --size;
-        for (; size != 0 && (rop[size - 1] & GMP_NUMB_MASK) == 0u; --size) {
+    const bool sn = n.is_static(), sr = rop.is_static();
+    if (mppp_likely(sn)) {
+        if (!sr) {
+            rop.set_zero();
         }
+        static_tdiv_q_2exp(rop._get_union().g_st(), n._get_union().g_st(), s);
+        return rop;
     }
-    // Add 1.
-    if (size != 0) {
-        // If rop is nonzero, use the mpn_add_1() primitive, storing the carry
-        // and updating the size if necessary.
-        if (mpn_add_1(rop, rop, size, 1) != 0u) {
-            // This needs to hold as sp is nonzero: 2sc can never
-            // overflow the highest limb.
-            assert(size < n);
-            rop[size++] = 1;
-        }
-    } else {
-        // If rop is zero, we cannot use mpn functions, just set the value directly.
-        rop[0] = 1;
-        size = 1;
+    if (sr) {
+        rop._get_union().promote();
     }
-    // NOTE: the new size cannot be greater than n, the only way for this
-    // to be possible would be if the input was zero (but this is prevented)
-    // by the top assert).
-    assert(size <= n);
-    return size;
+    mpz_tdiv_q_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
+    return rop;
 }
 
+namespace detail
+{
+
 // mpn implementation.
 template <std::size_t SSize>
-inline void static_ior_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2)
+inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2)
 {
-    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
-    // Handle zeroes.
-    if (!sign1) {
-        // NOTE: manual copy rather than assignment, to avoid
-        // a few branches.
-        rop._mp_size = op2._mp_size;
-        copy_limbs(data2, data2 + asize2, rop.m_limbs.data());
-        return;
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
     }
-    if (!sign2) {
-        rop._mp_size = op1._mp_size;
-        copy_limbs(data1, data1 + asize1, rop.m_limbs.data());
-        return;
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
     }
-    // Make sure data1/asize1 refer to the largest operand.
-    if (asize1 < asize2) {
-        std::swap(data1, data2);
-        std::swap(asize1, asize2);
-        std::swap(sign1, sign2);
+    // The two sizes are equal, compare the absolute values.
+    const auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
+    if (asize) {
+        // NOTE: reduce the value of the comparison to the [-1, 1] range, so that
+        // if we need to negate it below we ensure not to run into overflows.
+        const int cmp_abs
+            = integral_sign(mpn_cmp(n1.m_limbs.data(), n2.m_limbs.data(), static_cast<::mp_size_t>(asize)));
+        // If the values are non-negative, return the comparison of the absolute values, otherwise invert it.
+        return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
     }
-    if (sign1 > 0 && sign2 > 0) {
-        // The easy case: both are nonnegative.
-        // Set the size.
-        rop._mp_size = asize1;
-        // Compute the ior.
-        mpn_ior_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
-        // Copy extra limbs from data1.
-        copy_limbs(data1 + asize2, data1 + asize1, rop.m_limbs.data() + asize2);
-        return;
+    // Both operands are zero.
+    // NOTE: we do this special casing in order to avoid calling mpn_cmp() on zero operands. It seems to
+    // work, but the official GMP docs say one is not supposed to call mpn functions on zero operands.
+    return 0;
+}
+
+// 1-limb optimisation.
+inline int static_cmp(const static_int<1> &n1, const static_int<1> &n2)
+{
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
     }
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
-    std::array<::mp_limb_t, SSize> tmp1, tmp2;
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u:
-            // op1 negative, op2 nonnegative.
-            twosc(tmp1.data(), data1, asize1);
-            // NOTE: in all 3 cases, the mpn_ior_n() is done with the minimum size among the operands
-            // (asize2). In this case, due to the twosc, the first most significant limbs in tmp1 might
-            // be zero, but according to the mpn docs this is not a problem.
-            mpn_ior_n(rop.m_limbs.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
-            // Copy over the remaining limbs from the largest operand.
-            copy_limbs(tmp1.data() + asize2, tmp1.data() + asize1, rop.m_limbs.data() + asize2);
-            // The final twosc. This will return the effective abs size, which we need to negate.
-            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize1);
-            break;
-        case 2u:
-            // op1 nonnegative, op2 negative.
-            twosc(tmp2.data(), data2, asize2);
-            // NOTE: after the twosc, the limbs in tmp2 from asize2 to asize1 should be set
-            // to all 1s. We don't need to actually do that: ORing op1 with these high all-1 limbs
-            // produces all-1 limbs in the result, and the final twosc will flip them back to zero.
-            mpn_ior_n(rop.m_limbs.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
-            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize2);
-            break;
-        case 3u:
-            twosc(tmp1.data(), data1, asize1);
-            twosc(tmp2.data(), data2, asize2);
-            mpn_ior_n(rop.m_limbs.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
-            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize2);
-            break;
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
+    }
+    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+    int cmp_abs = (n1.m_limbs[0u] & GMP_NUMB_MASK) > (n2.m_limbs[0u] & GMP_NUMB_MASK);
+    if (cmp_abs == 0) {
+        cmp_abs = -static_cast<int>((n1.m_limbs[0u] & GMP_NUMB_MASK) < (n2.m_limbs[0u] & GMP_NUMB_MASK));
     }
+    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
 }
 
-// The dispatching function for the static implementation.
-template <std::size_t SSize>
-inline void static_ior(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+// 2-limb optimisation.
+inline int static_cmp(const static_int<2> &n1, const static_int<2> &n2)
 {
-    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    int sign1 = asize1 != 0, sign2 = asize2 != 0;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
     }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-        sign2 = -1;
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
     }
-    // NOTE: currently the implementation dispatches only on the static size: there's no need to
-    // zero upper limbs as mpn functions are never used in case of optimised size.
-    static_ior_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
+    auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
+    while (asize != 0) {
+        --asize;
+        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) > (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
+            return (n1._mp_size >= 0) ? 1 : -1;
+        }
+        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) < (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
+            return (n1._mp_size >= 0) ? -1 : 1;
+        }
+    }
+    return 0;
 }
 } // namespace detail
 
-// Bitwise OR.
+// Comparison function.
 template <std::size_t SSize>
-inline integer<SSize> &bitwise_ior(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline int cmp(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
     if (mppp_likely(s1 && s2)) {
-        if (!sr) {
-            rop.set_zero();
-        }
-        static_ior(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
+        return static_cmp(op1._get_union().g_st(), op2._get_union().g_st());
     }
-    mpz_ior(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
+    return mpz_cmp(op1.get_mpz_view(), op2.get_mpz_view());
+}
+
+// Sign function.
+template <std::size_t SSize>
+inline int sgn(const integer<SSize> &n)
+{
+    return n.sgn();
+}
+
+// Test if integer is odd.
+template <std::size_t SSize>
+inline bool odd_p(const integer<SSize> &n)
+{
+    return n.odd_p();
+}
+
+// Test if integer is even.
+template <std::size_t SSize>
+inline bool even_p(const integer<SSize> &n)
+{
+    return n.even_p();
+}
+
+// Test if an integer is zero.
+template <std::size_t SSize>
+inline bool is_zero(const integer<SSize> &n)
+{
+    return n.is_zero();
+}
+
+// Test if an integer is equal to one.
+template <std::size_t SSize>
+inline bool is_one(const integer<SSize> &n)
+{
+    return n.is_one();
+}
+
+// Test if an integer is equal to minus one.
+template <std::size_t SSize>
+inline bool is_negative_one(const integer<SSize> &n)
+{
+    return n.is_negative_one();
 }
 
 namespace detail
 {
 
 // 1-limb implementation.
-inline bool static_and_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
-                            mpz_size_t, int sign1, int sign2)
+inline bool static_not_impl(static_int<1> &rop, const static_int<1> &op, mpz_size_t, int sign)
 {
-    const ::mp_limb_t l1 = op1.m_limbs[0] & GMP_NUMB_MASK, l2 = op2.m_limbs[0] & GMP_NUMB_MASK;
-    if (sign1 >= 0 && sign2 >= 0) {
-        // The easy case: both are nonnegative.
-        // NOTE: no need to mask, as we masked l1 and l2 already, and AND
-        // won't turn on any upper bit.
-        ::mp_limb_t ret = l1 & l2;
-        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-        rop._mp_size = ret != 0u;
-        rop.m_limbs[0] = ret;
-        return true;
-    }
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u: {
-            // op1 negative, op2 nonnegative.
-            // The result will be nonnegative, and it does not need to be masked:
-            // nail bits will be switched off by ANDing with l2.
-            const ::mp_limb_t ret = (~l1 + 1u) & l2;
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = ret != 0u;
-            rop.m_limbs[0] = ret;
-            return true;
-        }
-        case 2u: {
-            // op1 nonnegative, op2 negative.
-            // This is the symmetric of above.
-            const ::mp_limb_t ret = l1 & (~l2 + 1u);
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = ret != 0u;
-            rop.m_limbs[0] = ret;
-            return true;
-        }
-        case 3u: {
-            // Both negative. In this case, the result will be negative,
-            // unless the ANDing of the 2scs results in zero: in that
-            // case, we return failure as we need extra storage for the result.
-            ::mp_limb_t ret = (~l1 + 1u) & (~l2 + 1u);
-            // NOTE: need to mask here, as nail bits will have been flipped
-            // by the NOTing above.
-            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
-                return false;
-            }
-            // The NOT here will flip back the nail bits, no need to mask.
-            ret = ~ret + 1u;
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = -(ret != 0u);
-            rop.m_limbs[0] = ret;
-            return true;
+    const ::mp_limb_t l = op.m_limbs[0] & GMP_NUMB_MASK;
+    if (sign >= 0) {
+        if (mppp_unlikely(l == GMP_NUMB_MAX)) {
+            // NOTting would overflow the limb.
+            return false;
         }
+        rop._mp_size = -1;
+        rop.m_limbs[0] = l + 1u;
+        return true;
     }
-    // Keep the compiler happy.
-    // LCOV_EXCL_START
-    assert(false);
+    // Size can be zero or 1.
+    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+    rop._mp_size = l != 1u;
+    rop.m_limbs[0] = l - 1u;
     return true;
-    // LCOV_EXCL_STOP
 }
 
 // 2-limbs implementation.
-inline bool static_and_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
-                            mpz_size_t, int sign1, int sign2)
+inline bool static_not_impl(static_int<2> &rop, const static_int<2> &op, mpz_size_t, int sign)
 {
-    const ::mp_limb_t lo1 = (op1.m_limbs[0] & GMP_NUMB_MASK), hi1 = (op1.m_limbs[1] & GMP_NUMB_MASK),
-                      lo2 = (op2.m_limbs[0] & GMP_NUMB_MASK), hi2 = (op2.m_limbs[1] & GMP_NUMB_MASK);
-    if (sign1 >= 0 && sign2 >= 0) {
-        // The easy case: both are nonnegative.
-        const ::mp_limb_t lo = lo1 & lo2, hi = hi1 & hi2;
-        rop._mp_size = size_from_lohi(lo, hi);
-        rop.m_limbs[0] = lo;
-        rop.m_limbs[1] = hi;
+    const ::mp_limb_t lo = op.m_limbs[0] & GMP_NUMB_MASK, hi = op.m_limbs[1] & GMP_NUMB_MASK;
+    if (sign >= 0) {
+        if (mppp_unlikely(lo == GMP_NUMB_MAX && hi == GMP_NUMB_MAX)) {
+            // The static has the maximum possible value, NOT will overflow it.
+            return false;
+        }
+        const ::mp_limb_t new_lo = (lo + 1u) & GMP_NUMB_MASK, new_hi = hi + unsigned(lo == GMP_NUMB_MAX);
+        // asize can be -1 or -2, never zero.
+        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+        rop._mp_size = -1 - (new_hi != 0u);
+        rop.m_limbs[0] = new_lo;
+        rop.m_limbs[1] = new_hi;
         return true;
     }
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
-    std::array<::mp_limb_t, 2> tmp1, tmp2;
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u:
-            // op1 negative, op2 nonnegative.
-            twosc(tmp1, lo1, hi1);
-            // NOTE: here lo2, hi2 and the 2 limbs in tmp1 have already
-            // been masked for nail bits.
-            rop.m_limbs[0] = tmp1[0] & lo2;
-            rop.m_limbs[1] = tmp1[1] & hi2;
-            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
-        case 2u:
-            // op1 nonnegative, op2 negative.
-            twosc(tmp2, lo2, hi2);
-            rop.m_limbs[0] = tmp2[0] & lo1;
-            rop.m_limbs[1] = tmp2[1] & hi1;
-            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
-        case 3u: {
-            // Both negative.
-            twosc(tmp1, lo1, hi1);
-            twosc(tmp2, lo2, hi2);
-            const ::mp_limb_t new_lo = tmp1[0] & tmp2[0], new_hi = tmp1[1] & tmp2[1];
-            if (mppp_unlikely(!new_lo && !new_hi)) {
-                // When both operands are negative, we could end up in a situation
-                // where, after the 2scs, the ANDing returns zero. In this case,
-                // we need extra storage.
-                return false;
-            }
-            twosc(rop.m_limbs, new_lo, new_hi);
-            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
-        }
-    }
-    // LCOV_EXCL_START
-    assert(false);
+    const ::mp_limb_t new_lo = (lo - 1u) & GMP_NUMB_MASK, new_hi = hi - unsigned(lo == 0u);
+    // Size could be 0, 1 or 2.
+    rop._mp_size = size_from_lohi(new_lo, new_hi);
+    rop.m_limbs[0] = new_lo;
+    rop.m_limbs[1] = new_hi;
     return true;
-    // LCOV_EXCL_STOP
 }
 
-// Small helper to compute the abs size of a static int, knowing it must
-// be at most asize > 0.
+// n-limbs implementation.
 template <std::size_t SSize>
-inline mpz_size_t compute_static_int_asize(const static_int<SSize> &r, mpz_size_t asize)
+inline bool static_not_impl(static_int<SSize> &rop, const static_int<SSize> &op, mpz_size_t asize, int sign)
 {
-    assert(asize > 0);
-    if (!(r.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK)) {
-        --asize;
-        for (; asize && !(r.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK); --asize) {
+    auto data = op.m_limbs.data();
+    if (sign >= 0) {
+        if (mppp_unlikely(static_cast<mpz_size_t>(SSize) == asize && std::all_of(data, data + asize, [](::mp_limb_t l) {
+                              return (l & GMP_NUMB_MASK) == GMP_NUMB_MAX;
+                          }))) {
+            // If the current size is the max possible static size, and the value
+            // is the max possible value, then we will overflow.
+            return false;
         }
-    }
-    return asize;
-}
-
-// mpn implementation.
-template <std::size_t SSize>
-inline bool static_and_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2)
-{
-    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
-    // Handle zeroes.
-    if (!sign1 || !sign2) {
-        rop._mp_size = 0;
-        return true;
-    }
-    // Make sure data1/asize1 refer to the largest operand.
-    if (asize1 < asize2) {
-        std::swap(data1, data2);
-        std::swap(asize1, asize2);
-        std::swap(sign1, sign2);
-    }
-    if (sign1 > 0 && sign2 > 0) {
-        // The easy case: both are nonnegative.
-        // Compute the and.
-        mpn_and_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
-        // The asize will be at most asize2. Upper limbs could be zero due to the ANDing.
-        rop._mp_size = compute_static_int_asize(rop, asize2);
-        return true;
-    }
-    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
-    std::array<::mp_limb_t, SSize> tmp1, tmp2, tmpr;
-    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
-    switch (sign_mask) {
-        case 1u:
-            // op1 negative, op2 nonnegative.
-            twosc(tmp1.data(), data1, asize1);
-            // NOTE: in all 3 cases, the mpn_and_n() is done with the minimum size among the operands
-            // (asize2). In this case, due to the twosc, the first most significant limbs in tmp1 might
-            // be zero, but according to the mpn docs this is not a problem.
-            mpn_and_n(rop.m_limbs.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
-            // NOTE: size cannot be larger than asize2, as all the limbs above that limit from op1
-            // will be set to zero by the ANDing.
-            rop._mp_size = compute_static_int_asize(rop, asize2);
-            return true;
-        case 2u:
-            // op1 nonnegative, op2 negative.
-            twosc(tmp2.data(), data2, asize2);
-            // Do the AND.
-            mpn_and_n(rop.m_limbs.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
-            // Copy over the upper limbs of op1 to rop: the limbs in tmp2 from asize2 to asize1
-            // are (virtually) set to all 1s by the twosc, so ANDing with the corresponding limbs
-            // in op1 means simply copying op1 over.
-            copy_limbs(data1 + asize2, data1 + asize1, rop.m_limbs.data() + asize2);
-            // Compute the final size. It can be at most asize1.
-            rop._mp_size = compute_static_int_asize(rop, asize1);
-            return true;
-        case 3u:
-            twosc(tmp1.data(), data1, asize1);
-            twosc(tmp2.data(), data2, asize2);
-            // Write in temp storage, as we might overflow and we don't want to spoil
-            // rop in that case.
-            mpn_and_n(tmpr.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
-            // Copy over the upper limbs of op1 to rop (same as above). Non overlapping,
-            // as we are only using local storage.
-            copy_limbs_no(tmp1.data() + asize2, tmp1.data() + asize1, tmpr.data() + asize2);
-            // Check for zero.
-            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
-                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
-                return false;
+        if (sign) {
+            const auto cy
+                = static_cast<mpz_size_t>(mpn_add_1(rop.m_limbs.data(), data, static_cast<::mp_size_t>(asize), 1));
+            if (cy) {
+                // If there's a carry, we'll need to write into the upper limb.
+                assert(asize < static_cast<mpz_size_t>(SSize));
+                rop.m_limbs[static_cast<std::size_t>(asize)] = 1;
             }
-            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
-            return true;
+            rop._mp_size = -asize - cy;
+        } else {
+            // Special case zero, as mpn functions don't want zero operands.
+            rop.m_limbs[0] = 1;
+            rop._mp_size = -1;
+        }
+        return true;
     }
-    // LCOV_EXCL_START
-    assert(false);
+    mpn_sub_1(rop.m_limbs.data(), data, static_cast<::mp_size_t>(asize), 1);
+    // Size will be the original asize minus possibly 1, if the original topmost limb
+    // has become zero.
+    rop._mp_size
+        = asize - static_cast<mpz_size_t>((rop.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK) == 0u);
     return true;
-    // LCOV_EXCL_STOP
 }
 
 template <std::size_t SSize>
-inline bool static_and(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+inline bool static_not(static_int<SSize> &rop, const static_int<SSize> &op)
 {
-    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    int sign1 = asize1 != 0, sign2 = asize2 != 0;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
-    }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-        sign2 = -1;
+    mpz_size_t asize = op._mp_size;
+    int sign = asize != 0;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
     }
     // NOTE: currently the implementation dispatches only on the static size: there's no need to
     // zero upper limbs as mpn functions are never used in case of optimised size.
-    return static_and_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
+    return static_not_impl(rop, op, asize, sign);
 }
 } // namespace detail
 
-// Bitwise AND.
+// Bitwise NOT.
 template <std::size_t SSize>
-inline integer<SSize> &bitwise_and(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &bitwise_not(integer<SSize> &rop, const integer<SSize> &op)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
     bool sr = rop.is_static();
-    if (mppp_likely(s1 && s2)) {
+    const bool s = op.is_static();
+    if (mppp_likely(s)) {
         if (!sr) {
             rop.set_zero();
             sr = true;
         }
-        if (mppp_likely(static_and(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
+        if (mppp_likely(static_not(rop._get_union().g_st(), op._get_union().g_st()))) {
             return rop;
         }
     }
     if (sr) {
         rop._get_union().promote();
     }
-    mpz_and(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    mpz_com(&rop._get_union().g_dy(), op.get_mpz_view());
     return rop;
 }
 
@@ -5950,131 +6781,157 @@ namespace detail
 {
 
 // 1-limb implementation.
-inline bool static_xor_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
+inline void static_ior_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
                             mpz_size_t, int sign1, int sign2)
 {
     const ::mp_limb_t l1 = op1.m_limbs[0] & GMP_NUMB_MASK, l2 = op2.m_limbs[0] & GMP_NUMB_MASK;
     if (sign1 >= 0 && sign2 >= 0) {
         // The easy case: both are nonnegative.
-        // NOTE: no need to mask, as we masked l1 and l2 already, and XOR
+        // NOTE: no need to mask, as we masked l1 and l2 already, and OR
         // won't turn on any upper bit.
-        ::mp_limb_t ret = l1 ^ l2;
+        ::mp_limb_t ret = l1 | l2;
         // NOLINTNEXTLINE(readability-implicit-bool-conversion)
         rop._mp_size = ret != 0u;
         rop.m_limbs[0] = ret;
-        return false;
+        return;
     }
+    // NOTE: my understanding is the following:
+    // - the size of the operands is considered to be their real bit size, rounded up to GMP_NUMB_BITS,
+    //   plus a phantom sign bit on top due to the fake two's complement representation for negative numbers.
+    //   We never need to represent explicitly this fake bit;
+    // - the size of the result will be the max operand size.
+    // For instance, for ORing 25 and -5 we start like this:
+    // (0) ... 0 1 1 0 0 1 | <-- 25 (5 "real bits", plus a fake bit on top at index GMP_NUMB_BITS)
+    // (0) ... 0 0 0 1 0 1   <-- 5
+    // We do the two's complement of 5 to produce -5:
+    // (0) ... 0 1 1 0 0 1 | <-- 25
+    // (1) ... 1 1 1 0 1 1   <-- -5 (in two's complement)
+    // ---------------
+    // (1) ... 1 1 1 0 1 1
+    // The result has the sign bit set, thus it's a negative number. We take again
+    // the two's complement to get its absolute value:
+    // (0) ... 0 0 0 1 0 1
+    // So the final result is -5.
     const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOTE: at least 1 of the operands is strictly negative, so the result
+    // has to be negative as well (because of ORing the sign bits).
+    rop._mp_size = -1;
     // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
     switch (sign_mask) {
-        case 1u: {
-            // op1 negative, op2 nonnegative. In this case, the result will be negative,
-            // unless the XORing results in zero: in that
-            // case, we return failure as we need extra storage for the result.
-            ::mp_limb_t ret = (~l1 + 1u) ^ l2;
-            // NOTE: need to mask here, as nail bits will have been flipped
-            // by the NOTing above.
-            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
-                return false;
-            }
-            // The NOT here will flip back the nail bits, no need to mask.
-            ret = ~ret + 1u;
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = -(ret != 0u);
-            rop.m_limbs[0] = ret;
-            return true;
-        }
-        case 2u: {
-            // Specular of the above.
-            ::mp_limb_t ret = l1 ^ (~l2 + 1u);
-            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
-                return false;
-            }
-            ret = ~ret + 1u;
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = -(ret != 0u);
-            rop.m_limbs[0] = ret;
-            return true;
-        }
-        case 3u: {
-            // Both negative: the result will be nonnegative.
-            // NOTE: the XOR will zero the nail bits, no need to mask.
-            const ::mp_limb_t ret = (~l1 + 1u) ^ (~l2 + 1u);
-            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
-            rop._mp_size = (ret != 0u);
-            rop.m_limbs[0] = ret;
-            return true;
-        }
-    }
-    // LCOV_EXCL_START
-    assert(false);
-    return true;
-    // LCOV_EXCL_STOP
-}
-
-// 2-limbs implementation.
-inline bool static_xor_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
+        case 1u:
+            // op1 negative, op2 nonnegative.
+            // NOTE: here we know that the values we are 2sc-ing are not zero
+            // (they are strictly negative). The complement will turn on
+            // the nail bits, which will remain turned on after the ORing.
+            // The final 2sc will set them back to zero, so no need to mask.
+            rop.m_limbs[0] = ~((~l1 + 1u) | l2) + 1u;
+            break;
+        case 2u:
+            // op1 nonnegative, op2 negative.
+            rop.m_limbs[0] = ~((~l2 + 1u) | l1) + 1u;
+            break;
+        case 3u:
+            // Both negative.
+            rop.m_limbs[0] = ~((~l1 + 1u) | (~l2 + 1u)) + 1u;
+            break;
+    }
+}
+
+// Small helper to compute the two's complement of a nonzero 2-limbs static integer.
+inline void twosc(std::array<::mp_limb_t, 2> &arr, ::mp_limb_t lo, ::mp_limb_t hi)
+{
+    assert(hi != 0u || lo != 0u);
+    arr[0] = (~lo + 1u) & GMP_NUMB_MASK;
+    arr[1] = (~hi + unsigned(lo == 0u)) & GMP_NUMB_MASK;
+}
+
+// 2-limbs implementation.
+inline void static_ior_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
                             mpz_size_t, int sign1, int sign2)
 {
     const ::mp_limb_t lo1 = (op1.m_limbs[0] & GMP_NUMB_MASK), hi1 = (op1.m_limbs[1] & GMP_NUMB_MASK),
                       lo2 = (op2.m_limbs[0] & GMP_NUMB_MASK), hi2 = (op2.m_limbs[1] & GMP_NUMB_MASK);
     if (sign1 >= 0 && sign2 >= 0) {
         // The easy case: both are nonnegative.
-        const ::mp_limb_t lo = lo1 ^ lo2, hi = hi1 ^ hi2;
+        const ::mp_limb_t lo = lo1 | lo2, hi = hi1 | hi2;
         rop._mp_size = size_from_lohi(lo, hi);
         rop.m_limbs[0] = lo;
         rop.m_limbs[1] = hi;
-        return true;
+        return;
     }
     const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
     std::array<::mp_limb_t, 2> tmp1, tmp2;
     // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
     switch (sign_mask) {
-        case 1u: {
-            // op1 negative, op2 nonnegative. Result will be negative, unless
-            // it overflows.
+        case 1u:
+            // op1 negative, op2 nonnegative.
             twosc(tmp1, lo1, hi1);
             // NOTE: here lo2, hi2 and the 2 limbs in tmp1 have already
-            // been masked for nail bits. The XOR will not change nail bits.
-            const ::mp_limb_t new_lo = tmp1[0] ^ lo2, new_hi = tmp1[1] ^ hi2;
-            if (mppp_unlikely(!new_lo && !new_hi)) {
-                return false;
-            }
-            twosc(rop.m_limbs, new_lo, new_hi);
-            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
-        }
-        case 2u: {
-            // Mirror of the above.
+            // been masked for nail bits.
+            twosc(rop.m_limbs, tmp1[0] | lo2, tmp1[1] | hi2);
+            break;
+        case 2u:
+            // op1 nonnegative, op2 negative.
             twosc(tmp2, lo2, hi2);
-            const ::mp_limb_t new_lo = tmp2[0] ^ lo1, new_hi = tmp2[1] ^ hi1;
-            if (mppp_unlikely(!new_lo && !new_hi)) {
-                return false;
-            }
-            twosc(rop.m_limbs, new_lo, new_hi);
-            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
-        }
-        case 3u: {
+            twosc(rop.m_limbs, tmp2[0] | lo1, tmp2[1] | hi1);
+            break;
+        case 3u:
             // Both negative.
             twosc(tmp1, lo1, hi1);
             twosc(tmp2, lo2, hi2);
-            rop.m_limbs[0] = tmp1[0] ^ tmp2[0];
-            rop.m_limbs[1] = tmp1[1] ^ tmp2[1];
-            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
-            return true;
+            twosc(rop.m_limbs, tmp1[0] | tmp2[0], tmp1[1] | tmp2[1]);
+            break;
+    }
+    // Size is -1 or -2: we could have 1-limb operands, and even with
+    // 2-limbs operands, the final 2sc - in case of negative values - could
+    // zero out the upper limb.
+    // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+    rop._mp_size = -2 + (rop.m_limbs[1] == 0u);
+}
+
+// Compute the two's complement of an n-limbs nonzero integer. The new size of
+// the integer will be returned.
+inline mpz_size_t twosc(::mp_limb_t *rop, const ::mp_limb_t *sp, mpz_size_t n)
+{
+    // Make sure the size is nonzero, and the value is nonzero as well.
+    assert(n > 0);
+    assert(std::any_of(sp, sp + n, [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) != 0u; }));
+    // Create a copy so we can compare to the original value later.
+    auto size = n;
+    // Flip the bits.
+    mpn_com(rop, sp, static_cast<::mp_size_t>(size));
+    // Compute the new size.
+    if ((rop[size - 1] & GMP_NUMB_MASK) == 0u) {
+        --size;
+        for (; size != 0 && (rop[size - 1] & GMP_NUMB_MASK) == 0u; --size) {
         }
     }
-    // LCOV_EXCL_START
-    assert(false);
-    return true;
-    // LCOV_EXCL_STOP
+    // Add 1.
+    if (size != 0) {
+        // If rop is nonzero, use the mpn_add_1() primitive, storing the carry
+        // and updating the size if necessary.
+        if (mpn_add_1(rop, rop, size, 1) != 0u) {
+            // This needs to hold as sp is nonzero: 2sc can never
+            // overflow the highest limb.
+            assert(size < n);
+            rop[size++] = 1;
+        }
+    } else {
+        // If rop is zero, we cannot use mpn functions, just set the value directly.
+        rop[0] = 1;
+        size = 1;
+    }
+    // NOTE: the new size cannot be greater than n, the only way for this
+    // to be possible would be if the input was zero (but this is prevented)
+    // by the top assert).
+    assert(size <= n);
+    return size;
 }
 
 // mpn implementation.
 template <std::size_t SSize>
-inline bool static_xor_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+inline void static_ior_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
                             mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2)
 {
     auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
@@ -6084,12 +6941,12 @@ inline bool static_xor_impl(static_int<SSize> &rop, const static_int<SSize> &op1
         // a few branches.
         rop._mp_size = op2._mp_size;
         copy_limbs(data2, data2 + asize2, rop.m_limbs.data());
-        return true;
+        return;
     }
     if (!sign2) {
         rop._mp_size = op1._mp_size;
         copy_limbs(data1, data1 + asize1, rop.m_limbs.data());
-        return true;
+        return;
     }
     // Make sure data1/asize1 refer to the largest operand.
     if (asize1 < asize2) {
@@ -6099,75 +6956,52 @@ inline bool static_xor_impl(static_int<SSize> &rop, const static_int<SSize> &op1
     }
     if (sign1 > 0 && sign2 > 0) {
         // The easy case: both are nonnegative.
-        // Compute the xor.
-        mpn_xor_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
-        // Limbs from asize2 to asize1 in op1 get copied as-is, as they are XORed with
-        // zeroes from op2.
+        // Set the size.
+        rop._mp_size = asize1;
+        // Compute the ior.
+        mpn_ior_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
+        // Copy extra limbs from data1.
         copy_limbs(data1 + asize2, data1 + asize1, rop.m_limbs.data() + asize2);
-        // The asize will be at most asize1. Upper limbs could be zero due to the XORing
-        // (e.g., the values are identical).
-        rop._mp_size = compute_static_int_asize(rop, asize1);
-        return true;
+        return;
     }
     const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
-    std::array<::mp_limb_t, SSize> tmp1, tmp2, tmpr;
+    std::array<::mp_limb_t, SSize> tmp1, tmp2;
     // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
     switch (sign_mask) {
         case 1u:
             // op1 negative, op2 nonnegative.
             twosc(tmp1.data(), data1, asize1);
-            // NOTE: in all 3 cases, the mpn_xor_n() is done with the minimum size among the operands
+            // NOTE: in all 3 cases, the mpn_ior_n() is done with the minimum size among the operands
             // (asize2). In this case, due to the twosc, the first most significant limbs in tmp1 might
             // be zero, but according to the mpn docs this is not a problem.
-            mpn_xor_n(tmpr.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
-            // Copy over the limbs in tmp1 from asize2 to asize1.
-            copy_limbs_no(tmp1.data() + asize2, tmp1.data() + asize1, tmpr.data() + asize2);
-            // Check for zero.
-            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
-                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
-                return false;
-            }
-            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
-            return true;
+            mpn_ior_n(rop.m_limbs.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
+            // Copy over the remaining limbs from the largest operand.
+            copy_limbs(tmp1.data() + asize2, tmp1.data() + asize1, rop.m_limbs.data() + asize2);
+            // The final twosc. This will return the effective abs size, which we need to negate.
+            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize1);
+            break;
         case 2u:
             // op1 nonnegative, op2 negative.
             twosc(tmp2.data(), data2, asize2);
-            // Do the XOR.
-            mpn_xor_n(tmpr.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
-            // The limbs in tmp2 from asize2 to asize1 have all been set to 1: XORing them
-            // with the corresponding limbs in op1 means bit-flipping the limbs in op1.
-            if (asize2 != asize1) {
-                // NOTE: mpn functions require nonzero operands, so we need to branch here.
-                mpn_com(tmpr.data() + asize2, data1 + asize2, asize1 - asize2);
-            }
-            // Check for zero.
-            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
-                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
-                return false;
-            }
-            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
-            return true;
+            // NOTE: after the twosc, the limbs in tmp2 from asize2 to asize1 should be set
+            // to all 1s. We don't need to actually do that: ORing op1 with these high all-1 limbs
+            // produces all-1 limbs in the result, and the final twosc will flip them back to zero.
+            mpn_ior_n(rop.m_limbs.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
+            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize2);
+            break;
         case 3u:
             twosc(tmp1.data(), data1, asize1);
             twosc(tmp2.data(), data2, asize2);
-            mpn_xor_n(rop.m_limbs.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
-            // Same as above, regarding the all-1 limbs in tmp2.
-            if (asize2 != asize1) {
-                // NOTE: mpn functions require nonzero operands, so we need to branch here.
-                mpn_com(rop.m_limbs.data() + asize2, tmp1.data() + asize2, asize1 - asize2);
-            }
-            rop._mp_size = compute_static_int_asize(rop, asize1);
-            return true;
+            mpn_ior_n(rop.m_limbs.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
+            rop._mp_size = -twosc(rop.m_limbs.data(), rop.m_limbs.data(), asize2);
+            break;
     }
-    // LCOV_EXCL_START
-    assert(false);
-    return true;
-    // LCOV_EXCL_STOP
 }
 
+// The dispatching function for the static implementation.
 template <std::size_t SSize>
-inline bool static_xor(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+inline void static_ior(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
     mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
     int sign1 = asize1 != 0, sign2 = asize2 != 0;
@@ -6181,577 +7015,1625 @@ inline bool static_xor(static_int<SSize> &rop, const static_int<SSize> &op1, con
     }
     // NOTE: currently the implementation dispatches only on the static size: there's no need to
     // zero upper limbs as mpn functions are never used in case of optimised size.
-    return static_xor_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
+    static_ior_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
 }
 } // namespace detail
 
-// Bitwise XOR.
+// Bitwise OR.
 template <std::size_t SSize>
-inline integer<SSize> &bitwise_xor(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &bitwise_ior(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
-    bool sr = rop.is_static();
+    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
     if (mppp_likely(s1 && s2)) {
         if (!sr) {
             rop.set_zero();
-            sr = true;
-        }
-        if (mppp_likely(static_xor(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
-            return rop;
         }
+        static_ior(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        return rop;
     }
     if (sr) {
         rop._get_union().promote();
     }
-    mpz_xor(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
+    mpz_ior(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+namespace detail
+{
+
+// 1-limb implementation.
+inline bool static_and_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
+                            mpz_size_t, int sign1, int sign2)
+{
+    const ::mp_limb_t l1 = op1.m_limbs[0] & GMP_NUMB_MASK, l2 = op2.m_limbs[0] & GMP_NUMB_MASK;
+    if (sign1 >= 0 && sign2 >= 0) {
+        // The easy case: both are nonnegative.
+        // NOTE: no need to mask, as we masked l1 and l2 already, and AND
+        // won't turn on any upper bit.
+        ::mp_limb_t ret = l1 & l2;
+        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+        rop._mp_size = ret != 0u;
+        rop.m_limbs[0] = ret;
+        return true;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u: {
+            // op1 negative, op2 nonnegative.
+            // The result will be nonnegative, and it does not need to be masked:
+            // nail bits will be switched off by ANDing with l2.
+            const ::mp_limb_t ret = (~l1 + 1u) & l2;
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = ret != 0u;
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+        case 2u: {
+            // op1 nonnegative, op2 negative.
+            // This is the symmetric of above.
+            const ::mp_limb_t ret = l1 & (~l2 + 1u);
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = ret != 0u;
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+        case 3u: {
+            // Both negative. In this case, the result will be negative,
+            // unless the ANDing of the 2scs results in zero: in that
+            // case, we return failure as we need extra storage for the result.
+            ::mp_limb_t ret = (~l1 + 1u) & (~l2 + 1u);
+            // NOTE: need to mask here, as nail bits will have been flipped
+            // by the NOTing above.
+            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
+                return false;
+            }
+            // The NOT here will flip back the nail bits, no need to mask.
+            ret = ~ret + 1u;
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = -(ret != 0u);
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+    }
+    // Keep the compiler happy.
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+// 2-limbs implementation.
+inline bool static_and_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
+                            mpz_size_t, int sign1, int sign2)
+{
+    const ::mp_limb_t lo1 = (op1.m_limbs[0] & GMP_NUMB_MASK), hi1 = (op1.m_limbs[1] & GMP_NUMB_MASK),
+                      lo2 = (op2.m_limbs[0] & GMP_NUMB_MASK), hi2 = (op2.m_limbs[1] & GMP_NUMB_MASK);
+    if (sign1 >= 0 && sign2 >= 0) {
+        // The easy case: both are nonnegative.
+        const ::mp_limb_t lo = lo1 & lo2, hi = hi1 & hi2;
+        rop._mp_size = size_from_lohi(lo, hi);
+        rop.m_limbs[0] = lo;
+        rop.m_limbs[1] = hi;
+        return true;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, 2> tmp1, tmp2;
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u:
+            // op1 negative, op2 nonnegative.
+            twosc(tmp1, lo1, hi1);
+            // NOTE: here lo2, hi2 and the 2 limbs in tmp1 have already
+            // been masked for nail bits.
+            rop.m_limbs[0] = tmp1[0] & lo2;
+            rop.m_limbs[1] = tmp1[1] & hi2;
+            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        case 2u:
+            // op1 nonnegative, op2 negative.
+            twosc(tmp2, lo2, hi2);
+            rop.m_limbs[0] = tmp2[0] & lo1;
+            rop.m_limbs[1] = tmp2[1] & hi1;
+            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        case 3u: {
+            // Both negative.
+            twosc(tmp1, lo1, hi1);
+            twosc(tmp2, lo2, hi2);
+            const ::mp_limb_t new_lo = tmp1[0] & tmp2[0], new_hi = tmp1[1] & tmp2[1];
+            if (mppp_unlikely(!new_lo && !new_hi)) {
+                // When both operands are negative, we could end up in a situation
+                // where, after the 2scs, the ANDing returns zero. In this case,
+                // we need extra storage.
+                return false;
+            }
+            twosc(rop.m_limbs, new_lo, new_hi);
+            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        }
+    }
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+// Small helper to compute the abs size of a static int, knowing it must
+// be at most asize > 0.
+template <std::size_t SSize>
+inline mpz_size_t compute_static_int_asize(const static_int<SSize> &r, mpz_size_t asize)
+{
+    assert(asize > 0);
+    if (!(r.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK)) {
+        --asize;
+        for (; asize && !(r.m_limbs[static_cast<std::size_t>(asize - 1)] & GMP_NUMB_MASK); --asize) {
+        }
+    }
+    return asize;
+}
+
+// mpn implementation.
+template <std::size_t SSize>
+inline bool static_and_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2)
+{
+    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
+    // Handle zeroes.
+    if (!sign1 || !sign2) {
+        rop._mp_size = 0;
+        return true;
+    }
+    // Make sure data1/asize1 refer to the largest operand.
+    if (asize1 < asize2) {
+        std::swap(data1, data2);
+        std::swap(asize1, asize2);
+        std::swap(sign1, sign2);
+    }
+    if (sign1 > 0 && sign2 > 0) {
+        // The easy case: both are nonnegative.
+        // Compute the and.
+        mpn_and_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
+        // The asize will be at most asize2. Upper limbs could be zero due to the ANDing.
+        rop._mp_size = compute_static_int_asize(rop, asize2);
+        return true;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, SSize> tmp1, tmp2, tmpr;
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u:
+            // op1 negative, op2 nonnegative.
+            twosc(tmp1.data(), data1, asize1);
+            // NOTE: in all 3 cases, the mpn_and_n() is done with the minimum size among the operands
+            // (asize2). In this case, due to the twosc, the first most significant limbs in tmp1 might
+            // be zero, but according to the mpn docs this is not a problem.
+            mpn_and_n(rop.m_limbs.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
+            // NOTE: size cannot be larger than asize2, as all the limbs above that limit from op1
+            // will be set to zero by the ANDing.
+            rop._mp_size = compute_static_int_asize(rop, asize2);
+            return true;
+        case 2u:
+            // op1 nonnegative, op2 negative.
+            twosc(tmp2.data(), data2, asize2);
+            // Do the AND.
+            mpn_and_n(rop.m_limbs.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
+            // Copy over the upper limbs of op1 to rop: the limbs in tmp2 from asize2 to asize1
+            // are (virtually) set to all 1s by the twosc, so ANDing with the corresponding limbs
+            // in op1 means simply copying op1 over.
+            copy_limbs(data1 + asize2, data1 + asize1, rop.m_limbs.data() + asize2);
+            // Compute the final size. It can be at most asize1.
+            rop._mp_size = compute_static_int_asize(rop, asize1);
+            return true;
+        case 3u:
+            twosc(tmp1.data(), data1, asize1);
+            twosc(tmp2.data(), data2, asize2);
+            // Write in temp storage, as we might overflow and we don't want to spoil
+            // rop in that case.
+            mpn_and_n(tmpr.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
+            // Copy over the upper limbs of op1 to rop (same as above). Non overlapping,
+            // as we are only using local storage.
+            copy_limbs_no(tmp1.data() + asize2, tmp1.data() + asize1, tmpr.data() + asize2);
+            // Check for zero.
+            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
+                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
+                return false;
+            }
+            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
+            return true;
+    }
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+template <std::size_t SSize>
+inline bool static_and(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
+    int sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
+    }
+    // NOTE: currently the implementation dispatches only on the static size: there's no need to
+    // zero upper limbs as mpn functions are never used in case of optimised size.
+    return static_and_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
+}
+} // namespace detail
+
+// Bitwise AND.
+template <std::size_t SSize>
+inline integer<SSize> &bitwise_and(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    bool sr = rop.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
+            sr = true;
+        }
+        if (mppp_likely(static_and(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
+            return rop;
+        }
+    }
+    if (sr) {
+        rop._get_union().promote();
+    }
+    mpz_and(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+namespace detail
+{
+
+// 1-limb implementation.
+inline bool static_xor_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t,
+                            mpz_size_t, int sign1, int sign2)
+{
+    const ::mp_limb_t l1 = op1.m_limbs[0] & GMP_NUMB_MASK, l2 = op2.m_limbs[0] & GMP_NUMB_MASK;
+    if (sign1 >= 0 && sign2 >= 0) {
+        // The easy case: both are nonnegative.
+        // NOTE: no need to mask, as we masked l1 and l2 already, and XOR
+        // won't turn on any upper bit.
+        ::mp_limb_t ret = l1 ^ l2;
+        // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+        rop._mp_size = ret != 0u;
+        rop.m_limbs[0] = ret;
+        return false;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u: {
+            // op1 negative, op2 nonnegative. In this case, the result will be negative,
+            // unless the XORing results in zero: in that
+            // case, we return failure as we need extra storage for the result.
+            ::mp_limb_t ret = (~l1 + 1u) ^ l2;
+            // NOTE: need to mask here, as nail bits will have been flipped
+            // by the NOTing above.
+            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
+                return false;
+            }
+            // The NOT here will flip back the nail bits, no need to mask.
+            ret = ~ret + 1u;
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = -(ret != 0u);
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+        case 2u: {
+            // Specular of the above.
+            ::mp_limb_t ret = l1 ^ (~l2 + 1u);
+            if (mppp_unlikely(!(ret & GMP_NUMB_MASK))) {
+                return false;
+            }
+            ret = ~ret + 1u;
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = -(ret != 0u);
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+        case 3u: {
+            // Both negative: the result will be nonnegative.
+            // NOTE: the XOR will zero the nail bits, no need to mask.
+            const ::mp_limb_t ret = (~l1 + 1u) ^ (~l2 + 1u);
+            // NOLINTNEXTLINE(readability-implicit-bool-conversion)
+            rop._mp_size = (ret != 0u);
+            rop.m_limbs[0] = ret;
+            return true;
+        }
+    }
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+// 2-limbs implementation.
+inline bool static_xor_impl(static_int<2> &rop, const static_int<2> &op1, const static_int<2> &op2, mpz_size_t,
+                            mpz_size_t, int sign1, int sign2)
+{
+    const ::mp_limb_t lo1 = (op1.m_limbs[0] & GMP_NUMB_MASK), hi1 = (op1.m_limbs[1] & GMP_NUMB_MASK),
+                      lo2 = (op2.m_limbs[0] & GMP_NUMB_MASK), hi2 = (op2.m_limbs[1] & GMP_NUMB_MASK);
+    if (sign1 >= 0 && sign2 >= 0) {
+        // The easy case: both are nonnegative.
+        const ::mp_limb_t lo = lo1 ^ lo2, hi = hi1 ^ hi2;
+        rop._mp_size = size_from_lohi(lo, hi);
+        rop.m_limbs[0] = lo;
+        rop.m_limbs[1] = hi;
+        return true;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, 2> tmp1, tmp2;
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u: {
+            // op1 negative, op2 nonnegative. Result will be negative, unless
+            // it overflows.
+            twosc(tmp1, lo1, hi1);
+            // NOTE: here lo2, hi2 and the 2 limbs in tmp1 have already
+            // been masked for nail bits. The XOR will not change nail bits.
+            const ::mp_limb_t new_lo = tmp1[0] ^ lo2, new_hi = tmp1[1] ^ hi2;
+            if (mppp_unlikely(!new_lo && !new_hi)) {
+                return false;
+            }
+            twosc(rop.m_limbs, new_lo, new_hi);
+            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        }
+        case 2u: {
+            // Mirror of the above.
+            twosc(tmp2, lo2, hi2);
+            const ::mp_limb_t new_lo = tmp2[0] ^ lo1, new_hi = tmp2[1] ^ hi1;
+            if (mppp_unlikely(!new_lo && !new_hi)) {
+                return false;
+            }
+            twosc(rop.m_limbs, new_lo, new_hi);
+            rop._mp_size = -size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        }
+        case 3u: {
+            // Both negative.
+            twosc(tmp1, lo1, hi1);
+            twosc(tmp2, lo2, hi2);
+            rop.m_limbs[0] = tmp1[0] ^ tmp2[0];
+            rop.m_limbs[1] = tmp1[1] ^ tmp2[1];
+            rop._mp_size = size_from_lohi(rop.m_limbs[0], rop.m_limbs[1]);
+            return true;
+        }
+    }
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+// mpn implementation.
+template <std::size_t SSize>
+inline bool static_xor_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2)
+{
+    auto data1 = op1.m_limbs.data(), data2 = op2.m_limbs.data();
+    // Handle zeroes.
+    if (!sign1) {
+        // NOTE: manual copy rather than assignment, to avoid
+        // a few branches.
+        rop._mp_size = op2._mp_size;
+        copy_limbs(data2, data2 + asize2, rop.m_limbs.data());
+        return true;
+    }
+    if (!sign2) {
+        rop._mp_size = op1._mp_size;
+        copy_limbs(data1, data1 + asize1, rop.m_limbs.data());
+        return true;
+    }
+    // Make sure data1/asize1 refer to the largest operand.
+    if (asize1 < asize2) {
+        std::swap(data1, data2);
+        std::swap(asize1, asize2);
+        std::swap(sign1, sign2);
+    }
+    if (sign1 > 0 && sign2 > 0) {
+        // The easy case: both are nonnegative.
+        // Compute the xor.
+        mpn_xor_n(rop.m_limbs.data(), data1, data2, static_cast<::mp_size_t>(asize2));
+        // Limbs from asize2 to asize1 in op1 get copied as-is, as they are XORed with
+        // zeroes from op2.
+        copy_limbs(data1 + asize2, data1 + asize1, rop.m_limbs.data() + asize2);
+        // The asize will be at most asize1. Upper limbs could be zero due to the XORing
+        // (e.g., the values are identical).
+        rop._mp_size = compute_static_int_asize(rop, asize1);
+        return true;
+    }
+    const unsigned sign_mask = unsigned(sign1 < 0) + (unsigned(sign2 < 0) << 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, SSize> tmp1, tmp2, tmpr;
+    // NOLINTNEXTLINE(hicpp-multiway-paths-covered)
+    switch (sign_mask) {
+        case 1u:
+            // op1 negative, op2 nonnegative.
+            twosc(tmp1.data(), data1, asize1);
+            // NOTE: in all 3 cases, the mpn_xor_n() is done with the minimum size among the operands
+            // (asize2). In this case, due to the twosc, the first most significant limbs in tmp1 might
+            // be zero, but according to the mpn docs this is not a problem.
+            mpn_xor_n(tmpr.data(), tmp1.data(), data2, static_cast<::mp_size_t>(asize2));
+            // Copy over the limbs in tmp1 from asize2 to asize1.
+            copy_limbs_no(tmp1.data() + asize2, tmp1.data() + asize1, tmpr.data() + asize2);
+            // Check for zero.
+            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
+                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
+                return false;
+            }
+            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
+            return true;
+        case 2u:
+            // op1 nonnegative, op2 negative.
+            twosc(tmp2.data(), data2, asize2);
+            // Do the XOR.
+            mpn_xor_n(tmpr.data(), data1, tmp2.data(), static_cast<::mp_size_t>(asize2));
+            // The limbs in tmp2 from asize2 to asize1 have all been set to 1: XORing them
+            // with the corresponding limbs in op1 means bit-flipping the limbs in op1.
+            if (asize2 != asize1) {
+                // NOTE: mpn functions require nonzero operands, so we need to branch here.
+                mpn_com(tmpr.data() + asize2, data1 + asize2, asize1 - asize2);
+            }
+            // Check for zero.
+            if (mppp_unlikely(std::all_of(tmpr.data(), tmpr.data() + asize1,
+                                          [](::mp_limb_t l) { return (l & GMP_NUMB_MASK) == 0u; }))) {
+                return false;
+            }
+            rop._mp_size = -twosc(rop.m_limbs.data(), tmpr.data(), asize1);
+            return true;
+        case 3u:
+            twosc(tmp1.data(), data1, asize1);
+            twosc(tmp2.data(), data2, asize2);
+            mpn_xor_n(rop.m_limbs.data(), tmp1.data(), tmp2.data(), static_cast<::mp_size_t>(asize2));
+            // Same as above, regarding the all-1 limbs in tmp2.
+            if (asize2 != asize1) {
+                // NOTE: mpn functions require nonzero operands, so we need to branch here.
+                mpn_com(rop.m_limbs.data() + asize2, tmp1.data() + asize2, asize1 - asize2);
+            }
+            rop._mp_size = compute_static_int_asize(rop, asize1);
+            return true;
+    }
+    // LCOV_EXCL_START
+    assert(false);
+    return true;
+    // LCOV_EXCL_STOP
+}
+
+template <std::size_t SSize>
+inline bool static_xor(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
+    int sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
+    }
+    // NOTE: currently the implementation dispatches only on the static size: there's no need to
+    // zero upper limbs as mpn functions are never used in case of optimised size.
+    return static_xor_impl(rop, op1, op2, asize1, asize2, sign1, sign2);
+}
+} // namespace detail
+
+// Bitwise XOR.
+template <std::size_t SSize>
+inline integer<SSize> &bitwise_xor(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    bool sr = rop.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
+            sr = true;
+        }
+        if (mppp_likely(static_xor(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
+            return rop;
+        }
+    }
+    if (sr) {
+        rop._get_union().promote();
+    }
+    mpz_xor(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+namespace detail
+{
+
+// mpn/mpz implementation.
+template <std::size_t SSize>
+inline void static_gcd_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2)
+{
+    // NOTE: performance testing indicates that, even if mpz_gcd() does special casing
+    // for zeroes and 1-limb values, it is still worth it to repeat the special casing
+    // here. This is probably because if we manage to actually call mpn_gcd_1() here,
+    // we avoid interacting with dynamically allocated memory below in the thread-local
+    // object. If we ever start using mpn_gcd(), we will probably have to re-do a
+    // performance analysis.
+    //
+    // Handle zeroes.
+    if (!asize1) {
+        // NOTE: we want the result to be positive, and to copy only the set limbs.
+        rop._mp_size = asize2;
+        copy_limbs(op2.m_limbs.data(), op2.m_limbs.data() + asize2, rop.m_limbs.data());
+        return;
+    }
+    if (!asize2) {
+        rop._mp_size = asize1;
+        copy_limbs(op1.m_limbs.data(), op1.m_limbs.data() + asize1, rop.m_limbs.data());
+        return;
+    }
+    // Special casing if an operand has asize 1.
+    if (asize1 == 1) {
+        rop._mp_size = 1;
+        rop.m_limbs[0] = mpn_gcd_1(op2.m_limbs.data(), static_cast<::mp_size_t>(asize2), op1.m_limbs[0]);
+        return;
+    }
+    if (asize2 == 1) {
+        rop._mp_size = 1;
+        rop.m_limbs[0] = mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
+        return;
+    }
+    // General case, via mpz.
+    // NOTE: there is an mpn_gcd() function, but it seems difficult to use. Apparently, and contrary to
+    // what stated in the latest documentation, the mpn function requires odd operands and bit size
+    // (not only limb size!) of the second operand not greater than the first. See for instance the old
+    // documentation:
+    // ftp://ftp.gnu.org/old-gnu/Manuals/gmp-3.1.1/html_chapter/gmp_9.html
+    // Indeed, compiling GMP in debug mode and then trying to use the mpn function without respecting the above
+    // results in assertion failures. For now let's keep it like this, the small operand cases are handled above
+    // (partially) via mpn_gcd_1(), and in the future we can also think about binary GCD for 1/2 limbs optimisation.
+    const mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    const auto v1 = op1.get_mpz_view();
+    const auto v2 = op2.get_mpz_view();
+    mpz_gcd(&tmp.m_mpz, &v1, &v2);
+    // Copy over.
+    rop._mp_size = tmp.m_mpz._mp_size;
+    assert(rop._mp_size > 0);
+    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + rop._mp_size, rop.m_limbs.data());
+}
+
+// 1-limb optimization.
+inline void static_gcd_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t asize1,
+                            mpz_size_t asize2)
+{
+    // Handle the special cases first.
+    if (asize1 == 0) {
+        // gcd(0, n) = abs(n). This also covers the convention
+        // that gcd(0, 0) = 0.
+        // NOTE: don't use the copy assignment operator of static_int,
+        // as the size needs to be set to positive.
+        rop._mp_size = asize2;
+        rop.m_limbs = op2.m_limbs;
+        return;
+    }
+    if (asize2 == 0) {
+        // gcd(n, 0) = abs(n).
+        // NOTE: op1 is not zero, its size can only be 1.
+        rop._mp_size = 1;
+        rop.m_limbs = op1.m_limbs;
+        return;
+    }
+    // At this point, asize1 == asize2 == 1, and the result
+    // will also have size 1.
+    rop._mp_size = 1;
+    // Compute the limb value.
+    // NOTE: as an alternative, here we could have a custom binary GCD. See for
+    // instance this implementation by Howard Hinnant using compiler intrinsics:
+    // https://groups.google.com/a/isocpp.org/forum/#!topic/std-proposals/8WB2Z9d7A0w
+    // Testing however shows that mpn_gcd_1() is quite well optimised, so let's
+    // use it and keep in mind the option about the binary GCD for the future.
+    // NOTE: at the commit c146af86e416cf1348d0b3fc454600b47b523f4f we have an implementation
+    // of the binary GCD, just in case.
+    // NOTE: currently, the binary GCD is faster on Zen processors, but I believe
+    // that is because the current GMP version does not have optimised GCD assembly for Zen.
+    // We need to benchmark again when the next GMP version comes out. If the binary GCD
+    // is still faster, we should consider using it instead of mpn_gcd_1(), as even on Intel
+    // processors the binary GCD is only marginally slower than mpn_gcd_1().
+    rop.m_limbs[0] = mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(1), op2.m_limbs[0]);
+}
+
+template <std::size_t SSize>
+inline void static_gcd(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    static_gcd_impl(rop, op1, op2, std::abs(op1._mp_size), std::abs(op2._mp_size));
+    if (SSize > 1u) {
+        // If we used the generic function, zero the unused limbs on top (if necessary).
+        // NOTE: as usual, potential of mpn/mpz use on optimised size (e.g., with 2-limb
+        // static ints we are currently invoking mpz_gcd() - this could produce a result
+        // with only the lower limb, and the higher limb is not zeroed out).
+        rop.zero_unused_limbs();
+    }
+}
+} // namespace detail
+
+// GCD (ternary version).
+template <std::size_t SSize>
+inline integer<SSize> &gcd(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
+        }
+        static_gcd(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        return rop;
+    }
+    if (sr) {
+        rop._get_union().promote();
+    }
+    mpz_gcd(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+// GCD (binary version).
+template <std::size_t SSize>
+inline integer<SSize> gcd(const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    integer<SSize> retval;
+    gcd(retval, op1, op2);
+    return retval;
+}
+
+namespace detail
+{
+
+// The general-purpose implementation of ternary LCM.
+template <std::size_t SSize>
+inline void integer_ternary_lcm_generic(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    // Temporary working variable.
+    const mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS integer<SSize> g;
+
+    // rop = (abs(op1) / gcd(op1, op2)) * abs(op2).
+    gcd(g, op1, op2);
+    divexact_gcd(g, op1, g);
+    mul(g, g, op2);
+    mb.escape([&]() { abs(rop, g); });
+}
+
+template <std::size_t SSize>
+inline void integer_ternary_lcm_impl(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    integer_ternary_lcm_generic(rop, op1, op2);
+}
+
+inline void integer_ternary_lcm_impl(integer<1> &rop, const integer<1> &op1, const integer<1> &op2)
+{
+    if (mppp_likely(op1.is_static() && op2.is_static())) {
+        // NOTE: the idea here is that if both op1 and op2
+        // are static, we can use static integer primitives
+        // directly in parts of the algorithm, thus avoiding
+        // branching wrt the general-purpose primitives.
+        integer<1> g;
+
+        auto &g_st = g._get_union().g_st();
+        const auto &op1_st = op1._get_union().g_st();
+        const auto &op2_st = op2._get_union().g_st();
+
+        // Use the static primitives for the first two
+        // steps, as we are sure that no overflow
+        // is possible.
+        static_gcd(g_st, op1_st, op2_st);
+        static_divexact_gcd(g_st, op1_st, g_st);
+
+        // Switch to the general-purpose multiplication,
+        // as the result could overflow.
+        // NOTE: perhaps using the static mul primitive
+        // here could help us squeeze a bit extra performance,
+        // at the price of duplicating the overflow handling
+        // logic. Keep in mind for the future.
+        mul(rop, g, op2);
+        // Turn rop into abs(rop).
+        // NOTE: this is always safe to do because
+        // rop will consist of at most 2 limbs.
+        rop._get_union().m_st._mp_size = std::abs(rop._get_union().m_st._mp_size);
+    } else {
+        // op1/op2 are not both statics. Run
+        // the general-purpose implementation.
+        integer_ternary_lcm_generic(rop, op1, op2);
+    }
+}
+
+} // namespace detail
+
+// LCM (ternary version).
+template <std::size_t SSize>
+inline integer<SSize> &lcm(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    // Handle the special case lcm(0, 0) == 0.
+    if (mppp_unlikely(op1.is_zero() && op2.is_zero())) {
+        rop.set_zero();
+    } else {
+        detail::integer_ternary_lcm_impl(rop, op1, op2);
+    }
+
+    return rop;
+}
+
+namespace detail
+{
+
+// The general-purpose implementation of binary LCM.
+template <std::size_t SSize>
+inline integer<SSize> integer_binary_lcm_generic(const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    // retval = (abs(op1) / gcd(op1, op2)) * abs(op2).
+    auto retval = gcd(op1, op2);
+    divexact_gcd(retval, op1, retval);
+    mul(retval, retval, op2);
+    abs(retval, retval);
+
+    return retval;
+}
+
+template <std::size_t SSize>
+inline integer<SSize> integer_binary_lcm_impl(const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    return integer_binary_lcm_generic(op1, op2);
+}
+
+inline integer<1> integer_binary_lcm_impl(const integer<1> &op1, const integer<1> &op2)
+{
+    if (mppp_likely(op1.is_static() && op2.is_static())) {
+        integer<1> retval;
+
+        auto &r_st = retval._get_union().g_st();
+        const auto &op1_st = op1._get_union().g_st();
+        const auto &op2_st = op2._get_union().g_st();
+
+        static_gcd(r_st, op1_st, op2_st);
+        static_divexact_gcd(r_st, op1_st, r_st);
+
+        mul(retval, retval, op2);
+        // Turn retval into abs(retval).
+        // NOTE: this is always safe to do because
+        // rop will consist of at most 2 limbs.
+        retval._get_union().m_st._mp_size = std::abs(retval._get_union().m_st._mp_size);
+
+        return retval;
+    } else {
+        return integer_binary_lcm_generic(op1, op2);
+    }
+}
+
+} // namespace detail
+
+// LCM (binary version).
+// NOTE: don't implement on top of the ternary primitives, a custom
+// implementation avoids the creation of an unnecessary temporary.
+template <std::size_t SSize>
+inline integer<SSize> lcm(const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    // Handle the special case lcm(0, 0) == 0.
+    if (mppp_unlikely(op1.is_zero() && op2.is_zero())) {
+        return integer<SSize>{};
+    } else {
+        return detail::integer_binary_lcm_impl(op1, op2);
+    }
+}
+
+// Factorial.
+template <std::size_t SSize>
+inline integer<SSize> &fac_ui(integer<SSize> &rop, unsigned long n)
+{
+    // NOTE: we put a limit here because the GMP function just crashes and burns
+    // if n is too large, and n does not even need to be that large.
+    constexpr auto max_fac = 1000000ull;
+    if (mppp_unlikely(n > max_fac)) {
+        throw std::invalid_argument(
+            "The value " + detail::to_string(n)
+            + " is too large to be used as input for the factorial function (the maximum allowed value is "
+            + detail::to_string(max_fac) + ")");
+    }
+    // NOTE: let's get through a static temporary and then assign it to the rop,
+    // so that rop will be static/dynamic according to the size of tmp.
+    const detail::mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS detail::mpz_raii tmp;
+    mpz_fac_ui(&tmp.m_mpz, n);
+    return mb.escape([&]() -> integer<SSize> & { return rop = &tmp.m_mpz; });
+}
+
+// Binomial coefficient (ternary version).
+template <std::size_t SSize>
+inline integer<SSize> &bin_ui(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
+{
+    const detail::mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS detail::mpz_raii tmp;
+    mpz_bin_ui(&tmp.m_mpz, n.get_mpz_view(), k);
+    return mb.escape([&]() -> integer<SSize> & { return rop = &tmp.m_mpz; });
+}
+
+// Binomial coefficient (binary version).
+template <std::size_t SSize>
+inline integer<SSize> bin_ui(const integer<SSize> &n, unsigned long k)
+{
+    integer<SSize> retval;
+    bin_ui(retval, n, k);
+    return retval;
+}
+
+namespace detail
+{
+
+// These helpers are used here and in pow() as well.
+template <typename T, enable_if_t<is_integral<T>::value, int> = 0>
+inline unsigned long integer_exp_to_ulong(const T &exp)
+{
+#if !defined(__INTEL_COMPILER)
+    assert(exp >= T(0));
+#endif
+    // NOTE: make_unsigned_t<T> is T if T is already unsigned.
+    // Don't use the make_unsigned() helper, as exp might be
+    // unsigned already.
+    static_assert(!std::is_same<T, bool>::value, "Cannot use the bool type in make_unsigned_t.");
+    if (mppp_unlikely(static_cast<make_unsigned_t<T>>(exp) > nl_max<unsigned long>())) {
+        throw std::overflow_error("Cannot convert the integral value " + detail::to_string(exp)
+                                  + " to unsigned long: the value is too large");
+    }
+    return static_cast<unsigned long>(exp);
+}
+
+// NOTE: special case bool, otherwise we end up invoking make_unsigned_t<bool> in the
+// previous overload, which is not well-defined:
+// https://en.cppreference.com/w/cpp/types/make_unsigned
+inline unsigned long integer_exp_to_ulong(bool exp)
+{
+
+    return static_cast<unsigned long>(exp);
+}
+
+template <std::size_t SSize>
+inline unsigned long integer_exp_to_ulong(const integer<SSize> &exp)
+{
+    try {
+        return static_cast<unsigned long>(exp);
+    } catch (const std::overflow_error &) {
+        // Rewrite the error message.
+        throw std::overflow_error("Cannot convert the integral value " + exp.to_string()
+                                  + " to unsigned long: the value is too large");
+    }
+}
+
+template <typename T, std::size_t SSize>
+inline integer<SSize> binomial_impl(const integer<SSize> &n, const T &k)
+{
+    // NOTE: here we re-use some helper member functions used in the implementation of pow().
+    if (sgn(k) >= 0) {
+        return bin_ui(n, integer_exp_to_ulong(k));
+    }
+    // This is the case k < 0, handled according to:
+    // https://arxiv.org/abs/1105.3689/
+    if (n.sgn() >= 0) {
+        // n >= 0, k < 0.
+        return integer<SSize>{};
+    }
+    // n < 0, k < 0.
+    if (k <= n) {
+        // The formula is: (-1)**(n-k) * binomial(-k-1,n-k).
+        // Cache n-k.
+        const integer<SSize> nmk{n - k};
+        integer<SSize> tmp{k};
+        ++tmp;
+        tmp.neg();
+        auto retval = bin_ui(tmp, integer_exp_to_ulong(nmk));
+        if (nmk.odd_p()) {
+            retval.neg();
+        }
+        return retval;
+    }
+    return integer<SSize>{};
 }
 
-namespace detail
+template <typename T, std::size_t SSize, enable_if_t<is_integral<T>::value, int> = 0>
+inline integer<SSize> binomial_impl(const T &n, const integer<SSize> &k)
 {
+    return binomial_impl(integer<SSize>{n}, k);
+}
+} // namespace detail
 
-// mpn/mpz implementation.
-template <std::size_t SSize>
-inline void static_gcd_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2)
+// Generic binomial coefficient.
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T, typename U>
+    requires integer_integral_op_types<T, U>
+inline auto
+#else
+template <typename T, typename U, detail::enable_if_t<are_integer_integral_op_types<T, U>::value, int> = 0>
+inline detail::integer_common_t<T, U>
+#endif
+binomial(const T &n, const U &k)
 {
-    // NOTE: performance testing indicates that, even if mpz_gcd() does special casing
-    // for zeroes and 1-limb values, it is still worth it to repeat the special casing
-    // here. This is probably because if we manage to actually call mpn_gcd_1() here,
-    // we avoid interacting with dynamically allocated memory below in the thread-local
-    // object. If we ever start using mpn_gcd(), we will probably have to re-do a
-    // performance analysis.
-    //
-    // Handle zeroes.
-    if (!asize1) {
-        // NOTE: we want the result to be positive, and to copy only the set limbs.
-        rop._mp_size = asize2;
-        copy_limbs(op2.m_limbs.data(), op2.m_limbs.data() + asize2, rop.m_limbs.data());
-        return;
-    }
-    if (!asize2) {
-        rop._mp_size = asize1;
-        copy_limbs(op1.m_limbs.data(), op1.m_limbs.data() + asize1, rop.m_limbs.data());
-        return;
-    }
-    // Special casing if an operand has asize 1.
-    if (asize1 == 1) {
-        rop._mp_size = 1;
-        rop.m_limbs[0] = mpn_gcd_1(op2.m_limbs.data(), static_cast<::mp_size_t>(asize2), op1.m_limbs[0]);
-        return;
-    }
-    if (asize2 == 1) {
-        rop._mp_size = 1;
-        rop.m_limbs[0] = mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
-        return;
-    }
-    // General case, via mpz.
-    // NOTE: there is an mpn_gcd() function, but it seems difficult to use. Apparently, and contrary to
-    // what stated in the latest documentation, the mpn function requires odd operands and bit size
-    // (not only limb size!) of the second operand not greater than the first. See for instance the old
-    // documentation:
-    // ftp://ftp.gnu.org/old-gnu/Manuals/gmp-3.1.1/html_chapter/gmp_9.html
-    // Indeed, compiling GMP in debug mode and then trying to use the mpn function without respecting the above
-    // results in assertion failures. For now let's keep it like this, the small operand cases are handled above
-    // (partially) via mpn_gcd_1(), and in the future we can also think about binary GCD for 1/2 limbs optimisation.
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    const auto v1 = op1.get_mpz_view();
-    const auto v2 = op2.get_mpz_view();
-    mpz_gcd(&tmp.m_mpz, &v1, &v2);
-    // Copy over.
-    rop._mp_size = tmp.m_mpz._mp_size;
-    assert(rop._mp_size > 0);
-    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + rop._mp_size, rop.m_limbs.data());
+    return detail::binomial_impl(n, k);
 }
 
-// 1-limb optimization.
-inline void static_gcd_impl(static_int<1> &rop, const static_int<1> &op1, const static_int<1> &op2, mpz_size_t asize1,
-                            mpz_size_t asize2)
+namespace detail
 {
-    // Handle the special cases first.
-    if (asize1 == 0) {
-        // gcd(0, n) = abs(n). This also covers the convention
-        // that gcd(0, 0) = 0.
-        // NOTE: don't use the copy assignment operator of static_int,
-        // as the size needs to be set to positive.
-        rop._mp_size = asize2;
-        rop.m_limbs = op2.m_limbs;
-        return;
-    }
-    if (asize2 == 0) {
-        // gcd(n, 0) = abs(n).
-        // NOTE: op1 is not zero, its size can only be 1.
-        rop._mp_size = 1;
-        rop.m_limbs = op1.m_limbs;
-        return;
-    }
-    // At this point, asize1 == asize2 == 1, and the result
-    // will also have size 1.
-    rop._mp_size = 1;
-    // Compute the limb value.
-    // NOTE: as an alternative, here we could have a custom binary GCD. See for
-    // instance this implementation by Howard Hinnant using compiler intrinsics:
-    // https://groups.google.com/a/isocpp.org/forum/#!topic/std-proposals/8WB2Z9d7A0w
-    // Testing however shows that mpn_gcd_1() is quite well optimised, so let's
-    // use it and keep in mind the option about the binary GCD for the future.
-    // NOTE: at the commit c146af86e416cf1348d0b3fc454600b47b523f4f we have an implementation
-    // of the binary GCD, just in case.
-    // NOTE: currently, the binary GCD is faster on Zen processors, but I believe
-    // that is because the current GMP version does not have optimised GCD assembly for Zen.
-    // We need to benchmark again when the next GMP version comes out. If the binary GCD
-    // is still faster, we should consider using it instead of mpn_gcd_1(), as even on Intel
-    // processors the binary GCD is only marginally slower than mpn_gcd_1().
-    rop.m_limbs[0] = mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(1), op2.m_limbs[0]);
-}
 
 template <std::size_t SSize>
-inline void static_gcd(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+inline void nextprime_impl(integer<SSize> &rop, const integer<SSize> &n)
 {
-    static_gcd_impl(rop, op1, op2, std::abs(op1._mp_size), std::abs(op2._mp_size));
-    if (SSize > 1u) {
-        // If we used the generic function, zero the unused limbs on top (if necessary).
-        // NOTE: as usual, potential of mpn/mpz use on optimised size (e.g., with 2-limb
-        // static ints we are currently invoking mpz_gcd() - this could produce a result
-        // with only the lower limb, and the higher limb is not zeroed out).
-        rop.zero_unused_limbs();
-    }
+    const mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    mpz_nextprime(&tmp.m_mpz, n.get_mpz_view());
+    mb.escape([&]() { rop = &tmp.m_mpz; });
 }
 } // namespace detail
 
-// GCD (ternary version).
+// Compute next prime number (binary version).
 template <std::size_t SSize>
-inline integer<SSize> &gcd(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &nextprime(integer<SSize> &rop, const integer<SSize> &n)
 {
-    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sr) {
-            rop.set_zero();
-        }
-        static_gcd(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
-    }
-    mpz_gcd(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    // NOTE: nextprime on negative numbers always returns 2.
+    detail::nextprime_impl(rop, n);
     return rop;
 }
 
-// GCD (binary version).
+// Compute next prime number (unary version).
 template <std::size_t SSize>
-inline integer<SSize> gcd(const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> nextprime(const integer<SSize> &n)
 {
     integer<SSize> retval;
-    gcd(retval, op1, op2);
+    detail::nextprime_impl(retval, n);
     return retval;
 }
 
-namespace detail
+// Test primality.
+template <std::size_t SSize>
+inline int probab_prime_p(const integer<SSize> &n, int reps = 25)
 {
+    return n.probab_prime_p(reps);
+}
 
-// The general-purpose implementation of ternary LCM.
+// Ternary exponentiation.
 template <std::size_t SSize>
-inline void integer_ternary_lcm_generic(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &pow_ui(integer<SSize> &rop, const integer<SSize> &base, unsigned long exp)
 {
-    // Temporary working variable.
-    MPPP_MAYBE_TLS integer<SSize> g;
-
-    // rop = (abs(op1) / gcd(op1, op2)) * abs(op2).
-    gcd(g, op1, op2);
-    divexact_gcd(g, op1, g);
-    mul(g, g, op2);
-    abs(rop, g);
+    const detail::mpz_default_memory_binding mb;
+    MPPP_MAYBE_TLS detail::mpz_raii tmp;
+    mpz_pow_ui(&tmp.m_mpz, base.get_mpz_view(), exp);
+    return mb.escape([&]() -> integer<SSize> & { return rop = &tmp.m_mpz; });
 }
 
+// Binary exponentiation.
 template <std::size_t SSize>
-inline void integer_ternary_lcm_impl(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> pow_ui(const integer<SSize> &base, unsigned long exp)
 {
-    integer_ternary_lcm_generic(rop, op1, op2);
+    integer<SSize> retval;
+    pow_ui(retval, base, exp);
+    return retval;
 }
 
-inline void integer_ternary_lcm_impl(integer<1> &rop, const integer<1> &op1, const integer<1> &op2)
+namespace detail
 {
-    if (mppp_likely(op1.is_static() && op2.is_static())) {
-        // NOTE: the idea here is that if both op1 and op2
-        // are static, we can use static integer primitives
-        // directly in parts of the algorithm, thus avoiding
-        // branching wrt the general-purpose primitives.
-        integer<1> g;
 
-        auto &g_st = g._get_union().g_st();
-        const auto &op1_st = op1._get_union().g_st();
-        const auto &op2_st = op2._get_union().g_st();
+// Various helpers for the implementation of pow().
+template <typename T, enable_if_t<is_integral<T>::value, int> = 0>
+inline bool integer_exp_is_odd(const T &exp)
+{
+    return (exp % T(2)) != T(0);
+}
 
-        // Use the static primitives for the first two
-        // steps, as we are sure that no overflow
-        // is possible.
-        static_gcd(g_st, op1_st, op2_st);
-        static_divexact_gcd(g_st, op1_st, g_st);
+template <std::size_t SSize>
+inline bool integer_exp_is_odd(const integer<SSize> &exp)
+{
+    return exp.odd_p();
+}
 
-        // Switch to the general-purpose multiplication,
-        // as the result could overflow.
-        // NOTE: perhaps using the static mul primitive
-        // here could help us squeeze a bit extra performance,
-        // at the price of duplicating the overflow handling
-        // logic. Keep in mind for the future.
-        mul(rop, g, op2);
-        // Turn rop into abs(rop).
-        // NOTE: this is always safe to do because
-        // rop will consist of at most 2 limbs.
-        rop._get_union().m_st._mp_size = std::abs(rop._get_union().m_st._mp_size);
+// Implementation of pow().
+// integer -- integral overload.
+template <typename T, std::size_t SSize,
+          enable_if_t<disjunction<std::is_same<T, integer<SSize>>, is_integral<T>>::value, int> = 0>
+inline integer<SSize> pow_impl(const integer<SSize> &base, const T &exp)
+{
+    integer<SSize> rop;
+    if (sgn(exp) >= 0) {
+        pow_ui(rop, base, integer_exp_to_ulong(exp));
+    } else if (mppp_unlikely(is_zero(base))) {
+        // 0**-n is a division by zero.
+        throw zero_division_error("Cannot raise zero to the negative power " + detail::to_string(exp));
+    } else if (base.is_one()) {
+        // 1**-n == 1.
+        rop.set_one();
+    } else if (base.is_negative_one()) {
+        if (integer_exp_is_odd(exp)) {
+            // (-1)**(-2n-1) == -1.
+            rop.set_negative_one();
+        } else {
+            // (-1)**(-2n) == 1.
+            rop.set_one();
+        }
     } else {
-        // op1/op2 are not both statics. Run
-        // the general-purpose implementation.
-        integer_ternary_lcm_generic(rop, op1, op2);
+        // m**-n == 1 / m**n == 0, truncated division.
+        rop.set_zero();
     }
+    return rop;
+}
+
+// C++ integral -- integer overload.
+template <typename T, std::size_t SSize, enable_if_t<is_integral<T>::value, int> = 0>
+inline integer<SSize> pow_impl(const T &base, const integer<SSize> &exp)
+{
+    return pow_impl(integer<SSize>{base}, exp);
+}
+
+// integer -- FP/complex overload.
+template <typename T, std::size_t SSize,
+          enable_if_t<disjunction<std::is_floating_point<T>, is_cpp_complex<T>>::value, int> = 0>
+inline T pow_impl(const integer<SSize> &base, const T &exp)
+{
+    return std::pow(static_cast<T>(base), exp);
+}
+
+// FP/complex -- integer overload.
+template <typename T, std::size_t SSize,
+          enable_if_t<disjunction<std::is_floating_point<T>, is_cpp_complex<T>>::value, int> = 0>
+inline T pow_impl(const T &base, const integer<SSize> &exp)
+{
+    return std::pow(base, static_cast<T>(exp));
 }
 
 } // namespace detail
 
-// LCM (ternary version).
-template <std::size_t SSize>
-inline integer<SSize> &lcm(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+// Generic binary exponentiation.
+template <typename T, typename U>
+#if defined(MPPP_HAVE_CONCEPTS)
+    requires integer_op_types<T, U>
+inline auto
+#else
+inline detail::integer_common_t<T, U>
+#endif
+pow(const T &base, const U &exp)
 {
-    // Handle the special case lcm(0, 0) == 0.
-    if (mppp_unlikely(op1.is_zero() && op2.is_zero())) {
-        rop.set_zero();
-    } else {
-        detail::integer_ternary_lcm_impl(rop, op1, op2);
-    }
-
-    return rop;
+    return detail::pow_impl(base, exp);
 }
 
 namespace detail
 {
 
-// The general-purpose implementation of binary LCM.
-template <std::size_t SSize>
-inline integer<SSize> integer_binary_lcm_generic(const integer<SSize> &op1, const integer<SSize> &op2)
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+
+// 1-limb Montgomery multiplication via dlimb: returns a * b * 2**-GMP_NUMB_BITS mod m.
+// NOTE: a and b must be less than m, minv must be -m**-1 modulo 2**GMP_NUMB_BITS.
+inline ::mp_limb_t mont_mul_1(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t m, ::mp_limb_t minv)
 {
-    // retval = (abs(op1) / gcd(op1, op2)) * abs(op2).
-    auto retval = gcd(op1, op2);
-    divexact_gcd(retval, op1, retval);
-    mul(retval, retval, op2);
-    abs(retval, retval);
+    // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+    ::mp_limb_t hi, u_hi, ret;
+    const auto lo = dlimb_mul(a, b, &hi);
+    dlimb_mul(static_cast<::mp_limb_t>(lo * minv), m, &u_hi);
 
-    return retval;
-}
+    // NOTE: by construction, the low limb of lo + u * m is zero, and the addition
+    // produces a carry iff lo is nonzero. Because hi < m - 1, hi + 1 cannot overflow.
+    const auto cy = limb_add_overflow(hi + static_cast<::mp_limb_t>(lo != 0u), u_hi, &ret);
 
-template <std::size_t SSize>
-inline integer<SSize> integer_binary_lcm_impl(const integer<SSize> &op1, const integer<SSize> &op2)
-{
-    return integer_binary_lcm_generic(op1, op2);
-}
+    // The result is less than 2 * m, a single conditional subtraction is enough.
+    // NOTE: the condition is unpredictable, use a mask instead of a branch.
+    const auto mask = static_cast<::mp_limb_t>(::mp_limb_t(0) - ::mp_limb_t((cy != 0u) | (ret >= m)));
 
-inline integer<1> integer_binary_lcm_impl(const integer<1> &op1, const integer<1> &op2)
-{
-    if (mppp_likely(op1.is_static() && op2.is_static())) {
-        integer<1> retval;
+    return static_cast<::mp_limb_t>(ret - (m & mask));
+}
 
-        auto &r_st = retval._get_union().g_st();
-        const auto &op1_st = op1._get_union().g_st();
-        const auto &op2_st = op2._get_union().g_st();
+#endif
 
-        static_gcd(r_st, op1_st, op2_st);
-        static_divexact_gcd(r_st, op1_st, r_st);
+// Montgomery reduction of the 2 * n limbs in tp, whose value must be less than m * 2**(n * GMP_NUMB_BITS).
+// The fully reduced result is written into the n limbs of rp. tp is destroyed.
+// NOTE: this is the one-limb-at-a-time REDC in the variant used by GMP's mpn_redc_1():
+// each step clears a low limb of tp, and we stash the carry of the step there. The
+// carries are then added back to the high half in one go at the end.
+inline void mont_redc_n(::mp_limb_t *rp, ::mp_limb_t *tp, const ::mp_limb_t *mp, std::size_t n, ::mp_limb_t minv)
+{
+    const auto sn = static_cast<::mp_size_t>(n);
 
-        mul(retval, retval, op2);
-        // Turn retval into abs(retval).
-        // NOTE: this is always safe to do because
-        // rop will consist of at most 2 limbs.
-        retval._get_union().m_st._mp_size = std::abs(retval._get_union().m_st._mp_size);
+    for (std::size_t i = 0; i < n; ++i) {
+        tp[i] = mpn_addmul_1(tp + i, mp, sn, static_cast<::mp_limb_t>(tp[i] * minv));
+    }
 
-        return retval;
-    } else {
-        return integer_binary_lcm_generic(op1, op2);
+    if (mpn_add_n(rp, tp + n, tp, sn) != 0u || mpn_cmp(rp, mp, sn) >= 0) {
+        mpn_sub_n(rp, rp, mp, sn);
     }
 }
 
+// The implementation strategies of mod_context.
+enum class mod_context_algo : unsigned char {
+    // mpz functions.
+    generic,
+    // Even 1-limb modulus, double-limb multiplication and remainder.
+    dlimb,
+    // Odd 1-limb modulus, Montgomery multiplication via double-limb multiplication.
+    mont_1,
+    // Odd n-limb modulus, Montgomery multiplication via the mpn functions.
+    mont_n
+};
+
 } // namespace detail
 
-// LCM (binary version).
-// NOTE: don't implement on top of the ternary primitives, a custom
-// implementation avoids the creation of an unnecessary temporary.
+// Modular arithmetic context.
+// NOTE: the modulus is fixed at construction time, and the constants needed by
+// the reduction algorithm are precomputed once. All results are in the [0, |mod|) range.
 template <std::size_t SSize>
-inline integer<SSize> lcm(const integer<SSize> &op1, const integer<SSize> &op2)
+class mod_context
 {
-    // Handle the special case lcm(0, 0) == 0.
-    if (mppp_unlikely(op1.is_zero() && op2.is_zero())) {
-        return integer<SSize>{};
-    } else {
-        return detail::integer_binary_lcm_impl(op1, op2);
+    // Fixed-size limb storage. The non-generic
+    // algorithms are used only if the modulus fits.
+    using limbs_t = std::array<::mp_limb_t, SSize>;
+
+public:
+    // Constructor from modulus.
+    explicit mod_context(const integer<SSize> &mod) : m_mod(mod)
+    {
+        if (mppp_unlikely(m_mod.sgn() == 0)) {
+            throw zero_division_error("Cannot construct a modular arithmetic context with a zero modulus");
+        }
+
+        m_mod.abs();
+        m_nlimbs = m_mod.size();
+
+        // NOTE: the non-generic algorithms do not do any masking,
+        // so we use them only if there are no nail bits.
+        if (GMP_NAIL_BITS != 0 || m_nlimbs > SSize) {
+            return;
+        }
+
+        const ::mp_limb_t *mptr
+            = m_mod.is_static() ? m_mod._get_union().g_st().m_limbs.data() : m_mod._get_union().g_dy()._mp_d;
+        detail::copy_limbs_no(mptr, mptr + m_nlimbs, m_mod_limbs.data());
+
+        if (m_mod.odd_p()) {
+            m_algo = (m_nlimbs == 1u && detail::integer_have_dlimb_mul::value) ? detail::mod_context_algo::mont_1
+                                                                                : detail::mod_context_algo::mont_n;
+            m_minv = detail::mont_neg_inverse(m_mod_limbs[0]);
+
+            // Compute R mod m and R**2 mod m, with R = 2**(nlimbs * GMP_NUMB_BITS).
+            detail::mpz_raii tmp;
+            mpz_set_ui(&tmp.m_mpz, 1u);
+            mpz_mul_2exp(&tmp.m_mpz, &tmp.m_mpz, static_cast<::mp_bitcnt_t>(m_nlimbs * unsigned(GMP_NUMB_BITS)));
+            mpz_mod(&tmp.m_mpz, &tmp.m_mpz, m_mod.get_mpz_view());
+            copy_padded(m_one, &tmp.m_mpz);
+            mpz_mul(&tmp.m_mpz, &tmp.m_mpz, &tmp.m_mpz);
+            mpz_mod(&tmp.m_mpz, &tmp.m_mpz, m_mod.get_mpz_view());
+            copy_padded(m_r2, &tmp.m_mpz);
+        } else if (m_nlimbs == 1u && detail::integer_have_dlimb_mul::value
+                   && detail::integer_have_dlimb_div::value) {
+            m_algo = detail::mod_context_algo::dlimb;
+            // NOTE: an even modulus is at least 2.
+            m_one[0] = 1u;
+        }
     }
-}
 
-// Factorial.
-template <std::size_t SSize>
-inline integer<SSize> &fac_ui(integer<SSize> &rop, unsigned long n)
-{
-    // NOTE: we put a limit here because the GMP function just crashes and burns
-    // if n is too large, and n does not even need to be that large.
-    constexpr auto max_fac = 1000000ull;
-    if (mppp_unlikely(n > max_fac)) {
-        throw std::invalid_argument(
-            "The value " + detail::to_string(n)
-            + " is too large to be used as input for the factorial function (the maximum allowed value is "
-            + detail::to_string(max_fac) + ")");
+    // Getters.
+    MPPP_NODISCARD const integer<SSize> &get_mod() const
+    {
+        return m_mod;
+    }
+    MPPP_NODISCARD bool is_montgomery() const
+    {
+        return m_algo == detail::mod_context_algo::mont_1 || m_algo == detail::mod_context_algo::mont_n;
     }
-    // NOTE: let's get through a static temporary and then assign it to the rop,
-    // so that rop will be static/dynamic according to the size of tmp.
-    MPPP_MAYBE_TLS detail::mpz_raii tmp;
-    mpz_fac_ui(&tmp.m_mpz, n);
-    return rop = &tmp.m_mpz;
-}
 
-// Binomial coefficient (ternary version).
-template <std::size_t SSize>
-inline integer<SSize> &bin_ui(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
-{
-    MPPP_MAYBE_TLS detail::mpz_raii tmp;
-    mpz_bin_ui(&tmp.m_mpz, n.get_mpz_view(), k);
-    return rop = &tmp.m_mpz;
-}
+    // Modular multiplication.
+    integer<SSize> &mulm(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2) const
+    {
+        if (m_algo == detail::mod_context_algo::generic) {
+            const detail::mpz_default_memory_binding mb;
+            MPPP_MAYBE_TLS detail::mpz_raii tmp;
+            mpz_mul(&tmp.m_mpz, op1.get_mpz_view(), op2.get_mpz_view());
+            mpz_mod(&tmp.m_mpz, &tmp.m_mpz, m_mod.get_mpz_view());
+            return mb.escape([&]() -> integer<SSize> & { return rop = &tmp.m_mpz; });
+        }
 
-// Binomial coefficient (binary version).
-template <std::size_t SSize>
-inline integer<SSize> bin_ui(const integer<SSize> &n, unsigned long k)
-{
-    integer<SSize> retval;
-    bin_ui(retval, n, k);
-    return retval;
-}
+#if defined(MPPP_HAVE_DLIMB_T)
+        if (m_nlimbs == 1u) {
+            return write_result_1(rop, detail::static_mulm_impl_1(reduce_1(op1), reduce_1(op2), m_mod_limbs[0]));
+        }
+#endif
 
-namespace detail
-{
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        limbs_t a, b;
+        reduce(a, op1);
+        reduce(b, op2);
+        plain_mul(a.data(), a.data(), b.data());
 
-// These helpers are used here and in pow() as well.
-template <typename T, enable_if_t<is_integral<T>::value, int> = 0>
-inline unsigned long integer_exp_to_ulong(const T &exp)
-{
-#if !defined(__INTEL_COMPILER)
-    assert(exp >= T(0));
+        return write_result(rop, a);
+    }
+    // Modular squaring.
+    integer<SSize> &sqrm(integer<SSize> &rop, const integer<SSize> &op) const
+    {
+        if (m_algo == detail::mod_context_algo::generic) {
+            const detail::mpz_default_memory_binding mb;
+            MPPP_MAYBE_TLS detail::mpz_raii tmp;
+            mpz_mul(&tmp.m_mpz, op.get_mpz_view(), op.get_mpz_view());
+            mpz_mod(&tmp.m_mpz, &tmp.m_mpz, m_mod.get_mpz_view());
+            return mb.escape([&]() -> integer<SSize> & { return rop = &tmp.m_mpz; });
+        }
+
+#if defined(MPPP_HAVE_DLIMB_T)
+        if (m_nlimbs == 1u) {
+            const auto a = reduce_1(op);
+            return write_result_1(rop, detail::static_mulm_impl_1(a, a, m_mod_limbs[0]));
+        }
 #endif
-    // NOTE: make_unsigned_t<T> is T if T is already unsigned.
-    // Don't use the make_unsigned() helper, as exp might be
-    // unsigned already.
-    static_assert(!std::is_same<T, bool>::value, "Cannot use the bool type in make_unsigned_t.");
-    if (mppp_unlikely(static_cast<make_unsigned_t<T>>(exp) > nl_max<unsigned long>())) {
-        throw std::overflow_error("Cannot convert the integral value " + detail::to_string(exp)
-                                  + " to unsigned long: the value is too large");
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        limbs_t a;
+        reduce(a, op);
+        plain_mul(a.data(), a.data(), a.data());
+
+        return write_result(rop, a);
     }
-    return static_cast<unsigned long>(exp);
-}
+    // Modular exponentiation.
+    // NOTE: negative exponents are allowed if base is invertible modulo the modulus.
+    integer<SSize> &powm(integer<SSize> &rop, const integer<SSize> &base, const integer<SSize> &exp) const
+    {
+        return multi_powm(rop, &base, &exp, 1);
+    }
+    // Modular multi-exponentiation: computes the product of bases[i]**exps[i], modulo the modulus.
+    integer<SSize> &multi_powm(integer<SSize> &rop, const integer<SSize> *bases, const integer<SSize> *exps,
+                               std::size_t n) const
+    {
+        if (m_algo == detail::mod_context_algo::generic) {
+            const detail::mpz_default_memory_binding mb;
+            MPPP_MAYBE_TLS detail::mpz_raii acc, tmp;
+            mpz_set_ui(&acc.m_mpz, 1u);
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto e_view = exps[i].get_mpz_view();
+                // NOTE: pass the absolute value of the exponent
+                // to mpz_powm() via a read-only copy of the view.
+                auto e_abs = *e_view.get();
+                e_abs._mp_size = static_cast<detail::mpz_size_t>(exps[i].size());
+                if (exps[i].sgn() < 0) {
+                    invert(&tmp.m_mpz, bases[i]);
+                    mpz_powm(&tmp.m_mpz, &tmp.m_mpz, &e_abs, m_mod.get_mpz_view());
+                } else {
+                    mpz_powm(&tmp.m_mpz, bases[i].get_mpz_view(), &e_abs, m_mod.get_mpz_view());
+                }
+                mpz_mul(&acc.m_mpz, &acc.m_mpz, &tmp.m_mpz);
+                mpz_mod(&acc.m_mpz, &acc.m_mpz, m_mod.get_mpz_view());
+            }
+            return mb.escape([&]() -> integer<SSize> & { return rop = &acc.m_mpz; });
+        }
+
+        // Bring the bases into the working domain (Montgomery
+        // form or plain residues), and determine the max bit size of the exponents.
+        MPPP_MAYBE_TLS std::vector<limbs_t> dbases;
+        // NOTE: cache also the limb pointers and sizes of the exponents,
+        // so that the bit tests in the main loop are cheap.
+        MPPP_MAYBE_TLS std::vector<std::pair<const ::mp_limb_t *, std::size_t>> elimbs;
+        dbases.resize(n);
+        elimbs.resize(n);
+        std::size_t max_nbits = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            elimbs[i].first = exps[i].is_static() ? exps[i]._get_union().g_st().m_limbs.data()
+                                                  : exps[i]._get_union().g_dy()._mp_d;
+            elimbs[i].second = exps[i].size();
+            if (exps[i].sgn() < 0) {
+                const detail::mpz_default_memory_binding mb;
+                MPPP_MAYBE_TLS detail::mpz_raii inv;
+                invert(&inv.m_mpz, bases[i]);
+                copy_padded(dbases[i], &inv.m_mpz);
+            } else {
+                reduce(dbases[i], bases[i]);
+            }
+            to_dom(dbases[i].data(), dbases[i].data());
+            max_nbits = std::max(max_nbits, exps[i].nbits());
+        }
+
+        // Left-to-right binary exponentiation, with the squarings
+        // shared among all the bases (Straus' algorithm).
+        limbs_t acc = m_one;
+        bool first = true;
+        for (auto bit = max_nbits; bit > 0u; --bit) {
+            const auto idx = bit - 1u;
+            if (!first) {
+                dom_mul(acc.data(), acc.data(), acc.data());
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                if (exp_bit(elimbs[i].first, elimbs[i].second, idx)) {
+                    if (first) {
+                        acc = dbases[i];
+                        first = false;
+                    } else {
+                        dom_mul(acc.data(), acc.data(), dbases[i].data());
+                    }
+                }
+            }
+        }
+        from_dom(acc.data(), acc.data());
 
-// NOTE: special case bool, otherwise we end up invoking make_unsigned_t<bool> in the
-// previous overload, which is not well-defined:
-// https://en.cppreference.com/w/cpp/types/make_unsigned
-inline unsigned long integer_exp_to_ulong(bool exp)
-{
+        return write_result(rop, acc);
+    }
 
-    return static_cast<unsigned long>(exp);
-}
+private:
+    // Copy the limbs of the nonnegative value n into out, zero-padding up to m_nlimbs.
+    void copy_padded(limbs_t &out, const detail::mpz_struct_t *n) const
+    {
+        const auto size = static_cast<std::size_t>(n->_mp_size);
+        assert(size <= m_nlimbs);
+        detail::copy_limbs_no(n->_mp_d, n->_mp_d + size, out.data());
+        std::fill(out.data() + size, out.data() + m_nlimbs, ::mp_limb_t(0));
+    }
+    // Write into out the residue of n in the [0, m) range, zero-padding up to m_nlimbs.
+    void reduce(limbs_t &out, const integer<SSize> &n) const
+    {
+        const auto asize = n.size();
+        const ::mp_limb_t *ptr = n.is_static() ? n._get_union().g_st().m_limbs.data() : n._get_union().g_dy()._mp_d;
+        if (mppp_likely(n.sgn() >= 0
+                        && (asize < m_nlimbs
+                            || (asize == m_nlimbs
+                                && mpn_cmp(ptr, m_mod_limbs.data(), static_cast<::mp_size_t>(asize)) < 0)))) {
+            // Already reduced, just copy it over.
+            detail::copy_limbs(ptr, ptr + asize, out.data());
+            std::fill(out.data() + asize, out.data() + m_nlimbs, ::mp_limb_t(0));
+            return;
+        }
 
-template <std::size_t SSize>
-inline unsigned long integer_exp_to_ulong(const integer<SSize> &exp)
-{
-    try {
-        return static_cast<unsigned long>(exp);
-    } catch (const std::overflow_error &) {
-        // Rewrite the error message.
-        throw std::overflow_error("Cannot convert the integral value " + exp.to_string()
-                                  + " to unsigned long: the value is too large");
+        if (!n.is_static()) {
+            const detail::mpz_default_memory_binding mb;
+            MPPP_MAYBE_TLS detail::mpz_raii tmp;
+            mpz_mod(&tmp.m_mpz, n.get_mpz_view(), m_mod.get_mpz_view());
+            copy_padded(out, &tmp.m_mpz);
+            return;
+        }
+
+        // Static operand: compute the remainder of the absolute value via mpn.
+        if (asize < m_nlimbs) {
+            detail::copy_limbs(ptr, ptr + asize, out.data());
+            std::fill(out.data() + asize, out.data() + m_nlimbs, ::mp_limb_t(0));
+        } else if (m_nlimbs == 1u) {
+            out[0] = asize == 1u ? static_cast<::mp_limb_t>(ptr[0] % m_mod_limbs[0])
+                                 : mpn_mod_1(ptr, static_cast<::mp_size_t>(asize), m_mod_limbs[0]);
+        } else {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            limbs_t q;
+            mpn_tdiv_qr(q.data(), out.data(), 0, ptr, static_cast<::mp_size_t>(asize), m_mod_limbs.data(),
+                        static_cast<::mp_size_t>(m_nlimbs));
+        }
+        // For negative operands, the residue is m - (|n| mod m), unless |n| mod m is zero.
+        if (n.sgn() < 0 && std::any_of(out.data(), out.data() + m_nlimbs, [](::mp_limb_t l) { return l != 0u; })) {
+            mpn_sub_n(out.data(), m_mod_limbs.data(), out.data(), static_cast<::mp_size_t>(m_nlimbs));
+        }
     }
-}
+    // Residue of n for 1-limb moduli.
+    ::mp_limb_t reduce_1(const integer<SSize> &n) const
+    {
+        assert(m_nlimbs == 1u);
+        if (mppp_likely(n.is_static() && n.size() <= 1u)) {
+            // NOTE: cannot read the limb directly if n is zero, as the
+            // unused limbs are zeroed only for the optimised static sizes.
+            const auto m = m_mod_limbs[0], l = n.size() == 0u ? ::mp_limb_t(0) : n._get_union().g_st().m_limbs[0];
+            const auto r = l < m ? l : static_cast<::mp_limb_t>(l % m);
+            return (n.sgn() < 0 && r != 0u) ? static_cast<::mp_limb_t>(m - r) : r;
+        }
 
-template <typename T, std::size_t SSize>
-inline integer<SSize> binomial_impl(const integer<SSize> &n, const T &k)
-{
-    // NOTE: here we re-use some helper member functions used in the implementation of pow().
-    if (sgn(k) >= 0) {
-        return bin_ui(n, integer_exp_to_ulong(k));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        limbs_t out;
+        reduce(out, n);
+        return out[0];
     }
-    // This is the case k < 0, handled according to:
-    // https://arxiv.org/abs/1105.3689/
-    if (n.sgn() >= 0) {
-        // n >= 0, k < 0.
-        return integer<SSize>{};
+    // Write into rop the modular inverse of n.
+    void invert(detail::mpz_struct_t *rop, const integer<SSize> &n) const
+    {
+        if (mppp_unlikely(!mpz_invert(rop, n.get_mpz_view(), m_mod.get_mpz_view()))) {
+            throw zero_division_error("Cannot raise the non-invertible value " + n.to_string()
+                                      + " to a negative power modulo " + m_mod.to_string());
+        }
+    }
+    // Test the bit at index idx in the size limbs at ptr.
+    static bool exp_bit(const ::mp_limb_t *ptr, std::size_t size, std::size_t idx)
+    {
+        const auto lidx = idx / unsigned(GMP_NUMB_BITS);
+        if (lidx >= size) {
+            return false;
+        }
+        return ((ptr[lidx] >> (idx % unsigned(GMP_NUMB_BITS))) & 1u) != 0u;
+    }
+    // Montgomery multiplication: rp = ap * bp * R**-1 mod m.
+    // NOTE: rp may overlap with ap and/or bp.
+    void mont_mul(::mp_limb_t *rp, const ::mp_limb_t *ap, const ::mp_limb_t *bp) const
+    {
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+        if (m_algo == detail::mod_context_algo::mont_1) {
+            rp[0] = detail::mont_mul_1(ap[0], bp[0], m_mod_limbs[0], m_minv);
+            return;
+        }
+#endif
+        assert(m_algo == detail::mod_context_algo::mont_n);
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize * 2u> tp;
+        if (ap == bp) {
+            mpn_sqr(tp.data(), ap, static_cast<::mp_size_t>(m_nlimbs));
+        } else {
+            mpn_mul_n(tp.data(), ap, bp, static_cast<::mp_size_t>(m_nlimbs));
+        }
+        detail::mont_redc_n(rp, tp.data(), m_mod_limbs.data(), m_nlimbs, m_minv);
+    }
+    // Multiplication of plain residues: rp = ap * bp mod m.
+    // NOTE: a single multiplication in Montgomery form requires two
+    // reductions (one for the product, one to convert back to a plain residue),
+    // which is slower than a single division. Thus, mulm() and sqrm() use this function,
+    // and Montgomery multiplication is used only in the exponentiations.
+    // NOTE: rp may overlap with ap and/or bp.
+    void plain_mul(::mp_limb_t *rp, const ::mp_limb_t *ap, const ::mp_limb_t *bp) const
+    {
+#if defined(MPPP_HAVE_DLIMB_T)
+        if (m_nlimbs == 1u) {
+            rp[0] = detail::static_mulm_impl_1(ap[0], bp[0], m_mod_limbs[0]);
+            return;
+        }
+#endif
+
+        const auto n = static_cast<::mp_size_t>(m_nlimbs);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize * 2u> tp;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize + 1u> qp;
+        if (ap == bp) {
+            mpn_sqr(tp.data(), ap, n);
+        } else {
+            mpn_mul_n(tp.data(), ap, bp, n);
+        }
+        mpn_tdiv_qr(qp.data(), rp, 0, tp.data(), 2 * n, m_mod_limbs.data(), n);
+    }
+    // Multiplication in the working domain.
+    void dom_mul(::mp_limb_t *rp, const ::mp_limb_t *ap, const ::mp_limb_t *bp) const
+    {
+#if defined(MPPP_HAVE_DLIMB_T)
+        if (m_algo == detail::mod_context_algo::dlimb) {
+            rp[0] = detail::static_mulm_impl_1(ap[0], bp[0], m_mod_limbs[0]);
+            return;
+        }
+#endif
+        mont_mul(rp, ap, bp);
+    }
+    // Conversions to/from the working domain.
+    void to_dom(::mp_limb_t *rp, const ::mp_limb_t *ap) const
+    {
+        if (is_montgomery()) {
+            mont_mul(rp, ap, m_r2.data());
+        }
+    }
+    void from_dom(::mp_limb_t *rp, const ::mp_limb_t *ap) const
+    {
+        if (is_montgomery()) {
+            // NOTE: a * R**-1, via the reduction of a zero-extended to 2 * n limbs.
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<::mp_limb_t, SSize * 2u> tp;
+            detail::copy_limbs(ap, ap + m_nlimbs, tp.data());
+            std::fill(tp.data() + m_nlimbs, tp.data() + 2u * m_nlimbs, ::mp_limb_t(0));
+            detail::mont_redc_n(rp, tp.data(), m_mod_limbs.data(), m_nlimbs, m_minv);
+        }
+    }
+    // Write the m_nlimbs limbs in r into rop.
+    integer<SSize> &write_result(integer<SSize> &rop, const limbs_t &r) const
+    {
+        auto size = m_nlimbs;
+        while (size != 0u && r[size - 1u] == 0u) {
+            --size;
+        }
+        if (!rop.is_static()) {
+            rop.set_zero();
+        }
+        auto &st = rop._get_union().g_st();
+        detail::copy_limbs(r.data(), r.data() + size, st.m_limbs.data());
+        st._mp_size = static_cast<detail::mpz_size_t>(size);
+        // NOTE: as usual, make sure the unused limbs
+        // are zeroed for the optimised static sizes.
+        st.zero_unused_limbs();
+        return rop;
     }
-    // n < 0, k < 0.
-    if (k <= n) {
-        // The formula is: (-1)**(n-k) * binomial(-k-1,n-k).
-        // Cache n-k.
-        const integer<SSize> nmk{n - k};
-        integer<SSize> tmp{k};
-        ++tmp;
-        tmp.neg();
-        auto retval = bin_ui(tmp, integer_exp_to_ulong(nmk));
-        if (nmk.odd_p()) {
-            retval.neg();
+
+    // Write the limb l into rop.
+    static integer<SSize> &write_result_1(integer<SSize> &rop, ::mp_limb_t l)
+    {
+        if (!rop.is_static()) {
+            rop.set_zero();
         }
-        return retval;
+        auto &st = rop._get_union().g_st();
+        st._mp_size = static_cast<detail::mpz_size_t>(l != 0u);
+        st.m_limbs[0] = l;
+        st.zero_unused_limbs();
+        return rop;
     }
-    return integer<SSize>{};
-}
 
-template <typename T, std::size_t SSize, enable_if_t<is_integral<T>::value, int> = 0>
-inline integer<SSize> binomial_impl(const T &n, const integer<SSize> &k)
-{
-    return binomial_impl(integer<SSize>{n}, k);
-}
-} // namespace detail
+    integer<SSize> m_mod;
+    std::size_t m_nlimbs = 0;
+    detail::mod_context_algo m_algo = detail::mod_context_algo::generic;
+    ::mp_limb_t m_minv = 0;
+    // NOTE: m_one is the representation of 1
+    // in the working domain, m_r2 is R**2 mod m.
+    limbs_t m_mod_limbs{}, m_one{}, m_r2{};
+};
 
-// Generic binomial coefficient.
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T, typename U>
-    requires integer_integral_op_types<T, U>
-inline auto
-#else
-template <typename T, typename U, detail::enable_if_t<are_integer_integral_op_types<T, U>::value, int> = 0>
-inline detail::integer_common_t<T, U>
-#endif
-binomial(const T &n, const U &k)
+// Ternary modular multiplication.
+template <std::size_t SSize>
+inline integer<SSize> &mulm(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2,
+                            const mod_context<SSize> &ctx)
 {
-    return detail::binomial_impl(n, k);
+    return ctx.mulm(rop, op1, op2);
 }
 
-namespace detail
-{
-
+// Binary modular multiplication.
 template <std::size_t SSize>
-inline void nextprime_impl(integer<SSize> &rop, const integer<SSize> &n)
+inline integer<SSize> mulm(const integer<SSize> &op1, const integer<SSize> &op2, const mod_context<SSize> &ctx)
 {
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    mpz_nextprime(&tmp.m_mpz, n.get_mpz_view());
-    rop = &tmp.m_mpz;
+    integer<SSize> retval;
+    ctx.mulm(retval, op1, op2);
+    return retval;
 }
-} // namespace detail
 
-// Compute next prime number (binary version).
+// Ternary modular squaring with context.
 template <std::size_t SSize>
-inline integer<SSize> &nextprime(integer<SSize> &rop, const integer<SSize> &n)
+inline integer<SSize> &sqrm(integer<SSize> &rop, const integer<SSize> &op, const mod_context<SSize> &ctx)
 {
-    // NOTE: nextprime on negative numbers always returns 2.
-    detail::nextprime_impl(rop, n);
-    return rop;
+    return ctx.sqrm(rop, op);
 }
 
-// Compute next prime number (unary version).
+// Binary modular squaring with context.
 template <std::size_t SSize>
-inline integer<SSize> nextprime(const integer<SSize> &n)
+inline integer<SSize> sqrm(const integer<SSize> &op, const mod_context<SSize> &ctx)
 {
     integer<SSize> retval;
-    detail::nextprime_impl(retval, n);
+    ctx.sqrm(retval, op);
     return retval;
 }
 
-// Test primality.
-template <std::size_t SSize>
-inline int probab_prime_p(const integer<SSize> &n, int reps = 25)
-{
-    return n.probab_prime_p(reps);
-}
-
-// Ternary exponentiation.
+// Ternary modular exponentiation with context.
 template <std::size_t SSize>
-inline integer<SSize> &pow_ui(integer<SSize> &rop, const integer<SSize> &base, unsigned long exp)
+inline integer<SSize> &powm(integer<SSize> &rop, const integer<SSize> &base, const integer<SSize> &exp,
+                            const mod_context<SSize> &ctx)
 {
-    MPPP_MAYBE_TLS detail::mpz_raii tmp;
-    mpz_pow_ui(&tmp.m_mpz, base.get_mpz_view(), exp);
-    return rop = &tmp.m_mpz;
+    return ctx.powm(rop, base, exp);
 }
 
-// Binary exponentiation.
+// Binary modular exponentiation with context.
 template <std::size_t SSize>
-inline integer<SSize> pow_ui(const integer<SSize> &base, unsigned long exp)
+inline integer<SSize> powm(const integer<SSize> &base, const integer<SSize> &exp, const mod_context<SSize> &ctx)
 {
     integer<SSize> retval;
-    pow_ui(retval, base, exp);
+    ctx.powm(retval, base, exp);
     return retval;
 }
 
-namespace detail
-{
-
-// Various helpers for the implementation of pow().
-template <typename T, enable_if_t<is_integral<T>::value, int> = 0>
-inline bool integer_exp_is_odd(const T &exp)
-{
-    return (exp % T(2)) != T(0);
-}
-
+// Ternary modular exponentiation.
 template <std::size_t SSize>
-inline bool integer_exp_is_odd(const integer<SSize> &exp)
-{
-    return exp.odd_p();
-}
-
-// Implementation of pow().
-// integer -- integral overload.
-template <typename T, std::size_t SSize,
-          enable_if_t<disjunction<std::is_same<T, integer<SSize>>, is_integral<T>>::value, int> = 0>
-inline integer<SSize> pow_impl(const integer<SSize> &base, const T &exp)
-{
-    integer<SSize> rop;
-    if (sgn(exp) >= 0) {
-        pow_ui(rop, base, integer_exp_to_ulong(exp));
-    } else if (mppp_unlikely(is_zero(base))) {
-        // 0**-n is a division by zero.
-        throw zero_division_error("Cannot raise zero to the negative power " + detail::to_string(exp));
-    } else if (base.is_one()) {
-        // 1**-n == 1.
-        rop.set_one();
-    } else if (base.is_negative_one()) {
-        if (integer_exp_is_odd(exp)) {
-            // (-1)**(-2n-1) == -1.
-            rop.set_negative_one();
-        } else {
-            // (-1)**(-2n) == 1.
-            rop.set_one();
-        }
-    } else {
-        // m**-n == 1 / m**n == 0, truncated division.
-        rop.set_zero();
-    }
-    return rop;
-}
-
-// C++ integral -- integer overload.
-template <typename T, std::size_t SSize, enable_if_t<is_integral<T>::value, int> = 0>
-inline integer<SSize> pow_impl(const T &base, const integer<SSize> &exp)
-{
-    return pow_impl(integer<SSize>{base}, exp);
-}
-
-// integer -- FP/complex overload.
-template <typename T, std::size_t SSize,
-          enable_if_t<disjunction<std::is_floating_point<T>, is_cpp_complex<T>>::value, int> = 0>
-inline T pow_impl(const integer<SSize> &base, const T &exp)
+inline integer<SSize> &powm(integer<SSize> &rop, const integer<SSize> &base, const integer<SSize> &exp,
+                            const integer<SSize> &mod)
 {
-    return std::pow(static_cast<T>(base), exp);
+    return mod_context<SSize>(mod).powm(rop, base, exp);
 }
 
-// FP/complex -- integer overload.
-template <typename T, std::size_t SSize,
-          enable_if_t<disjunction<std::is_floating_point<T>, is_cpp_complex<T>>::value, int> = 0>
-inline T pow_impl(const T &base, const integer<SSize> &exp)
+// Binary modular exponentiation.
+template <std::size_t SSize>
+inline integer<SSize> powm(const integer<SSize> &base, const integer<SSize> &exp, const integer<SSize> &mod)
 {
-    return std::pow(base, static_cast<T>(exp));
+    integer<SSize> retval;
+    powm(retval, base, exp, mod);
+    return retval;
 }
 
-} // namespace detail
-
-// Generic binary exponentiation.
-template <typename T, typename U>
-#if defined(MPPP_HAVE_CONCEPTS)
-    requires integer_op_types<T, U>
-inline auto
-#else
-inline detail::integer_common_t<T, U>
-#endif
-pow(const T &base, const U &exp)
+// Modular multi-exponentiation.
+template <std::size_t SSize>
+inline integer<SSize> &multi_powm(integer<SSize> &rop, const integer<SSize> *bases, const integer<SSize> *exps,
+                                  std::size_t n, const mod_context<SSize> &ctx)
 {
-    return detail::pow_impl(base, exp);
+    return ctx.multi_powm(rop, bases, exps, n);
 }
 
 namespace detail
@@ -6940,9 +8822,10 @@ inline bool root(integer<SSize> &rop, const integer<SSize> &n, unsigned long m)
         throw std::domain_error("Cannot compute the integer root of degree " + std::to_string(m)
                                 + " of the negative number " + n.to_string());
     }
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS detail::mpz_raii tmp;
     const auto ret = mpz_root(&tmp.m_mpz, n.get_mpz_view(), m);
-    rop = &tmp.m_mpz;
+    mb.escape([&]() { rop = &tmp.m_mpz; });
     return ret != 0;
 }
 
@@ -6966,11 +8849,14 @@ inline void rootrem(integer<SSize> &rop, integer<SSize> &rem, const integer<SSiz
         throw std::domain_error("Cannot compute the integer root with remainder of degree " + std::to_string(m)
                                 + " of the negative number " + n.to_string());
     }
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS detail::mpz_raii tmp_rop;
     MPPP_MAYBE_TLS detail::mpz_raii tmp_rem;
     mpz_rootrem(&tmp_rop.m_mpz, &tmp_rem.m_mpz, n.get_mpz_view(), m);
-    rop = &tmp_rop.m_mpz;
-    rem = &tmp_rem.m_mpz;
+    mb.escape([&]() {
+        rop = &tmp_rop.m_mpz;
+        rem = &tmp_rem.m_mpz;
+    });
 }
 
 // Detect perfect power.
@@ -7029,6 +8915,91 @@ inline std::ostream &operator<<(std::ostream &os, const integer<SSize> &n)
     return detail::integer_stream_operator_impl(os, n.get_mpz_view(), n.sgn());
 }
 
+// Write the representation of an integer in base base into the range [first, last).
+template <std::size_t SSize>
+inline to_chars_result to_chars(char *first, char *last, const integer<SSize> &n, int base = 10)
+{
+    if (mppp_unlikely(base < 2 || base > 62)) {
+        throw std::invalid_argument("Invalid base for the conversion of an integer to chars: the base must be between "
+                                    "2 and 62, but a value of "
+                                    + detail::to_string(base) + " was provided instead");
+    }
+
+    const auto &u = n._get_union();
+    if (u.is_static()) {
+        // NOTE: for static integers, the scratch buffers are on the stack
+        // and no memory allocation takes place.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<::mp_limb_t, SSize> scratch;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<unsigned char, SSize * unsigned(GMP_NUMB_BITS) + 1u> dbuf;
+        return detail::limbs_to_chars(first, last, u.g_st().m_limbs.data(),
+                                      static_cast<std::size_t>(u.g_st().abs_size()), u.g_st()._mp_size < 0, base,
+                                      scratch.data(), dbuf.data());
+    } else {
+        return detail::mpz_to_chars(first, last, &u.g_dy(), base);
+    }
+}
+
+// Read an integer in base base from the range [first, last).
+template <std::size_t SSize>
+inline from_chars_result from_chars(const char *first, const char *last, integer<SSize> &n, int base = 10)
+{
+    if (mppp_unlikely(base < 2 || base > 62)) {
+        throw std::invalid_argument("Invalid base for the conversion of chars to an integer: the base must be between "
+                                    "2 and 62, but a value of "
+                                    + detail::to_string(base) + " was provided instead");
+    }
+
+    // Optional minus sign, followed by the digits.
+    const bool neg = first != last && *first == '-';
+    const auto *const dbegin = neg ? first + 1 : first;
+    const auto *const dend = detail::scan_digits(dbegin, last, base);
+    if (dbegin == dend) {
+        return {first, std::errc::invalid_argument};
+    }
+
+    constexpr auto buf_size = detail::from_chars_nlimbs<SSize>::value;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<::mp_limb_t, buf_size> buf;
+    const auto size = detail::digits_to_limbs(buf.data(), buf_size, dbegin, dend, base);
+    if (size <= buf_size) {
+        n = integer<SSize>{buf.data(), size};
+    } else if ((base & (base - 1)) == 0) {
+        // Large values in a power of 2 base: the number of bits of the value is known
+        // in advance (possibly by excess, due to leading zeroes), thus the limbs can be
+        // written directly into the dynamic storage of the result.
+        unsigned k = 0;
+        for (auto b = base; b > 1; b >>= 1) {
+            ++k;
+        }
+        const auto nd = static_cast<std::size_t>(dend - dbegin);
+        if (mppp_unlikely(nd > detail::nl_max<::mp_bitcnt_t>() / k)) {
+            throw std::overflow_error("Too many digits in the conversion of chars to an integer");
+        }
+        integer<SSize> tmp{integer_bitcnt_t(static_cast<::mp_bitcnt_t>(nd) * k)};
+        assert(tmp.is_dynamic());
+        auto &dy = tmp._get_union().g_dy();
+        const auto dsize
+            = detail::digits_to_limbs(dy._mp_d, static_cast<std::size_t>(dy._mp_alloc), dbegin, dend, base);
+        assert(dsize <= static_cast<std::size_t>(dy._mp_alloc));
+        dy._mp_size = static_cast<detail::mpz_size_t>(dsize);
+        n = std::move(tmp);
+    } else {
+        // Large values: use the (subquadratic) GMP conversion.
+        n = integer<SSize>{dbegin, dend, base};
+    }
+    if (neg) {
+        n.neg();
+    }
+
+    return {dend, std::errc{}};
+}
+
+// Configuration of the parallel conversion of large integers to and from strings.
+MPPP_DLL_PUBLIC void set_integer_parallel_conversion(std::size_t, unsigned);
+MPPP_DLL_PUBLIC std::pair<std::size_t, unsigned> get_integer_parallel_conversion();
+
 // Binary size.
 template <std::size_t SSize>
 inline std::size_t binary_size(const integer<SSize> &n)
@@ -7069,9 +9040,246 @@ inline std::size_t hash(const integer<SSize> &n)
     return retval;
 }
 
+namespace detail
+{
+
+#if !GMP_NAIL_BITS
+
+// Radix sort of the n keys of nlimbs limbs each at keys. The keys are nonnegative integers
+// with at most nbits significant bits. buf must have room for n * nlimbs limbs.
+// Returns a pointer to the sorted keys, which will be either keys or buf.
+MPPP_DLL_PUBLIC const ::mp_limb_t *integer_radix_sort_keys(::mp_limb_t *, ::mp_limb_t *, std::size_t, std::size_t,
+                                                           ::mp_bitcnt_t);
+
+// Compute the sort key of the static integer st, that is, the SSize + 1 limbs
+// of st + 2**(SSize * GMP_NUMB_BITS). The keys of different integers compare like
+// the integers themselves.
+template <std::size_t SSize>
+inline void integer_sort_key(::mp_limb_t *k, const static_int<SSize> &st)
+{
+    fixed_limbs<0, SSize>::load(k, st.m_limbs.data(), static_cast<std::size_t>(st.abs_size()));
+    // NOTE: for negative values, the lower limbs of the key are the two's complement of the
+    // absolute value, computed as ~k + 1, and the top limb is zero. Proceed without branching,
+    // as the signs of the values to be sorted are usually unpredictable.
+    const auto mask = -static_cast<::mp_limb_t>(st._mp_size < 0);
+    ::mp_limb_t cy = mask & 1u;
+    for (std::size_t i = 0; i < SSize; ++i) {
+        cy = limb_add_carry(k[i] ^ mask, 0, cy, k + i);
+    }
+    k[SSize] = 1u + mask;
+}
+
+// Set the static integer st from its sort key k.
+template <std::size_t SSize>
+inline void integer_from_sort_key(static_int<SSize> &st, const ::mp_limb_t *k)
+{
+    int sign = 1;
+    if (k[SSize] == 0u) {
+        // Negative value.
+        ::mp_limb_t cy = 1;
+        for (std::size_t i = 0; i < SSize; ++i) {
+            cy = limb_add_carry(~k[i], 0, cy, &st.m_limbs[i]);
+        }
+        sign = -1;
+    } else {
+        copy_limbs_no(k, k + SSize, st.m_limbs.data());
+    }
+    st._mp_size = sign * static_cast<mpz_size_t>(fixed_limbs_size(st.m_limbs.data(), SSize));
+}
+
+// The number of values below which mppp::integer_sort() uses std::sort().
+constexpr std::size_t integer_radix_sort_threshold = 256;
+
+#endif
+
+} // namespace detail
+
+// Sort a range of integers.
+// NOTE: if all the values in the range are in static storage, they are sorted via
+// an LSD radix sort of their sort keys. The keys are stored relative to the minimum value,
+// in the smallest number of limbs able to represent the difference between the maximum
+// and minimum values. Only the digits of the keys which are not the same for all the values are sorted.
+// As equal values are indistinguishable, the sorted values are then written back directly from the sorted keys.
+// Otherwise, std::sort() is used.
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename It>
+    requires std::random_access_iterator<It> && detail::is_integer<typename std::iterator_traits<It>::value_type>::value
+             && std::is_same_v<typename std::iterator_traits<It>::value_type &,
+                               typename std::iterator_traits<It>::reference>
+#else
+template <typename It,
+          detail::enable_if_t<
+              detail::conjunction<
+                  std::is_base_of<std::random_access_iterator_tag,
+                                  typename std::iterator_traits<It>::iterator_category>,
+                  detail::is_integer<typename std::iterator_traits<It>::value_type>,
+                  std::is_same<typename std::iterator_traits<It>::value_type &,
+                               typename std::iterator_traits<It>::reference>>::value,
+              int> = 0>
+#endif
+inline void integer_sort(It begin, It end)
+{
+    using int_t = typename std::iterator_traits<It>::value_type;
+
+#if GMP_NAIL_BITS
+    std::sort(begin, end);
+#else
+    constexpr auto SSize = int_t::ssize;
+
+    const auto n = static_cast<std::size_t>(end - begin);
+    if (n < detail::integer_radix_sort_threshold
+        || !std::all_of(begin, end, [](const int_t &x) { return x.is_static(); })) {
+        std::sort(begin, end);
+        return;
+    }
+
+    const auto mm = std::minmax_element(begin, end);
+    // NOTE: the keys are relative to the minimum value, thus
+    // the number of significant bits of the keys is the number of bits of the span.
+    const auto nbits = static_cast<::mp_bitcnt_t>((*mm.second - *mm.first).nbits());
+    if (nbits == 0u) {
+        // All values are equal.
+        return;
+    }
+    const auto nlimbs = static_cast<std::size_t>(detail::nbits_to_nlimbs(nbits));
+    assert(nlimbs <= SSize + 1u);
+
+    std::array<::mp_limb_t, SSize + 1u> min_key, key; // NOLINT(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    detail::integer_sort_key(min_key.data(), mm.first->_get_union().g_st());
+
+    // NOTE: no overflow is possible in the computation of the
+    // storage size, as the keys are not larger than the integers.
+    std::unique_ptr<::mp_limb_t[]> keys(new ::mp_limb_t[n * nlimbs]), buf(new ::mp_limb_t[n * nlimbs]);
+    auto kptr = keys.get();
+    for (auto it = begin; it != end; ++it, kptr += nlimbs) {
+        detail::integer_sort_key(key.data(), it->_get_union().g_st());
+        detail::fixed_limbs<0, SSize + 1u>::sub(key.data(), key.data(), min_key.data(), 0);
+        detail::copy_limbs_no(key.data(), key.data() + nlimbs, kptr);
+    }
+
+    auto sorted = detail::integer_radix_sort_keys(keys.get(), buf.get(), n, nlimbs, nbits);
+
+    // Write back the sorted values.
+    // NOTE: the limbs of rkey above nlimbs stay zero.
+    std::array<::mp_limb_t, SSize + 1u> rkey{};
+    for (auto it = begin; it != end; ++it, sorted += nlimbs) {
+        detail::copy_limbs_no(sorted, sorted + nlimbs, rkey.data());
+        detail::fixed_limbs<0, SSize + 1u>::add(key.data(), rkey.data(), min_key.data(), 0);
+        detail::integer_from_sort_key(it->_get_union().g_st(), key.data());
+    }
+#endif
+}
+
 // Free the caches.
 MPPP_DLL_PUBLIC void free_integer_caches();
 
+// Statistics of the integer caches.
+struct integer_cache_stats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+};
+
+// Configuration and monitoring of the integer caches.
+MPPP_DLL_PUBLIC void set_integer_cache_limits(std::size_t, std::size_t);
+MPPP_DLL_PUBLIC std::pair<std::size_t, std::size_t> get_integer_cache_limits();
+MPPP_DLL_PUBLIC void prefill_integer_cache(std::size_t, std::size_t);
+MPPP_DLL_PUBLIC integer_cache_stats get_integer_cache_stats();
+MPPP_DLL_PUBLIC void reset_integer_cache_stats();
+
+// Route the GMP memory allocations through mp++, so that
+// the dynamic storage of integers can be drawn from memory resources.
+MPPP_DLL_PUBLIC void enable_integer_memory_resources();
+MPPP_DLL_PUBLIC bool integer_memory_resources_enabled();
+
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+// Bind a memory resource to the calling thread for the lifetime of the object.
+class integer_memory_resource_scope
+{
+    static void *allocate(void *r, std::size_t size)
+    {
+        return static_cast<std::pmr::memory_resource *>(r)->allocate(size, alignof(std::max_align_t));
+    }
+    static void deallocate(void *r, void *p, std::size_t size)
+    {
+        static_cast<std::pmr::memory_resource *>(r)->deallocate(p, size, alignof(std::max_align_t));
+    }
+    static constexpr detail::mpz_memory_resource_ops s_ops = {allocate, deallocate, true};
+    static detail::mpz_memory_binding bind(std::pmr::memory_resource *r)
+    {
+        if (mppp_unlikely(r == nullptr)) {
+            throw std::invalid_argument("Cannot bind a null memory resource to the integer memory allocations");
+        }
+        if (mppp_unlikely(!integer_memory_resources_enabled())) {
+            throw std::invalid_argument("Cannot bind a memory resource to the integer memory allocations: the "
+                                        "memory resources have not been enabled via "
+                                        "enable_integer_memory_resources()");
+        }
+        return detail::mpz_exchange_memory_binding({static_cast<void *>(r), &s_ops});
+    }
+
+public:
+    explicit integer_memory_resource_scope(std::pmr::memory_resource *r) : m_prev(bind(r)) {}
+    integer_memory_resource_scope(const integer_memory_resource_scope &) = delete;
+    integer_memory_resource_scope(integer_memory_resource_scope &&) = delete;
+    integer_memory_resource_scope &operator=(const integer_memory_resource_scope &) = delete;
+    integer_memory_resource_scope &operator=(integer_memory_resource_scope &&) = delete;
+    ~integer_memory_resource_scope()
+    {
+        detail::mpz_exchange_memory_binding(m_prev);
+    }
+
+private:
+    detail::mpz_memory_binding m_prev;
+};
+
+#endif
+
+// Route the memory allocations of mp++, GMP and MPFR on the
+// calling thread to a bump allocator for the lifetime of the object.
+class MPPP_DLL_PUBLIC arena_scope
+{
+public:
+    static constexpr std::size_t default_chunk_size = 65536;
+
+    explicit arena_scope(std::size_t = default_chunk_size);
+    arena_scope(const arena_scope &) = delete;
+    arena_scope(arena_scope &&) = delete;
+    arena_scope &operator=(const arena_scope &) = delete;
+    arena_scope &operator=(arena_scope &&) = delete;
+    ~arena_scope();
+
+    // Invoke f with the allocations routed to where they
+    // were routed before the creation of this object.
+    template <typename F>
+    auto escape(F &&f) const -> decltype(std::forward<F>(f)())
+    {
+        const detail::mpz_memory_binding_restorer r(detail::mpz_exchange_memory_binding(m_prev));
+        return std::forward<F>(f)();
+    }
+
+private:
+    // NOTE: this is a pointer to the (opaque) state of the arena.
+    void *m_arena;
+    detail::mpz_memory_binding m_prev;
+};
+
+// The variants of the static integer kernels.
+// NOTE: there is no AVX-512 variant. AVX-512 has no full 64x64->128-bit multiplication
+// (IFMA works on 52-bit digits, which would require converting the limbs back and forth),
+// and the carry chains of additions on 3 to 8 limbs are inherently serial. The scalar
+// MULX/ADCX/ADOX kernels are thus the better fit for these sizes.
+enum class integer_kernel_variant {
+    // Portable C++ implementation.
+    generic,
+    // Implementation based on the BMI2/ADX instructions.
+    bmi2_adx
+};
+
+// Get the variant of the static integer kernels in use.
+MPPP_DLL_PUBLIC integer_kernel_variant integer_get_kernel_variant();
+
 namespace detail
 {
 
@@ -0,0 +1,394 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_INTEGER_VECTOR_HPP
+#define MPPP_INTEGER_VECTOR_HPP
+
+#include <mp++/config.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/detail/utils.hpp>
+#include <mp++/detail/visibility.hpp>
+#include <mp++/integer.hpp>
+
+MPPP_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+struct integer_vector_access;
+
+} // namespace detail
+
+// Vector of integers with a structure-of-arrays layout.
+template <std::size_t SSize>
+class integer_vector
+{
+    friend struct detail::integer_vector_access;
+
+    // The marker signalling, in m_sizes, that an element
+    // is stored in m_dyn instead of in m_limbs.
+    static constexpr detail::mpz_size_t dyn_marker = static_cast<detail::mpz_size_t>(SSize + 1u);
+
+public:
+    // Alias for the template parameter SSize.
+    static constexpr std::size_t ssize = SSize;
+    // The element type.
+    using value_type = integer<SSize>;
+    // The size type.
+    using size_type = std::size_t;
+
+    // Default constructor.
+    integer_vector() = default;
+    // Copy and move constructors.
+    integer_vector(const integer_vector &) = default;
+    // NOLINTNEXTLINE(hicpp-noexcept-move, performance-noexcept-move-constructor)
+    integer_vector(integer_vector &&) = default;
+    // Constructor from size, all elements are inited to zero.
+    explicit integer_vector(size_type n) : m_sizes(n), m_limbs(limbs_size(n)) {}
+    // Constructor from an initializer list.
+    integer_vector(std::initializer_list<value_type> l) : integer_vector(l.begin(), l.end()) {}
+    // Constructor from a range.
+    template <typename It,
+              detail::enable_if_t<std::is_constructible<value_type, decltype(*std::declval<It &>())>::value, int> = 0>
+    explicit integer_vector(It begin, It end)
+    {
+        for (; begin != end; ++begin) {
+            push_back(value_type(*begin));
+        }
+    }
+
+    // Copy and move assignment.
+    integer_vector &operator=(const integer_vector &) = default;
+    // NOLINTNEXTLINE(hicpp-noexcept-move, performance-noexcept-move-constructor)
+    integer_vector &operator=(integer_vector &&) = default;
+
+    // Destructor.
+    ~integer_vector() = default;
+
+    // Size.
+    MPPP_NODISCARD size_type size() const
+    {
+        return m_sizes.size();
+    }
+    // Resize. New elements are inited to zero.
+    void resize(size_type n)
+    {
+        const auto old_size = size();
+        // NOTE: resize m_limbs first, so that we remain in a consistent
+        // state if resizing m_sizes fails.
+        m_limbs.resize(limbs_size(n));
+        m_sizes.resize(n);
+
+        // Remove the dynamic elements which were cut off.
+        for (auto i = n; i < old_size && !m_dyn.empty(); ++i) {
+            m_dyn.erase(i);
+        }
+    }
+    // Append an element.
+    void push_back(const value_type &n)
+    {
+        const auto s = size();
+        resize(s + 1u);
+        set(s, n);
+    }
+
+    // Get a copy of the element at index i.
+    MPPP_NODISCARD value_type get(size_type i) const
+    {
+        check_index(i);
+        if (m_sizes[i] == dyn_marker) {
+            return m_dyn.find(i)->second;
+        }
+        value_type retval;
+        auto &st = retval._get_union().g_st();
+        std::copy(m_limbs.begin() + static_cast<std::ptrdiff_t>(i * SSize),
+                  m_limbs.begin() + static_cast<std::ptrdiff_t>((i + 1u) * SSize), st.m_limbs.begin());
+        st._mp_size = m_sizes[i];
+        return retval;
+    }
+    // Set the element at index i to n.
+    void set(size_type i, const value_type &n)
+    {
+        check_index(i);
+        const auto asize = n.size();
+        if (asize <= SSize) {
+            const auto &u = n._get_union();
+            const ::mp_limb_t *ptr = u.is_static() ? u.g_st().m_limbs.data() : u.g_dy()._mp_d;
+            auto out = m_limbs.begin() + static_cast<std::ptrdiff_t>(i * SSize);
+            std::copy(ptr, ptr + asize, out);
+            std::fill(out + static_cast<std::ptrdiff_t>(asize), out + static_cast<std::ptrdiff_t>(SSize),
+                      ::mp_limb_t(0));
+            if (m_sizes[i] == dyn_marker) {
+                m_dyn.erase(i);
+            }
+            m_sizes[i] = static_cast<detail::mpz_size_t>(n.sgn() * static_cast<int>(asize));
+        } else {
+            // NOTE: insert into m_dyn first, for exception safety.
+            m_dyn[i] = n;
+            m_sizes[i] = dyn_marker;
+        }
+    }
+    // Check if the element at index i is stored in the
+    // contiguous static storage of the vector.
+    MPPP_NODISCARD bool is_static(size_type i) const
+    {
+        check_index(i);
+        return m_sizes[i] != dyn_marker;
+    }
+
+private:
+    static std::vector<::mp_limb_t>::size_type limbs_size(size_type n)
+    {
+        // LCOV_EXCL_START
+        if (mppp_unlikely(n > detail::nl_max<std::vector<::mp_limb_t>::size_type>() / SSize)) {
+            throw std::overflow_error("Overflow in the computation of the storage size of an integer vector");
+        }
+        // LCOV_EXCL_STOP
+        return static_cast<std::vector<::mp_limb_t>::size_type>(n * SSize);
+    }
+    void check_index(size_type i) const
+    {
+        if (mppp_unlikely(i >= size())) {
+            throw std::out_of_range("Cannot access the element at index " + detail::to_string(i)
+                                    + " of an integer vector of size " + detail::to_string(size()));
+        }
+    }
+
+    // The signed sizes of the elements.
+    std::vector<detail::mpz_size_t> m_sizes;
+    // The limbs of the elements, SSize limbs per element.
+    std::vector<::mp_limb_t> m_limbs;
+    // The elements which do not fit in static storage.
+    std::unordered_map<size_type, value_type> m_dyn;
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
+template <std::size_t SSize>
+constexpr std::size_t integer_vector<SSize>::ssize;
+
+template <std::size_t SSize>
+constexpr detail::mpz_size_t integer_vector<SSize>::dyn_marker;
+
+#endif
+
+namespace detail
+{
+
+#if !GMP_NAIL_BITS
+
+// Batch kernels for vectors of integers with 1 limb of static storage.
+// The kernels process n elements, writing the results into (rs, rl). The elements for which
+// the result cannot be computed (because one of the operands is not stored in static storage
+// or the result does not fit in 1 limb) are left untouched in (rs, rl) and flagged in fl.
+// The return value is the number of flagged elements. Overlapping arguments are allowed.
+MPPP_DLL_PUBLIC std::size_t integer_vector_add_1(mpz_size_t *, ::mp_limb_t *, const mpz_size_t *, const ::mp_limb_t *,
+                                                 const mpz_size_t *, const ::mp_limb_t *, unsigned *, std::size_t);
+MPPP_DLL_PUBLIC std::size_t integer_vector_sub_1(mpz_size_t *, ::mp_limb_t *, const mpz_size_t *, const ::mp_limb_t *,
+                                                 const mpz_size_t *, const ::mp_limb_t *, unsigned *, std::size_t);
+MPPP_DLL_PUBLIC std::size_t integer_vector_mul_1(mpz_size_t *, ::mp_limb_t *, const mpz_size_t *, const ::mp_limb_t *,
+                                                 const mpz_size_t *, const ::mp_limb_t *, unsigned *, std::size_t);
+MPPP_DLL_PUBLIC std::size_t integer_vector_mul_2exp_1(mpz_size_t *, ::mp_limb_t *, const mpz_size_t *,
+                                                      const ::mp_limb_t *, ::mp_bitcnt_t, unsigned *, std::size_t);
+
+#endif
+
+// The number of elements processed in a single call to the batch kernels.
+constexpr std::size_t integer_vector_block_size = 256;
+
+// Helper to detect if the batch kernels can be used.
+template <std::size_t SSize>
+using integer_vector_have_batch = std::integral_constant<bool, SSize == 1u && !GMP_NAIL_BITS>;
+
+struct integer_vector_access {
+    // Remove from the dynamic storage of v the elements which have been overwritten
+    // by a batch kernel.
+    template <std::size_t SSize>
+    static void prune_dyn(integer_vector<SSize> &v)
+    {
+        for (auto it = v.m_dyn.begin(); it != v.m_dyn.end();) {
+            if (v.m_sizes[it->first] != integer_vector<SSize>::dyn_marker) {
+                it = v.m_dyn.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Elementwise binary operation, implementation via integer<SSize>.
+    template <std::size_t SSize, typename F>
+    static void binary_op_generic(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                                  const integer_vector<SSize> &b, const F &f, const unsigned *fl,
+                                  std::size_t begin, std::size_t end)
+    {
+        integer<SSize> tmp;
+        for (auto i = begin; i < end; ++i) {
+            if (fl == nullptr || fl[i - begin] != 0u) {
+                f(tmp, a.get(i), b.get(i));
+                rop.set(i, tmp);
+            }
+        }
+    }
+
+    template <std::size_t SSize, typename F, typename Kernel>
+    static void binary_op_impl(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                               const integer_vector<SSize> &b, const F &f, const Kernel &, const std::false_type &)
+    {
+        binary_op_generic(rop, a, b, f, nullptr, 0, a.size());
+    }
+
+    template <std::size_t SSize, typename F, typename Kernel>
+    static void binary_op_impl(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                               const integer_vector<SSize> &b, const F &f, const Kernel &k, const std::true_type &)
+    {
+        const auto size = a.size();
+        std::array<unsigned, integer_vector_block_size> fl{};
+
+        for (std::size_t i = 0; i < size; i += integer_vector_block_size) {
+            const auto n = std::min(integer_vector_block_size, size - i);
+            if (k(rop.m_sizes.data() + i, rop.m_limbs.data() + i, a.m_sizes.data() + i, a.m_limbs.data() + i,
+                  b.m_sizes.data() + i, b.m_limbs.data() + i, fl.data(), n)
+                != 0u) {
+                // Handle the flagged elements.
+                binary_op_generic(rop, a, b, f, fl.data(), i, i + n);
+            }
+        }
+
+        if (!rop.m_dyn.empty()) {
+            prune_dyn(rop);
+        }
+    }
+
+    template <std::size_t SSize, typename F, typename Kernel>
+    static void binary_op(integer_vector<SSize> &rop, const integer_vector<SSize> &a, const integer_vector<SSize> &b,
+                          const F &f, const Kernel &k)
+    {
+        if (mppp_unlikely(a.size() != b.size())) {
+            throw std::invalid_argument("Cannot perform an elementwise operation on integer vectors of different "
+                                        "sizes "
+                                        + detail::to_string(a.size()) + " and " + detail::to_string(b.size()));
+        }
+        // NOTE: if rop overlaps with a or b, this will be a no-op.
+        rop.resize(a.size());
+        binary_op_impl(rop, a, b, f, k, integer_vector_have_batch<SSize>{});
+    }
+};
+
+// The batch kernels, wrapped into function objects. If the batch
+// kernels are not available, these are never invoked.
+#if !GMP_NAIL_BITS
+
+#define MPPP_INTEGER_VECTOR_KERNEL(name)                                                                              \
+    struct integer_vector_##name##_kernel {                                                                            \
+        template <typename... Args>                                                                                    \
+        std::size_t operator()(Args... args) const                                                                     \
+        {                                                                                                              \
+            return integer_vector_##name##_1(args...);                                                                 \
+        }                                                                                                              \
+    };
+
+#else
+
+#define MPPP_INTEGER_VECTOR_KERNEL(name)                                                                              \
+    struct integer_vector_##name##_kernel {                                                                            \
+        template <typename... Args>                                                                                    \
+        std::size_t operator()(Args...) const                                                                          \
+        {                                                                                                              \
+            assert(false);                                                                                             \
+            return 0;                                                                                                  \
+        }                                                                                                              \
+    };
+
+#endif
+
+MPPP_INTEGER_VECTOR_KERNEL(add)
+MPPP_INTEGER_VECTOR_KERNEL(sub)
+MPPP_INTEGER_VECTOR_KERNEL(mul)
+
+#undef MPPP_INTEGER_VECTOR_KERNEL
+
+// Helper to adapt the mul_2exp batch kernel to the signature of the binary kernels.
+struct integer_vector_mul_2exp_kernel {
+    ::mp_bitcnt_t s;
+    std::size_t operator()(mpz_size_t *rs, ::mp_limb_t *rl, const mpz_size_t *as, const ::mp_limb_t *al,
+                           const mpz_size_t *, const ::mp_limb_t *, unsigned *fl, std::size_t n) const
+    {
+#if !GMP_NAIL_BITS
+        return integer_vector_mul_2exp_1(rs, rl, as, al, s, fl, n);
+#else
+        ignore(rs, rl, as, al, fl, n);
+        assert(false);
+        return 0;
+#endif
+    }
+};
+
+} // namespace detail
+
+// Elementwise ternary addition.
+template <std::size_t SSize>
+inline integer_vector<SSize> &add(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                                  const integer_vector<SSize> &b)
+{
+    detail::integer_vector_access::binary_op(
+        rop, a, b, [](integer<SSize> &r, const integer<SSize> &x, const integer<SSize> &y) { add(r, x, y); },
+        detail::integer_vector_add_kernel{});
+    return rop;
+}
+
+// Elementwise ternary subtraction.
+template <std::size_t SSize>
+inline integer_vector<SSize> &sub(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                                  const integer_vector<SSize> &b)
+{
+    detail::integer_vector_access::binary_op(
+        rop, a, b, [](integer<SSize> &r, const integer<SSize> &x, const integer<SSize> &y) { sub(r, x, y); },
+        detail::integer_vector_sub_kernel{});
+    return rop;
+}
+
+// Elementwise ternary multiplication.
+template <std::size_t SSize>
+inline integer_vector<SSize> &mul(integer_vector<SSize> &rop, const integer_vector<SSize> &a,
+                                  const integer_vector<SSize> &b)
+{
+    detail::integer_vector_access::binary_op(
+        rop, a, b, [](integer<SSize> &r, const integer<SSize> &x, const integer<SSize> &y) { mul(r, x, y); },
+        detail::integer_vector_mul_kernel{});
+    return rop;
+}
+
+// Elementwise ternary left shift.
+template <std::size_t SSize>
+inline integer_vector<SSize> &mul_2exp(integer_vector<SSize> &rop, const integer_vector<SSize> &a, ::mp_bitcnt_t s)
+{
+    // NOTE: the second operand is not used, pass in a for
+    // the sake of reusing the binary machinery.
+    detail::integer_vector_access::binary_op(
+        rop, a, a, [s](integer<SSize> &r, const integer<SSize> &x, const integer<SSize> &) { mul_2exp(r, x, s); },
+        detail::integer_vector_mul_2exp_kernel{s});
+    return rop;
+}
+
+MPPP_END_NAMESPACE
+
+#endif
@@ -0,0 +1,688 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_LAZY_HPP
+#define MPPP_LAZY_HPP
+
+#include <mp++/config.hpp>
+
+#if defined(MPPP_WITH_MPFR)
+
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+#include <mp++/detail/mpfr.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/detail/utils.hpp>
+#include <mp++/real.hpp>
+
+#if defined(MPPP_WITH_MPC)
+
+#include <mp++/complex.hpp>
+#include <mp++/detail/mpc.hpp>
+
+#endif
+
+MPPP_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// The binary operations in a lazy expression.
+struct lazy_add {
+};
+
+struct lazy_sub {
+};
+
+struct lazy_mul {
+};
+
+struct lazy_div {
+};
+
+// A reference to a value in a lazy expression.
+template <typename T>
+struct lazy_term {
+    const T *m_ptr;
+};
+
+// A binary operation in a lazy expression.
+template <typename Op, typename L, typename R>
+struct lazy_binary {
+    L m_l;
+    R m_r;
+};
+
+// A negation in a lazy expression.
+template <typename A>
+struct lazy_neg {
+    A m_arg;
+};
+
+// Detect lazy expressions.
+template <typename T>
+struct is_lazy_expr : std::false_type {
+};
+
+template <typename T>
+struct is_lazy_expr<lazy_term<T>> : std::true_type {
+};
+
+template <typename Op, typename L, typename R>
+struct is_lazy_expr<lazy_binary<Op, L, R>> : std::true_type {
+};
+
+template <typename A>
+struct is_lazy_expr<lazy_neg<A>> : std::true_type {
+};
+
+template <typename T>
+struct is_lazy_term : std::false_type {
+};
+
+template <typename T>
+struct is_lazy_term<lazy_term<T>> : std::true_type {
+};
+
+// The type of the value of a lazy expression.
+template <typename T>
+struct lazy_value_type {
+};
+
+template <typename T>
+struct lazy_value_type<lazy_term<T>> {
+    using type = T;
+};
+
+template <typename Op, typename L, typename R>
+struct lazy_value_type<lazy_binary<Op, L, R>> : lazy_value_type<L> {
+};
+
+template <typename A>
+struct lazy_value_type<lazy_neg<A>> : lazy_value_type<A> {
+};
+
+template <typename T>
+using lazy_value_t = typename lazy_value_type<T>::type;
+
+// Turn an operand of an operator into a node of a lazy expression. Lazy
+// expressions are used as they are, values are wrapped into terminals.
+template <typename T, typename = void>
+struct lazy_node {
+};
+
+template <typename T>
+struct lazy_node<T, enable_if_t<is_lazy_expr<T>::value>> {
+    using type = T;
+    static const T &get(const T &x)
+    {
+        return x;
+    }
+};
+
+template <>
+struct lazy_node<real> {
+    using type = lazy_term<real>;
+    static type get(const real &x)
+    {
+        return type{&x};
+    }
+};
+
+#if defined(MPPP_WITH_MPC)
+
+template <>
+struct lazy_node<complex> {
+    using type = lazy_term<complex>;
+    static type get(const complex &c)
+    {
+        return type{&c};
+    }
+};
+
+#endif
+
+template <typename T>
+using lazy_node_t = typename lazy_node<T>::type;
+
+// The operators are enabled if at least one operand is a lazy expression, and
+// if the values of the operands have the same type.
+template <typename T, typename U, typename = void>
+struct are_lazy_op_types : std::false_type {
+};
+
+template <typename T, typename U>
+struct are_lazy_op_types<T, U, void_t<lazy_value_t<lazy_node_t<T>>, lazy_value_t<lazy_node_t<U>>>>
+    : conjunction<disjunction<is_lazy_expr<T>, is_lazy_expr<U>>,
+                  std::is_same<lazy_value_t<lazy_node_t<T>>, lazy_value_t<lazy_node_t<U>>>> {
+};
+
+template <typename T, typename U>
+using lazy_op_enabler = enable_if_t<are_lazy_op_types<T, U>::value, int>;
+
+template <typename T, typename U, lazy_op_enabler<T, U> = 0>
+inline lazy_binary<lazy_add, lazy_node_t<T>, lazy_node_t<U>> operator+(const T &a, const U &b)
+{
+    return {lazy_node<T>::get(a), lazy_node<U>::get(b)};
+}
+
+template <typename T, typename U, lazy_op_enabler<T, U> = 0>
+inline lazy_binary<lazy_sub, lazy_node_t<T>, lazy_node_t<U>> operator-(const T &a, const U &b)
+{
+    return {lazy_node<T>::get(a), lazy_node<U>::get(b)};
+}
+
+template <typename T, typename U, lazy_op_enabler<T, U> = 0>
+inline lazy_binary<lazy_mul, lazy_node_t<T>, lazy_node_t<U>> operator*(const T &a, const U &b)
+{
+    return {lazy_node<T>::get(a), lazy_node<U>::get(b)};
+}
+
+template <typename T, typename U, lazy_op_enabler<T, U> = 0>
+inline lazy_binary<lazy_div, lazy_node_t<T>, lazy_node_t<U>> operator/(const T &a, const U &b)
+{
+    return {lazy_node<T>::get(a), lazy_node<U>::get(b)};
+}
+
+// NOTE: lazy expressions store pointers to their values, thus the operators are
+// disabled for rvalue values (e.g., lazy(a) * real{2}), which would be destroyed
+// before the evaluation of the expression. Lazy expressions themselves are
+// stored by value, and they can be rvalues.
+template <typename T>
+struct is_lazy_rvalue_value : std::false_type {
+};
+
+template <>
+struct is_lazy_rvalue_value<real> : std::true_type {
+};
+
+#if defined(MPPP_WITH_MPC)
+
+template <>
+struct is_lazy_rvalue_value<complex> : std::true_type {
+};
+
+#endif
+
+// NOTE: T and U are here the deduced types of forwarding references,
+// thus they are not references if the operands are rvalues.
+template <typename T, typename U>
+using lazy_op_rvalue_enabler
+    = enable_if_t<conjunction<are_lazy_op_types<uncvref_t<T>, uncvref_t<U>>,
+                              disjunction<conjunction<negation<std::is_reference<T>>,
+                                                      is_lazy_rvalue_value<remove_cv_t<T>>>,
+                                          conjunction<negation<std::is_reference<U>>,
+                                                      is_lazy_rvalue_value<remove_cv_t<U>>>>>::value,
+                  int>;
+
+template <typename T, typename U, lazy_op_rvalue_enabler<T, U> = 0>
+void operator+(T &&, U &&) = delete;
+
+template <typename T, typename U, lazy_op_rvalue_enabler<T, U> = 0>
+void operator-(T &&, U &&) = delete;
+
+template <typename T, typename U, lazy_op_rvalue_enabler<T, U> = 0>
+void operator*(T &&, U &&) = delete;
+
+template <typename T, typename U, lazy_op_rvalue_enabler<T, U> = 0>
+void operator/(T &&, U &&) = delete;
+
+template <typename T, enable_if_t<is_lazy_expr<T>::value, int> = 0>
+inline lazy_neg<T> operator-(const T &a)
+{
+    return {a};
+}
+
+// The low-level operations on the values of lazy expressions.
+template <typename T>
+struct lazy_traits {
+};
+
+template <>
+struct lazy_traits<real> {
+    using ptr_t = mpfr_struct_t *;
+    using cptr_t = const mpfr_struct_t *;
+    // NOTE: MPFR has mpfr_fms().
+    static constexpr bool has_fms = true;
+    static cptr_t get(const real &x)
+    {
+        return x.get_mpfr_t();
+    }
+    static ptr_t get(real &x)
+    {
+        return x._get_mpfr_t();
+    }
+    // Create a value with precision p.
+    static real make(::mpfr_prec_t p)
+    {
+        return real{real_kind::nan, p};
+    }
+    static void set(ptr_t rop, cptr_t x)
+    {
+        mpfr_set(rop, x, MPFR_RNDN);
+    }
+    static void neg(ptr_t rop, cptr_t x)
+    {
+        ::mpfr_neg(rop, x, MPFR_RNDN);
+    }
+    static void apply(const lazy_add &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpfr_add(rop, a, b, MPFR_RNDN);
+    }
+    static void apply(const lazy_sub &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpfr_sub(rop, a, b, MPFR_RNDN);
+    }
+    static void apply(const lazy_mul &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpfr_mul(rop, a, b, MPFR_RNDN);
+    }
+    static void apply(const lazy_div &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpfr_div(rop, a, b, MPFR_RNDN);
+    }
+    static void fma(ptr_t rop, cptr_t a, cptr_t b, cptr_t c)
+    {
+        ::mpfr_fma(rop, a, b, c, MPFR_RNDN);
+    }
+    static void fms(ptr_t rop, cptr_t a, cptr_t b, cptr_t c)
+    {
+        ::mpfr_fms(rop, a, b, c, MPFR_RNDN);
+    }
+};
+
+#if defined(MPPP_WITH_MPC)
+
+template <>
+struct lazy_traits<complex> {
+    using ptr_t = mpc_struct_t *;
+    using cptr_t = const mpc_struct_t *;
+    // NOTE: MPC does not have an fms primitive.
+    static constexpr bool has_fms = false;
+    static cptr_t get(const complex &c)
+    {
+        return c.get_mpc_t();
+    }
+    static ptr_t get(complex &c)
+    {
+        return c._get_mpc_t();
+    }
+    static complex make(::mpfr_prec_t p)
+    {
+        return complex{0, complex_prec_t(p)};
+    }
+    static void set(ptr_t rop, cptr_t c)
+    {
+        ::mpc_set(rop, c, MPC_RNDNN);
+    }
+    static void neg(ptr_t rop, cptr_t c)
+    {
+        ::mpc_neg(rop, c, MPC_RNDNN);
+    }
+    static void apply(const lazy_add &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpc_add(rop, a, b, MPC_RNDNN);
+    }
+    static void apply(const lazy_sub &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpc_sub(rop, a, b, MPC_RNDNN);
+    }
+    static void apply(const lazy_mul &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpc_mul(rop, a, b, MPC_RNDNN);
+    }
+    static void apply(const lazy_div &, ptr_t rop, cptr_t a, cptr_t b)
+    {
+        ::mpc_div(rop, a, b, MPC_RNDNN);
+    }
+    static void fma(ptr_t rop, cptr_t a, cptr_t b, cptr_t c)
+    {
+        ::mpc_fma(rop, a, b, c, MPC_RNDNN);
+    }
+};
+
+#endif
+
+// A temporary value used in the evaluation of a lazy expression,
+// constructed on demand.
+template <typename T>
+class lazy_tmp
+{
+public:
+    lazy_tmp() = default;
+    lazy_tmp(const lazy_tmp &) = delete;
+    lazy_tmp(lazy_tmp &&) = delete;
+    lazy_tmp &operator=(const lazy_tmp &) = delete;
+    lazy_tmp &operator=(lazy_tmp &&) = delete;
+    ~lazy_tmp()
+    {
+        if (m_init) {
+            get().~T();
+        }
+    }
+    T &init(::mpfr_prec_t p)
+    {
+        assert(!m_init);
+        ::new (static_cast<void *>(m_storage)) T(lazy_traits<T>::make(p));
+        m_init = true;
+        return get();
+    }
+
+private:
+    T &get()
+    {
+        return *reinterpret_cast<T *>(m_storage);
+    }
+
+    // NOTE: std::aligned_storage is deprecated in C++23.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    alignas(T) unsigned char m_storage[sizeof(T)];
+    bool m_init = false;
+};
+
+// The precision of a lazy expression, that is, the largest
+// precision among the values in the expression.
+template <typename T>
+inline ::mpfr_prec_t lazy_prec(const lazy_term<T> &e)
+{
+    return e.m_ptr->get_prec();
+}
+
+template <typename Op, typename L, typename R>
+inline ::mpfr_prec_t lazy_prec(const lazy_binary<Op, L, R> &e)
+{
+    return c_max(lazy_prec(e.m_l), lazy_prec(e.m_r));
+}
+
+template <typename A>
+inline ::mpfr_prec_t lazy_prec(const lazy_neg<A> &e)
+{
+    return lazy_prec(e.m_arg);
+}
+
+// Check if the lazy expression e refers to x.
+template <typename T>
+inline bool lazy_refers(const lazy_term<T> &e, const T &x)
+{
+    return e.m_ptr == &x;
+}
+
+template <typename Op, typename L, typename R, typename T>
+inline bool lazy_refers(const lazy_binary<Op, L, R> &e, const T &x)
+{
+    return lazy_refers(e.m_l, x) || lazy_refers(e.m_r, x);
+}
+
+template <typename A, typename T>
+inline bool lazy_refers(const lazy_neg<A> &e, const T &x)
+{
+    return lazy_refers(e.m_arg, x);
+}
+
+template <typename T>
+inline void lazy_eval_into(T &, const lazy_term<T> &, ::mpfr_prec_t);
+template <typename T, typename Op, typename L, typename R>
+inline void lazy_eval_into(T &, const lazy_binary<Op, L, R> &, ::mpfr_prec_t);
+template <typename T, typename A>
+inline void lazy_eval_into(T &, const lazy_neg<A> &, ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_add, lazy_binary<lazy_mul, A, B>, C> &, ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_add, C, lazy_binary<lazy_mul, A, B>> &, ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C, typename D>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_add, lazy_binary<lazy_mul, A, B>, lazy_binary<lazy_mul, C, D>> &,
+                           ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_sub, lazy_binary<lazy_mul, A, B>, C> &, ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_sub, C, lazy_binary<lazy_mul, A, B>> &, ::mpfr_prec_t);
+template <typename T, typename A, typename B, typename C, typename D>
+inline void lazy_eval_into(T &, const lazy_binary<lazy_sub, lazy_binary<lazy_mul, A, B>, lazy_binary<lazy_mul, C, D>> &,
+                           ::mpfr_prec_t);
+
+// Get a pointer to the value of the operand e of a node which is being evaluated into rop.
+// Terminals are used directly. Otherwise, e is evaluated into rop (if use_rop is true)
+// or into the temporary tmp.
+template <typename T>
+inline typename lazy_traits<T>::cptr_t lazy_operand(T &, const lazy_term<T> &e, bool, lazy_tmp<T> &, ::mpfr_prec_t)
+{
+    return lazy_traits<T>::get(*e.m_ptr);
+}
+
+template <typename T, typename E>
+inline typename lazy_traits<T>::cptr_t lazy_operand(T &rop, const E &e, bool use_rop, lazy_tmp<T> &tmp,
+                                                    ::mpfr_prec_t p)
+{
+    if (use_rop) {
+        lazy_eval_into(rop, e, p);
+        return lazy_traits<T>::get(rop);
+    } else {
+        auto &t = tmp.init(p);
+        lazy_eval_into(t, e, p);
+        return lazy_traits<T>::get(t);
+    }
+}
+
+// NOTE: in the evaluation of a node into rop, rop can be used to store the value of an
+// operand (instead of a temporary) only if the other operands do not refer to rop,
+// otherwise the value of rop would be overwritten before being read. The evaluation
+// of the operand itself may refer to rop, as the same rule is applied recursively.
+
+// Evaluate the binary operation op on the lazy expressions l and r into rop.
+template <typename T, typename Op, typename L, typename R>
+inline void lazy_eval_binary(T &rop, const Op &op, const L &l, const R &r, ::mpfr_prec_t p)
+{
+    const auto l_rop = !is_lazy_term<L>::value && !lazy_refers(r, rop);
+    const auto r_rop = !is_lazy_term<R>::value && !l_rop && !lazy_refers(l, rop);
+
+    lazy_tmp<T> t0, t1;
+    const auto a = lazy_operand(rop, l, l_rop, t0, p);
+    const auto b = lazy_operand(rop, r, r_rop, t1, p);
+    lazy_traits<T>::apply(op, lazy_traits<T>::get(rop), a, b);
+}
+
+// Compute x * y + z (false_type) or x * y - z (true_type) into rop.
+template <typename T>
+inline void lazy_fused_apply(const std::false_type &, T &rop, typename lazy_traits<T>::cptr_t x,
+                             typename lazy_traits<T>::cptr_t y, typename lazy_traits<T>::cptr_t z)
+{
+    lazy_traits<T>::fma(lazy_traits<T>::get(rop), x, y, z);
+}
+
+template <typename T>
+inline void lazy_fused_apply(const std::true_type &, T &rop, typename lazy_traits<T>::cptr_t x,
+                             typename lazy_traits<T>::cptr_t y, typename lazy_traits<T>::cptr_t z)
+{
+    lazy_traits<T>::fms(lazy_traits<T>::get(rop), x, y, z);
+}
+
+// Evaluate a * b + c (if Sub is false) or a * b - c (if Sub is true) into rop.
+template <bool Sub, typename T, typename A, typename B, typename C>
+inline void lazy_eval_fused(T &rop, const A &a, const B &b, const C &c, ::mpfr_prec_t p)
+{
+    const auto a_rop = !is_lazy_term<A>::value && !lazy_refers(b, rop) && !lazy_refers(c, rop);
+    const auto b_rop = !is_lazy_term<B>::value && !a_rop && !lazy_refers(a, rop) && !lazy_refers(c, rop);
+    const auto c_rop
+        = !is_lazy_term<C>::value && !a_rop && !b_rop && !lazy_refers(a, rop) && !lazy_refers(b, rop);
+
+    lazy_tmp<T> t0, t1, t2;
+    const auto x = lazy_operand(rop, a, a_rop, t0, p);
+    const auto y = lazy_operand(rop, b, b_rop, t1, p);
+    const auto z = lazy_operand(rop, c, c_rop, t2, p);
+    lazy_fused_apply(std::integral_constant<bool, Sub>{}, rop, x, y, z);
+}
+
+// Evaluate a * b - c into rop, if the fms primitive is available.
+template <typename T, typename Node, typename A, typename B, typename C>
+inline void lazy_eval_fms(const std::true_type &, T &rop, const Node &, const A &a, const B &b, const C &c,
+                          ::mpfr_prec_t p)
+{
+    lazy_eval_fused<true>(rop, a, b, c, p);
+}
+
+template <typename T, typename Node, typename A, typename B, typename C>
+inline void lazy_eval_fms(const std::false_type &, T &rop, const Node &e, const A &, const B &, const C &,
+                          ::mpfr_prec_t p)
+{
+    lazy_eval_binary(rop, lazy_sub{}, e.m_l, e.m_r, p);
+}
+
+// Evaluate the lazy expression e into rop. The precision of rop
+// (and of the temporary values) is p.
+template <typename T>
+inline void lazy_eval_into(T &rop, const lazy_term<T> &e, ::mpfr_prec_t)
+{
+    if (e.m_ptr != &rop) {
+        lazy_traits<T>::set(lazy_traits<T>::get(rop), lazy_traits<T>::get(*e.m_ptr));
+    }
+}
+
+template <typename T, typename Op, typename L, typename R>
+inline void lazy_eval_into(T &rop, const lazy_binary<Op, L, R> &e, ::mpfr_prec_t p)
+{
+    lazy_eval_binary(rop, Op{}, e.m_l, e.m_r, p);
+}
+
+template <typename T, typename A>
+inline void lazy_eval_into(T &rop, const lazy_neg<A> &e, ::mpfr_prec_t p)
+{
+    lazy_tmp<T> t;
+    // NOTE: rop can always be used for the operand of a negation.
+    const auto a = lazy_operand(rop, e.m_arg, true, t, p);
+    lazy_traits<T>::neg(lazy_traits<T>::get(rop), a);
+}
+
+// a * b + c.
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &rop, const lazy_binary<lazy_add, lazy_binary<lazy_mul, A, B>, C> &e, ::mpfr_prec_t p)
+{
+    lazy_eval_fused<false>(rop, e.m_l.m_l, e.m_l.m_r, e.m_r, p);
+}
+
+// c + a * b.
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &rop, const lazy_binary<lazy_add, C, lazy_binary<lazy_mul, A, B>> &e, ::mpfr_prec_t p)
+{
+    lazy_eval_fused<false>(rop, e.m_r.m_l, e.m_r.m_r, e.m_l, p);
+}
+
+// a * b + c * d.
+template <typename T, typename A, typename B, typename C, typename D>
+inline void lazy_eval_into(T &rop,
+                           const lazy_binary<lazy_add, lazy_binary<lazy_mul, A, B>, lazy_binary<lazy_mul, C, D>> &e,
+                           ::mpfr_prec_t p)
+{
+    lazy_eval_fused<false>(rop, e.m_l.m_l, e.m_l.m_r, e.m_r, p);
+}
+
+// a * b - c.
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &rop, const lazy_binary<lazy_sub, lazy_binary<lazy_mul, A, B>, C> &e, ::mpfr_prec_t p)
+{
+    lazy_eval_fms(std::integral_constant<bool, lazy_traits<T>::has_fms>{}, rop, e, e.m_l.m_l, e.m_l.m_r, e.m_r, p);
+}
+
+// c - a * b, computed as -(a * b - c).
+template <typename T, typename A, typename B, typename C>
+inline void lazy_eval_into(T &rop, const lazy_binary<lazy_sub, C, lazy_binary<lazy_mul, A, B>> &e, ::mpfr_prec_t p)
+{
+    lazy_eval_fms(std::integral_constant<bool, lazy_traits<T>::has_fms>{}, rop, e, e.m_r.m_l, e.m_r.m_r, e.m_l, p);
+    if (lazy_traits<T>::has_fms) {
+        lazy_traits<T>::neg(lazy_traits<T>::get(rop), lazy_traits<T>::get(rop));
+    }
+}
+
+// a * b - c * d.
+template <typename T, typename A, typename B, typename C, typename D>
+inline void lazy_eval_into(T &rop,
+                           const lazy_binary<lazy_sub, lazy_binary<lazy_mul, A, B>, lazy_binary<lazy_mul, C, D>> &e,
+                           ::mpfr_prec_t p)
+{
+    lazy_eval_fms(std::integral_constant<bool, lazy_traits<T>::has_fms>{}, rop, e, e.m_l.m_l, e.m_l.m_r, e.m_r, p);
+}
+
+} // namespace detail
+
+template <typename T>
+using is_lazy_expr = detail::is_lazy_expr<T>;
+
+#if defined(MPPP_HAVE_CONCEPTS)
+
+template <typename T>
+MPPP_CONCEPT_DECL lazy_expr = is_lazy_expr<T>::value;
+
+#endif
+
+// Start a lazy expression.
+// NOTE: the expression refers to its argument, thus
+// starting an expression from an rvalue is disabled.
+inline detail::lazy_term<real> lazy(const real &x)
+{
+    return detail::lazy_term<real>{&x};
+}
+
+detail::lazy_term<real> lazy(const real &&) = delete;
+
+#if defined(MPPP_WITH_MPC)
+
+inline detail::lazy_term<complex> lazy(const complex &c)
+{
+    return detail::lazy_term<complex>{&c};
+}
+
+detail::lazy_term<complex> lazy(const complex &&) = delete;
+
+#endif
+
+// Evaluate a lazy expression into rop.
+#if defined(MPPP_HAVE_CONCEPTS)
+template <lazy_expr E>
+#else
+template <typename E, detail::enable_if_t<is_lazy_expr<E>::value, int> = 0>
+#endif
+inline detail::lazy_value_t<E> &eval(detail::lazy_value_t<E> &rop, const E &e)
+{
+    const auto p = detail::lazy_prec(e);
+    const auto r_prec = rop.get_prec();
+    if (r_prec > p) {
+        // NOTE: if the precision of rop is larger than the
+        // precision of the expression, rop is not in the expression.
+        // Thus, we can set the precision destructively.
+        rop.set_prec(p);
+    } else if (r_prec < p) {
+        // NOTE: rop may be in the expression, set the precision
+        // without changing its value.
+        rop.prec_round(p);
+    }
+    detail::lazy_eval_into(rop, e, p);
+    return rop;
+}
+
+// Evaluate a lazy expression.
+#if defined(MPPP_HAVE_CONCEPTS)
+template <lazy_expr E>
+#else
+template <typename E, detail::enable_if_t<is_lazy_expr<E>::value, int> = 0>
+#endif
+inline detail::lazy_value_t<E> eval(const E &e)
+{
+    using value_t = detail::lazy_value_t<E>;
+
+    const auto p = detail::lazy_prec(e);
+    auto retval = detail::lazy_traits<value_t>::make(p);
+    detail::lazy_eval_into(retval, e, p);
+    return retval;
+}
+
+MPPP_END_NAMESPACE
+
+#endif
+
+#endif
@@ -12,10 +12,13 @@
 #include <mp++/config.hpp>
 #include <mp++/exceptions.hpp>
 #include <mp++/integer.hpp>
+#include <mp++/integer_vector.hpp>
 #include <mp++/rational.hpp>
+#include <mp++/relocate.hpp>
 #include <mp++/type_name.hpp>
 
 #if defined(MPPP_WITH_MPFR)
+#include <mp++/lazy.hpp>
 #include <mp++/real.hpp>
 #endif
 
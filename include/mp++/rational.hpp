@@ -54,6 +54,7 @@
 #include <mp++/exceptions.hpp>
 #include <mp++/fwd.hpp>
 #include <mp++/integer.hpp>
+#include <mp++/relocate.hpp>
 #include <mp++/type_name.hpp>
 
 #if defined(MPPP_WITH_MPFR)
@@ -235,10 +236,13 @@ private:
             throw std::domain_error("Cannot construct a rational from the non-finite floating-point value "
                                     + detail::to_string(x));
         }
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpq_raii q;
         mpq_set_d(&q.m_mpq, static_cast<double>(x));
-        m_num = mpq_numref(&q.m_mpq);
-        m_den = mpq_denref(&q.m_mpq);
+        mb.escape([&]() {
+            m_num = mpq_numref(&q.m_mpq);
+            m_den = mpq_denref(&q.m_mpq);
+        });
     }
 #if defined(MPPP_WITH_MPFR)
     explicit rational(const ptag &, const long double &x)
@@ -249,6 +253,7 @@ private:
         }
         // NOTE: static checks for overflows and for the precision value are done in mpfr.hpp.
         constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
         MPPP_MAYBE_TLS detail::mpf_raii mpf(static_cast<::mp_bitcnt_t>(d2));
         MPPP_MAYBE_TLS detail::mpq_raii mpq;
@@ -263,8 +268,10 @@ private:
 #endif
         ::mpfr_get_f(&mpf.m_mpf, &mpfr.m_mpfr, MPFR_RNDN);
         mpq_set_f(&mpq.m_mpq, &mpf.m_mpf);
-        m_num = mpq_numref(&mpq.m_mpq);
-        m_den = mpq_denref(&mpq.m_mpq);
+        mb.escape([&]() {
+            m_num = mpq_numref(&mpq.m_mpq);
+            m_den = mpq_denref(&mpq.m_mpq);
+        });
     }
 #endif
     template <typename T, detail::enable_if_t<is_rational_cvr_integral_interoperable<T, SSize>::value, int> = 0>
@@ -537,6 +544,7 @@ private:
     MPPP_NODISCARD std::pair<bool, T> dispatch_conversion() const
     {
         constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
         const auto v = detail::get_mpq_view(*this);
         ::mpfr_set_q(&mpfr.m_mpfr, &v, MPFR_RNDN);
@@ -662,6 +670,7 @@ public:
             return true;
         }
         // Num and den must be coprime.
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS int_t g;
         gcd(g, m_num, m_den);
         return g.is_one();
@@ -25,6 +25,7 @@
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -61,6 +62,7 @@
 #include <mp++/fwd.hpp>
 #include <mp++/integer.hpp>
 #include <mp++/rational.hpp>
+#include <mp++/relocate.hpp>
 #include <mp++/type_name.hpp>
 
 #if defined(MPPP_WITH_QUADMATH)
@@ -155,6 +157,36 @@ inline ::mpfr_prec_t real_deduce_precision(const real128 &)
 
 #endif
 
+// Check if the long double or real128 x is represented exactly by a double.
+// If this is the case, the mixed-mode arithmetic operations between reals and x
+// can use the MPFR primitives for double (e.g., mpfr_add_d()) instead of a temporary real.
+inline bool real_fp_is_double(const long double &x)
+{
+    // NOTE: non-finite values are represented exactly.
+    if (!std::isfinite(x)) {
+        return true;
+    }
+
+    // NOTE: check the range first in order to avoid undefined behaviour
+    // in the conversion to double.
+    return std::abs(x) <= static_cast<long double>(nl_max<double>())
+           && static_cast<long double>(static_cast<double>(x)) == x;
+}
+
+#if defined(MPPP_WITH_QUADMATH)
+
+inline bool real_fp_is_double(const real128 &x)
+{
+    if (!x.finite()) {
+        return true;
+    }
+
+    const auto v = x.m_value;
+    return (v < 0 ? -v : v) <= nl_max<double>() && static_cast<__float128>(static_cast<double>(v)) == v;
+}
+
+#endif
+
 // Fwd declare for friendship.
 template <bool, typename F, typename Arg0, typename... Args>
 real &mpfr_nary_op_impl(::mpfr_prec_t, const F &, real &, Arg0 &&, Args &&...);
@@ -165,6 +197,16 @@ real mpfr_nary_op_return_impl(::mpfr_prec_t, const F &, Arg0 &&, Args &&...);
 template <typename F>
 real real_constant(const F &, ::mpfr_prec_t);
 
+inline real *mpfr_nary_op2_setup_rop(real &, ::mpfr_prec_t, real *&);
+
+template <bool, typename F, typename Arg0, typename... Args>
+std::pair<real, real> mpfr_nary_op2_return_impl(::mpfr_prec_t, const F &, Arg0 &&, Args &&...);
+
+// Init/clear the dynamic storage of a real via the thread-local
+// significand cache.
+MPPP_DLL_PUBLIC void mpfr_init_cached(mpfr_struct_t &, ::mpfr_prec_t);
+MPPP_DLL_PUBLIC void mpfr_clear_cached(mpfr_struct_t &);
+
 // Wrapper for calling mpfr_lgamma().
 MPPP_DLL_PUBLIC void real_lgamma_wrapper(::mpfr_t, const ::mpfr_t, ::mpfr_rnd_t);
 
@@ -258,14 +300,23 @@ enum class real_kind : std::underlying_type<::mpfr_kind_t>::type {
 //   and mpfr_set_z_2exp()?
 // - Do we need real_equal_to() to work also on invalid reals, the way
 //   real_lt/gt() do?
-// - Not sure what the caching situation is currently. The MPFR 4 changelog mentions it:
-//   https://www.mpfr.org/mpfr-4.0.0/#changes
-//   But experiments with valgrind and the real_alloc benchmark seem to indicate
-//   that no caching is done. Need to revisit this.
+// - MPFR does not cache the significands of mpfr_t objects (the caches mentioned in the
+//   MPFR 4 changelog are for constants and temporaries). Small significands live in the
+//   static storage, larger ones are recycled via the thread-local significand cache in real.cpp.
+//   We could consider size classes for the precisions above the cache limit,
+//   as in the integer cache.
 
 // Multiprecision floating-point class.
 class MPPP_DLL_PUBLIC real
 {
+public:
+    // Number of limbs in the static storage.
+    static constexpr std::size_t ssize = 4;
+
+private:
+    // The largest precision which fits in the static storage.
+    static constexpr ::mpfr_prec_t static_prec_max = static_cast<::mpfr_prec_t>(ssize * GMP_NUMB_BITS);
+
 #if defined(MPPP_WITH_BOOST_S11N)
     friend class boost::serialization::access;
 
@@ -305,6 +356,11 @@ class MPPP_DLL_PUBLIC real
     template <typename F>
     // NOLINTNEXTLINE(readability-redundant-declaration)
     friend real detail::real_constant(const F &, ::mpfr_prec_t);
+    // NOLINTNEXTLINE(readability-redundant-declaration)
+    friend real *detail::mpfr_nary_op2_setup_rop(real &, ::mpfr_prec_t, real *&);
+    template <bool, typename F, typename Arg0, typename... Args>
+    // NOLINTNEXTLINE(readability-redundant-declaration)
+    friend std::pair<real, real> detail::mpfr_nary_op2_return_impl(::mpfr_prec_t, const F &, Arg0 &&, Args &&...);
     // Utility function to check the precision upon init.
     static ::mpfr_prec_t check_init_prec(::mpfr_prec_t p)
     {
@@ -315,6 +371,50 @@ class MPPP_DLL_PUBLIC real
         }
         return p;
     }
+    // Init the storage of this with precision p, setting the value to NaN.
+    // No precision checking is performed.
+    // NOTE: if p is small enough, the significand is placed in the static
+    // storage via the MPFR custom interface, otherwise it is taken from
+    // the significand cache or allocated by mpfr_init2().
+    void init_storage(::mpfr_prec_t p)
+    {
+        if (p <= static_prec_max) {
+            mpfr_custom_init(m_limbs.data(), p);
+            mpfr_custom_init_set(&m_mpfr, MPFR_NAN_KIND, 0, p, m_limbs.data());
+        } else {
+            detail::mpfr_init_cached(m_mpfr, p);
+        }
+    }
+    // Free the storage of this (or return it to the
+    // significand cache), if dynamically allocated.
+    void clear_storage()
+    {
+        if (!is_static()) {
+            detail::mpfr_clear_cached(m_mpfr);
+        }
+    }
+    // Swap the storage of this and other.
+    // NOTE: the significand of a real in static storage points
+    // to the object itself, so we cannot just swap the mpfr_t structs.
+    // Neither can we use mpfr_swap(), which would swap the pointers as well.
+    void swap_storage(real &other) noexcept
+    {
+        const auto s1 = is_static(), s2 = other.is_static();
+        std::swap(m_mpfr, other.m_mpfr);
+        if (s1 || s2) {
+            std::swap(m_limbs, other.m_limbs);
+            if (s2) {
+                m_mpfr._mpfr_d = m_limbs.data();
+            }
+            if (s1) {
+                other.m_mpfr._mpfr_d = other.m_limbs.data();
+            }
+        }
+    }
+    // NOTE: swap() needs access to swap_storage().
+    friend void swap(real &, real &) noexcept;
+    // Implementation of prec_round() for reals in static storage.
+    void static_prec_round(::mpfr_prec_t);
 
 #if defined(MPPP_WITH_MPC)
     // NOTE: the complex class needs access to some
@@ -326,6 +426,21 @@ class MPPP_DLL_PUBLIC real
     struct shallow_copy_t {
     };
     explicit real(shallow_copy_t, const ::mpfr_t r) : m_mpfr(r[0]) {}
+
+    // Move the value of this into the uninitialised mpfr_t rop, marking this
+    // as moved-from. Used by the complex class to steal the real and imaginary
+    // parts from reals. If this is in static storage, the significand of rop
+    // will be dynamically allocated.
+    void move_into(mpfr_struct_t &rop)
+    {
+        if (is_static()) {
+            detail::mpfr_init_cached(rop, mpfr_get_prec(&m_mpfr));
+            mpfr_set(&rop, &m_mpfr, MPFR_RNDN);
+        } else {
+            rop = m_mpfr;
+        }
+        m_mpfr._mpfr_d = nullptr;
+    }
 #endif
 
 public:
@@ -348,6 +463,12 @@ public:
         : // Shallow copy other.
           m_mpfr(other.m_mpfr)
     {
+        // If other is in static storage, copy over
+        // the limbs and point the significand to them.
+        if (other.is_static()) {
+            m_limbs = other.m_limbs;
+            m_mpfr._mpfr_d = m_limbs.data();
+        }
         // Mark the other as moved-from.
         other.m_mpfr._mpfr_d = nullptr;
     }
@@ -537,9 +658,9 @@ public:
         //
         // Here however it is fine, as we know there are no side effects we need to maintain.
         //
-        // NOTE: we use a raw std::swap() here (instead of mpfr_swap()) because we don't know in principle
+        // NOTE: we don't use mpfr_swap() here because we don't know in principle
         // if mpfr_swap() relies on the operands not to be in a moved-from state (although it's unlikely).
-        std::swap(m_mpfr, other.m_mpfr);
+        swap_storage(other);
         return *this;
     }
 
@@ -688,6 +809,12 @@ public:
         return m_mpfr._mpfr_d != nullptr;
     }
 
+    // Check if this is in static storage.
+    MPPP_NODISCARD bool is_static() const noexcept
+    {
+        return m_mpfr._mpfr_d == m_limbs.data();
+    }
+
     // Set to another real.
     real &set(const real &);
 
@@ -828,16 +955,34 @@ private:
         return p;
     }
     // mpfr_set_prec() wrapper, with or without prec checking.
+    // NOTE: mpfr_set_prec() and mpfr_prec_round() may reallocate the significand,
+    // thus they must not be used on the static storage. A real in static storage
+    // is moved to dynamic storage only if the new precision does not fit in the
+    // static storage. A real in dynamic storage stays in dynamic storage.
     template <bool Check>
     void set_prec_impl(::mpfr_prec_t p)
     {
-        ::mpfr_set_prec(&m_mpfr, Check ? check_set_prec(p) : p);
+        if (Check) {
+            check_set_prec(p);
+        }
+        if (is_static()) {
+            init_storage(p);
+        } else {
+            ::mpfr_set_prec(&m_mpfr, p);
+        }
     }
     // mpfr_prec_round() wrapper, with or without prec checking.
     template <bool Check>
     void prec_round_impl(::mpfr_prec_t p)
     {
-        ::mpfr_prec_round(&m_mpfr, Check ? check_set_prec(p) : p, MPFR_RNDN);
+        if (Check) {
+            check_set_prec(p);
+        }
+        if (is_static()) {
+            static_prec_round(p);
+        } else {
+            ::mpfr_prec_round(&m_mpfr, p, MPFR_RNDN);
+        }
     }
 
 public:
@@ -855,28 +1000,31 @@ private:
         if (mppp_unlikely(!number_p())) {
             throw std::domain_error("Cannot convert a non-finite real to an integer");
         }
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpz_raii mpz;
         // Truncate the value when converting to integer.
         ::mpfr_get_z(&mpz.m_mpz, &m_mpfr, MPFR_RNDZ);
-        return T{&mpz.m_mpz};
+        return mb.escape([&]() { return T{&mpz.m_mpz}; });
     }
     // rational.
     template <std::size_t SSize>
     bool rational_conversion(rational<SSize> &rop) const
     {
 #if defined(MPPP_MPFR_HAVE_MPFR_GET_Q)
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpq_raii mpq;
         // NOTE: we already checked outside
         // that rop is a finite number, hence
         // this function cannot fail.
         ::mpfr_get_q(&mpq.m_mpq, &m_mpfr);
-        rop = &mpq.m_mpq;
+        mb.escape([&]() { rop = &mpq.m_mpq; });
         return true;
 #else
         // Clear the range error flag before attempting the conversion.
         ::mpfr_clear_erangeflag();
         // NOTE: this call can fail if the exponent of this is very close to the upper/lower limits of the exponent
         // type. If the call fails (signalled by a range flag being set), we will return error.
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpz_raii mpz;
         const ::mpfr_exp_t exp2 = ::mpfr_get_z_2exp(&mpz.m_mpz, &m_mpfr);
         // NOTE: not sure at the moment how to trigger this, let's leave it for now.
@@ -889,16 +1037,18 @@ private:
         // LCOV_EXCL_STOP
         // The conversion to n * 2**exp succeeded. We will build a rational
         // from n and exp.
-        rop._get_num() = &mpz.m_mpz;
-        rop._get_den().set_one();
-        if (exp2 >= ::mpfr_exp_t(0)) {
-            // The output value will be an integer.
-            rop._get_num() <<= detail::make_unsigned(exp2);
-        } else {
-            // The output value will be a rational. Canonicalisation will be needed.
-            rop._get_den() <<= detail::nint_abs(exp2);
-            canonicalise(rop);
-        }
+        mb.escape([&]() {
+            rop._get_num() = &mpz.m_mpz;
+            rop._get_den().set_one();
+            if (exp2 >= ::mpfr_exp_t(0)) {
+                // The output value will be an integer.
+                rop._get_num() <<= detail::make_unsigned(exp2);
+            } else {
+                // The output value will be a rational. Canonicalisation will be needed.
+                rop._get_den() <<= detail::nint_abs(exp2);
+                canonicalise(rop);
+            }
+        });
         return true;
 #endif
     }
@@ -1065,10 +1215,11 @@ private:
         if (!number_p()) {
             return false;
         }
+        const detail::mpz_default_memory_binding mb;
         MPPP_MAYBE_TLS detail::mpz_raii mpz;
         // Truncate the value when converting to integer.
         ::mpfr_get_z(&mpz.m_mpz, &m_mpfr, MPFR_RNDZ);
-        rop = &mpz.m_mpz;
+        mb.escape([&]() { rop = &mpz.m_mpz; });
         return true;
     }
     template <std::size_t SSize>
@@ -1322,6 +1473,8 @@ public:
 
 private:
     mpfr_struct_t m_mpfr;
+    // NOTE: the static storage for the significand.
+    std::array<::mp_limb_t, ssize> m_limbs;
 };
 
 template <typename T, typename U>
@@ -1370,6 +1523,22 @@ inline std::size_t get_nlimbs(const real &r)
 
 MPPP_DLL_PUBLIC std::size_t prec_to_nlimbs(mpfr_prec_t);
 
+// Free the significand cache.
+MPPP_DLL_PUBLIC void free_real_cache();
+
+// Statistics of the significand cache.
+struct real_cache_stats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+};
+
+// Configuration and monitoring of the significand cache.
+MPPP_DLL_PUBLIC void set_real_cache_limits(std::size_t, std::size_t);
+MPPP_DLL_PUBLIC std::pair<std::size_t, std::size_t> get_real_cache_limits();
+MPPP_DLL_PUBLIC real_cache_stats get_real_cache_stats();
+MPPP_DLL_PUBLIC void reset_real_cache_stats();
+
 namespace detail
 {
 
@@ -1413,7 +1582,7 @@ template <std::size_t SSize>
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init, bugprone-easily-swappable-parameters)
 inline real::real(const integer<SSize> &n, ::mpfr_exp_t e, ::mpfr_prec_t p)
 {
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     set_z_2exp(*this, n, e);
 }
 
@@ -1438,7 +1607,7 @@ inline real &set_zero(real &r, int sign = 0)
 // Swap.
 inline void swap(real &a, real &b) noexcept
 {
-    ::mpfr_swap(a._get_mpfr_t(), b._get_mpfr_t());
+    a.swap_storage(b);
 }
 
 // Generic conversion functions.
@@ -1469,6 +1638,7 @@ inline mpfr_exp_t get_z_2exp(integer<SSize> &n, const real &r)
     if (mppp_unlikely(!r.number_p())) {
         throw std::domain_error("Cannot extract the significand and the exponent of a non-finite real");
     }
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS detail::mpz_raii m;
     ::mpfr_clear_erangeflag();
     auto retval = ::mpfr_get_z_2exp(&m.m_mpz, r.get_mpfr_t());
@@ -1479,7 +1649,7 @@ inline mpfr_exp_t get_z_2exp(integer<SSize> &n, const real &r)
                                   + ": the exponent's magnitude is too large");
     }
     // LCOV_EXCL_STOP
-    n = &m.m_mpz;
+    mb.escape([&]() { n = &m.m_mpz; });
     return retval;
 }
 
@@ -1702,6 +1872,126 @@ inline real mpfr_nary_op_return_impl(::mpfr_prec_t min_prec, const F &f, Arg0 &&
     }
 }
 
+// Helper to prepare the return value rop of an MPFR-like function with two outputs
+// for an invocation with target precision p. steal is either null or an argument
+// with precision p which can be used as output instead of rop.
+//
+// The return value is a pointer to the object to be used as output, which will be
+// either rop or steal. In the latter case, steal is set to null so that it is not used
+// for the other output.
+inline real *mpfr_nary_op2_setup_rop(real &rop, ::mpfr_prec_t p, real *&steal)
+{
+    const auto r_prec = rop.get_prec();
+
+    if (p == r_prec) {
+        return &rop;
+    }
+
+    if (r_prec > p) {
+        // NOTE: rop does not overlap with any argument,
+        // we can reset its precision destructively.
+        rop.set_prec_impl<false>(p);
+        return &rop;
+    }
+
+    if (steal != nullptr) {
+        auto *retval = steal;
+        steal = nullptr;
+        return retval;
+    }
+
+    // NOTE: rop might overlap with one of the arguments,
+    // change the precision without destroying its value.
+    rop.prec_round_impl<false>(p);
+    return &rop;
+}
+
+// The goal of this helper is to invoke the MPFR-like function object f with two outputs and signature
+//
+// void f(mpfr_t out1, mpfr_t out2, const mpfr_t x0, const mpfr_t x1, ...)
+//
+// on the mpfr_t instances contained in the input real objects,
+//
+// f(rop1._get_mpfr_t(), rop2._get_mpfr_t(), arg0.get_mpfr_t(), arg1.get_mpfr_t(), ...)
+//
+// The helper will ensure that, before the invocation, the precision
+// of rop1 and rop2 is set to max(min_prec, arg0.get_prec(), arg1.get_prec(), ...).
+//
+// As in mpfr_nary_op_impl(), one of the input arguments may be used as output in the
+// invocation instead of rop1 or rop2 if it provides enough precision and it is passed
+// as a non-const rvalue reference. In such a case, the selected input argument will be
+// swapped into the corresponding return value after the invocation.
+//
+// rop1 and rop2 must be distinct objects, and the MPFR-like function object being called
+// must support overlapping arguments (between the inputs and each output).
+template <bool Rnd, typename F, typename Arg0, typename... Args>
+inline void mpfr_nary_op2_impl(::mpfr_prec_t min_prec, const F &f, real &rop1, real &rop2, Arg0 &&arg0,
+                               Args &&...args)
+{
+    assert(min_prec == 0 || real_prec_check(min_prec));
+    assert(&rop1 != &rop2);
+
+    auto p = mpfr_nary_op_init_pair(min_prec, std::forward<Arg0>(arg0));
+    mpfr_nary_op_check_steal(p, std::forward<Args>(args)...);
+
+    // NOTE: we can steal from the candidate only if it has the target
+    // precision and it is not one of the return values (in which case
+    // the two outputs could end up being the same object).
+    auto *steal = (p.first && p.first->get_prec() == p.second && p.first != &rop1 && p.first != &rop2)
+                      ? p.first
+                      : nullptr;
+
+    auto *out1 = mpfr_nary_op2_setup_rop(rop1, p.second, steal);
+    auto *out2 = mpfr_nary_op2_setup_rop(rop2, p.second, steal);
+
+    mpfr_nary_func_wrapper(std::integral_constant<bool, Rnd>{}, f, out1->_get_mpfr_t(), out2->_get_mpfr_t(),
+                           arg0.get_mpfr_t(), args.get_mpfr_t()...);
+
+    if (out1 != &rop1) {
+        swap(*out1, rop1);
+    }
+    if (out2 != &rop2) {
+        swap(*out2, rop2);
+    }
+}
+
+// The goal of this helper is to invoke the MPFR-like function object f with two outputs and signature
+//
+// void f(mpfr_t out1, mpfr_t out2, const mpfr_t x0, const mpfr_t x1, ...)
+//
+// on the mpfr_t instances contained in the input real objects, and then return
+// the two outputs as a pair.
+//
+// The outputs will be created within the helper with a precision
+// set to max(min_prec, arg0.get_prec(), arg1.get_prec(), ...). As in mpfr_nary_op_return_impl(),
+// one of the input arguments will be used as first output instead if it provides enough
+// precision and it is passed as a non-const rvalue reference.
+//
+// The MPFR-like function object being called must support overlapping
+// arguments (between the inputs and each output).
+template <bool Rnd, typename F, typename Arg0, typename... Args>
+inline std::pair<real, real> mpfr_nary_op2_return_impl(::mpfr_prec_t min_prec, const F &f, Arg0 &&arg0,
+                                                        Args &&...args)
+{
+    assert(min_prec == 0 || real_prec_check(min_prec));
+
+    auto p = mpfr_nary_op_init_pair(min_prec, std::forward<Arg0>(arg0));
+    mpfr_nary_op_check_steal(p, std::forward<Args>(args)...);
+
+    real out2{real::ptag{}, p.second, true};
+
+    if (p.first && p.first->get_prec() == p.second) {
+        mpfr_nary_func_wrapper(std::integral_constant<bool, Rnd>{}, f, p.first->_get_mpfr_t(), out2._get_mpfr_t(),
+                               arg0.get_mpfr_t(), args.get_mpfr_t()...);
+        return std::make_pair(std::move(*p.first), std::move(out2));
+    } else {
+        real out1{real::ptag{}, p.second, true};
+        mpfr_nary_func_wrapper(std::integral_constant<bool, Rnd>{}, f, out1._get_mpfr_t(), out2._get_mpfr_t(),
+                               arg0.get_mpfr_t(), args.get_mpfr_t()...);
+        return std::make_pair(std::move(out1), std::move(out2));
+    }
+}
+
 } // namespace detail
 
 // Ternary addition.
@@ -2049,20 +2339,22 @@ MPPP_DLL_PUBLIC bool real_gt(const real &, const real &);
               enable_if_t<conjunction<is_cvr_real<T>, is_real_interoperable<U>>::value, int> = 0>                      \
     inline real dispatch_##name(T &&a, const U &x)                                                                     \
     {                                                                                                                  \
+        const mpz_default_memory_binding mb;                                                                           \
         MPPP_MAYBE_TLS real tmp;                                                                                       \
         tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));                                                   \
         tmp.set(x);                                                                                                    \
-        return dispatch_##name(std::forward<T>(a), tmp);                                                               \
+        return mb.escape([&]() { return dispatch_##name(std::forward<T>(a), tmp); });                                  \
     }                                                                                                                  \
     /* Only the second argument is real. */                                                                            \
     template <typename T, typename U,                                                                                  \
               enable_if_t<conjunction<is_real_interoperable<T>, is_cvr_real<U>>::value, int> = 0>                      \
     inline real dispatch_##name(const T &x, U &&a)                                                                     \
     {                                                                                                                  \
+        const mpz_default_memory_binding mb;                                                                           \
         MPPP_MAYBE_TLS real tmp;                                                                                       \
         tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));                                                   \
         tmp.set(x);                                                                                                    \
-        return dispatch_##name(tmp, std::forward<U>(a));                                                               \
+        return mb.escape([&]() { return dispatch_##name(tmp, std::forward<U>(a)); });                                  \
     }                                                                                                                  \
     }                                                                                                                  \
     /* The overload which returns the result. */                                                                       \
@@ -2203,10 +2495,11 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_pow(T &&a, const U &x)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_pow(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_real_pow(std::forward<T>(a), tmp); });
 }
 
 // (everything but unsigned integral)-real.
@@ -2216,10 +2509,11 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_pow(const T &x, U &&a)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_pow(tmp, std::forward<U>(a));
+    return mb.escape([&]() { return dispatch_real_pow(tmp, std::forward<U>(a)); });
 }
 
 // unsigned integral-real.
@@ -2288,10 +2582,6 @@ MPPP_REAL_MPFR_UNARY_IMPL(acos, ::mpfr_acos, true)
 MPPP_REAL_MPFR_UNARY_IMPL(atan, ::mpfr_atan, true)
 
 // sin and cos at the same time.
-// NOTE: we don't have the machinery to steal resources
-// for multiple retvals, thus we do a manual implementation
-// of this function. We keep the signature with cvr_real
-// for consistency with the other functions.
 #if defined(MPPP_HAVE_CONCEPTS)
 template <cvr_real T>
 #else
@@ -2304,16 +2594,17 @@ inline void sin_cos(real &sop, real &cop, T &&op)
             "In the real sin_cos() function, the return values 'sop' and 'cop' must be distinct objects");
     }
 
-    // Set the precision of sop and cop to the
-    // precision of op.
-    const auto op_prec = op.get_prec();
-    // NOTE: use prec_round() to avoid issues in case
-    // sop/cop overlap with op.
-    sop.prec_round(op_prec);
-    cop.prec_round(op_prec);
+    detail::mpfr_nary_op2_impl<true>(0, ::mpfr_sin_cos, sop, cop, std::forward<T>(op));
+}
 
-    // Run the mpfr function.
-    ::mpfr_sin_cos(sop._get_mpfr_t(), cop._get_mpfr_t(), op.get_mpfr_t(), MPFR_RNDN);
+#if defined(MPPP_HAVE_CONCEPTS)
+template <cvr_real T>
+#else
+template <typename T, cvr_real_enabler<T> = 0>
+#endif
+inline std::pair<real, real> sin_cos(T &&op)
+{
+    return detail::mpfr_nary_op2_return_impl<true>(0, ::mpfr_sin_cos, std::forward<T>(op));
 }
 
 MPPP_REAL_MPFR_BINARY_IMPL(atan2, ::mpfr_atan2, true)
@@ -2330,10 +2621,6 @@ MPPP_REAL_MPFR_UNARY_IMPL(acosh, ::mpfr_acosh, true)
 MPPP_REAL_MPFR_UNARY_IMPL(atanh, ::mpfr_atanh, true)
 
 // sinh and cosh at the same time.
-// NOTE: we don't have the machinery to steal resources
-// for multiple retvals, thus we do a manual implementation
-// of this function. We keep the signature with cvr_real
-// for consistency with the other functions.
 #if defined(MPPP_HAVE_CONCEPTS)
 template <cvr_real T>
 #else
@@ -2346,16 +2633,17 @@ inline void sinh_cosh(real &sop, real &cop, T &&op)
             "In the real sinh_cosh() function, the return values 'sop' and 'cop' must be distinct objects");
     }
 
-    // Set the precision of sop and cop to the
-    // precision of op.
-    const auto op_prec = op.get_prec();
-    // NOTE: use prec_round() to avoid issues in case
-    // sop/cop overlap with op.
-    sop.prec_round(op_prec);
-    cop.prec_round(op_prec);
+    detail::mpfr_nary_op2_impl<true>(0, ::mpfr_sinh_cosh, sop, cop, std::forward<T>(op));
+}
 
-    // Run the mpfr function.
-    ::mpfr_sinh_cosh(sop._get_mpfr_t(), cop._get_mpfr_t(), op.get_mpfr_t(), MPFR_RNDN);
+#if defined(MPPP_HAVE_CONCEPTS)
+template <cvr_real T>
+#else
+template <typename T, cvr_real_enabler<T> = 0>
+#endif
+inline std::pair<real, real> sinh_cosh(T &&op)
+{
+    return detail::mpfr_nary_op2_return_impl<true>(0, ::mpfr_sinh_cosh, std::forward<T>(op));
 }
 
 // Exponentials and logarithms.
@@ -2542,10 +2830,6 @@ MPPP_REAL_MPFR_UNARY_IMPL(trunc, detail::real_trunc_wrapper, false)
 MPPP_REAL_MPFR_UNARY_IMPL(frac, detail::real_frac_wrapper, false)
 
 // modf.
-// NOTE: we don't have the machinery to steal resources
-// for multiple retvals, thus we do a manual implementation
-// of this function. We keep the signature with cvr_real
-// for consistency with the other functions.
 #if defined(MPPP_HAVE_CONCEPTS)
 template <cvr_real T>
 #else
@@ -2561,16 +2845,21 @@ inline void modf(real &iop, real &fop, T &&op)
         throw std::domain_error("In the real modf() function, the input argument cannot be NaN");
     }
 
-    // Set the precision of iop and fop to the
-    // precision of op.
-    const auto op_prec = op.get_prec();
-    // NOTE: use prec_round() to avoid issues in case
-    // iop/fop overlap with op.
-    iop.prec_round(op_prec);
-    fop.prec_round(op_prec);
+    detail::mpfr_nary_op2_impl<true>(0, ::mpfr_modf, iop, fop, std::forward<T>(op));
+}
+
+#if defined(MPPP_HAVE_CONCEPTS)
+template <cvr_real T>
+#else
+template <typename T, cvr_real_enabler<T> = 0>
+#endif
+inline std::pair<real, real> modf(T &&op)
+{
+    if (mppp_unlikely(op.nan_p())) {
+        throw std::domain_error("In the real modf() function, the input argument cannot be NaN");
+    }
 
-    // Run the mpfr function.
-    ::mpfr_modf(iop._get_mpfr_t(), fop._get_mpfr_t(), op.get_mpfr_t(), MPFR_RNDN);
+    return detail::mpfr_nary_op2_return_impl<true>(0, ::mpfr_modf, std::forward<T>(op));
 }
 
 MPPP_REAL_MPFR_BINARY_IMPL(fmod, ::mpfr_fmod, true)
@@ -2621,14 +2910,17 @@ inline real &nexttoward(real &rop, T &&x, const real &y)
     // NOTE: we need to make a copy of y because we don't
     // want to risk changing its value in case it overlaps
     // with rop or x.
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real y_copy;
     y_copy = y;
 
-    rop = std::forward<T>(x);
+    return mb.escape([&]() -> real & {
+        rop = std::forward<T>(x);
 
-    ::mpfr_nexttoward(rop._get_mpfr_t(), y_copy.get_mpfr_t());
+        ::mpfr_nexttoward(rop._get_mpfr_t(), y_copy.get_mpfr_t());
 
-    return rop;
+        return rop;
+    });
 }
 
 #if defined(MPPP_HAVE_CONCEPTS)
@@ -2638,14 +2930,17 @@ template <typename T, cvr_real_enabler<T> = 0>
 #endif
 inline real nexttoward(T &&x, const real &y)
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real y_copy;
     y_copy = y;
 
-    real retval{std::forward<T>(x)};
+    return mb.escape([&]() {
+        real retval{std::forward<T>(x)};
 
-    ::mpfr_nexttoward(retval._get_mpfr_t(), y_copy.get_mpfr_t());
+        ::mpfr_nexttoward(retval._get_mpfr_t(), y_copy.get_mpfr_t());
 
-    return retval;
+        return retval;
+    });
 }
 
 #if defined(MPPP_HAVE_CONCEPTS)
@@ -2677,6 +2972,13 @@ inline real nextafter(T &&x, const real &y)
 // Output stream operator.
 MPPP_DLL_PUBLIC std::ostream &operator<<(std::ostream &, const real &);
 
+// The formats for the conversion of a real to chars.
+enum class real_chars_format { scientific, fixed, shortest };
+
+// Write a real into the range [first, last).
+MPPP_DLL_PUBLIC to_chars_result to_chars(char *, char *, const real &, int = 10);
+MPPP_DLL_PUBLIC to_chars_result to_chars(char *, char *, const real &, real_chars_format, int = -1);
+
 #if defined(MPPP_MPFR_HAVE_MPFR_GET_STR_NDIGITS)
 
 // Get the number of significant digits required for a round-tripping representation.
@@ -2861,10 +3163,18 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_binary_add(T &&a, const U &x)
 {
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_add_d(r, o, static_cast<double>(x), MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_add(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_real_binary_add(std::forward<T>(a), tmp); });
 }
 
 // (long double, real128)-real.
@@ -3181,10 +3491,18 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_binary_sub(T &&a, const U &x)
 {
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_sub_d(r, o, static_cast<double>(x), MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_sub(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_real_binary_sub(std::forward<T>(a), tmp); });
 }
 
 // (long double, real128)-real.
@@ -3199,10 +3517,18 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_binary_sub(const U &x, T &&a)
 {
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_d_sub(r, static_cast<double>(x), o, MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_sub(tmp, std::forward<T>(a));
+    return mb.escape([&]() { return dispatch_real_binary_sub(tmp, std::forward<T>(a)); });
 }
 
 } // namespace detail
@@ -3457,10 +3783,18 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_binary_mul(T &&a, const U &x)
 {
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_mul_d(r, o, static_cast<double>(x), MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_mul(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_real_binary_mul(std::forward<T>(a), tmp); });
 }
 
 // (long double, real128)-real.
@@ -3596,25 +3930,41 @@ inline real dispatch_real_binary_div(T &&a, U &&b)
     return mpfr_nary_op_return_impl<true>(0, ::mpfr_div, std::forward<T>(a), std::forward<U>(b));
 }
 
-// (long double, real128, integer, rational)-real.
-// NOTE: place it here because it is used in the
-// implementations below.
-template <
-    typename T, typename U,
-    enable_if_t<conjunction<is_cvr_real<T>, disjunction<std::is_same<U, long double>, is_integer<U>, is_rational<U>
-#if defined(MPPP_WITH_QUADMATH)
-                                                        ,
-                                                        std::is_same<U, real128>
-#endif
-                                                        >>::value,
-                int>
-    = 0>
-inline real dispatch_real_binary_div(const U &x, T &&a)
+// (long double, real128, integer, rational)-real via a temporary real.
+template <typename T, typename U>
+inline real dispatch_real_binary_div_tmp(const U &x, T &&a)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_div(tmp, std::forward<T>(a));
+    return mb.escape([&]() { return dispatch_real_binary_div(tmp, std::forward<T>(a)); });
+}
+
+// integer-real.
+// NOTE: place it here because it is used in the
+// implementations below.
+template <typename T, std::size_t SSize, enable_if_t<is_cvr_real<T>::value, int> = 0>
+inline real dispatch_real_binary_div(const integer<SSize> &n, T &&a)
+{
+    long l = 0;
+    if (n.get(l)) {
+        // NOTE: MPFR does not have a primitive for the division
+        // of an mpz_t by an mpfr_t, but we can use mpfr_si_div()
+        // if n fits in a long. Keep the precision deduced from n.
+        auto wrapper = [l](::mpfr_t r, const ::mpfr_t o) { ::mpfr_si_div(r, l, o, MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(n), wrapper, std::forward<T>(a));
+    } else {
+        return dispatch_real_binary_div_tmp(n, std::forward<T>(a));
+    }
+}
+
+// rational-real.
+template <typename T, std::size_t SSize, enable_if_t<is_cvr_real<T>::value, int> = 0>
+inline real dispatch_real_binary_div(const rational<SSize> &q, T &&a)
+{
+    return dispatch_real_binary_div_tmp(q, std::forward<T>(a));
 }
 
 // real-integer.
@@ -3750,6 +4100,28 @@ inline real dispatch_real_binary_div(const U &x, T &&a)
     return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
 }
 
+// (long double, real128)-real.
+template <typename T, typename U,
+          enable_if_t<conjunction<is_cvr_real<T>, disjunction<std::is_same<U, long double>
+#if defined(MPPP_WITH_QUADMATH)
+                                                              ,
+                                                              std::is_same<U, real128>
+#endif
+                                                              >>::value,
+                      int>
+          = 0>
+inline real dispatch_real_binary_div(const U &x, T &&a)
+{
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_d_div(r, static_cast<double>(x), o, MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    return dispatch_real_binary_div_tmp(x, std::forward<T>(a));
+}
+
 // real-(long double, real128).
 template <typename T, typename U,
           enable_if_t<conjunction<is_cvr_real<T>, disjunction<std::is_same<U, long double>
@@ -3762,10 +4134,18 @@ template <typename T, typename U,
           = 0>
 inline real dispatch_real_binary_div(T &&a, const U &x)
 {
+    if (real_fp_is_double(x)) {
+        // NOTE: keep the precision deduced from x.
+        auto wrapper = [&x](::mpfr_t r, const ::mpfr_t o) { ::mpfr_div_d(r, o, static_cast<double>(x), MPFR_RNDN); };
+
+        return mpfr_nary_op_return_impl<false>(real_deduce_precision(x), wrapper, std::forward<T>(a));
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    return dispatch_real_binary_div(std::forward<T>(a), tmp);
+    return mb.escape([&]() { return dispatch_real_binary_div(std::forward<T>(a), tmp); });
 }
 
 } // namespace detail
@@ -4635,6 +5015,22 @@ namespace fmt
 
 template <>
 struct formatter<mppp::real> : mppp::detail::to_string_formatter {
+    template <typename FormatContext>
+    auto format(const mppp::real &x, FormatContext &ctx) const -> decltype(ctx.out())
+    {
+        // NOTE: for low precision values, write the representation
+        // into a local buffer rather than into a string.
+        if (x.get_prec() <= 512) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<char, 256> buffer;
+            const auto res = mppp::to_chars(buffer.data(), buffer.data() + buffer.size(), x);
+            if (res.ec == std::errc{}) {
+                return std::copy(buffer.data(), res.ptr, ctx.out());
+            }
+        }
+
+        return fmt::format_to(ctx.out(), "{}", x.to_string());
+    }
 };
 
 } // namespace fmt
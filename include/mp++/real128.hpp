@@ -337,6 +337,7 @@ private:
         } else if (n_bits > sig_digits && d_bits <= sig_digits) {
             // Num's bit size is larger than quad's significand, den's is not. We will shift num down,
             // do the conversion, and then recover the shifted bits in the float128.
+            const detail::mpz_default_memory_binding mb;
             MPPP_MAYBE_TLS integer<SSize> n;
 
             const auto shift = n_bits - sig_digits;
@@ -345,6 +346,7 @@ private:
             return detail::scalblnq(retval, detail::safe_cast<long>(shift));
         } else if (n_bits <= sig_digits && d_bits > sig_digits) {
             // The opposite of above.
+            const detail::mpz_default_memory_binding mb;
             MPPP_MAYBE_TLS integer<SSize> d;
 
             const auto shift = d_bits - sig_digits;
@@ -354,6 +356,7 @@ private:
         } else {
             // Both num and den have more bits than quad's significand. We will downshift
             // both until they have 113 bits, do the division, and then recover the shifted bits.
+            const detail::mpz_default_memory_binding mb;
             MPPP_MAYBE_TLS integer<SSize> n;
             MPPP_MAYBE_TLS integer<SSize> d;
 
@@ -0,0 +1,135 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_RELOCATE_HPP
+#define MPPP_RELOCATE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/config.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/fwd.hpp>
+
+// NOTE: libstdc++ (from GCC 9) uses bitwise copies in the reallocation of std::vector for the types
+// for which the (internal) std::__is_bitwise_relocatable trait is true. We specialise it below for the mp++
+// classes which are trivially relocatable (i.e., all but real), so that the growth of vectors of such objects
+// does not go through the move constructor and destructor of each element.
+#if defined(_GLIBCXX_RELEASE) && _GLIBCXX_RELEASE >= 9
+
+#define MPPP_HAVE_GLIBCXX_BITWISE_RELOCATABLE
+
+#endif
+
+MPPP_BEGIN_NAMESPACE
+
+// Detect trivially relocatable types.
+// NOTE: a type is trivially relocatable if moving an object to a new location and
+// destroying the original is equivalent to a bitwise copy of the object. This holds for
+// trivially copyable types and for the mp++ classes which never store pointers to themselves.
+// NOTE: real is not trivially relocatable, as the significand of a real in static
+// storage points to the object itself.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {
+};
+
+template <std::size_t SSize>
+struct is_trivially_relocatable<integer<SSize>> : std::true_type {
+};
+
+template <std::size_t SSize>
+struct is_trivially_relocatable<rational<SSize>> : std::true_type {
+};
+
+#if defined(MPPP_WITH_MPC)
+
+template <>
+struct is_trivially_relocatable<complex> : std::true_type {
+};
+
+#endif
+
+namespace detail
+{
+
+template <typename T>
+inline T *relocate_impl(T *first, T *last, T *d_first, const std::true_type &) noexcept
+{
+    const auto n = static_cast<std::size_t>(last - first);
+    // NOTE: memmove() is fine with overlapping ranges. The
+    // casts to void * silence compiler warnings about non-trivial types.
+    std::memmove(static_cast<void *>(d_first), static_cast<const void *>(first), n * sizeof(T));
+    return d_first + n;
+}
+
+template <typename T>
+inline T *relocate_impl(T *first, T *last, T *d_first, const std::false_type &) noexcept
+{
+    for (; first != last; ++first, ++d_first) {
+        ::new (static_cast<void *>(d_first)) T(std::move(*first));
+        first->~T();
+    }
+    return d_first;
+}
+
+} // namespace detail
+
+// Relocate the objects in the range [first, last) into the uninitialised
+// storage starting at d_first.
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T>
+    requires is_trivially_relocatable<T>::value
+             || (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+#else
+template <typename T,
+          detail::enable_if_t<detail::disjunction<is_trivially_relocatable<T>,
+                                                  detail::conjunction<std::is_nothrow_move_constructible<T>,
+                                                                      std::is_nothrow_destructible<T>>>::value,
+                              int> = 0>
+#endif
+inline T *relocate(T *first, T *last, T *d_first) noexcept
+{
+    return detail::relocate_impl(first, last, d_first, is_trivially_relocatable<T>{});
+}
+
+MPPP_END_NAMESPACE
+
+#if defined(MPPP_HAVE_GLIBCXX_BITWISE_RELOCATABLE)
+
+// NOLINTBEGIN(cert-dcl58-cpp, bugprone-reserved-identifier)
+
+namespace std
+{
+
+template <std::size_t SSize>
+struct __is_bitwise_relocatable<mppp::integer<SSize>, void> : true_type {
+};
+
+template <std::size_t SSize>
+struct __is_bitwise_relocatable<mppp::rational<SSize>, void> : true_type {
+};
+
+#if defined(MPPP_WITH_MPC)
+
+template <>
+struct __is_bitwise_relocatable<mppp::complex, void> : true_type {
+};
+
+#endif
+
+} // namespace std
+
+// NOLINTEND(cert-dcl58-cpp, bugprone-reserved-identifier)
+
+#endif
+
+#endif
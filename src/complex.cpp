@@ -161,13 +161,9 @@ void complex::construct_from_c_string(const char *s, int base, ::mpfr_prec_t p)
     // The imaginary part might not be present.
     auto im = (res[2] == nullptr) ? real{real_kind::zero, 1, p} : real{res[2], res[3], base, p};
 
-    // Shallow-copy into this.
-    m_mpc.re[0] = *re.get_mpfr_t();
-    m_mpc.im[0] = *im.get_mpfr_t();
-
-    // Deactivate the temporaries.
-    re._get_mpfr_t()->_mpfr_d = nullptr;
-    im._get_mpfr_t()->_mpfr_d = nullptr;
+    // Move into this.
+    re.move_into(m_mpc.re[0]);
+    im.move_into(m_mpc.im[0]);
 }
 
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
@@ -670,6 +666,7 @@ complex &complex::conj()
 // In-place absolute value.
 complex &complex::abs()
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
 
     tmp.set_prec(get_prec());
@@ -684,6 +681,7 @@ complex &complex::abs()
 // In-place norm.
 complex &complex::norm()
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
 
     tmp.set_prec(get_prec());
@@ -698,6 +696,7 @@ complex &complex::norm()
 // In-place arg.
 complex &complex::arg()
 {
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
 
     tmp.set_prec(get_prec());
@@ -901,18 +900,19 @@ void complex::load(boost::archive::binary_iarchive &ar, unsigned)
 {
     // NOTE: for the binary archive, don't pass through the constructor,
     // but assign directly the re/im members.
+    const detail::mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real re, im;
 
     ar >> re;
     ar >> im;
 
-    {
+    mb.escape([&]() {
         re_ref rr{*this};
         im_ref ir{*this};
 
         *rr = re;
         *ir = im;
-    }
+    });
 }
 
 #endif
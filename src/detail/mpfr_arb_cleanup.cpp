@@ -223,7 +223,7 @@ real::~real()
     if (is_valid()) {
         // The object is not moved-from, destroy it.
         assert(detail::real_prec_check(get_prec()));
-        ::mpfr_clear(&m_mpfr);
+        clear_storage();
     }
 }
 
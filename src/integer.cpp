@@ -6,15 +6,23 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <future>
 #include <ios>
 #include <iostream>
-#include <locale>
+#include <new>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -25,6 +33,21 @@
 #include <mp++/detail/utils.hpp>
 #include <mp++/integer.hpp>
 
+#if defined(MPPP_HAVE_ADX_KERNELS)
+
+#include <cpuid.h>
+
+#endif
+
+// SSE2 is always available on x86-64.
+#if defined(__x86_64__) && defined(__GNUC__) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS
+
+#define MPPP_HAVE_SSE2_HEX
+
+#include <emmintrin.h>
+
+#endif
+
 MPPP_BEGIN_NAMESPACE
 
 namespace detail
@@ -92,6 +115,273 @@ static_assert(nl_digits<::mp_limb_t>() == GMP_LIMB_BITS,
 
 } // namespace
 
+#if MPPP_CPLUSPLUS < 201703L
+
+constexpr std::size_t mpz_alloc_cache::max_size_limit;
+constexpr std::size_t mpz_alloc_cache::default_max_size;
+constexpr std::size_t mpz_alloc_cache::default_max_entries;
+constexpr std::size_t mpz_alloc_cache::n_classes;
+constexpr std::size_t mpz_alloc_cache::class_max_entries;
+
+#endif
+
+namespace
+{
+
+// Size (in limbs) of the size class idx of mpz_alloc_cache.
+constexpr std::size_t mpz_class_size(std::size_t idx)
+{
+    return (4u + idx % 4u) << (idx / 4u + 1u);
+}
+
+// The smallest and largest size classes.
+constexpr std::size_t mpz_min_class_size = mpz_class_size(0);
+constexpr std::size_t mpz_max_class_size = mpz_class_size(mpz_alloc_cache::n_classes - 1u);
+
+static_assert(mpz_min_class_size == 8u && mpz_max_class_size == 1024u, "Invalid size classes.");
+
+// Index of the smallest size class whose size is not less than n.
+std::size_t mpz_ceil_class(std::size_t n)
+{
+    assert(n != 0u && n <= mpz_max_class_size);
+    if (n <= mpz_min_class_size) {
+        return 0;
+    }
+    // NOTE: the sizes of the classes in the octave o are in the (8 * 2**o, 16 * 2**o] range.
+    const auto o = limb_size_nbits(static_cast<::mp_limb_t>(n - 1u)) - 4u;
+    return 4u * o + ((n - 1u) >> (o + 1u)) - 3u;
+}
+
+// Index of the largest size class whose size is not greater than n.
+// NOTE: the return value will be n_classes or greater if n is large enough.
+std::size_t mpz_floor_class(std::size_t n)
+{
+    assert(n >= mpz_min_class_size);
+    const auto o = limb_size_nbits(static_cast<::mp_limb_t>(n)) - 4u;
+    return 4u * o + (n >> (o + 1u)) - 4u;
+}
+
+// Central depot for the arrays of the thread-local caches.
+// NOTE: the depot is a magazine allocator: the arrays are exchanged between the thread-local
+// caches and the depot in magazines of arrays of the same size, so that the cost of the synchronisation
+// is amortised over many allocations. A thread whose cache fills up moves part of it to the depot, and a thread
+// whose cache runs empty refills it from the depot before resorting to the GMP allocation function. This helps
+// in producer/consumer patterns, where the integers created in one thread are destroyed in another.
+// The magazines are taken from a fixed pool, and the full magazines of each key (that is, the exact sizes
+// of the cache followed by its size classes) are kept in lock-free stacks.
+struct mpz_depot {
+    // Max number of arrays in a magazine.
+    static constexpr std::size_t mag_capacity = 16;
+    // Number of magazines in the pool.
+    static constexpr std::size_t n_mags = 1024;
+    // Max number of magazines for each key.
+    static constexpr std::uint32_t max_mags_per_key = 64;
+    // Number of keys.
+    static constexpr std::size_t n_keys = mpz_alloc_cache::max_size_limit + mpz_alloc_cache::n_classes;
+
+    struct magazine {
+        // Index + 1 of the next magazine in the stack (zero for the bottom of the stack).
+        // NOTE: this needs to be atomic because it can be read by a thread attempting to
+        // pop the magazine while another thread is reusing it (in which case the
+        // compare-and-swap in pop() will fail).
+        std::atomic<std::uint32_t> next;
+        std::size_t count;
+        std::array<::mp_limb_t *, mag_capacity> arrays;
+    };
+
+    // Push the magazine with index + 1 equal to id onto the stack with head h.
+    // NOTE: the low 32 bits of a head store the index + 1 of the top magazine, the high 32 bits a tag which
+    // is bumped at every modification of the stack in order to avoid the ABA problem.
+    void push(std::atomic<std::uint64_t> &h, std::uint32_t id) noexcept
+    {
+        auto old = h.load(std::memory_order_relaxed);
+        do {
+            mags[id - 1u].next.store(static_cast<std::uint32_t>(old), std::memory_order_relaxed);
+        } while (!h.compare_exchange_weak(old, (((old >> 32) + 1u) << 32) | id, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    }
+    // Pop a magazine from the stack with head h. Returns the index + 1 of the magazine,
+    // or zero if the stack is empty.
+    std::uint32_t pop(std::atomic<std::uint64_t> &h) noexcept
+    {
+        auto old = h.load(std::memory_order_acquire);
+        while (true) {
+            const auto id = static_cast<std::uint32_t>(old);
+            if (id == 0u) {
+                return 0;
+            }
+            const auto next = std::uint64_t(mags[id - 1u].next.load(std::memory_order_relaxed));
+            if (h.compare_exchange_weak(old, (((old >> 32) + 1u) << 32) | next, std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+                return id;
+            }
+        }
+    }
+    // Get an unused magazine. Returns zero if the pool is exhausted.
+    std::uint32_t get_free_mag() noexcept
+    {
+        if (const auto id = pop(free_head)) {
+            return id;
+        }
+        // Take a magazine which has never been used, if any.
+        auto n = n_fresh.load(std::memory_order_relaxed);
+        while (n < n_mags) {
+            if (n_fresh.compare_exchange_weak(n, n + 1u, std::memory_order_relaxed)) {
+                return n + 1u;
+            }
+        }
+        return 0;
+    }
+    // Move the n arrays starting at ptrs into a magazine for the key k. Returns false
+    // if the depot cannot accept the arrays.
+    bool put(std::size_t k, ::mp_limb_t *const *ptrs, std::size_t n) noexcept
+    {
+        assert(k < n_keys && n != 0u && n <= mag_capacity);
+        if (closed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (key_counts[k].fetch_add(1, std::memory_order_relaxed) >= max_mags_per_key) {
+            key_counts[k].fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        const auto id = get_free_mag();
+        if (id == 0u) {
+            key_counts[k].fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto &mag = mags[id - 1u];
+        std::copy(ptrs, ptrs + n, mag.arrays.begin());
+        mag.count = n;
+        push(heads[k], id);
+        return true;
+    }
+    // Move up to max_n arrays for the key k from a magazine into dst.
+    // Returns the number of arrays written into dst.
+    std::size_t get(std::size_t k, ::mp_limb_t **dst, std::size_t max_n) noexcept
+    {
+        assert(k < n_keys && max_n != 0u);
+        const auto id = pop(heads[k]);
+        if (id == 0u) {
+            return 0;
+        }
+        auto &mag = mags[id - 1u];
+        const auto n = std::min(mag.count, max_n);
+        mag.count -= n;
+        std::copy(mag.arrays.begin() + static_cast<std::ptrdiff_t>(mag.count),
+                  mag.arrays.begin() + static_cast<std::ptrdiff_t>(mag.count + n), dst);
+        if (mag.count == 0u) {
+            key_counts[k].fetch_sub(1, std::memory_order_relaxed);
+            push(free_head, id);
+        } else {
+            // NOTE: this can happen if the magazine was filled
+            // by a thread whose cache has larger limits.
+            push(heads[k], id);
+        }
+        return n;
+    }
+    // Free all the arrays in the depot.
+    void drain() noexcept
+    {
+        void (*ffp)(void *, std::size_t) = nullptr;
+        ::mp_get_memory_functions(nullptr, nullptr, &ffp);
+        assert(ffp != nullptr);
+        for (std::size_t k = 0; k < n_keys; ++k) {
+            while (const auto id = pop(heads[k])) {
+                auto &mag = mags[id - 1u];
+                for (std::size_t i = 0; i < mag.count; ++i) {
+                    // NOTE: the size of the arrays in the size classes
+                    // is stored in their first limb.
+                    const auto nlimbs = k < mpz_alloc_cache::max_size_limit ? k + 1u
+                                                                             : static_cast<std::size_t>(mag.arrays[i][0]);
+                    ffp(static_cast<void *>(mag.arrays[i]), nlimbs * sizeof(::mp_limb_t));
+                }
+                key_counts[k].fetch_sub(1, std::memory_order_relaxed);
+                push(free_head, id);
+            }
+        }
+    }
+
+    std::array<magazine, n_mags> mags;
+    std::array<std::atomic<std::uint64_t>, n_keys> heads;
+    // The stack of the unused magazines.
+    std::atomic<std::uint64_t> free_head;
+    // Number of magazines in the pool which have never been used.
+    std::atomic<std::uint32_t> n_fresh;
+    // Number of magazines for each key.
+    std::array<std::atomic<std::uint32_t>, n_keys> key_counts;
+    // Set at program exit, after which the depot does not accept arrays any more.
+    std::atomic<bool> closed;
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
+constexpr std::size_t mpz_depot::mag_capacity;
+constexpr std::size_t mpz_depot::n_mags;
+constexpr std::uint32_t mpz_depot::max_mags_per_key;
+constexpr std::size_t mpz_depot::n_keys;
+
+#endif
+
+// NOTE: the depot has only trivial members, thus it is zero-initialised before
+// any dynamic initialisation and it is never destroyed. It can thus be used safely by threads
+// exiting during or after the destruction of the objects with static storage duration.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+mpz_depot mpz_depot_inst;
+
+// Free the content of the depot at program exit.
+// NOTE: the destruction of the objects with thread storage duration of the
+// main thread happens before this, so that the arrays moved to the depot
+// at the exit of the main thread are freed as well. The arrays moved to the depot by threads
+// which are still running at this point are evicted by them instead.
+struct mpz_depot_cleanup {
+    mpz_depot_cleanup() = default;
+    mpz_depot_cleanup(const mpz_depot_cleanup &) = delete;
+    mpz_depot_cleanup(mpz_depot_cleanup &&) = delete;
+    mpz_depot_cleanup &operator=(const mpz_depot_cleanup &) = delete;
+    mpz_depot_cleanup &operator=(mpz_depot_cleanup &&) = delete;
+    ~mpz_depot_cleanup()
+    {
+        mpz_depot_inst.closed.store(true, std::memory_order_relaxed);
+        mpz_depot_inst.drain();
+    }
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+const mpz_depot_cleanup mpz_depot_cleanup_inst;
+
+} // namespace
+
+// Flag signalling if the GMP memory functions have been installed.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<bool> mpz_memory_resources_flag{false};
+
+namespace
+{
+
+// NOTE: the memory blocks allocated via the GMP memory functions installed
+// by enable_integer_memory_resources() are preceded by a header storing the memory resource
+// from which the block was allocated (null for std::malloc()) and the total size of the block.
+struct alignas(std::max_align_t) mpz_block_header {
+    mpz_memory_binding binding;
+    std::size_t size;
+};
+
+mpz_block_header *mpz_get_block_header(void *p)
+{
+    return static_cast<mpz_block_header *>(p) - 1;
+}
+
+// Check if the limbs of m were allocated from a memory resource.
+bool mpz_from_memory_resource(const mpz_struct_t &m)
+{
+    // NOTE: if the alloc is zero, the limbs pointer may
+    // not point to a block allocated by GMP.
+    return mpz_memory_resources_flag.load(std::memory_order_relaxed) && m._mp_alloc != 0
+           && mpz_get_block_header(m._mp_d)->binding.resource != nullptr;
+}
+
+} // namespace
+
 void mpz_alloc_cache::clear() noexcept
 {
 #if !defined(NDEBUG)
@@ -104,12 +394,223 @@ void mpz_alloc_cache::clear() noexcept
     for (std::size_t i = 0; i < max_size; ++i) {
         // Free all the limbs arrays allocated for this size.
         for (std::size_t j = 0; j < sizes[i]; ++j) {
-            ffp(static_cast<void *>(caches[i][j]), i + 1u);
+            ffp(static_cast<void *>(caches[i * max_entries + j]), (i + 1u) * sizeof(::mp_limb_t));
         }
         // Reset the number of limbs array present in this
         // cache entry.
         sizes[i] = 0u;
     }
+    for (std::size_t i = 0; i < n_classes; ++i) {
+        // NOTE: the size of the arrays in the size classes
+        // is stored in their first limb.
+        for (std::size_t j = 0; j < class_sizes[i]; ++j) {
+            ffp(static_cast<void *>(class_caches[i][j]),
+                static_cast<std::size_t>(class_caches[i][j][0]) * sizeof(::mp_limb_t));
+        }
+        class_sizes[i] = 0u;
+    }
+    // Free the storage of the cache.
+    delete[] caches;
+    caches = nullptr;
+    capacity = 0;
+}
+
+bool mpz_alloc_cache::init_storage() noexcept
+{
+    if (caches == nullptr) {
+        // NOTE: the product cannot overflow, as it is checked in set_limits().
+        caches = new (std::nothrow)::mp_limb_t *[max_size * max_entries];
+        if (caches == nullptr) {
+            return false;
+        }
+        // NOTE: if the memory resources are enabled, the fast path of mpz_clear_wrap()
+        // is disabled, so that cache_or_clear() can prevent the limbs allocated
+        // from a memory resource from entering the cache. This keeps the check
+        // out of the fast path when the memory resources are not in use.
+        capacity = mpz_memory_resources_flag.load(std::memory_order_relaxed) ? 0 : max_entries;
+    }
+    return true;
+}
+
+bool mpz_alloc_cache::init_slow(mpz_struct_t &rop, std::size_t nlimbs)
+{
+    assert(nlimbs != 0u);
+    if (max_size == 0u || max_entries == 0u) {
+        ++misses;
+        return false;
+    }
+    if (nlimbs <= max_size) {
+        // The cache for this size is empty, try to refill it from the depot.
+        const auto idx = nlimbs - 1u;
+        assert(sizes[idx] == 0u);
+        if (init_storage()) {
+            sizes[idx] = mpz_depot_inst.get(idx, caches + idx * max_entries, max_entries);
+            if (sizes[idx] != 0u) {
+                ++hits;
+                rop._mp_alloc = static_cast<mpz_alloc_t>(nlimbs);
+                rop._mp_size = 0;
+                rop._mp_d = caches[idx * max_entries + --sizes[idx]];
+                return true;
+            }
+        }
+        ++misses;
+        return false;
+    }
+    if (nlimbs <= mpz_max_class_size) {
+        const auto idx = mpz_ceil_class(nlimbs);
+        if (class_sizes[idx] == 0u) {
+            class_sizes[idx] = mpz_depot_inst.get(max_size_limit + idx, class_caches[idx].data(),
+                                                  std::min(max_entries, class_max_entries));
+        }
+        if (class_sizes[idx] != 0u) {
+            ++hits;
+            auto *ptr = class_caches[idx][--class_sizes[idx]];
+            rop._mp_alloc = static_cast<mpz_alloc_t>(ptr[0]);
+            rop._mp_size = 0;
+            rop._mp_d = ptr;
+        } else {
+            ++misses;
+            mpz_init2(&rop, static_cast<::mp_bitcnt_t>(mpz_class_size(idx) * unsigned(GMP_NUMB_BITS)));
+            assert(make_unsigned(rop._mp_alloc) == mpz_class_size(idx));
+        }
+        return true;
+    }
+    ++misses;
+    return false;
+}
+
+namespace
+{
+
+// Make room in the cache entry with n arrays, starting at ptrs, by moving
+// up to half of it (but at least one array) to the depot under the key k.
+// Returns the new number of arrays in the cache entry.
+std::size_t mpz_cache_to_depot(std::size_t k, ::mp_limb_t *const *ptrs, std::size_t n) noexcept
+{
+    const auto nmove = std::min(mpz_depot::mag_capacity, std::max(std::size_t(1), n / 2u));
+    return mpz_depot_inst.put(k, ptrs + (n - nmove), nmove) ? n - nmove : n;
+}
+
+} // namespace
+
+void mpz_alloc_cache::cache_or_clear(mpz_struct_t &m)
+{
+    const auto ualloc = make_unsigned(m._mp_alloc);
+    // NOTE: the limbs allocated from a memory resource are never cached, as the
+    // memory resource may be released while the cache is still alive.
+    if (ualloc != 0u && !mpz_from_memory_resource(m)) {
+        if (ualloc <= max_size) {
+            if (max_entries != 0u && init_storage()) {
+                const auto idx = ualloc - 1u;
+                auto *ptrs = caches + idx * max_entries;
+                if (sizes[idx] == max_entries) {
+                    sizes[idx] = mpz_cache_to_depot(idx, ptrs, sizes[idx]);
+                }
+                if (sizes[idx] < max_entries) {
+                    ptrs[sizes[idx]] = m._mp_d;
+                    ++sizes[idx];
+                    return;
+                }
+            }
+        } else if (max_size != 0u && max_entries != 0u && ualloc >= mpz_min_class_size) {
+            const auto idx = mpz_floor_class(ualloc);
+            // NOTE: the arrays in the size classes not larger than max_size
+            // would never be reused, as the requests for those sizes
+            // are served by the exact-size cache.
+            if (idx < n_classes && mpz_class_size(idx) > max_size) {
+                const auto cap = std::min(max_entries, class_max_entries);
+                if (class_sizes[idx] == cap) {
+                    class_sizes[idx] = mpz_cache_to_depot(max_size_limit + idx, class_caches[idx].data(), cap);
+                }
+                if (class_sizes[idx] < cap) {
+                    m._mp_d[0] = static_cast<::mp_limb_t>(ualloc);
+                    class_caches[idx][class_sizes[idx]] = m._mp_d;
+                    ++class_sizes[idx];
+                    return;
+                }
+            }
+        }
+        ++evictions;
+    }
+    mpz_clear(&m);
+}
+
+void mpz_alloc_cache::flush() noexcept
+{
+    for (std::size_t i = 0; i < max_size; ++i) {
+        while (sizes[i] != 0u) {
+            const auto n = std::min(sizes[i], mpz_depot::mag_capacity);
+            if (!mpz_depot_inst.put(i, caches + i * max_entries + (sizes[i] - n), n)) {
+                break;
+            }
+            sizes[i] -= n;
+        }
+    }
+    for (std::size_t i = 0; i < n_classes; ++i) {
+        while (class_sizes[i] != 0u) {
+            const auto n = std::min(class_sizes[i], mpz_depot::mag_capacity);
+            if (!mpz_depot_inst.put(max_size_limit + i, class_caches[i].data() + (class_sizes[i] - n), n)) {
+                break;
+            }
+            class_sizes[i] -= n;
+        }
+    }
+    // Free whatever could not be moved to the depot.
+    clear();
+}
+
+void mpz_alloc_cache::set_limits(std::size_t new_max_size, std::size_t new_max_entries)
+{
+    if (mppp_unlikely(new_max_size > max_size_limit)) {
+        throw std::invalid_argument("Cannot set the maximum size of the arrays in the integer cache to "
+                                    + detail::to_string(new_max_size) + ": the value must not be greater than "
+                                    + detail::to_string(max_size_limit));
+    }
+    if (mppp_unlikely(new_max_size != 0u
+                      && new_max_entries > nl_max<std::size_t>() / sizeof(::mp_limb_t *) / new_max_size)) {
+        throw std::overflow_error("Cannot set the maximum number of entries in the integer cache to "
+                                  + detail::to_string(new_max_entries) + ": the value is too large");
+    }
+    clear();
+    max_size = new_max_size;
+    max_entries = new_max_entries;
+}
+
+void mpz_alloc_cache::prefill(std::size_t nlimbs, std::size_t n)
+{
+    if (mppp_unlikely(max_size == 0u || max_entries == 0u)) {
+        throw std::invalid_argument("Cannot prefill the integer cache: the cache is disabled");
+    }
+    if (mppp_unlikely(nlimbs == 0u || nlimbs > mpz_max_class_size)) {
+        throw std::invalid_argument("Cannot prefill the integer cache with arrays of " + detail::to_string(nlimbs)
+                                    + " limbs: the size must be nonzero and not greater than "
+                                    + detail::to_string(mpz_max_class_size));
+    }
+    // Get the GMP allocation function.
+    void *(*afp)(std::size_t) = nullptr;
+    ::mp_get_memory_functions(&afp, nullptr, nullptr);
+    assert(afp != nullptr);
+    // NOTE: like mpz_init2(), we rely on the GMP allocation
+    // function to handle allocation failures.
+    if (nlimbs <= max_size) {
+        if (mppp_unlikely(!init_storage())) {
+            throw std::bad_alloc();
+        }
+        const auto idx = nlimbs - 1u;
+        for (; n != 0u && sizes[idx] < max_entries; --n) {
+            caches[idx * max_entries + sizes[idx]] = static_cast<::mp_limb_t *>(afp(nlimbs * sizeof(::mp_limb_t)));
+            ++sizes[idx];
+        }
+    } else {
+        const auto idx = mpz_ceil_class(nlimbs);
+        const auto csize = mpz_class_size(idx);
+        for (; n != 0u && class_sizes[idx] < std::min(max_entries, class_max_entries); --n) {
+            auto *ptr = static_cast<::mp_limb_t *>(afp(csize * sizeof(::mp_limb_t)));
+            ptr[0] = static_cast<::mp_limb_t>(csize);
+            class_caches[idx][class_sizes[idx]] = ptr;
+            ++class_sizes[idx];
+        }
+    }
 }
 
 #if defined(MPPP_HAVE_THREAD_LOCAL)
@@ -153,6 +654,204 @@ namespace
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 MPPP_CONSTINIT thread_local mpz_alloc_cache mpz_alloc_cache_inst;
 
+// The memory resource bound to the current thread.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+MPPP_CONSTINIT thread_local mpz_memory_binding mpz_memory_binding_inst{nullptr, nullptr};
+
+void *mpz_block_alloc(const mpz_memory_binding &b, std::size_t size)
+{
+    // LCOV_EXCL_START
+    if (mppp_unlikely(size > nl_max<std::size_t>() - sizeof(mpz_block_header))) {
+        std::abort();
+    }
+    // LCOV_EXCL_STOP
+    const auto total = size + sizeof(mpz_block_header);
+    void *ptr = nullptr;
+    if (b.resource == nullptr) {
+        ptr = std::malloc(total);
+    } else {
+        // NOTE: exceptions cannot propagate through GMP. Like GMP, we abort
+        // in case of memory allocation errors.
+        try {
+            ptr = b.ops->allocate(b.resource, total);
+            // LCOV_EXCL_START
+        } catch (...) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+    }
+    // LCOV_EXCL_START
+    if (mppp_unlikely(ptr == nullptr)) {
+        std::abort();
+    }
+    // LCOV_EXCL_STOP
+    return ::new (ptr) mpz_block_header{b, total} + 1;
+}
+
+void mpz_block_free(void *p)
+{
+    auto *h = mpz_get_block_header(p);
+    const auto b = h->binding;
+    if (b.resource == nullptr) {
+        std::free(static_cast<void *>(h));
+    } else {
+        b.ops->deallocate(b.resource, static_cast<void *>(h), h->size);
+    }
+}
+
+// The GMP memory functions.
+void *mpz_gmp_alloc(std::size_t size)
+{
+    return mpz_block_alloc(mpz_memory_binding_inst, size);
+}
+
+void *mpz_gmp_realloc(void *p, std::size_t, std::size_t new_size)
+{
+    auto *h = mpz_get_block_header(p);
+    if (h->binding.resource == nullptr) {
+        // LCOV_EXCL_START
+        if (mppp_unlikely(new_size > nl_max<std::size_t>() - sizeof(mpz_block_header))) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+        const auto total = new_size + sizeof(mpz_block_header);
+        auto *new_h = static_cast<mpz_block_header *>(std::realloc(static_cast<void *>(h), total));
+        // LCOV_EXCL_START
+        if (mppp_unlikely(new_h == nullptr)) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+        new_h->size = total;
+        return new_h + 1;
+    }
+    // NOTE: a block is reallocated either from the memory resource it was allocated from
+    // or (for non-sticky resources, such as the arenas) from the memory resource currently bound to the thread.
+    auto *ret = mpz_block_alloc(h->binding.ops->sticky ? h->binding : mpz_memory_binding_inst, new_size);
+    std::memcpy(ret, p, std::min(new_size, h->size - sizeof(mpz_block_header)));
+    mpz_block_free(p);
+    return ret;
+}
+
+void mpz_gmp_free(void *p, std::size_t)
+{
+    mpz_block_free(p);
+}
+
+// Arena for arena_scope.
+// NOTE: the memory is carved out of chunks with a bump allocator. Each block is prefixed by
+// a pointer to its chunk, and each chunk keeps a count of the live blocks it contains (plus one
+// while the chunk is the current chunk of the arena). A chunk is freed when its count reaches zero,
+// that is, when the arena has moved on to another chunk (or it has been destroyed) and all the
+// blocks in the chunk have been freed. Thus, the blocks allocated from an arena can safely
+// outlive it (e.g., the results of a computation or the thread-local temporaries of mp++),
+// at the price of keeping their chunks alive.
+struct alignas(std::max_align_t) mpz_arena_chunk {
+    std::atomic<std::size_t> refs;
+};
+
+struct alignas(std::max_align_t) mpz_arena_block_prefix {
+    mpz_arena_chunk *chunk;
+};
+
+struct mpz_arena {
+    explicit mpz_arena(std::size_t cs) : chunk_size(cs), cur(nullptr), ptr(nullptr), end(nullptr) {}
+    mpz_arena(const mpz_arena &) = delete;
+    mpz_arena(mpz_arena &&) = delete;
+    mpz_arena &operator=(const mpz_arena &) = delete;
+    mpz_arena &operator=(mpz_arena &&) = delete;
+    ~mpz_arena()
+    {
+        if (cur != nullptr) {
+            release_chunk(cur);
+        }
+    }
+    static void release_chunk(mpz_arena_chunk *c) noexcept
+    {
+        if (c->refs.fetch_sub(1, std::memory_order_acq_rel) == 1u) {
+            c->~mpz_arena_chunk();
+            std::free(static_cast<void *>(c));
+        }
+    }
+    static mpz_arena_chunk *new_chunk(std::size_t size) noexcept
+    {
+        // LCOV_EXCL_START
+        if (mppp_unlikely(size > nl_max<std::size_t>() - sizeof(mpz_arena_chunk))) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+        auto *ptr = std::malloc(sizeof(mpz_arena_chunk) + size);
+        // LCOV_EXCL_START
+        if (mppp_unlikely(ptr == nullptr)) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+        auto *c = ::new (ptr) mpz_arena_chunk;
+        c->refs.store(1, std::memory_order_relaxed);
+        return c;
+    }
+    void *allocate(std::size_t size) noexcept
+    {
+        constexpr auto align = alignof(std::max_align_t);
+        // LCOV_EXCL_START
+        if (mppp_unlikely(size > nl_max<std::size_t>() - sizeof(mpz_arena_block_prefix) - align)) {
+            std::abort();
+        }
+        // LCOV_EXCL_STOP
+        const auto need = sizeof(mpz_arena_block_prefix) + (size + align - 1u) / align * align;
+        unsigned char *bptr = nullptr;
+        mpz_arena_chunk *c = nullptr;
+        if (need > chunk_size / 2u) {
+            // Large blocks are allocated in a dedicated chunk, which
+            // is not used by the arena for other allocations.
+            c = new_chunk(need);
+            bptr = reinterpret_cast<unsigned char *>(c + 1);
+        } else {
+            if (need > static_cast<std::size_t>(end - ptr)) {
+                if (cur != nullptr) {
+                    release_chunk(cur);
+                }
+                cur = new_chunk(chunk_size);
+                ptr = reinterpret_cast<unsigned char *>(cur + 1);
+                end = ptr + chunk_size;
+                cur->refs.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                cur->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+            c = cur;
+            bptr = ptr;
+            ptr += need;
+        }
+        return ::new (static_cast<void *>(bptr)) mpz_arena_block_prefix{c} + 1;
+    }
+    static void deallocate(void *p) noexcept
+    {
+        auto *prefix = static_cast<mpz_arena_block_prefix *>(p) - 1;
+        release_chunk(prefix->chunk);
+    }
+
+    std::size_t chunk_size;
+    // The current chunk and its free range.
+    mpz_arena_chunk *cur;
+    unsigned char *ptr;
+    unsigned char *end;
+};
+
+void *mpz_arena_allocate(void *a, std::size_t size)
+{
+    return static_cast<mpz_arena *>(a)->allocate(size);
+}
+
+// NOTE: the arena may not exist any more when a block is deallocated,
+// thus the arena pointer must not be used here.
+void mpz_arena_deallocate(void *, void *p, std::size_t)
+{
+    mpz_arena::deallocate(p);
+}
+
+// NOTE: the arenas are not sticky: the reallocation of a block from an arena
+// (which may not exist any more) is served by the memory resource bound to the thread.
+constexpr mpz_memory_resource_ops mpz_arena_ops = {mpz_arena_allocate, mpz_arena_deallocate, false};
+
 // Implementation of the init of an mpz from cache.
 bool mpz_init_from_cache_impl(mpz_struct_t &rop, std::size_t nlimbs)
 {
@@ -166,11 +865,13 @@ bool mpz_init_from_cache_impl(mpz_struct_t &rop, std::size_t nlimbs)
         const auto idx = nlimbs - 1u;
         rop._mp_alloc = static_cast<mpz_alloc_t>(nlimbs);
         rop._mp_size = 0;
-        rop._mp_d = mpzc.caches[idx][mpzc.sizes[idx] - 1u];
+        rop._mp_d = mpzc.caches[idx * mpzc.max_entries + mpzc.sizes[idx] - 1u];
         --mpzc.sizes[idx];
+        ++mpzc.hits;
         return true;
     }
-    return false;
+    // NOTE: init_slow() takes care of updating the statistics.
+    return nlimbs != 0u && mpzc.init_slow(rop, nlimbs);
 }
 
 } // namespace
@@ -180,6 +881,20 @@ mpz_alloc_cache &get_thread_local_mpz_cache()
     return mpz_alloc_cache_inst;
 }
 
+mpz_memory_binding mpz_exchange_memory_binding(const mpz_memory_binding &b) noexcept
+{
+    const auto prev = mpz_memory_binding_inst;
+    mpz_memory_binding_inst = b;
+    return prev;
+}
+
+#else
+
+mpz_memory_binding mpz_exchange_memory_binding(const mpz_memory_binding &) noexcept
+{
+    return {nullptr, nullptr};
+}
+
 #endif
 
 void mpz_init_nlimbs(mpz_struct_t &rop, std::size_t nlimbs)
@@ -229,39 +944,841 @@ void mpz_clear_wrap(mpz_struct_t &m)
 #if defined(MPPP_HAVE_THREAD_LOCAL)
     auto &mpzc = mpz_alloc_cache_inst;
     const auto ualloc = make_unsigned(m._mp_alloc);
-    if (ualloc != 0u && ualloc <= mpzc.max_size && mpzc.sizes[ualloc - 1u] < mpzc.max_entries) {
+    if (ualloc != 0u && ualloc <= mpzc.max_size) {
         const auto idx = ualloc - 1u;
-        mpzc.caches[idx][mpzc.sizes[idx]] = m._mp_d;
-        ++mpzc.sizes[idx];
-    } else {
-#endif
-        mpz_clear(&m);
-#if defined(MPPP_HAVE_THREAD_LOCAL)
+        const auto size = mpzc.sizes[idx];
+        if (size < mpzc.capacity) {
+            mpzc.caches[idx * mpzc.max_entries + size] = m._mp_d;
+            mpzc.sizes[idx] = size + 1u;
+            return;
+        }
     }
+    mpzc.cache_or_clear(m);
+#else
+    mpz_clear(&m);
 #endif
 }
 
-void mpz_to_str(std::vector<char> &out, const mpz_struct_t *mpz, int base)
+namespace
+{
+
+// The chars representing the digits, following the GMP conventions: lowercase
+// letters up to base 36, uppercase and then lowercase letters for larger bases.
+constexpr char digit_chars_36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+constexpr char digit_chars_62[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+// If base is a power of 2, return its base-2 logarithm, otherwise return 0.
+unsigned pow2_base_log2(int base)
 {
     assert(base >= 2 && base <= 62);
-    const auto size_base = mpz_sizeinbase(mpz, base);
-    // LCOV_EXCL_START
-    if (mppp_unlikely(size_base > nl_max<std::size_t>() - 2u)) {
-        throw std::overflow_error("Too many digits in the conversion of mpz_t to string");
-    }
-    // LCOV_EXCL_STOP
-    // Total max size is the size in base plus an optional sign and the null terminator.
-    const auto total_size = size_base + 2u;
-    // NOTE: possible improvement: use a null allocator to avoid initing the chars each time
-    // we resize up.
-    // Overflow check.
-    // LCOV_EXCL_START
-    if (mppp_unlikely(total_size > nl_max<std::vector<char>::size_type>())) {
-        throw std::overflow_error("Too many digits in the conversion of mpz_t to string");
+    switch (base) {
+        case 2:
+            return 1;
+        case 4:
+            return 2;
+        case 8:
+            return 3;
+        case 16:
+            return 4;
+        case 32:
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+// Number of digits in base 2**k of the value stored in the limbs [p, p + size).
+std::size_t pow2_ndigits(const ::mp_limb_t *p, std::size_t size, unsigned k)
+{
+    if (size == 0u) {
+        return 1;
+    }
+    const auto nbits = (size - 1u) * unsigned(GMP_NUMB_BITS) + limb_size_nbits(p[size - 1u]);
+    return nbits / k + static_cast<std::size_t>(nbits % k != 0u);
+}
+
+// Write into out the nd least significant digits in base 2**k of the value
+// stored in the limbs [p, p + size), starting from the most significant digit.
+void pow2_to_chars_generic(char *out, const ::mp_limb_t *p, std::size_t size, unsigned k, std::size_t nd,
+                           const char *digit_chars)
+{
+    const auto mask = (::mp_limb_t(1) << k) - 1u;
+    for (std::size_t i = 0; i < nd; ++i) {
+        const auto pos = (nd - 1u - i) * k;
+        const auto idx = pos / unsigned(GMP_NUMB_BITS);
+        const auto off = static_cast<unsigned>(pos % unsigned(GMP_NUMB_BITS));
+        auto d = p[idx] >> off;
+        if (off + k > unsigned(GMP_NUMB_BITS) && idx + 1u < size) {
+            // The digit spans two limbs.
+            d |= p[idx + 1u] << (unsigned(GMP_NUMB_BITS) - off);
+        }
+        out[i] = digit_chars[d & mask];
+    }
+}
+
+#if defined(MPPP_HAVE_SSE2_HEX)
+
+// Write the 16 hex digits of l into out, starting from the most significant one.
+void limb_to_hex(char *out, ::mp_limb_t l, bool upper)
+{
+    // Load the bytes of l, most significant first, and split them into nibbles.
+    const auto v = _mm_cvtsi64_si128(static_cast<long long>(__builtin_bswap64(l)));
+    const auto m = _mm_set1_epi8(0x0f);
+    const auto nib = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(v, 4), m), _mm_and_si128(v, m));
+    // Map the nibbles to chars: add '0', and then the distance
+    // between '9' + 1 and the first letter for nibbles greater than 9.
+    const auto gt9 = _mm_cmpgt_epi8(nib, _mm_set1_epi8(9));
+    const auto res = _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')),
+                                  _mm_and_si128(gt9, _mm_set1_epi8(static_cast<char>(upper ? 7 : 39))));
+    _mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(out)), res);
+}
+
+#elif (GMP_NUMB_BITS == 64 || GMP_NUMB_BITS == 32) && !GMP_NAIL_BITS
+
+// Write the 8 hex digits of x into out, starting from the most significant one.
+// NOTE: the nibbles are expanded into the bytes of a 64-bit integer and
+// converted into chars all at once.
+void u32_to_hex(char *out, std::uint32_t x, bool upper)
+{
+    std::uint64_t v = x;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    // Now the i-th byte of v contains the i-th nibble of x. Map the nibbles to
+    // chars: add '0', and then the distance between '9' + 1 and the first
+    // letter for nibbles greater than 9.
+    const auto gt9 = ((v + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+    v += 0x3030303030303030ull + gt9 * (upper ? 7u : 39u);
+    for (unsigned i = 0; i < 8u; ++i) {
+        out[i] = static_cast<char>((v >> (8u * (7u - i))) & 0xffu);
+    }
+}
+
+// Write the hex digits of l into out, starting from the most significant one.
+void limb_to_hex(char *out, ::mp_limb_t l, bool upper)
+{
+#if GMP_NUMB_BITS == 64
+    u32_to_hex(out, static_cast<std::uint32_t>(l >> 32), upper);
+    u32_to_hex(out + 8, static_cast<std::uint32_t>(l & 0xffffffffu), upper);
+#else
+    u32_to_hex(out, static_cast<std::uint32_t>(l), upper);
+#endif
+}
+
+#endif
+
+// Write into out the nd digits in base 2**k of the value stored in
+// the limbs [p, p + size), starting from the most significant digit. nd must
+// be the number of digits as computed by pow2_ndigits(). The letters are
+// uppercase if upper is true, lowercase otherwise.
+void pow2_to_chars(char *out, const ::mp_limb_t *p, std::size_t size, unsigned k, std::size_t nd, bool upper)
+{
+    assert(nd == pow2_ndigits(p, size, k));
+
+    if (size == 0u) {
+        *out = '0';
+        return;
+    }
+
+    const auto *const digit_chars = upper ? digit_chars_62 : digit_chars_36;
+
+#if defined(MPPP_HAVE_SSE2_HEX) || ((GMP_NUMB_BITS == 64 || GMP_NUMB_BITS == 32) && !GMP_NAIL_BITS)
+    if (k == 4u) {
+        // Hex: the most significant limb is handled separately,
+        // then each limb is converted into a fixed number of digits.
+        constexpr auto dpl = unsigned(GMP_NUMB_BITS) / 4u;
+        const auto nd_top = nd - (size - 1u) * dpl;
+        pow2_to_chars_generic(out, p + size - 1u, 1, 4, nd_top, digit_chars);
+        out += nd_top;
+        for (auto i = size - 1u; i > 0u; --i, out += dpl) {
+            limb_to_hex(out, p[i - 1u], upper);
+        }
+        return;
+    }
+#endif
+
+    pow2_to_chars_generic(out, p, size, k, nd, digit_chars);
+}
+
+// Settings for the parallel conversion of large integers to and from strings
+// (see set_integer_parallel_conversion()).
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<std::size_t> par_conv_min_nlimbs{std::size_t(1) << 15};
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<unsigned> par_conv_max_threads{0};
+
+// Return the number of threads to be used for the conversion of a value
+// with nlimbs limbs, or zero if the conversion must not be parallel.
+unsigned par_conv_nthreads(std::size_t nlimbs)
+{
+    if (nlimbs < par_conv_min_nlimbs.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    auto nt = par_conv_max_threads.load(std::memory_order_relaxed);
+    if (nt == 0u) {
+        nt = std::thread::hardware_concurrency();
+    }
+    return nt > 1u ? nt : 0u;
+}
+
+// The tree of powers of the base used in the parallel conversions.
+// NOTE: the value is split recursively into 2**depth leaves of w digits each, via
+// the powers base**(w * 2**i), for i in [0, depth). The subtrees at each level are independent,
+// while the leaves are converted via the (subquadratic) GMP functions. There are at least
+// as many leaves as threads, and each subtree is assigned a share of the threads (see par_to_str()).
+struct par_conv_tree {
+    explicit par_conv_tree(int base, std::size_t nd, unsigned nthreads) : depth(0), w(0)
+    {
+        assert(nd > 0u);
+        assert(nthreads > 1u);
+
+        while ((1u << depth) < nthreads && depth < 15u) {
+            ++depth;
+        }
+        while (depth > 0u && (nd >> depth) == 0u) {
+            --depth;
+        }
+
+        const auto nleaves = std::size_t(1) << depth;
+        w = nd / nleaves + static_cast<std::size_t>(nd % nleaves != 0u);
+        // LCOV_EXCL_START
+        if (mppp_unlikely(w > nl_max<unsigned long>())) {
+            throw std::overflow_error("Too many digits in the parallel conversion of an integer");
+        }
+        // LCOV_EXCL_STOP
+
+        pows = std::vector<mpz_raii>(depth);
+        if (depth > 0u) {
+            mpz_ui_pow_ui(&pows[0].m_mpz, static_cast<unsigned long>(base), static_cast<unsigned long>(w));
+            for (unsigned i = 1; i < depth; ++i) {
+                mpz_mul(&pows[i].m_mpz, &pows[i - 1u].m_mpz, &pows[i - 1u].m_mpz);
+            }
+        }
+    }
+
+    unsigned depth;
+    std::size_t w;
+    std::vector<mpz_raii> pows;
+};
+
+// Run f in a new thread. If the thread cannot be
+// created, f will be run when the result is requested.
+template <typename F>
+auto par_conv_async(const F &f) -> std::future<decltype(f())>
+{
+    try {
+        return std::async(std::launch::async, f);
+        // LCOV_EXCL_START
+    } catch (const std::system_error &) {
+        return std::async(std::launch::deferred, f);
+    }
+    // LCOV_EXCL_STOP
+}
+
+// Write into out the w * 2**lvl digits (including the leading zeroes) of the
+// nonnegative value x, which must be less than base**(w * 2**lvl).
+// NOTE: the conversion uses up to nthreads threads, including the calling thread.
+// If nthreads > 1, the high half is converted in a new thread with half of the threads,
+// while the calling thread keeps the other half. Thus, at most nthreads - 1 new threads
+// are started overall.
+void par_to_str(char *out, const mpz_struct_t *x, unsigned lvl, int base, const par_conv_tree &t,
+                unsigned nthreads)
+{
+    assert(mpz_sgn(x) >= 0);
+
+    const auto width = t.w << lvl;
+    if (mpz_sgn(x) == 0) {
+        std::fill(out, out + width, '0');
+        return;
+    }
+    if (lvl == 0u) {
+        std::vector<char> buffer(mpz_sizeinbase(x, base) + 1u);
+        mpz_get_str(buffer.data(), base, x);
+        const auto n = std::strlen(buffer.data());
+        assert(n <= width);
+        std::fill(out, out + (width - n), '0');
+        std::copy(buffer.data(), buffer.data() + n, out + (width - n));
+        return;
+    }
+
+    // Split x into the high and low halves.
+    mpz_raii hi, lo;
+    mpz_tdiv_qr(&hi.m_mpz, &lo.m_mpz, x, &t.pows[lvl - 1u].m_mpz);
+    if (nthreads < 2u) {
+        par_to_str(out, &hi.m_mpz, lvl - 1u, base, t, 1);
+        par_to_str(out + (width >> 1), &lo.m_mpz, lvl - 1u, base, t, 1);
+        return;
+    }
+
+    // Convert the high half in a separate thread.
+    // NOTE: the halves are owned by this thread, the other
+    // thread only reads from the high half.
+    const auto nt_hi = nthreads / 2u;
+    auto fut = par_conv_async([&]() { par_to_str(out, &hi.m_mpz, lvl - 1u, base, t, nt_hi); });
+    par_to_str(out + (width >> 1), &lo.m_mpz, lvl - 1u, base, t, nthreads - nt_hi);
+    fut.get();
+}
+
+// Parallel version of mpz_get_str(), for non power of 2 bases.
+void mpz_get_str_par(char *out, int base, const mpz_struct_t *mpz, unsigned nthreads)
+{
+    const par_conv_tree t(base, mpz_sizeinbase(mpz, base), nthreads);
+
+    // NOTE: the absolute value of mpz, as a read-only view.
+    mpz_struct_t abs_view;
+    abs_view._mp_alloc = mpz->_mp_alloc;
+    abs_view._mp_size = mpz->_mp_size < 0 ? -mpz->_mp_size : mpz->_mp_size;
+    abs_view._mp_d = mpz->_mp_d;
+
+    std::vector<char> buffer(t.w << t.depth);
+    par_to_str(buffer.data(), &abs_view, t.depth, base, t, nthreads);
+
+    // Strip the leading zeroes.
+    const auto it = std::find_if(buffer.begin(), buffer.end() - 1, [](char c) { return c != '0'; });
+    if (mpz->_mp_size < 0) {
+        *out++ = '-';
+    }
+    out = std::copy(it, buffer.end(), out);
+    *out = '\0';
+}
+
+// Wrapper around mpz_get_str(), which switches to the parallel
+// conversion for large values in non power of 2 bases.
+void mpz_get_str_wrap(char *out, int base, const mpz_struct_t *mpz)
+{
+    assert(pow2_base_log2(base) == 0u);
+
+    if (const auto nt = par_conv_nthreads(static_cast<std::size_t>(get_mpz_size(mpz)))) {
+        mpz_get_str_par(out, base, mpz, nt);
+    } else {
+        mpz_get_str(out, base, mpz);
+    }
+}
+
+// Compute into x the value of the valid digits in base base in the range
+// [first, last), whose length must be at most w * 2**lvl. The threads
+// are shared among the subtrees as in par_to_str().
+void par_from_str(mpz_struct_t *x, const char *first, const char *last, unsigned lvl, int base,
+                  const par_conv_tree &t, unsigned nthreads)
+{
+    const auto nd = static_cast<std::size_t>(last - first);
+    assert(nd <= t.w << lvl);
+
+    if (nd == 0u) {
+        mpz_set_ui(x, 0);
+        return;
+    }
+    if (lvl == 0u) {
+        // NOTE: mpz_set_str() needs a null-terminated string.
+        const std::string s(first, last);
+        const auto ret = mpz_set_str(x, s.c_str(), base);
+        ignore(ret);
+        assert(ret == 0);
+        return;
+    }
+
+    const auto half = t.w << (lvl - 1u);
+    if (nd <= half) {
+        par_from_str(x, first, last, lvl - 1u, base, t, nthreads);
+        return;
+    }
+
+    const auto *const mid = last - half;
+    if (nthreads < 2u) {
+        mpz_raii hi;
+        par_from_str(&hi.m_mpz, first, mid, lvl - 1u, base, t, 1);
+        par_from_str(x, mid, last, lvl - 1u, base, t, 1);
+        mpz_addmul(x, &hi.m_mpz, &t.pows[lvl - 1u].m_mpz);
+        return;
+    }
+
+    // Convert the high digits in a separate thread, and then
+    // compute x = hi * base**half + lo.
+    // NOTE: the high half is initialised by the other thread, and it is then
+    // owned by this thread. This ensures that the memory of an mpz is never
+    // reallocated by a thread different from the one which allocated it.
+    const auto nt_hi = nthreads / 2u;
+    auto fut = par_conv_async([&]() {
+        mpz_struct_t ret;
+        mpz_init(&ret);
+        try {
+            par_from_str(&ret, first, mid, lvl - 1u, base, t, nt_hi);
+        } catch (...) {
+            mpz_clear(&ret);
+            throw;
+        }
+        return ret;
+    });
+    try {
+        par_from_str(x, mid, last, lvl - 1u, base, t, nthreads - nt_hi);
+    } catch (...) {
+        // NOTE: wait for the other thread and free its result.
+        try {
+            auto ret = fut.get();
+            mpz_clear(&ret);
+        } catch (...) {
+        }
+        throw;
+    }
+    mpz_raii hi;
+    auto ret = fut.get();
+    mpz_swap(&hi.m_mpz, &ret);
+    mpz_clear(&ret);
+    mpz_addmul(x, &hi.m_mpz, &t.pows[lvl - 1u].m_mpz);
+}
+
+// Implementation of mpz_to_str(), with the option of uppercase letters in base 16.
+void mpz_to_str_impl(std::vector<char> &out, const mpz_struct_t *mpz, int base, bool upper)
+{
+    assert(base >= 2 && base <= 62);
+    assert(!upper || base == 16);
+
+    if (const auto k = pow2_base_log2(base)) {
+        // Power of 2 base: write the digits directly.
+        const auto size = static_cast<std::size_t>(get_mpz_size(mpz));
+        const auto nd = pow2_ndigits(mpz->_mp_d, size, k);
+        const auto neg = static_cast<std::size_t>(mpz->_mp_size < 0);
+        out.resize(safe_cast<std::vector<char>::size_type>(nd + neg + 1u));
+        if (neg != 0u) {
+            out[0] = '-';
+        }
+        pow2_to_chars(out.data() + neg, mpz->_mp_d, size, k, nd, upper);
+        out[nd + neg] = '\0';
+        return;
+    }
+
+    const auto size_base = mpz_sizeinbase(mpz, base);
+    // LCOV_EXCL_START
+    if (mppp_unlikely(size_base > nl_max<std::size_t>() - 2u)) {
+        throw std::overflow_error("Too many digits in the conversion of mpz_t to string");
+    }
+    // LCOV_EXCL_STOP
+    // Total max size is the size in base plus an optional sign and the null terminator.
+    const auto total_size = size_base + 2u;
+    // NOTE: possible improvement: use a null allocator to avoid initing the chars each time
+    // we resize up.
+    // Overflow check.
+    // LCOV_EXCL_START
+    if (mppp_unlikely(total_size > nl_max<std::vector<char>::size_type>())) {
+        throw std::overflow_error("Too many digits in the conversion of mpz_t to string");
     }
     // LCOV_EXCL_STOP
     out.resize(static_cast<std::vector<char>::size_type>(total_size));
-    mpz_get_str(out.data(), base, mpz);
+    mpz_get_str_wrap(out.data(), base, mpz);
+}
+
+} // namespace
+
+void mpz_to_str(std::vector<char> &out, const mpz_struct_t *mpz, int base)
+{
+    mpz_to_str_impl(out, mpz, base, false);
+}
+
+int mpz_from_str(mpz_struct_t *mpz, const char *s, int base)
+{
+    if (base >= 2 && base <= 62 && pow2_base_log2(base) == 0u) {
+        const bool neg = *s == '-';
+        const auto *const first = neg ? s + 1 : s;
+
+        // NOTE: a digit in a base up to 62 carries less than 6 bits, thus strings
+        // shorter than min_digits can never reach the threshold. Check this
+        // by scanning at most min_digits chars, before measuring the whole string.
+        const auto min_nlimbs = par_conv_min_nlimbs.load(std::memory_order_relaxed);
+        if (min_nlimbs > nl_max<std::size_t>() / unsigned(GMP_NUMB_BITS)) {
+            return mpz_set_str(mpz, s, base);
+        }
+        const auto min_digits = min_nlimbs * unsigned(GMP_NUMB_BITS) / 6u;
+        for (std::size_t i = 0; i < min_digits; ++i) {
+            if (first[i] == '\0') {
+                return mpz_set_str(mpz, s, base);
+            }
+        }
+
+        const auto nd = min_digits + std::strlen(first + min_digits);
+        // NOTE: the number of limbs is estimated via the number of bits
+        // per digit, and the value is parsed in parallel only if
+        // it consists exclusively of valid digits. Otherwise, the
+        // string is left to mpz_set_str().
+        const auto nlimbs
+            = static_cast<std::size_t>(static_cast<double>(nd) * std::log2(base) / unsigned(GMP_NUMB_BITS));
+        const auto nt = par_conv_nthreads(nlimbs);
+        const auto *const last = first + nd;
+        if (nt != 0u && nd != 0u && scan_digits(first, last, base) == last) {
+            const par_conv_tree t(base, nd, nt);
+            par_from_str(mpz, first, last, t.depth, base, t, nt);
+            if (neg) {
+                mpz_neg(mpz, mpz);
+            }
+            return 0;
+        }
+    }
+
+    return mpz_set_str(mpz, s, base);
+}
+
+namespace
+{
+
+// The decimal representations of the numbers in the [0, 100) range.
+constexpr char dec_digit_pairs[] = "00010203040506070809"
+                                   "10111213141516171819"
+                                   "20212223242526272829"
+                                   "30313233343536373839"
+                                   "40414243444546474849"
+                                   "50515253545556575859"
+                                   "60616263646566676869"
+                                   "70717273747576777879"
+                                   "80818283848586878889"
+                                   "90919293949596979899";
+
+// Write the decimal representation of n into the chars
+// ending at out, and return a pointer to the first char.
+char *u64_to_dec(char *out, std::uint64_t n)
+{
+    while (n >= 100u) {
+        const auto idx = static_cast<std::size_t>(n % 100u) * 2u;
+        n /= 100u;
+        out -= 2;
+        out[0] = dec_digit_pairs[idx];
+        out[1] = dec_digit_pairs[idx + 1u];
+    }
+    if (n >= 10u) {
+        const auto idx = static_cast<std::size_t>(n) * 2u;
+        out -= 2;
+        out[0] = dec_digit_pairs[idx];
+        out[1] = dec_digit_pairs[idx + 1u];
+    } else {
+        *--out = static_cast<char>('0' + n);
+    }
+    return out;
+}
+
+#if GMP_NUMB_BITS <= 32
+
+// Combine the two limbs of a value into a 64-bit integer.
+std::uint64_t limbs_to_u64(const ::mp_limb_t *p)
+{
+    return static_cast<std::uint64_t>(p[0]) + (static_cast<std::uint64_t>(p[1]) << GMP_NUMB_BITS);
+}
+
+#elif GMP_NUMB_BITS <= 64 && defined(MPPP_HAVE_GCC_INT128)
+
+// Same as u64_to_dec(), but always writes 19 digits,
+// padding with leading zeroes.
+char *u64_to_dec19(char *out, std::uint64_t n)
+{
+    for (int i = 0; i < 9; ++i) {
+        const auto idx = static_cast<std::size_t>(n % 100u) * 2u;
+        n /= 100u;
+        out -= 2;
+        out[0] = dec_digit_pairs[idx];
+        out[1] = dec_digit_pairs[idx + 1u];
+    }
+    assert(n < 10u);
+    *--out = static_cast<char>('0' + n);
+    return out;
+}
+
+// Write the decimal representation of the value in the limbs p[0] and p[1]
+// into the chars ending at out, and return a pointer to the first char.
+char *limbs_to_dec(char *out, const ::mp_limb_t *p)
+{
+    constexpr std::uint64_t p19 = 10000000000000000000ull;
+
+    auto n = static_cast<__uint128_t>(p[0]) + (static_cast<__uint128_t>(p[1]) << GMP_NUMB_BITS);
+    while (n > nl_max<std::uint64_t>()) {
+        out = u64_to_dec19(out, static_cast<std::uint64_t>(n % p19));
+        n /= p19;
+    }
+    return u64_to_dec(out, static_cast<std::uint64_t>(n));
+}
+
+#endif
+
+// Write the chars in [begin, end) into [first, last), prefixed by
+// a minus sign if neg is true.
+to_chars_result copy_to_chars(char *first, char *last, bool neg, const char *begin, const char *end)
+{
+    const auto size = static_cast<std::size_t>(end - begin);
+    if (size + static_cast<std::size_t>(neg) > static_cast<std::size_t>(last - first)) {
+        return {last, std::errc::value_too_large};
+    }
+    if (neg) {
+        *first++ = '-';
+    }
+    std::copy(begin, end, first);
+    return {first + size, std::errc{}};
+}
+
+// Tables mapping chars to the values of the digits they represent, following
+// the GMP conventions (the first table is for bases up to 36, the second one for
+// larger bases). Invalid chars are mapped to 62.
+// For each base, the tables also contain the number of digits which always
+// fit in a limb (dpl), the corresponding power of the base (bb) and
+// the number of bits needed to represent a digit (bpd).
+struct digit_tables {
+    std::array<unsigned char, 256> t36, t62;
+    std::array<std::size_t, 63> dpl;
+    std::array<::mp_limb_t, 63> bb;
+    std::array<unsigned, 63> bpd;
+};
+
+const digit_tables &get_digit_tables()
+{
+    static const digit_tables dt = []() {
+        digit_tables retval{};
+        retval.t36.fill(62);
+        retval.t62.fill(62);
+        for (unsigned char i = 0; i < 10u; ++i) {
+            retval.t36[static_cast<unsigned char>('0' + i)] = i;
+            retval.t62[static_cast<unsigned char>('0' + i)] = i;
+        }
+        for (unsigned char i = 0; i < 26u; ++i) {
+            retval.t36[static_cast<unsigned char>(digit_chars_36[10u + i])] = static_cast<unsigned char>(10u + i);
+            retval.t36[static_cast<unsigned char>(digit_chars_62[10u + i])] = static_cast<unsigned char>(10u + i);
+            retval.t62[static_cast<unsigned char>(digit_chars_62[10u + i])] = static_cast<unsigned char>(10u + i);
+            retval.t62[static_cast<unsigned char>(digit_chars_62[36u + i])] = static_cast<unsigned char>(36u + i);
+        }
+        for (unsigned base = 2; base <= 62u; ++base) {
+            const auto ubase = static_cast<::mp_limb_t>(base);
+            const auto bb_max = GMP_NUMB_MAX / ubase;
+            retval.bb[base] = 1;
+            while (retval.bb[base] <= bb_max) {
+                retval.bb[base] *= ubase;
+                ++retval.dpl[base];
+            }
+            for (auto b = base - 1u; b != 0u; b >>= 1) {
+                ++retval.bpd[base];
+            }
+        }
+        return retval;
+    }();
+
+    return dt;
+}
+
+// Fetch the digit table for the base base.
+const std::array<unsigned char, 256> &get_digit_table(const digit_tables &dt, int base)
+{
+    return base <= 36 ? dt.t36 : dt.t62;
+}
+
+} // namespace
+
+to_chars_result limbs_to_chars(char *first, char *last, const ::mp_limb_t *p, std::size_t size, bool neg, int base,
+                               ::mp_limb_t *scratch, unsigned char *dbuf)
+{
+    assert(base >= 2 && base <= 62);
+    assert(size == 0u || p[size - 1u] != 0u);
+    assert(size != 0u || !neg);
+
+    if (size == 0u) {
+        const char zero = '0';
+        return copy_to_chars(first, last, false, &zero, &zero + 1);
+    }
+
+#if GMP_NUMB_BITS <= 64
+    if (base == 10 && size <= 2u) {
+        // Fast path for 1 or 2 limbs in base 10, using
+        // a table of digit pairs.
+        // NOTE: 40 chars are enough for 128-bit values.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<char, 40> buf;
+        auto *const end = buf.data() + buf.size();
+        if (size == 1u) {
+            return copy_to_chars(first, last, neg, u64_to_dec(end, p[0]), end);
+        }
+#if GMP_NUMB_BITS <= 32
+        return copy_to_chars(first, last, neg, u64_to_dec(end, limbs_to_u64(p)), end);
+#elif defined(MPPP_HAVE_GCC_INT128)
+        return copy_to_chars(first, last, neg, limbs_to_dec(end, p), end);
+#endif
+    }
+#endif
+
+    if (const auto k = pow2_base_log2(base)) {
+        // Power of 2 base: write the digits directly.
+        const auto nd = pow2_ndigits(p, size, k);
+        if (nd + static_cast<std::size_t>(neg) > static_cast<std::size_t>(last - first)) {
+            return {last, std::errc::value_too_large};
+        }
+        if (neg) {
+            *first++ = '-';
+        }
+        pow2_to_chars(first, p, size, k, nd, false);
+        return {first + nd, std::errc{}};
+    }
+
+    // The general case: mpn_get_str() clobbers its input, so work on a copy of the limbs.
+    copy_limbs(p, p + size, scratch);
+    const auto nd = mpn_get_str(dbuf, base, scratch, static_cast<::mp_size_t>(size));
+    // NOTE: mpn_get_str() may produce leading zeroes.
+    std::size_t i = 0;
+    while (dbuf[i] == 0u) {
+        ++i;
+    }
+    assert(i < nd);
+    if (nd - i + static_cast<std::size_t>(neg) > static_cast<std::size_t>(last - first)) {
+        return {last, std::errc::value_too_large};
+    }
+    if (neg) {
+        *first++ = '-';
+    }
+    const auto *const digit_chars = base <= 36 ? digit_chars_36 : digit_chars_62;
+    for (; i < nd; ++i) {
+        *first++ = digit_chars[dbuf[i]];
+    }
+    return {first, std::errc{}};
+}
+
+to_chars_result mpz_to_chars(char *first, char *last, const mpz_struct_t *mpz, int base)
+{
+    assert(base >= 2 && base <= 62);
+
+    if (pow2_base_log2(base) != 0u) {
+        // Power of 2 base: the direct conversion does not need the scratch buffers.
+        return limbs_to_chars(first, last, mpz->_mp_d, static_cast<std::size_t>(get_mpz_size(mpz)),
+                              mpz->_mp_size < 0, base, nullptr, nullptr);
+    }
+
+    const auto avail = static_cast<std::size_t>(last - first);
+    const auto neg = static_cast<std::size_t>(mpz->_mp_size < 0);
+    // NOTE: mpz_sizeinbase() might overestimate the number of digits by 1.
+    const auto sb = mpz_sizeinbase(mpz, base);
+    if (sb - 1u + neg > avail) {
+        return {last, std::errc::value_too_large};
+    }
+    if (sb + neg < avail) {
+        // There is enough room for the largest possible representation,
+        // plus the terminator written by mpz_get_str().
+        mpz_get_str_wrap(first, base, mpz);
+        return {first + std::strlen(first), std::errc{}};
+    }
+
+    // The representation might just fit: go through a temporary buffer.
+    std::vector<char> tmp;
+    mpz_to_str(tmp, mpz, base);
+    return copy_to_chars(first, last, false, tmp.data(), tmp.data() + std::strlen(tmp.data()));
+}
+
+const char *scan_digits(const char *first, const char *last, int base)
+{
+    assert(base >= 2 && base <= 62);
+
+    const auto &tab = get_digit_table(get_digit_tables(), base);
+    while (first != last && tab[static_cast<unsigned char>(*first)] < base) {
+        ++first;
+    }
+    return first;
+}
+
+std::size_t digits_to_limbs(::mp_limb_t *out, std::size_t out_size, const char *first, const char *last, int base)
+{
+    assert(base >= 2 && base <= 62);
+    assert(scan_digits(first, last, base) == last);
+
+    const auto &dt = get_digit_tables();
+    const auto ubase = static_cast<unsigned>(base);
+
+    // Skip the leading zeroes.
+    while (first != last && *first == '0') {
+        ++first;
+    }
+    const auto nd = static_cast<std::size_t>(last - first);
+
+    // Each digit needs at most bpd bits. Check that the value
+    // is guaranteed to fit in out_size limbs.
+    // NOTE: check first nd against the number of bits in the buffer
+    // in order to avoid overflow in the multiplication.
+    const auto nbits = out_size * unsigned(GMP_NUMB_BITS);
+    if (nd > nbits || nd * dt.bpd[ubase] > nbits) {
+        return out_size + 1u;
+    }
+
+    const auto &tab = get_digit_table(dt, base);
+
+    if (const auto k = pow2_base_log2(base)) {
+        // Power of 2 base: pack the bits of the digits directly
+        // into the limbs, starting from the least significant digit.
+        std::size_t size = 0;
+        ::mp_limb_t cur = 0;
+        unsigned nb = 0;
+        auto it = last;
+#if !GMP_NAIL_BITS
+        if (k == 4u) {
+            // Hex: each limb is made of a fixed number of digits. Convert
+            // all the full limbs first, without dependencies between the digits.
+            constexpr auto dpl = unsigned(GMP_NUMB_BITS) / 4u;
+            for (; static_cast<std::size_t>(it - first) >= dpl; it -= dpl) {
+                const auto *const lbegin = it - dpl;
+                ::mp_limb_t l = 0;
+                for (unsigned i = 0; i < dpl; ++i) {
+                    l |= static_cast<::mp_limb_t>(tab[static_cast<unsigned char>(lbegin[i])]) << (4u * (dpl - 1u - i));
+                }
+                out[size++] = l;
+            }
+        }
+#endif
+        for (; it != first;) {
+            const auto d = static_cast<::mp_limb_t>(tab[static_cast<unsigned char>(*--it)]);
+            cur |= d << nb;
+            nb += k;
+            if (nb >= unsigned(GMP_NUMB_BITS)) {
+                out[size++] = cur & GMP_NUMB_MASK;
+                nb -= unsigned(GMP_NUMB_BITS);
+                // Keep the bits of d which did not fit in the limb.
+                cur = nb == 0u ? 0u : d >> (k - nb);
+            }
+        }
+        // NOTE: the most significant digit is not zero, but
+        // its bits might all be in the last written limb.
+        if (cur != 0u) {
+            out[size++] = cur;
+        }
+        assert(size == 0u || out[size - 1u] != 0u);
+        assert(size <= out_size);
+        return size;
+    }
+
+    const auto dpl = dt.dpl[ubase];
+    const auto bb = dt.bb[ubase];
+    const auto ubase2 = static_cast<::mp_limb_t>(ubase * ubase);
+
+    // Process the digits in chunks of dpl digits, starting from the most significant
+    // ones. The first chunk contains the leftover digits.
+    std::size_t size = 0;
+    auto chunk_len = nd;
+    if (nd > dpl) {
+        const auto rem = nd % dpl;
+        chunk_len = rem == 0u ? dpl : rem;
+    }
+    for (; first != last; first += chunk_len, chunk_len = dpl) {
+        // NOTE: consume the digits in pairs in order to
+        // shorten the dependency chain.
+        std::size_t i = chunk_len % 2u;
+        ::mp_limb_t chunk = i == 0u ? 0u : tab[static_cast<unsigned char>(first[0])];
+        for (; i < chunk_len; i += 2u) {
+            chunk = chunk * ubase2
+                    + (static_cast<::mp_limb_t>(tab[static_cast<unsigned char>(first[i])]) * ubase
+                       + tab[static_cast<unsigned char>(first[i + 1u])]);
+        }
+        if (size == 0u) {
+            if (chunk != 0u) {
+                out[size++] = chunk;
+            }
+        } else {
+            auto cy = mpn_mul_1(out, out, static_cast<::mp_size_t>(size), bb);
+            if (cy != 0u) {
+                out[size++] = cy;
+            }
+            cy = mpn_add_1(out, out, static_cast<::mp_size_t>(size), chunk);
+            if (cy != 0u) {
+                out[size++] = cy;
+            }
+        }
+        assert(size <= out_size);
+    }
+    return size;
 }
 
 std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t *n, int n_sgn)
@@ -286,9 +1803,10 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
 
     // Write out to a temporary vector in the required base. This will produce
     // a representation in the required base, with no base prefix and no
-    // extra '+' for nonnegative integers.
+    // extra '+' for nonnegative integers. The letters are uppercase
+    // if requested.
     MPPP_MAYBE_TLS std::vector<char> tmp;
-    mpz_to_str(tmp, n, base);
+    mpz_to_str_impl(tmp, n, base, base == 16 && uppercase);
     // NOTE: tmp contains the terminator, and it might be
     // larger than needed. Make sure to shrink it so that
     // the last element is the terminator.
@@ -300,7 +1818,7 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
             // If we need the base prefix, we will have to add the base after the minus sign.
             assert(tmp[0] == '-');
             if (base == 16) {
-                constexpr std::array<char, 2> hex_prefix = {{'0', 'x'}};
+                const std::array<char, 2> hex_prefix = {{'0', uppercase ? 'X' : 'x'}};
                 tmp.insert(tmp.begin() + 1, hex_prefix.begin(), hex_prefix.end());
             } else {
                 tmp.insert(tmp.begin() + 1, '0');
@@ -314,7 +1832,7 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
         const bool with_plus = (flags & std::ios_base::showpos) != 0;
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
         std::array<char, 3> prep_buffer;
-        const auto prep_n = [&prep_buffer, with_plus, with_base_prefix, base]() -> std::size_t {
+        const auto prep_n = [&prep_buffer, with_plus, with_base_prefix, base, uppercase]() -> std::size_t {
             std::size_t ret = 0;
             if (with_plus) {
                 prep_buffer[ret++] = '+';
@@ -322,7 +1840,7 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
             if (with_base_prefix) {
                 prep_buffer[ret++] = '0';
                 if (base == 16) {
-                    prep_buffer[ret++] = 'x';
+                    prep_buffer[ret++] = uppercase ? 'X' : 'x';
                 }
             }
             return ret;
@@ -331,18 +1849,6 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
         tmp.insert(tmp.begin(), prep_buffer.data(), prep_buffer.data() + prep_n);
     }
 
-    // Apply a final toupper() transformation in base 16, if needed,
-    // but do it before doing the filling in order to avoid
-    // uppercasing the fill character.
-    if (base == 16 && uppercase) {
-        const auto &cloc = std::locale::classic();
-        for (decltype(tmp.size()) i = 0; i < tmp.size() - 1u; ++i) {
-            if (std::isalpha(tmp[i], cloc)) {
-                tmp[i] = std::toupper(tmp[i], cloc);
-            }
-        }
-    }
-
     // Compute the total size of the number
     // representation (i.e., without fill characters).
     // NOTE: -1 because of the terminator.
@@ -397,13 +1903,355 @@ std::ostream &integer_stream_operator_impl(std::ostream &os, const mpz_struct_t
     return os;
 }
 
+#if defined(MPPP_HAVE_ADX_KERNELS)
+
+namespace
+{
+
+// Detect if the CPU supports the BMI2 and ADX instructions.
+bool cpu_has_bmi2_adx()
+{
+    if (__get_cpuid_max(0, nullptr) < 7u) {
+        return false; // LCOV_EXCL_LINE
+    }
+
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    // NOTE: BMI2 is bit 8 and ADX is bit 19 of EBX.
+    return (ebx & (1u << 8)) != 0u && (ebx & (1u << 19)) != 0u;
+}
+
+// The BMI2/ADX implementation of r[0:k+1] = r[0:k] + a[0:k] * l.
+// Each step uses MULX, which does not modify the flags, to compute the
+// double-limb product a[j] * l, and two independent carry chains: the low
+// half of the product is added to the high half of the previous
+// product via ADOX (overflow flag chain) and to r[j] via ADCX (carry flag chain).
+// The two chains are merged into r[k] at the end.
+#define MPPP_ADX_STEP(j)                                                                                               \
+    "mulx " #j "*8(%[a]), %%rax, %%r8\n\t"                                                                             \
+    "adox %%r9, %%rax\n\t"                                                                                             \
+    "adcx " #j "*8(%[r]), %%rax\n\t"                                                                                   \
+    "movq %%rax, " #j "*8(%[r])\n\t"                                                                                   \
+    "movq %%r8, %%r9\n\t"
+
+#define MPPP_ADX_END(k)                                                                                                \
+    "movl $0, %%eax\n\t"                                                                                               \
+    "adox %%rax, %%r9\n\t"                                                                                             \
+    "adcx %%rax, %%r9\n\t"                                                                                             \
+    "movq %%r9, " #k "*8(%[r])\n\t"
+
+// NOTE: the initial XOR zeroes both the carry and overflow flags.
+#define MPPP_ADX_ROW(body)                                                                                             \
+    __asm__("xorl %%r9d, %%r9d\n\t" body                                                                               \
+            :                                                                                                          \
+            : [r] "r"(r), [a] "r"(a), "d"(l)                                                                           \
+            : "rax", "r8", "r9", "cc", "memory")
+
+template <std::size_t K>
+struct adx_row;
+
+#define MPPP_ADX_ROW_SPEC(k, body)                                                                                     \
+    template <>                                                                                                        \
+    struct adx_row<k> {                                                                                                \
+        __attribute__((target("bmi2,adx"))) static void run(::mp_limb_t *r, const ::mp_limb_t *a, ::mp_limb_t l)     \
+        {                                                                                                              \
+            MPPP_ADX_ROW(body MPPP_ADX_END(k));                                                                        \
+        }                                                                                                              \
+    };
+
+MPPP_ADX_ROW_SPEC(1, MPPP_ADX_STEP(0))
+MPPP_ADX_ROW_SPEC(2, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1))
+MPPP_ADX_ROW_SPEC(3, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2))
+MPPP_ADX_ROW_SPEC(4, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2) MPPP_ADX_STEP(3))
+MPPP_ADX_ROW_SPEC(5, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2) MPPP_ADX_STEP(3) MPPP_ADX_STEP(4))
+MPPP_ADX_ROW_SPEC(6, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2) MPPP_ADX_STEP(3) MPPP_ADX_STEP(4)
+                         MPPP_ADX_STEP(5))
+MPPP_ADX_ROW_SPEC(7, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2) MPPP_ADX_STEP(3) MPPP_ADX_STEP(4)
+                         MPPP_ADX_STEP(5) MPPP_ADX_STEP(6))
+MPPP_ADX_ROW_SPEC(8, MPPP_ADX_STEP(0) MPPP_ADX_STEP(1) MPPP_ADX_STEP(2) MPPP_ADX_STEP(3) MPPP_ADX_STEP(4)
+                         MPPP_ADX_STEP(5) MPPP_ADX_STEP(6) MPPP_ADX_STEP(7))
+
+#undef MPPP_ADX_ROW_SPEC
+#undef MPPP_ADX_ROW
+#undef MPPP_ADX_END
+#undef MPPP_ADX_STEP
+
+static_assert(integer_unrolled_max_size == 8u, "The BMI2/ADX kernels must be updated.");
+
+template <std::size_t K>
+__attribute__((target("bmi2,adx"))) void adx_mul_rows(::mp_limb_t *r, const ::mp_limb_t *a, const ::mp_limb_t *b,
+                                                       std::size_t asize2)
+{
+    for (std::size_t i = 0; i < asize2; ++i) {
+        adx_row<K>::run(r + i, a, b[i]);
+    }
+}
+
+} // namespace
+
+const bool integer_use_adx_kernels = cpu_has_bmi2_adx();
+
+__attribute__((target("bmi2,adx"))) void fixed_mul_adx(::mp_limb_t *r, const ::mp_limb_t *a, std::size_t asize1,
+                                                        const ::mp_limb_t *b, std::size_t asize2)
+{
+    assert(asize1 >= asize2);
+
+    switch (asize1) {
+        case 1u:
+            adx_mul_rows<1>(r, a, b, asize2);
+            break;
+        case 2u:
+            adx_mul_rows<2>(r, a, b, asize2);
+            break;
+        case 3u:
+            adx_mul_rows<3>(r, a, b, asize2);
+            break;
+        case 4u:
+            adx_mul_rows<4>(r, a, b, asize2);
+            break;
+        case 5u:
+            adx_mul_rows<5>(r, a, b, asize2);
+            break;
+        case 6u:
+            adx_mul_rows<6>(r, a, b, asize2);
+            break;
+        case 7u:
+            adx_mul_rows<7>(r, a, b, asize2);
+            break;
+        default:
+            assert(asize1 == 8u);
+            adx_mul_rows<8>(r, a, b, asize2);
+    }
+}
+
+#endif
+
+#if !GMP_NAIL_BITS
+
+namespace
+{
+
+// The number of bits in a digit of the radix sort.
+constexpr unsigned radix_sort_dbits = 8;
+
+constexpr std::size_t radix_sort_nbuckets = std::size_t(1) << radix_sort_dbits;
+
+// Extract the digit at index d from the key k.
+inline std::size_t radix_sort_digit(const ::mp_limb_t *k, std::size_t d)
+{
+    const auto bit_idx = d * radix_sort_dbits;
+    return static_cast<std::size_t>((k[bit_idx / unsigned(GMP_NUMB_BITS)] >> (bit_idx % unsigned(GMP_NUMB_BITS)))
+                                    & (radix_sort_nbuckets - 1u));
+}
+
+// Scatter the n keys at src into dst according to the digit at index d, using
+// the bucket offsets in offsets. If Single is true, the keys consist of a single limb.
+template <bool Single>
+void radix_sort_scatter(::mp_limb_t *dst, const ::mp_limb_t *src, std::size_t n, std::size_t nlimbs, std::size_t d,
+                        std::size_t *offsets)
+{
+    for (std::size_t i = 0; i < n; ++i, src += nlimbs) {
+        const auto idx = offsets[radix_sort_digit(src, d)]++;
+        if (Single) {
+            dst[idx] = *src;
+        } else {
+            copy_limbs_no(src, src + nlimbs, dst + idx * nlimbs);
+        }
+    }
+}
+
+} // namespace
+
+const ::mp_limb_t *integer_radix_sort_keys(::mp_limb_t *keys, ::mp_limb_t *buf, std::size_t n, std::size_t nlimbs,
+                                           ::mp_bitcnt_t nbits)
+{
+    assert(n > 0u);
+    assert(nlimbs > 0u);
+
+    const auto ndigits = static_cast<std::size_t>((nbits + radix_sort_dbits - 1u) / radix_sort_dbits);
+
+    // Compute the histograms of all the digits in a single pass.
+    std::vector<std::size_t> counts(ndigits * radix_sort_nbuckets);
+    auto k = keys;
+    for (std::size_t i = 0; i < n; ++i, k += nlimbs) {
+        for (std::size_t d = 0; d < ndigits; ++d) {
+            ++counts[d * radix_sort_nbuckets + radix_sort_digit(k, d)];
+        }
+    }
+
+    ::mp_limb_t *src = keys, *dst = buf;
+    for (std::size_t d = 0; d < ndigits; ++d) {
+        auto *offsets = counts.data() + d * radix_sort_nbuckets;
+        // NOTE: skip the digit if it is the same for all keys.
+        if (offsets[radix_sort_digit(src, d)] == n) {
+            continue;
+        }
+
+        // Turn the counts into the bucket offsets.
+        std::size_t cur = 0;
+        for (std::size_t b = 0; b < radix_sort_nbuckets; ++b) {
+            const auto c = offsets[b];
+            offsets[b] = cur;
+            cur += c;
+        }
+
+        if (nlimbs == 1u) {
+            radix_sort_scatter<true>(dst, src, n, nlimbs, d, offsets);
+        } else {
+            radix_sort_scatter<false>(dst, src, n, nlimbs, d, offsets);
+        }
+        std::swap(src, dst);
+    }
+
+    return src;
+}
+
+#endif
+
 } // namespace detail
 
 void free_integer_caches()
 {
 #if defined(MPPP_HAVE_THREAD_LOCAL)
     detail::mpz_alloc_cache_inst.clear();
+    detail::mpz_depot_inst.drain();
+#endif
+}
+
+void set_integer_cache_limits(std::size_t max_size, std::size_t max_entries)
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    detail::mpz_alloc_cache_inst.set_limits(max_size, max_entries);
+#else
+    detail::ignore(max_size, max_entries);
+#endif
+}
+
+std::pair<std::size_t, std::size_t> get_integer_cache_limits()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    return {detail::mpz_alloc_cache_inst.max_size, detail::mpz_alloc_cache_inst.max_entries};
+#else
+    return {0, 0};
+#endif
+}
+
+void set_integer_parallel_conversion(std::size_t min_nlimbs, unsigned max_threads)
+{
+    detail::par_conv_min_nlimbs.store(min_nlimbs, std::memory_order_relaxed);
+    detail::par_conv_max_threads.store(max_threads, std::memory_order_relaxed);
+}
+
+std::pair<std::size_t, unsigned> get_integer_parallel_conversion()
+{
+    return {detail::par_conv_min_nlimbs.load(std::memory_order_relaxed),
+            detail::par_conv_max_threads.load(std::memory_order_relaxed)};
+}
+
+void prefill_integer_cache(std::size_t nlimbs, std::size_t n)
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    // NOTE: the cache must not be prefilled with limbs
+    // allocated from a memory resource.
+    const auto prev = detail::mpz_exchange_memory_binding({nullptr, nullptr});
+    try {
+        detail::mpz_alloc_cache_inst.prefill(nlimbs, n);
+    } catch (...) {
+        detail::mpz_exchange_memory_binding(prev);
+        throw;
+    }
+    detail::mpz_exchange_memory_binding(prev);
+#else
+    detail::ignore(nlimbs, n);
+#endif
+}
+
+void enable_integer_memory_resources()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    if (!detail::mpz_memory_resources_flag.load()) {
+        // NOTE: the arrays in the cache were allocated
+        // with the previous memory functions.
+        free_integer_caches();
+        ::mp_set_memory_functions(detail::mpz_gmp_alloc, detail::mpz_gmp_realloc, detail::mpz_gmp_free);
+        detail::mpz_memory_resources_flag.store(true);
+    }
+#else
+    throw std::invalid_argument("Memory resources for integers are not supported on this platform");
+#endif
+}
+
+arena_scope::arena_scope(std::size_t chunk_size) : m_arena(nullptr), m_prev{nullptr, nullptr}
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    if (mppp_unlikely(chunk_size == 0u)) {
+        throw std::invalid_argument("The chunk size of an arena must be nonzero");
+    }
+    if (mppp_unlikely(!integer_memory_resources_enabled())) {
+        throw std::invalid_argument("Cannot create an arena scope: the memory resources have not been enabled via "
+                                    "enable_integer_memory_resources()");
+    }
+    auto *a = new detail::mpz_arena(chunk_size);
+    m_arena = a;
+    m_prev = detail::mpz_exchange_memory_binding({static_cast<void *>(a), &detail::mpz_arena_ops});
+#else
+    detail::ignore(chunk_size);
+    throw std::invalid_argument("Arenas are not supported on this platform");
+#endif
+}
+
+arena_scope::~arena_scope()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    detail::mpz_exchange_memory_binding(m_prev);
+    delete static_cast<detail::mpz_arena *>(m_arena);
+#endif
+}
+
+#if MPPP_CPLUSPLUS < 201703L
+
+constexpr std::size_t arena_scope::default_chunk_size;
+
+#endif
+
+bool integer_memory_resources_enabled()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    return detail::mpz_memory_resources_flag.load();
+#else
+    return false;
+#endif
+}
+
+integer_cache_stats get_integer_cache_stats()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    const auto &mpzc = detail::mpz_alloc_cache_inst;
+    return {mpzc.hits, mpzc.misses, mpzc.evictions};
+#else
+    return {0, 0, 0};
+#endif
+}
+
+void reset_integer_cache_stats()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    auto &mpzc = detail::mpz_alloc_cache_inst;
+    mpzc.hits = 0;
+    mpzc.misses = 0;
+    mpzc.evictions = 0;
+#endif
+}
+
+integer_kernel_variant integer_get_kernel_variant()
+{
+#if defined(MPPP_HAVE_ADX_KERNELS)
+    if (detail::integer_use_adx_kernels) {
+        return integer_kernel_variant::bmi2_adx;
+    }
 #endif
+    return integer_kernel_variant::generic;
 }
 
 MPPP_END_NAMESPACE
@@ -0,0 +1,183 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <mp++/config.hpp>
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/integer_vector.hpp>
+
+// NOTE: the batch kernels are written as branchless loops, which the compiler
+// is able to vectorise. On x86-64, we compile AVX2 and AVX-512 clones of the kernels,
+// and the best one for the CPU in use is selected at load time.
+// NOTE: target_clones relies on ifunc, which is available on GNU/Linux only.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)                      \
+    && defined(__linux__) && defined(__GLIBC__)
+
+#define MPPP_INTEGER_VECTOR_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+
+#else
+
+#define MPPP_INTEGER_VECTOR_CLONES
+
+#endif
+
+// NOTE: same condition as in integer_have_dlimb_mul.
+#if (defined(_MSC_VER) && defined(_WIN64) && GMP_NUMB_BITS == 64 && !GMP_NAIL_BITS) || defined(MPPP_HAVE_DLIMB_T)
+
+#define MPPP_HAVE_INTEGER_VECTOR_DLIMB_MUL
+
+#endif
+
+MPPP_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+#if !GMP_NAIL_BITS
+
+namespace
+{
+
+// Check if a 1-limb signed size is in static storage, i.e., if it is -1, 0 or 1.
+inline bool ivec_is_static_1(mpz_size_t s)
+{
+    return static_cast<unsigned>(s + 1) <= 2u;
+}
+
+// Implementation of addition and subtraction. For subtraction,
+// the sign of the second operand is flipped.
+template <bool AddOrSub>
+MPPP_INTEGER_VECTOR_CLONES std::size_t ivec_addsub_1(mpz_size_t *rs, ::mp_limb_t *rl, const mpz_size_t *as,
+                                                     const ::mp_limb_t *al, const mpz_size_t *bs,
+                                                     const ::mp_limb_t *bl, unsigned *fl, std::size_t n)
+{
+    std::size_t retval = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto sa = as[i], sb = AddOrSub ? bs[i] : -bs[i];
+        const auto la = al[i], lb = bl[i];
+
+        // NOTE: same_sign is true if the sign bits of sa and sb are equal, i.e., if the sizes
+        // are both non-negative or both negative. A zero operand thus counts as positive:
+        // with a negative operand it takes the subtraction branch below, which
+        // yields the correct result as well.
+        const bool same_sign = (sa ^ sb) >= 0;
+
+        const auto sum = la + lb;
+        const bool carry = sum < la;
+
+        const bool borrow = la < lb;
+        const auto diff = borrow ? lb - la : la - lb;
+
+        const auto res = same_sign ? sum : diff;
+        // NOTE: if the operands have the same sign, sa | sb
+        // is their sign (even if one of them is zero). In case of a zero result,
+        // the sign will be zeroed out below.
+        const auto sign = same_sign ? (sa | sb) : (borrow ? sb : sa);
+
+        // NOTE: use bitwise operators instead of the logical ones, in order
+        // to avoid branches which would prevent vectorisation.
+        const bool fail = !ivec_is_static_1(sa) | !ivec_is_static_1(sb) | (same_sign & carry);
+
+        // NOTE: load the current values of the output unconditionally,
+        // so that the compiler can turn the selections into blends.
+        const auto old_s = rs[i];
+        const auto old_l = rl[i];
+        rs[i] = fail ? old_s : (res != 0u ? sign : 0);
+        rl[i] = fail ? old_l : res;
+        fl[i] = static_cast<unsigned>(fail);
+        retval += static_cast<std::size_t>(fail);
+    }
+
+    return retval;
+}
+
+} // namespace
+
+std::size_t integer_vector_add_1(mpz_size_t *rs, ::mp_limb_t *rl, const mpz_size_t *as, const ::mp_limb_t *al,
+                                 const mpz_size_t *bs, const ::mp_limb_t *bl, unsigned *fl, std::size_t n)
+{
+    return ivec_addsub_1<true>(rs, rl, as, al, bs, bl, fl, n);
+}
+
+std::size_t integer_vector_sub_1(mpz_size_t *rs, ::mp_limb_t *rl, const mpz_size_t *as, const ::mp_limb_t *al,
+                                 const mpz_size_t *bs, const ::mp_limb_t *bl, unsigned *fl, std::size_t n)
+{
+    return ivec_addsub_1<false>(rs, rl, as, al, bs, bl, fl, n);
+}
+
+// NOTE: there is no SIMD instruction for the full 64x64 -> 128 bits product,
+// thus this kernel is not vectorised. It still benefits from the contiguous
+// layout and from the absence of branches.
+std::size_t integer_vector_mul_1(mpz_size_t *rs, ::mp_limb_t *rl, const mpz_size_t *as, const ::mp_limb_t *al,
+                                 const mpz_size_t *bs, const ::mp_limb_t *bl, unsigned *fl, std::size_t n)
+{
+    std::size_t retval = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto sa = as[i], sb = bs[i];
+
+        // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
+        ::mp_limb_t hi, lo;
+#if defined(MPPP_HAVE_INTEGER_VECTOR_DLIMB_MUL)
+        lo = dlimb_mul(al[i], bl[i], &hi);
+#else
+        hi = mpn_mul_1(&lo, al + i, 1, bl[i]);
+#endif
+
+        const bool fail = !ivec_is_static_1(sa) | !ivec_is_static_1(sb) | (hi != 0u);
+
+        // NOTE: if one of the operands is zero, its limb is zero
+        // and sa * sb will also be zero.
+        rs[i] = fail ? rs[i] : sa * sb;
+        rl[i] = fail ? rl[i] : lo;
+        fl[i] = static_cast<unsigned>(fail);
+        retval += static_cast<std::size_t>(fail);
+    }
+
+    return retval;
+}
+
+MPPP_INTEGER_VECTOR_CLONES std::size_t integer_vector_mul_2exp_1(mpz_size_t *rs, ::mp_limb_t *rl,
+                                                                 const mpz_size_t *as, const ::mp_limb_t *al,
+                                                                 ::mp_bitcnt_t s, unsigned *fl, std::size_t n)
+{
+    // NOTE: if s is not less than the number of bits in the limb,
+    // the only value which can be shifted is zero. We handle
+    // this case by setting the shift to zero and flagging all nonzero values.
+    const bool big_shift = s >= unsigned(GMP_NUMB_BITS);
+    const auto shift = big_shift ? 0u : static_cast<unsigned>(s);
+
+    std::size_t retval = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto sa = as[i];
+        const auto la = al[i];
+
+        // NOTE: split the right shift in two parts in order to avoid
+        // undefined behaviour for shift == 0.
+        const bool overflow = big_shift ? la != 0u : ((la >> (unsigned(GMP_NUMB_BITS) - 1u - shift)) >> 1) != 0u;
+        const bool fail = !ivec_is_static_1(sa) | overflow;
+
+        rs[i] = fail ? rs[i] : sa;
+        rl[i] = fail ? rl[i] : static_cast<::mp_limb_t>(la << shift);
+        fl[i] = static_cast<unsigned>(fail);
+        retval += static_cast<std::size_t>(fail);
+    }
+
+    return retval;
+}
+
+#endif
+
+} // namespace detail
+
+MPPP_END_NAMESPACE
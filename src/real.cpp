@@ -20,19 +20,22 @@
 #include <mp++/config.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cerrno>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <ios>
 #include <iostream>
 #include <limits>
 #include <locale>
-#include <memory>
+#include <new>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -210,103 +213,637 @@ void real_frac_wrapper(::mpfr_t rop, const ::mpfr_t op)
 namespace
 {
 
-void mpfr_to_string(const ::mpfr_t r, std::ostream &os, int base)
+// Check the base for the conversion of a real to string.
+void real_check_str_base(int base)
 {
-    // All chars potentially used by MPFR for representing the digits up to base 62, sorted.
-    constexpr char all_chars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-    // Check the base.
     if (mppp_unlikely(base < 2 || base > 62)) {
         throw std::invalid_argument("Cannot convert a real to a string in base " + to_string(base)
                                     + ": the base must be in the [2,62] range");
     }
-    // Special values first.
+}
+
+// Writer for the representation of a real into the range [first, last).
+// NOTE: if the range is too small, the writer stops writing
+// and records the failure.
+struct real_chars_writer {
+    explicit real_chars_writer(char *first, char *last) : m_ptr(first), m_last(last), m_ok(true) {}
+
+    void put(char c)
+    {
+        if (m_ok && m_ptr != m_last) {
+            *m_ptr++ = c;
+        } else {
+            m_ok = false;
+        }
+    }
+    void put(const char *s, std::size_t n)
+    {
+        if (m_ok && n <= static_cast<std::size_t>(m_last - m_ptr)) {
+            m_ptr = std::copy(s, s + n, m_ptr);
+        } else {
+            m_ok = false;
+        }
+    }
+    void fill(char c, unsigned long long n)
+    {
+        if (m_ok && n <= static_cast<unsigned long long>(m_last - m_ptr)) {
+            m_ptr = std::fill_n(m_ptr, static_cast<std::size_t>(n), c);
+        } else {
+            m_ok = false;
+        }
+    }
+    // Write the exponent e, preceded by the marker and by the sign,
+    // using at least min_digits digits.
+    void put_exp(char marker, long long e, std::size_t min_digits = 1)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<char, 24> buffer;
+        put(marker);
+        put(buffer.data(), static_cast<std::size_t>(exp_to_chars(buffer.data(), e, min_digits) - buffer.data()));
+    }
+    MPPP_NODISCARD to_chars_result result() const
+    {
+        if (m_ok) {
+            return {m_ptr, std::errc{}};
+        } else {
+            return {m_last, std::errc::value_too_large};
+        }
+    }
+    // Write into out the sign and the decimal digits of the exponent e,
+    // zero-padded to at least min_digits digits, returning a pointer past
+    // the last char written. out must have space for at least 21 chars.
+    static char *exp_to_chars(char *out, long long e, std::size_t min_digits = 1)
+    {
+        *out++ = e < 0 ? '-' : '+';
+        auto u = e < 0 ? 0ull - static_cast<unsigned long long>(e) : static_cast<unsigned long long>(e);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+        std::array<char, 20> buffer;
+        assert(min_digits <= buffer.size());
+        auto *ptr = buffer.data() + buffer.size();
+        do {
+            *--ptr = static_cast<char>('0' + static_cast<int>(u % 10u));
+            u /= 10u;
+        } while (u != 0u || static_cast<std::size_t>(buffer.data() + buffer.size() - ptr) < min_digits);
+        return std::copy(ptr, buffer.data() + buffer.size(), out);
+    }
+
+    char *m_ptr;
+    char *m_last;
+    bool m_ok;
+};
+
+// Upper bound for the number of digits produced by mpfr_get_str()
+// for a real of precision p when the number of digits is not specified.
+std::size_t mpfr_get_str_ndigits_bound(int base, ::mpfr_prec_t p)
+{
+    // NOTE: according to the MPFR docs, the number of digits is 1 + ceil(p * log(2) / log(base)),
+    // and it can be larger by one in some rare cases. Add some slack
+    // to account for the floating-point arithmetic.
+    const auto x = static_cast<double>(p) / std::log2(static_cast<double>(base));
+    return static_cast<std::size_t>(x + x * 1E-10) + 4u;
+}
+
+// Buffer for the digits produced by mpfr_get_str(). Small buffers are
+// stored in a local array, larger buffers are allocated dynamically.
+class mpfr_digits_buffer
+{
+public:
+    // Prepare a buffer for up to n digits, plus extra chars.
+    explicit mpfr_digits_buffer(std::size_t n, std::size_t extra = 0)
+    {
+        // NOTE: mpfr_get_str() needs room for the digits, for a minus sign
+        // and for the terminator, and at least 7 chars in total.
+        // LCOV_EXCL_START
+        if (mppp_unlikely(n > nl_max<std::size_t>() - 7u - extra)) {
+            throw std::overflow_error("Too many digits in the conversion of a real to string");
+        }
+        // LCOV_EXCL_STOP
+        const auto size = std::max(n + 2u, std::size_t(7)) + extra;
+        if (size <= m_local.size()) {
+            m_ptr = m_local.data();
+        } else {
+            m_dyn.resize(size);
+            m_ptr = m_dyn.data();
+        }
+    }
+    mpfr_digits_buffer(const mpfr_digits_buffer &) = delete;
+    mpfr_digits_buffer(mpfr_digits_buffer &&) = delete;
+    mpfr_digits_buffer &operator=(const mpfr_digits_buffer &) = delete;
+    mpfr_digits_buffer &operator=(mpfr_digits_buffer &&) = delete;
+    ~mpfr_digits_buffer() = default;
+
+    MPPP_NODISCARD char *data() const
+    {
+        return m_ptr;
+    }
+
+private:
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<char, 256> m_local;
+    std::vector<char> m_dyn;
+    char *m_ptr;
+};
+
+// Write into buf the n significant digits of r in base base (or the number of digits
+// required for round-tripping, if n is zero) via mpfr_get_str(), preceded by a minus sign
+// if r is negative. Return the number of digits, and store in exp the exponent
+// such that the value is 0.ddd * base**exp.
+std::size_t mpfr_get_digits(char *buf, ::mpfr_exp_t &exp, int base, std::size_t n, const ::mpfr_t r,
+                            ::mpfr_rnd_t rnd)
+{
+#if MPFR_VERSION_MAJOR < 4
+    if (n == 1u) {
+        // NOTE: before MPFR 4, mpfr_get_str() requires at least 2 digits. Round
+        // the truncated 2-digit representation to nearest, with ties to even.
+        assert(base == 10);
+        assert(rnd == MPFR_RNDN);
+        const auto nd = mpfr_get_digits(buf, exp, base, 2, r, MPFR_RNDZ);
+        ignore(nd);
+        assert(nd == 2u);
+        auto *d = buf + static_cast<int>(buf[0] == '-');
+        if (d[0] != '0') {
+            // NOTE: the truncated representation is exact
+            // if it coincides with the representation rounded away from zero.
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+            std::array<char, 8> away;
+            ::mpfr_exp_t exp_away(0);
+            mpfr_get_digits(away.data(), exp_away, base, 2, r, MPFR_RNDA);
+            const bool exact = exp_away == exp && std::strcmp(away.data(), buf) == 0;
+            if (d[1] > '5' || (d[1] == '5' && (!exact || (d[0] - '0') % 2 == 1))) {
+                if (d[0] == '9') {
+                    d[0] = '1';
+                    ++exp;
+                } else {
+                    ++d[0];
+                }
+            }
+        }
+        d[1] = '\0';
+        return 1;
+    }
+#endif
+
+    if (mppp_unlikely(::mpfr_get_str(buf, &exp, base, n, r, rnd) == nullptr)) {
+        // LCOV_EXCL_START
+        throw std::runtime_error("Error in the conversion of a real to string: the call to mpfr_get_str() failed");
+        // LCOV_EXCL_STOP
+    }
+    return std::strlen(buf) - static_cast<std::size_t>(buf[0] == '-');
+}
+
+// Write the representation of r if r is a NaN or an infinity.
+// Return false if r is finite.
+bool real_nonfinite_to_chars(real_chars_writer &w, const ::mpfr_t r, int base)
+{
+    // NOTE: up to base 16 we can use nan, inf, etc., but with larger
+    // bases we have to use the syntax with @.
     if (mpfr_nan_p(r)) {
-        // NOTE: up to base 16 we can use nan, inf, etc., but with larger
-        // bases we have to use the syntax with @.
-        os << (base <= 16 ? "nan" : "@nan@");
-        return;
+        const char *str = base <= 16 ? "nan" : "@nan@";
+        w.put(str, std::strlen(str));
+        return true;
     }
     if (mpfr_inf_p(r)) {
         if (mpfr_sgn(r) < 0) {
-            os << '-';
+            w.put('-');
         }
-        os << (base <= 16 ? "inf" : "@inf@");
+        const char *str = base <= 16 ? "inf" : "@inf@";
+        w.put(str, std::strlen(str));
+        return true;
+    }
+    return false;
+}
+
+// Write in scientific format the nd digits starting at d, representing
+// the value 0.ddd * base**exp. If full_exp is true, the exponent is always
+// written with at least two digits, as in std::chars_format::scientific.
+// Otherwise, the exponent is omitted if it is zero.
+void real_sci_to_chars(real_chars_writer &w, const char *d, std::size_t nd, ::mpfr_exp_t exp, int base, bool zero,
+                       bool full_exp)
+{
+    assert(nd > 0u);
+
+    // Insert the decimal point after the first digit.
+    w.put(d[0]);
+    if (nd > 1u) {
+        w.put('.');
+        w.put(d + 1, nd - 1u);
+    }
+
+    // Add the exponent at the end. The exponent of a zero value is zero.
+    // NOTE: for bases greater than 10 we need '@' for the exponent, rather than 'e' or 'E'.
+    // https://www.mpfr.org/mpfr-current/mpfr.html#Assignment-Functions
+    // NOTE: the exponent cannot overflow, as the exponents of reals
+    // are well within the range of long long.
+    const auto e = zero ? 0ll : static_cast<long long>(exp) - 1;
+    if (full_exp) {
+        w.put_exp(base <= 10 ? 'e' : '@', e, 2);
+    } else if (e != 0) {
+        w.put_exp(base <= 10 ? 'e' : '@', e);
+    }
+}
+
+// Write in fixed format the nd decimal digits starting at d, representing the value 0.ddd * 10**exp,
+// with nf digits after the decimal point. The digits missing from d are zeroes.
+void real_fixed_to_chars(real_chars_writer &w, const char *d, std::size_t nd, ::mpfr_exp_t exp, unsigned long long nf)
+{
+    // The integral part.
+    std::size_t nused = 0;
+    if (exp <= 0) {
+        w.put('0');
+    } else {
+        const auto ue = static_cast<unsigned long long>(exp);
+        nused = static_cast<std::size_t>(std::min(ue, static_cast<unsigned long long>(nd)));
+        w.put(d, nused);
+        w.fill('0', ue - nused);
+    }
+
+    if (nf == 0u) {
         return;
     }
 
-    // Get the string fractional representation via the MPFR function,
-    // and wrap it into a smart pointer.
+    // The fractional part.
+    w.put('.');
+    unsigned long long nz = 0;
+    if (exp < 0) {
+        nz = std::min(0ull - static_cast<unsigned long long>(exp), nf);
+        w.fill('0', nz);
+    }
+    const auto ndf = static_cast<std::size_t>(std::min(nf - nz, static_cast<unsigned long long>(nd - nused)));
+    w.put(d + nused, ndf);
+    w.fill('0', nf - nz - ndf);
+}
+
+// Implementation of to_chars() in the format of real::to_string().
+to_chars_result real_to_chars_impl(char *first, char *last, const real &r, int base)
+{
+    real_chars_writer w(first, last);
+    if (real_nonfinite_to_chars(w, r.get_mpfr_t(), base)) {
+        return w.result();
+    }
+
+    mpfr_digits_buffer buffer(mpfr_get_str_ndigits_bound(base, r.get_prec()));
     ::mpfr_exp_t exp(0);
-    std::unique_ptr<char, void (*)(char *)> str(::mpfr_get_str(nullptr, &exp, base, 0, r, MPFR_RNDN), ::mpfr_free_str);
-    // LCOV_EXCL_START
-    if (mppp_unlikely(!str)) {
-        throw std::runtime_error("Error in the conversion of a real to string: the call to mpfr_get_str() failed");
+    const auto nd = mpfr_get_digits(buffer.data(), exp, base, 0, r.get_mpfr_t(), MPFR_RNDN);
+    const auto *d = buffer.data();
+    if (*d == '-') {
+        w.put(*d++);
     }
-    // LCOV_EXCL_STOP
+    real_sci_to_chars(w, d, nd, exp, base, r.zero_p(), false);
 
-    // Print the string, inserting a decimal point after the first digit.
-    bool dot_added = false;
-    // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
-    for (auto cptr = str.get(); *cptr != '\0'; ++cptr) {
-        os << (*cptr);
-        if (!dot_added) {
-            if (base <= 10) {
-                // For bases up to 10, we can use the followig guarantee
-                // from the standard:
-                // http://stackoverflow.com/questions/13827180/char-ascii-relation
-                // """
-                // The mapping of integer values for characters does have one guarantee given
-                // by the Standard: the values of the decimal digits are contiguous.
-                // (i.e., '1' - '0' == 1, ... '9' - '0' == 9)
-                // """
-                // http://eel.is/c++draft/lex.charset#3
-                if (*cptr >= '0' && *cptr <= '9') {
-                    os << '.';
-                    dot_added = true;
-                }
-            } else {
-                // For bases larger than 10, we do a binary search among all the allowed characters.
-                // NOTE: we need to search into the whole all_chars array (instead of just up to all_chars
-                // + base) because apparently mpfr_get_str() seems to ignore lower/upper case when the base
-                // is small enough (e.g., it uses 'a' instead of 'A' when printing in base 11).
-                // NOTE: the range needs to be sizeof() - 1 because sizeof() also includes the terminator.
-                if (std::binary_search(all_chars, all_chars + (sizeof(all_chars) - 1u), *cptr)) {
-                    os << '.';
-                    dot_added = true;
-                }
+    return w.result();
+}
+
+// Implementation of to_chars() in scientific format with the given precision.
+to_chars_result real_to_chars_sci(char *first, char *last, const real &r, int precision)
+{
+    assert(precision >= 0);
+
+    real_chars_writer w(first, last);
+    if (real_nonfinite_to_chars(w, r.get_mpfr_t(), 10)) {
+        return w.result();
+    }
+
+    const auto n = static_cast<std::size_t>(precision) + 1u;
+    mpfr_digits_buffer buffer(n);
+    ::mpfr_exp_t exp(0);
+    const auto nd = mpfr_get_digits(buffer.data(), exp, 10, n, r.get_mpfr_t(), MPFR_RNDN);
+    const auto *d = buffer.data();
+    if (*d == '-') {
+        w.put(*d++);
+    }
+    real_sci_to_chars(w, d, nd, exp, 10, r.zero_p(), true);
+
+    return w.result();
+}
+
+// Implementation of to_chars() in fixed format. A negative precision
+// means the number of digits required for round-tripping.
+to_chars_result real_to_chars_fixed(char *first, char *last, const real &r, int precision)
+{
+    real_chars_writer w(first, last);
+    if (real_nonfinite_to_chars(w, r.get_mpfr_t(), 10)) {
+        return w.result();
+    }
+
+    if (r.signbit()) {
+        w.put('-');
+    }
+
+    if (precision < 0) {
+        // The digits required for round-tripping, in positional notation.
+        mpfr_digits_buffer buffer(mpfr_get_str_ndigits_bound(10, r.get_prec()));
+        ::mpfr_exp_t exp(0);
+        const auto nd = mpfr_get_digits(buffer.data(), exp, 10, 0, r.get_mpfr_t(), MPFR_RNDN);
+        const auto *d = buffer.data() + static_cast<int>(buffer.data()[0] == '-');
+        // NOTE: with a nonpositive exponent, all the digits are after the decimal point.
+        unsigned long long nf = 0;
+        if (exp <= 0) {
+            nf = nd + (0ull - static_cast<unsigned long long>(exp));
+        } else if (static_cast<unsigned long long>(exp) < nd) {
+            nf = nd - static_cast<std::size_t>(exp);
+        }
+        real_fixed_to_chars(w, d, nd, exp, nf);
+        return w.result();
+    }
+
+    const auto nf = static_cast<unsigned long long>(precision);
+    if (r.zero_p()) {
+        real_fixed_to_chars(w, "0", 1, 0, nf);
+        return w.result();
+    }
+
+    // Determine the exponent via the truncated leading digits.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<char, 8> lead;
+    ::mpfr_exp_t exp(0);
+    mpfr_get_digits(lead.data(), exp, 10, 2, r.get_mpfr_t(), MPFR_RNDZ);
+
+    // The number of significant digits up to the requested position.
+    const auto n = static_cast<long long>(exp) + precision;
+    if (n <= 0) {
+        // The absolute value of r is less than 10**-precision: the result
+        // is either zero or 10**-precision.
+        // NOTE: if n is zero, the leading digit determines the result. A tie is possible
+        // only if precision is zero and the absolute value of r is 1/2, as 5 * 10**-(precision + 1)
+        // is not a dyadic rational otherwise.
+        const auto d0 = lead[static_cast<std::size_t>(lead[0] == '-')];
+        const bool up
+            = n == 0 && d0 >= '5' && !(precision == 0 && ::mpfr_cmp_si_2exp(r.get_mpfr_t(), r.sgn(), -1) == 0);
+        real_fixed_to_chars(w, up ? "1" : "0", 1, -precision + 1, nf);
+        return w.result();
+    }
+
+    // NOTE: the representation has at least n chars.
+    if (static_cast<unsigned long long>(n) > static_cast<unsigned long long>(last - first)) {
+        return {last, std::errc::value_too_large};
+    }
+    mpfr_digits_buffer buffer(static_cast<std::size_t>(n));
+    ::mpfr_exp_t exp_rnd(0);
+    const auto nd
+        = mpfr_get_digits(buffer.data(), exp_rnd, 10, static_cast<std::size_t>(n), r.get_mpfr_t(), MPFR_RNDN);
+    // NOTE: the rounding might have carried over into a new leading digit.
+    assert(exp_rnd == exp || exp_rnd == exp + 1);
+    real_fixed_to_chars(w, buffer.data() + static_cast<int>(buffer.data()[0] == '-'), nd, exp_rnd, nf);
+
+    return w.result();
+}
+
+// Implementation of to_chars() in the shortest round-tripping format.
+to_chars_result real_to_chars_shortest(char *first, char *last, const real &r)
+{
+    real_chars_writer w(first, last);
+    if (real_nonfinite_to_chars(w, r.get_mpfr_t(), 10)) {
+        return w.result();
+    }
+
+    if (r.signbit()) {
+        w.put('-');
+    }
+    if (r.zero_p()) {
+        w.put('0');
+        return w.result();
+    }
+
+    // The number of digits of the representation used by to_string(),
+    // which is known to round-trip.
+    const auto bound = mpfr_get_str_ndigits_bound(10, r.get_prec());
+    mpfr_digits_buffer buffer(bound);
+    ::mpfr_exp_t exp(0);
+    auto nd = mpfr_get_digits(buffer.data(), exp, 10, 0, r.get_mpfr_t(), MPFR_RNDN);
+
+    // Check if the representation with n digits round-trips. The representation
+    // is written in the format 0.ddd@exp and parsed back.
+    // NOTE: the string starts after a prefix which leaves room for "-0.", and
+    // it is followed by the exponent.
+    mpfr_digits_buffer check_buffer(bound, 3u + 1u + 21u);
+    real tmp{real_kind::zero, r.get_prec()};
+    const auto round_trips = [&](std::size_t n) {
+        auto *const s = check_buffer.data() + 3;
+        ::mpfr_exp_t e(0);
+        const auto nd_check = mpfr_get_digits(s, e, 10, n, r.get_mpfr_t(), MPFR_RNDN);
+        const bool neg = s[0] == '-';
+        auto *const d = s + static_cast<int>(neg);
+        d[-1] = '.';
+        d[-2] = '0';
+        if (neg) {
+            d[-3] = '-';
+        }
+        auto *ptr = d + nd_check;
+        *ptr++ = '@';
+        *real_chars_writer::exp_to_chars(ptr, static_cast<long long>(e)) = '\0';
+        return ::mpfr_set_str(tmp._get_mpfr_t(), d - 2 - static_cast<int>(neg), 10, MPFR_RNDN) == 0
+               && ::mpfr_equal_p(tmp.get_mpfr_t(), r.get_mpfr_t()) != 0;
+    };
+
+    // Binary search for the smallest number of digits which round-trips.
+    std::size_t lo = 1, hi = nd;
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2u;
+        if (round_trips(mid)) {
+            hi = mid;
+        } else {
+            lo = mid + 1u;
+        }
+    }
+    if (hi != nd) {
+        nd = mpfr_get_digits(buffer.data(), exp, 10, hi, r.get_mpfr_t(), MPFR_RNDN);
+    }
+
+    // Strip the trailing zeroes.
+    const auto *d = buffer.data() + static_cast<int>(buffer.data()[0] == '-');
+    while (nd > 1u && d[nd - 1u] == '0') {
+        --nd;
+    }
+    real_sci_to_chars(w, d, nd, exp, 10, false, false);
+
+    return w.result();
+}
+
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+
+// Structure for caching the significands of the reals in dynamic storage.
+// NOTE: the cached significands are the ones allocated by mpfr_init2(), including
+// the header in which MPFR stores the size of the allocation. Each significand is
+// stored under the number of limbs of the precision of the real it belonged to, which is
+// never larger than the size of the allocation. Hence, a cached significand can be reused
+// for any precision with the same number of limbs, and it can later be resized by
+// mpfr_set_prec() and freed by mpfr_clear() as usual.
+struct mpfr_alloc_cache {
+    // Upper limit for the number of limbs of the significands which can be cached.
+    static constexpr std::size_t max_size_limit = 64;
+    // Default values for the runtime limits below.
+    static constexpr std::size_t default_max_size = 16;
+    static constexpr std::size_t default_max_entries = 20;
+    // Significands up to this number of limbs will be cached.
+    std::size_t max_size;
+    // Max number of significands to cache for each number of limbs.
+    std::size_t max_entries;
+    // The actual cache. This is a flat array of max_size * max_entries
+    // pointers, allocated on first use.
+    ::mp_limb_t **caches;
+    // The number of significands actually stored in each cache entry.
+    std::array<std::size_t, max_size_limit> sizes;
+    // Usage statistics, as in the integer cache.
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    // NOTE: use round brackets init for the usual GCC 4.8 workaround.
+    constexpr mpfr_alloc_cache() noexcept
+        : max_size(default_max_size), max_entries(default_max_entries), caches(nullptr), sizes(), hits(0),
+          misses(0), evictions(0)
+    {
+    }
+    mpfr_alloc_cache(const mpfr_alloc_cache &) = delete;
+    mpfr_alloc_cache(mpfr_alloc_cache &&) = delete;
+    mpfr_alloc_cache &operator=(const mpfr_alloc_cache &) = delete;
+    mpfr_alloc_cache &operator=(mpfr_alloc_cache &&) = delete;
+    // Clear the cache, freeing all the significands.
+    void clear() noexcept
+    {
+        for (std::size_t i = 0; i < max_size; ++i) {
+            for (std::size_t j = 0; j < sizes[i]; ++j) {
+                // NOTE: mpfr_clear() needs only the significand pointer, but
+                // set up a valid mpfr_t anyway.
+                mpfr_struct_t m;
+                m._mpfr_prec = static_cast<::mpfr_prec_t>((i + 1u) * unsigned(GMP_NUMB_BITS));
+                m._mpfr_sign = 1;
+                m._mpfr_exp = 0;
+                m._mpfr_d = caches[i * max_entries + j];
+                ::mpfr_clear(&m);
             }
+            sizes[i] = 0u;
+        }
+        delete[] caches;
+        caches = nullptr;
+    }
+    // Allocate the storage for the cache, if needed. Returns false
+    // if the allocation fails.
+    bool init_storage() noexcept
+    {
+        if (caches == nullptr) {
+            // NOTE: the product cannot overflow, as it is checked in set_limits().
+            caches = new (std::nothrow)::mp_limb_t *[max_size * max_entries];
         }
+        return caches != nullptr;
+    }
+    // Init rop with precision p and a NaN value, using a cached significand.
+    // Returns false if no suitable significand is available.
+    bool init(mpfr_struct_t &rop, ::mpfr_prec_t p) noexcept
+    {
+        const auto nlimbs = static_cast<std::size_t>((p - 1) / GMP_NUMB_BITS + 1);
+        if (nlimbs > max_size || sizes[nlimbs - 1u] == 0u) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        const auto idx = nlimbs - 1u;
+        // NOTE: mpfr_custom_init_set() just sets up the fields of rop,
+        // leaving untouched the MPFR header of the significand.
+        mpfr_custom_init_set(&rop, MPFR_NAN_KIND, 0, p, caches[idx * max_entries + --sizes[idx]]);
+        return true;
     }
-    assert(dot_added);
-
-    // Adjust the exponent. Do it in multiprec in order to avoid potential overflow.
-    integer<1> z_exp{exp};
-    --z_exp;
-    const auto exp_sgn = z_exp.sgn();
-    if (exp_sgn != 0 && !mpfr_zero_p(r)) {
-        // Add the exponent at the end of the string, if both the value and the exponent
-        // are nonzero.
-        // NOTE: for bases greater than 10 we need '@' for the exponent, rather than 'e' or 'E'.
-        // https://www.mpfr.org/mpfr-current/mpfr.html#Assignment-Functions
-        os << (base <= 10 ? 'e' : '@');
-        if (exp_sgn == 1) {
-            // Add extra '+' if the exponent is positive, for consistency with
-            // real128's string format (and possibly other formats too?).
-            os << '+';
+    // Store the significand of m in the cache if possible, otherwise free it.
+    void cache_or_clear(mpfr_struct_t &m)
+    {
+        const auto nlimbs = static_cast<std::size_t>((mpfr_get_prec(&m) - 1) / GMP_NUMB_BITS + 1);
+        // NOTE: the significands with at most ssize limbs are not cached, as
+        // the reals with such precisions use the static storage. The significands
+        // are not cached either if the memory resources for integers are enabled,
+        // as they may have been allocated from a memory resource which may
+        // be released while the cache is still alive.
+        if (nlimbs > real::ssize && nlimbs <= max_size && !integer_memory_resources_enabled()) {
+            const auto idx = nlimbs - 1u;
+            if (max_entries != 0u && sizes[idx] < max_entries && init_storage()) {
+                caches[idx * max_entries + sizes[idx]] = m._mpfr_d;
+                ++sizes[idx];
+                return;
+            }
+            ++evictions;
+        }
+        ::mpfr_clear(&m);
+    }
+    // Clear the cache and set new limits.
+    void set_limits(std::size_t new_max_size, std::size_t new_max_entries)
+    {
+        if (mppp_unlikely(new_max_size > max_size_limit)) {
+            throw std::invalid_argument("Cannot set the maximum size of the significands in the real cache to "
+                                        + detail::to_string(new_max_size) + ": the value must not be greater than "
+                                        + detail::to_string(max_size_limit));
         }
-        os << z_exp;
+        if (mppp_unlikely(new_max_size != 0u
+                          && new_max_entries > nl_max<std::size_t>() / sizeof(::mp_limb_t *) / new_max_size)) {
+            throw std::overflow_error("Cannot set the maximum number of entries in the real cache to "
+                                      + detail::to_string(new_max_entries) + ": the value is too large");
+        }
+        clear();
+        max_size = new_max_size;
+        max_entries = new_max_entries;
+    }
+    ~mpfr_alloc_cache()
+    {
+        clear();
+        // NOTE: reals with static storage duration may be destroyed
+        // after this cache. Make sure their significands are freed
+        // rather than cached.
+        max_size = 0;
     }
-}
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
+constexpr std::size_t mpfr_alloc_cache::max_size_limit;
+constexpr std::size_t mpfr_alloc_cache::default_max_size;
+constexpr std::size_t mpfr_alloc_cache::default_max_entries;
+
+#endif
+
+// Thread local significand cache.
+// NOTE: see the notes about thread_local in integer.cpp. Like the integer
+// cache, the constexpr ctor ensures that the initialisation of this variable
+// happens before any dynamic initialisation.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+MPPP_CONSTINIT thread_local mpfr_alloc_cache mpfr_alloc_cache_inst;
+
+#endif
 
 } // namespace
 
+// Init rop with precision p and a NaN value, reusing a cached
+// significand if possible.
+void mpfr_init_cached(mpfr_struct_t &rop, ::mpfr_prec_t p)
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    if (mpfr_alloc_cache_inst.init(rop, p)) {
+        return;
+    }
+#endif
+    ::mpfr_init2(&rop, p);
+}
+
+// Clear m, storing its significand in the cache if possible.
+void mpfr_clear_cached(mpfr_struct_t &m)
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    mpfr_alloc_cache_inst.cache_or_clear(m);
+#else
+    ::mpfr_clear(&m);
+#endif
+}
+
 } // namespace detail
 
+#if MPPP_CPLUSPLUS < 201703L
+
+constexpr std::size_t real::ssize;
+constexpr ::mpfr_prec_t real::static_prec_max;
+
+#endif
+
 // Default constructor.
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
 real::real()
 {
-    ::mpfr_init2(&m_mpfr, real_prec_min());
+    init_storage(real_prec_min());
     ::mpfr_set_zero(&m_mpfr, 1);
 }
 
@@ -318,7 +855,7 @@ real::real(const ptag &, ::mpfr_prec_t p, bool ignore_prec)
     assert(ignore_prec);
     assert(detail::real_prec_check(p));
     detail::ignore(ignore_prec);
-    ::mpfr_init2(&m_mpfr, p);
+    init_storage(p);
 }
 
 // Copy constructor.
@@ -329,7 +866,7 @@ real::real(const real &other) : real(&other.m_mpfr) {}
 real::real(const real &other, ::mpfr_prec_t p)
 {
     // Init with custom precision, and then set.
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     mpfr_set(&m_mpfr, &other.m_mpfr, MPFR_RNDN);
 }
 
@@ -342,6 +879,10 @@ real::real(real &&other, ::mpfr_prec_t p)
 
     // Shallow copy other.
     m_mpfr = other.m_mpfr;
+    if (other.is_static()) {
+        m_limbs = other.m_limbs;
+        m_mpfr._mpfr_d = m_limbs.data();
+    }
     // Mark the other as moved-from.
     other.m_mpfr._mpfr_d = nullptr;
 
@@ -409,10 +950,10 @@ void real::construct_from_c_string(const char *s, int base, ::mpfr_prec_t p)
         throw std::invalid_argument("Cannot construct a real from a string in base " + detail::to_string(base)
                                     + ": the base must either be zero or in the [2,62] range");
     }
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     const auto ret = ::mpfr_set_str(&m_mpfr, s, base, MPFR_RNDN);
     if (mppp_unlikely(ret == -1)) {
-        ::mpfr_clear(&m_mpfr);
+        clear_storage();
         throw std::invalid_argument(std::string{"The string '"} + s + "' does not represent a valid real in base "
                                     + detail::to_string(base));
     }
@@ -450,7 +991,7 @@ real::real(const char *begin, const char *end, ::mpfr_prec_t p) : real(begin, en
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init, bugprone-easily-swappable-parameters)
 real::real(real_kind k, int sign, ::mpfr_prec_t p)
 {
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     // NOTE: handle all cases explicitly, in order to avoid
     // compiler warnings.
     switch (k) {
@@ -464,7 +1005,7 @@ real::real(real_kind k, int sign, ::mpfr_prec_t p)
             break;
         default:
             // Clean up before throwing.
-            ::mpfr_clear(&m_mpfr);
+            clear_storage();
             using kind_cast_t = std::underlying_type<::mpfr_kind_t>::type;
             throw std::invalid_argument(
                 "The 'real_kind' value passed to the constructor of a real ("
@@ -482,14 +1023,14 @@ real::real(real_kind k, ::mpfr_prec_t p) : real(k, 0, p) {}
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init, bugprone-easily-swappable-parameters)
 real::real(unsigned long n, ::mpfr_exp_t e, ::mpfr_prec_t p)
 {
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     set_ui_2exp(*this, n, e);
 }
 
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init, bugprone-easily-swappable-parameters)
 real::real(long n, ::mpfr_exp_t e, ::mpfr_prec_t p)
 {
-    ::mpfr_init2(&m_mpfr, check_init_prec(p));
+    init_storage(check_init_prec(p));
     set_si_2exp(*this, n, e);
 }
 
@@ -498,7 +1039,7 @@ real::real(long n, ::mpfr_exp_t e, ::mpfr_prec_t p)
 real::real(const ::mpfr_t x)
 {
     // Init with the same precision as other, and then set.
-    ::mpfr_init2(&m_mpfr, mpfr_get_prec(x));
+    init_storage(mpfr_get_prec(x));
     mpfr_set(&m_mpfr, x, MPFR_RNDN);
 }
 
@@ -513,7 +1054,7 @@ real &real::operator=(const real &other)
             set_prec_impl<false>(other.get_prec());
         } else {
             // this has been moved-from: init before setting.
-            ::mpfr_init2(&m_mpfr, other.get_prec());
+            init_storage(other.get_prec());
         }
         // Perform the actual copy from other.
         mpfr_set(&m_mpfr, &other.m_mpfr, MPFR_RNDN);
@@ -565,7 +1106,7 @@ real &real::operator=(const ::mpfr_t x)
 real &real::operator=(::mpfr_t &&x)
 {
     // Clear this.
-    ::mpfr_clear(&m_mpfr);
+    clear_storage();
     // Shallow copy x.
     m_mpfr = *x;
     return *this;
@@ -721,6 +1262,7 @@ void real::assign_real128(const real128 &x)
         // Write the significand into this.
         write_significand();
         // Add the hidden bit on top.
+        const detail::mpz_default_memory_binding mb;
         const MPPP_MAYBE_TLS real r_2_112 = detail::real_2_112();
         ::mpfr_add(&m_mpfr, &m_mpfr, r_2_112.get_mpfr_t(), MPFR_RNDN);
         // Multiply by 2 raised to the adjusted exponent.
@@ -923,13 +1465,64 @@ real &real::prec_round(::mpfr_prec_t p)
     return *this;
 }
 
+// Implementation of prec_round() for reals in static storage.
+void real::static_prec_round(::mpfr_prec_t p)
+{
+    assert(is_static());
+
+    // NOTE: mpfr_prec_round() cannot be used on the static storage, as it
+    // might try to reallocate the significand. We round into a temporary
+    // with the new precision instead, and we then move the temporary into this.
+    std::array<::mp_limb_t, ssize> limbs;
+    mpfr_struct_t tmp;
+    if (p <= static_prec_max) {
+        mpfr_custom_init(limbs.data(), p);
+        mpfr_custom_init_set(&tmp, MPFR_NAN_KIND, 0, p, limbs.data());
+    } else {
+        // The new precision does not fit in the static storage,
+        // switch to dynamic storage.
+        detail::mpfr_init_cached(tmp, p);
+    }
+
+    if (mpfr_regular_p(&m_mpfr)) {
+        mpfr_set(&tmp, &m_mpfr, MPFR_RNDN);
+    } else {
+        // NOTE: for NaNs, infinities and zeroes, just copy
+        // the sign and the exponent, as mpfr_prec_round() would do.
+        tmp._mpfr_sign = m_mpfr._mpfr_sign;
+        tmp._mpfr_exp = m_mpfr._mpfr_exp;
+    }
+
+    m_mpfr = tmp;
+    if (p <= static_prec_max) {
+        m_limbs = limbs;
+        m_mpfr._mpfr_d = m_limbs.data();
+    }
+}
+
 // Convert to string.
 std::string real::to_string(int base) const
 {
-    std::ostringstream oss;
-    oss.exceptions(std::ios_base::failbit | std::ios_base::badbit);
-    detail::mpfr_to_string(&m_mpfr, oss, base);
-    return oss.str();
+    detail::real_check_str_base(base);
+
+    // NOTE: room for the digits, the sign, the decimal point and the exponent.
+    const auto size = detail::mpfr_get_str_ndigits_bound(base, get_prec()) + 32u;
+
+    // For low precision values, write the representation into a local
+    // buffer, otherwise write it directly into the return value.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    std::array<char, 256> buffer;
+    if (size <= buffer.size()) {
+        const auto res = to_chars(buffer.data(), buffer.data() + buffer.size(), *this, base);
+        assert(res.ec == std::errc{});
+        return std::string(buffer.data(), res.ptr);
+    }
+
+    std::string ret(size, '\0');
+    const auto res = to_chars(&ret[0], &ret[0] + ret.size(), *this, base);
+    assert(res.ec == std::errc{});
+    ret.resize(static_cast<std::string::size_type>(res.ptr - &ret[0]));
+    return ret;
 }
 
 // In-place square root.
@@ -1230,10 +1823,16 @@ namespace
 template <typename T>
 inline void dispatch_real_in_place_add_generic_impl(real &a, const T &x)
 {
+    if (real_fp_is_double(x)) {
+        dispatch_real_in_place_add_fd_impl(a, x);
+        return;
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    dispatch_real_in_place_add(a, tmp);
+    mb.escape([&]() { dispatch_real_in_place_add(a, tmp); });
 }
 
 } // namespace
@@ -1334,10 +1933,16 @@ namespace
 template <typename T>
 inline void dispatch_real_in_place_sub_generic_impl(real &a, const T &x)
 {
+    if (real_fp_is_double(x)) {
+        dispatch_real_in_place_sub_fd_impl(a, x);
+        return;
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    dispatch_real_in_place_sub(a, tmp);
+    mb.escape([&]() { dispatch_real_in_place_sub(a, tmp); });
 }
 
 } // namespace
@@ -1438,10 +2043,16 @@ namespace
 template <typename T>
 inline void dispatch_real_in_place_mul_generic_impl(real &a, const T &x)
 {
+    if (real_fp_is_double(x)) {
+        dispatch_real_in_place_mul_fd_impl(a, x);
+        return;
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    dispatch_real_in_place_mul(a, tmp);
+    mb.escape([&]() { dispatch_real_in_place_mul(a, tmp); });
 }
 
 } // namespace
@@ -1526,10 +2137,16 @@ namespace
 template <typename T>
 inline void dispatch_real_in_place_div_generic_impl(real &a, const T &x)
 {
+    if (real_fp_is_double(x)) {
+        dispatch_real_in_place_div_fd_impl(a, x);
+        return;
+    }
+
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp.set_prec(c_max(a.get_prec(), real_deduce_precision(x)));
     tmp.set(x);
-    dispatch_real_in_place_div(a, tmp);
+    mb.escape([&]() { dispatch_real_in_place_div(a, tmp); });
 }
 
 } // namespace
@@ -1640,6 +2257,7 @@ bool dispatch_real_equality(const real &r1, const real128 &r2)
 {
     // NOTE: straight assignment here is fine: tmp
     // will represent r2 exactly.
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r2;
 
@@ -1773,6 +2391,7 @@ bool dispatch_real_gt(const real &r1, const real128 &r2)
 {
     // NOTE: straight assignment here is fine: tmp
     // will represent r2 exactly.
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r2;
 
@@ -1781,6 +2400,7 @@ bool dispatch_real_gt(const real &r1, const real128 &r2)
 
 bool dispatch_real_gt(const real128 &r1, const real &r2)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r1;
 
@@ -1914,6 +2534,7 @@ bool dispatch_real_gte(const real &r1, const real128 &r2)
 {
     // NOTE: straight assignment here is fine: tmp
     // will represent r2 exactly.
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r2;
 
@@ -1922,6 +2543,7 @@ bool dispatch_real_gte(const real &r1, const real128 &r2)
 
 bool dispatch_real_gte(const real128 &r1, const real &r2)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r1;
 
@@ -2055,6 +2677,7 @@ bool dispatch_real_lt(const real &r1, const real128 &r2)
 {
     // NOTE: straight assignment here is fine: tmp
     // will represent r2 exactly.
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r2;
 
@@ -2063,6 +2686,7 @@ bool dispatch_real_lt(const real &r1, const real128 &r2)
 
 bool dispatch_real_lt(const real128 &r1, const real &r2)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r1;
 
@@ -2196,6 +2820,7 @@ bool dispatch_real_lte(const real &r1, const real128 &r2)
 {
     // NOTE: straight assignment here is fine: tmp
     // will represent r2 exactly.
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r2;
 
@@ -2204,6 +2829,7 @@ bool dispatch_real_lte(const real &r1, const real128 &r2)
 
 bool dispatch_real_lte(const real128 &r1, const real &r2)
 {
+    const mpz_default_memory_binding mb;
     MPPP_MAYBE_TLS real tmp;
     tmp = r1;
 
@@ -2298,6 +2924,30 @@ bool real_gt(const real &a, const real &b)
     return (!a.nan_p() && !b_nan) ? (::mpfr_greater_p(a.get_mpfr_t(), b.get_mpfr_t()) != 0) : !b_nan;
 }
 
+// Write a real into the range [first, last), in the format of real::to_string().
+to_chars_result to_chars(char *first, char *last, const real &r, int base)
+{
+    detail::real_check_str_base(base);
+
+    return detail::real_to_chars_impl(first, last, r, base);
+}
+
+// Write a real into the range [first, last), in the given format.
+to_chars_result to_chars(char *first, char *last, const real &r, real_chars_format fmt, int precision)
+{
+    switch (fmt) {
+        case real_chars_format::scientific:
+            return precision < 0 ? detail::real_to_chars_impl(first, last, r, 10)
+                                 : detail::real_to_chars_sci(first, last, r, precision);
+        case real_chars_format::fixed:
+            return detail::real_to_chars_fixed(first, last, r, precision);
+        case real_chars_format::shortest:
+            return detail::real_to_chars_shortest(first, last, r);
+    }
+
+    throw std::invalid_argument("Invalid format for the conversion of a real to chars");
+}
+
 // Output stream operator.
 std::ostream &operator<<(std::ostream &os, const real &r)
 {
@@ -2947,6 +3597,51 @@ std::size_t prec_to_nlimbs(mpfr_prec_t p)
     return detail::rbs_prec_to_nlimbs(p);
 }
 
+void free_real_cache()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    detail::mpfr_alloc_cache_inst.clear();
+#endif
+}
+
+void set_real_cache_limits(std::size_t max_size, std::size_t max_entries)
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    detail::mpfr_alloc_cache_inst.set_limits(max_size, max_entries);
+#else
+    detail::ignore(max_size, max_entries);
+#endif
+}
+
+std::pair<std::size_t, std::size_t> get_real_cache_limits()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    return {detail::mpfr_alloc_cache_inst.max_size, detail::mpfr_alloc_cache_inst.max_entries};
+#else
+    return {0, 0};
+#endif
+}
+
+real_cache_stats get_real_cache_stats()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    const auto &c = detail::mpfr_alloc_cache_inst;
+    return {c.hits, c.misses, c.evictions};
+#else
+    return {0, 0, 0};
+#endif
+}
+
+void reset_real_cache_stats()
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    auto &c = detail::mpfr_alloc_cache_inst;
+    c.hits = 0;
+    c.misses = 0;
+    c.evictions = 0;
+#endif
+}
+
 MPPP_END_NAMESPACE
 
 #if defined(_MSC_VER)
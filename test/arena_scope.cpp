@@ -0,0 +1,141 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 6>>;
+
+struct arena_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+
+        const integer big = integer{1} << (S::value * GMP_NUMB_BITS + 1u);
+        const std::string big_str = (big * 123456789).to_string();
+
+        // Reference values, computed outside the arenas.
+        const auto p_cmp = pow_ui(big + 1, 50);
+        integer f_cmp;
+        fac_ui(f_cmp, 500);
+        const auto b_cmp = bin_ui(big, 10);
+        const auto q_cmp = rational{big, 3} * rational{7, big + 1};
+
+        integer p, f, b;
+        rational q;
+        {
+            arena_scope a;
+            for (int i = 0; i < 100; ++i) {
+                p = pow_ui(big + 1, 50);
+                fac_ui(f, 500);
+                b = bin_ui(big, 10);
+                q = rational{big, 3} * rational{7, big + 1};
+                REQUIRE(integer{big_str} == big * 123456789);
+            }
+            REQUIRE(p == p_cmp);
+            REQUIRE(f == f_cmp);
+            REQUIRE(b == b_cmp);
+            REQUIRE(q == q_cmp);
+        }
+        // The results outlive the arena.
+        REQUIRE(p == p_cmp);
+        REQUIRE(f == f_cmp);
+        REQUIRE(b == b_cmp);
+        REQUIRE(q == q_cmp);
+        // The results can be modified after the end of the arena.
+        p *= p;
+        f <<= 10000u;
+        REQUIRE(p == p_cmp * p_cmp);
+        REQUIRE(f == f_cmp << 10000u);
+        p = 0;
+        f = 0;
+
+        // The thread-local temporaries used within the arena remain usable.
+        REQUIRE(pow_ui(big + 1, 50) == p_cmp);
+        REQUIRE(fac_ui(f, 500) == f_cmp);
+        REQUIRE(bin_ui(big, 10) == b_cmp);
+        REQUIRE(integer{big_str} == big * 123456789);
+
+        // Escaping from the arena.
+        {
+            arena_scope a(1024);
+            integer tmp = big * big;
+            auto r = a.escape([&tmp]() { return integer{tmp} << 100000u; });
+            REQUIRE(r == (big * big) << 100000u);
+            a.escape([&r]() { r <<= 1u; });
+            REQUIRE(r == (big * big) << 100001u);
+        }
+
+        // Nested arenas, and small chunks.
+        {
+            arena_scope a1(64);
+            std::vector<integer> v;
+            {
+                arena_scope a2(1);
+                for (int i = 0; i < 100; ++i) {
+                    v.push_back(pow_ui(big + i, 10));
+                }
+            }
+            for (int i = 0; i < 100; ++i) {
+                v.push_back(pow_ui(big + i, 10));
+            }
+            for (int i = 0; i < 100; ++i) {
+                REQUIRE(v[static_cast<std::size_t>(i)] == v[static_cast<std::size_t>(i) + 100u]);
+            }
+        }
+
+        // Arenas in other threads, with results destroyed in the main thread.
+        std::vector<integer> v;
+        std::thread t([&v, &big]() {
+            arena_scope a;
+            for (int i = 0; i < 100; ++i) {
+                v.push_back(pow_ui(big + i, 10));
+            }
+        });
+        t.join();
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(v[static_cast<std::size_t>(i)] == pow_ui(big + i, 10));
+        }
+        v.clear();
+
+        REQUIRE_THROWS_AS(arena_scope(0), std::invalid_argument);
+    }
+};
+
+TEST_CASE("arena_scope")
+{
+    // The memory resources must be enabled first.
+    REQUIRE_THROWS_AS(arena_scope{}, std::invalid_argument);
+
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    enable_integer_memory_resources();
+
+    tuple_for_each(sizes{}, arena_tester{});
+#endif
+}
@@ -0,0 +1,148 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const int ntries = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+struct accumulator_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using acc_t = integer_accumulator<S::value>;
+
+        // Basic API.
+        acc_t acc;
+        REQUIRE(acc.finalize() == 0);
+        REQUIRE(acc.finalize().is_static());
+        REQUIRE(&addmul(acc, integer{3}, integer{-4}) == &acc);
+        REQUIRE(&add(acc, integer{20}) == &acc);
+        REQUIRE(acc.finalize() == 8);
+        REQUIRE(&submul(acc, integer{-2}, integer{-5}) == &acc);
+        REQUIRE(&sub(acc, integer{-1}) == &acc);
+        REQUIRE(acc.finalize() == -1);
+        // finalize() does not alter the state.
+        REQUIRE(acc.finalize() == -1);
+        add(acc, integer{1});
+        REQUIRE(acc.finalize() == 0);
+        acc.addmul(integer{7}, integer{6}).sub(integer{2});
+        REQUIRE(acc.finalize() == 40);
+        acc.reset();
+        REQUIRE(acc.finalize() == 0);
+
+        // Zero operands.
+        addmul(acc, integer{}, integer{-5});
+        submul(acc, integer{-5}, integer{});
+        add(acc, integer{});
+        sub(acc, integer{});
+        REQUIRE(acc.finalize() == 0);
+
+        // Dynamic operands, including dynamic operands which would fit in static storage.
+        const integer big = integer{1} << (S::value * GMP_NUMB_BITS + 1u);
+        integer d{-3};
+        d.promote();
+        addmul(acc, big, integer{2});
+        addmul(acc, d, integer{5});
+        add(acc, -big);
+        sub(acc, d);
+        REQUIRE(acc.finalize() == big - 12);
+        submul(acc, big, integer{2});
+        add(acc, integer{12});
+        add(acc, big);
+        REQUIRE(acc.finalize() == 0);
+        REQUIRE(acc.finalize().is_static());
+        acc.reset();
+
+        // Random testing.
+        integer n1, n2, cmp;
+        detail::mpz_raii tmp;
+        std::uniform_int_distribution<unsigned> ldist(0, S::value);
+        std::uniform_int_distribution<int> sdist(0, 1), odist(0, 3);
+        auto random_int = [&](integer &n, unsigned x) {
+            random_integer(tmp, x, rng);
+            n = &tmp.m_mpz;
+            if (sdist(rng)) {
+                n.neg();
+            }
+            // Promote sometimes.
+            if (n.is_static() && !odist(rng)) {
+                n.promote();
+            }
+        };
+        for (int i = 0; i < ntries; ++i) {
+            random_int(n1, ldist(rng));
+            random_int(n2, ldist(rng));
+            switch (odist(rng)) {
+                case 0:
+                    addmul(acc, n1, n2);
+                    addmul(cmp, n1, n2);
+                    break;
+                case 1:
+                    submul(acc, n1, n2);
+                    submul(cmp, n1, n2);
+                    break;
+                case 2:
+                    add(acc, n1);
+                    add(cmp, cmp, n1);
+                    break;
+                default:
+                    sub(acc, n1);
+                    sub(cmp, cmp, n1);
+            }
+            REQUIRE(acc.finalize() == cmp);
+        }
+
+        // Operands with the largest static size, accumulating values
+        // which do not fit in static storage.
+        acc.reset();
+        cmp = 0;
+        for (int i = 0; i < ntries; ++i) {
+            random_int(n1, S::value);
+            random_int(n2, S::value);
+            if (sdist(rng)) {
+                addmul(acc, n1, n2);
+                addmul(cmp, n1, n2);
+            } else {
+                add(acc, n1);
+                add(cmp, cmp, n1);
+            }
+        }
+        REQUIRE(acc.finalize() == cmp);
+        // Cancel out the running sum.
+        sub(acc, cmp);
+        REQUIRE(acc.finalize() == 0);
+        REQUIRE(acc.finalize().is_static());
+    }
+};
+
+TEST_CASE("integer_accumulator")
+{
+    tuple_for_each(sizes{}, accumulator_tester{});
+}
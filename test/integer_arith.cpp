@@ -27,7 +27,7 @@ using namespace mppp_test;
 
 using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
                          std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
-                         std::integral_constant<std::size_t, 10>>;
+                         std::integral_constant<std::size_t, 8>, std::integral_constant<std::size_t, 10>>;
 
 // NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
 static std::mt19937 rng;
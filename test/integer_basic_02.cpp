@@ -95,7 +95,12 @@ struct nbits_ctor_tester {
         REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value)}.is_zero()));
         REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value + 1)}.is_dynamic()));
         REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value + 1)}.is_zero()));
-        REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value + 1)}.get_mpz_t()->_mp_alloc == S::value + 1));
+        // NOTE: for large enough sizes, the allocation is rounded
+        // up to the size classes of the integer cache.
+        REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value + 1)}.get_mpz_t()->_mp_alloc
+                 >= static_cast<int>(S::value + 1u)));
+        REQUIRE((integer{integer_bitcnt_t(GMP_NUMB_BITS * S::value + 1)}.get_mpz_t()->_mp_alloc
+                 <= static_cast<int>((S::value + 1u) * 5u / 4u + 1u)));
     }
 };
 
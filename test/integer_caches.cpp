@@ -9,6 +9,8 @@
 #include <atomic>
 #include <cstddef>
 #include <random>
+#include <stdexcept>
+#include <utility>
 #include <thread>
 #include <tuple>
 #include <type_traits>
@@ -120,3 +122,228 @@ TEST_CASE("caches")
 {
     tuple_for_each(sizes{}, cache_tester{});
 }
+
+TEST_CASE("cache configuration")
+{
+    using integer = integer<1>;
+    const integer big = integer{1} << (2 * GMP_NUMB_BITS);
+
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    const auto &mpzc = detail::get_thread_local_mpz_cache();
+
+    REQUIRE(get_integer_cache_limits()
+            == std::make_pair(detail::mpz_alloc_cache::default_max_size,
+                              detail::mpz_alloc_cache::default_max_entries));
+    // Start from an empty cache.
+    free_integer_caches();
+    reset_integer_cache_stats();
+    REQUIRE(get_integer_cache_stats().hits == 0u);
+    REQUIRE(get_integer_cache_stats().misses == 0u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+
+    // Misses, then hits.
+    {
+        integer n{big};
+        REQUIRE(get_integer_cache_stats().misses == 1u);
+    }
+    REQUIRE(mpzc.sizes[2] == 1u);
+    {
+        integer n{big};
+        REQUIRE(get_integer_cache_stats().hits == 1u);
+    }
+    REQUIRE(get_integer_cache_stats().misses == 1u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+
+    // When the cache is full, the arrays are moved to the central depot.
+    set_integer_cache_limits(3, 2);
+    REQUIRE(get_integer_cache_limits() == std::make_pair(std::size_t(3), std::size_t(2)));
+    // NOTE: set_integer_cache_limits() clears the cache.
+    REQUIRE(mpzc.sizes[2] == 0u);
+    {
+        std::vector<integer> v(5, big);
+    }
+    REQUIRE(mpzc.sizes[2] == 2u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+    // The cache is refilled from the depot.
+    reset_integer_cache_stats();
+    {
+        std::vector<integer> v(5, big);
+    }
+    REQUIRE(get_integer_cache_stats().hits == 5u);
+    REQUIRE(get_integer_cache_stats().misses == 0u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+    // NOTE: free_integer_caches() empties the depot as well.
+    free_integer_caches();
+    reset_integer_cache_stats();
+    {
+        std::vector<integer> v(5, big);
+    }
+    REQUIRE(get_integer_cache_stats().hits == 0u);
+    REQUIRE(get_integer_cache_stats().misses == 5u);
+
+    // Arrays larger than the largest size class are never cached.
+    {
+        integer n{big << (2000 * GMP_NUMB_BITS)};
+    }
+    REQUIRE(get_integer_cache_stats().evictions == 1u);
+
+    reset_integer_cache_stats();
+    REQUIRE(get_integer_cache_stats().hits == 0u);
+    REQUIRE(get_integer_cache_stats().misses == 0u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+
+    // Prefilling.
+    free_integer_caches();
+    prefill_integer_cache(3, 10);
+    REQUIRE(mpzc.sizes[2] == 2u);
+    prefill_integer_cache(1, 1);
+    REQUIRE(mpzc.sizes[0] == 1u);
+    {
+        std::vector<integer> v(2, big);
+    }
+    REQUIRE(get_integer_cache_stats().hits == 2u);
+    REQUIRE(get_integer_cache_stats().misses == 0u);
+    REQUIRE_THROWS_AS(prefill_integer_cache(0, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(prefill_integer_cache(1025, 1), std::invalid_argument);
+
+    // Disable the cache.
+    set_integer_cache_limits(0, 0);
+    {
+        integer n{big};
+    }
+    REQUIRE(get_integer_cache_stats().evictions == 1u);
+    REQUIRE_THROWS_AS(prefill_integer_cache(1, 1), std::invalid_argument);
+
+    // Invalid limits.
+    REQUIRE_THROWS_AS(set_integer_cache_limits(detail::mpz_alloc_cache::max_size_limit + 1u, 1),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(set_integer_cache_limits(2, static_cast<std::size_t>(-1)), std::overflow_error);
+    REQUIRE(get_integer_cache_limits() == std::make_pair(std::size_t(0), std::size_t(0)));
+
+    // Larger limits than the defaults.
+    set_integer_cache_limits(detail::mpz_alloc_cache::max_size_limit, 1000);
+    {
+        std::vector<integer> v(1000, big << (40 * GMP_NUMB_BITS));
+    }
+    REQUIRE(mpzc.sizes[42] == 1000u);
+    free_integer_caches();
+    REQUIRE(mpzc.sizes[42] == 0u);
+
+    // Size classes.
+    set_integer_cache_limits(detail::mpz_alloc_cache::default_max_size, detail::mpz_alloc_cache::default_max_entries);
+    reset_integer_cache_stats();
+    // 100 limbs are rounded up to the size class of 112 limbs.
+    {
+        integer n{integer_bitcnt_t(100 * GMP_NUMB_BITS)};
+        REQUIRE(n._get_union().g_dy()._mp_alloc == 112);
+    }
+    REQUIRE(get_integer_cache_stats().misses == 1u);
+    REQUIRE(mpzc.class_sizes[15] == 1u);
+    // Any size in the (96, 112] range reuses the array.
+    {
+        integer n{integer_bitcnt_t(97 * GMP_NUMB_BITS)};
+        REQUIRE(n._get_union().g_dy()._mp_alloc == 112);
+    }
+    {
+        integer n{integer_bitcnt_t(112 * GMP_NUMB_BITS)};
+        REQUIRE(n._get_union().g_dy()._mp_alloc == 112);
+    }
+    REQUIRE(get_integer_cache_stats().hits == 2u);
+    REQUIRE(get_integer_cache_stats().misses == 1u);
+    // Arrays whose size is not the size of a class go into the largest class which they fit.
+    {
+        integer n{integer_bitcnt_t(100 * GMP_NUMB_BITS)};
+        mpz_realloc2(&n._get_union().g_dy(), 120 * GMP_NUMB_BITS);
+    }
+    REQUIRE(mpzc.class_sizes[15] == 1u);
+    {
+        integer n{integer_bitcnt_t(105 * GMP_NUMB_BITS)};
+        REQUIRE(n._get_union().g_dy()._mp_alloc == 120);
+    }
+    // Smallest and largest size classes.
+    {
+        std::vector<integer> v;
+        v.emplace_back(integer_bitcnt_t(11 * GMP_NUMB_BITS));
+        v.emplace_back(integer_bitcnt_t(1024 * GMP_NUMB_BITS));
+        REQUIRE(v[0]._get_union().g_dy()._mp_alloc == 12);
+        REQUIRE(v[1]._get_union().g_dy()._mp_alloc == 1024);
+    }
+    REQUIRE(mpzc.class_sizes[2] == 1u);
+    REQUIRE(mpzc.class_sizes[28] == 1u);
+    // Each size class holds a limited number of arrays.
+    reset_integer_cache_stats();
+    {
+        std::vector<integer> v;
+        for (std::size_t i = 0; i < detail::mpz_alloc_cache::class_max_entries + 3u; ++i) {
+            v.emplace_back(integer_bitcnt_t(50 * GMP_NUMB_BITS));
+        }
+    }
+    // NOTE: when the class is full, half of its arrays are moved to the depot.
+    REQUIRE(mpzc.class_sizes[11] == detail::mpz_alloc_cache::class_max_entries / 2u + 3u);
+    REQUIRE(get_integer_cache_stats().evictions == 0u);
+    // Prefilling of the size classes.
+    prefill_integer_cache(200, 3);
+    REQUIRE(mpzc.class_sizes[19] == 3u);
+    free_integer_caches();
+    for (auto s : mpzc.class_sizes) {
+        REQUIRE(s == 0u);
+    }
+#else
+    // Without thread local storage, the functions are no-ops.
+    set_integer_cache_limits(3, 2);
+    prefill_integer_cache(1, 1);
+    reset_integer_cache_stats();
+    REQUIRE(get_integer_cache_limits() == std::make_pair(std::size_t(0), std::size_t(0)));
+    REQUIRE(get_integer_cache_stats().hits == 0u);
+    {
+        integer n{big};
+    }
+#endif
+}
+
+TEST_CASE("cache depot")
+{
+    using integer = integer<1>;
+    const integer big = integer{1} << (2 * GMP_NUMB_BITS);
+    const integer large = integer{1} << (99 * GMP_NUMB_BITS);
+
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    set_integer_cache_limits(detail::mpz_alloc_cache::default_max_size, detail::mpz_alloc_cache::default_max_entries);
+    free_integer_caches();
+
+    // Producer/consumer pattern: the integers created in the main
+    // thread are destroyed in another thread.
+    for (auto i = 0; i < 3; ++i) {
+        reset_integer_cache_stats();
+        std::vector<integer> v(500, big), w(100, large);
+        if (i == 0) {
+            REQUIRE(get_integer_cache_stats().misses == 600u);
+        } else {
+            // The arrays freed by the consumer thread are reused via the depot.
+            REQUIRE(get_integer_cache_stats().hits == 600u);
+            REQUIRE(get_integer_cache_stats().misses == 0u);
+        }
+        // NOTE: the consumer moves the arrays to the depot when its
+        // cache is full and when it exits.
+        std::thread t([](std::vector<integer>, std::vector<integer>) {}, std::move(v), std::move(w));
+        t.join();
+    }
+
+    // Arrays moved to the depot by exiting threads.
+    free_integer_caches();
+    std::thread t([&big]() { std::vector<integer> v(5, big); });
+    t.join();
+    reset_integer_cache_stats();
+    {
+        integer n{big};
+    }
+    REQUIRE(get_integer_cache_stats().hits == 1u);
+    REQUIRE(get_integer_cache_stats().misses == 0u);
+
+    free_integer_caches();
+#else
+    std::thread t([&big, &large]() { std::vector<integer> v(5, big), w(5, large); });
+    t.join();
+    REQUIRE(get_integer_cache_stats().hits == 0u);
+#endif
+}
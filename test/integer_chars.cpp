@@ -0,0 +1,252 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <ios>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const int ntries = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+struct chars_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+
+        std::vector<char> buf(10000);
+        auto *const b = buf.data();
+        auto *const e = buf.data() + buf.size();
+
+        // Simple checks.
+        auto res = to_chars(b, e, integer{});
+        REQUIRE(res.ec == std::errc{});
+        REQUIRE(std::string(b, res.ptr) == "0");
+        res = to_chars(b, e, integer{-123});
+        REQUIRE(res.ec == std::errc{});
+        REQUIRE(std::string(b, res.ptr) == "-123");
+        res = to_chars(b, e, integer{255}, 16);
+        REQUIRE(std::string(b, res.ptr) == "ff");
+        res = to_chars(b, e, integer{-5}, 2);
+        REQUIRE(std::string(b, res.ptr) == "-101");
+        res = to_chars(b, e, integer{61}, 62);
+        REQUIRE(std::string(b, res.ptr) == "z");
+        res = to_chars(b, e, integer{35}, 36);
+        REQUIRE(std::string(b, res.ptr) == "z");
+        res = to_chars(b, e, integer{GMP_NUMB_MAX});
+        REQUIRE(std::string(b, res.ptr) == std::to_string(GMP_NUMB_MAX));
+
+        // Buffer too small.
+        res = to_chars(b, b, integer{});
+        REQUIRE(res.ec == std::errc::value_too_large);
+        REQUIRE(res.ptr == b);
+        res = to_chars(b, b + 3, integer{-123});
+        REQUIRE(res.ec == std::errc::value_too_large);
+        REQUIRE(res.ptr == b + 3);
+        res = to_chars(b, b + 4, integer{-123});
+        REQUIRE(res.ec == std::errc{});
+        REQUIRE(res.ptr == b + 4);
+
+        // Invalid bases.
+        REQUIRE_THROWS_PREDICATE(to_chars(b, e, integer{}, 1), std::invalid_argument,
+                                 [](const std::invalid_argument &ex) {
+                                     return std::string(ex.what())
+                                            == "Invalid base for the conversion of an integer to chars: the base must "
+                                               "be between 2 and 62, but a value of 1 was provided instead";
+                                 });
+        REQUIRE_THROWS_AS(to_chars(b, e, integer{}, 63), std::invalid_argument);
+
+        // from_chars().
+        integer n{42};
+        const std::string s0 = "-1234xyz";
+        auto fres = from_chars(s0.data(), s0.data() + s0.size(), n);
+        REQUIRE(fres.ec == std::errc{});
+        REQUIRE(fres.ptr == s0.data() + 5);
+        REQUIRE(n == -1234);
+        fres = from_chars(s0.data(), s0.data() + s0.size(), n, 36);
+        REQUIRE(fres.ptr == s0.data() + s0.size());
+        REQUIRE(n == -integer{"1234xyz", 36});
+        const std::string s1 = "00ffG";
+        fres = from_chars(s1.data(), s1.data() + s1.size(), n, 16);
+        REQUIRE(fres.ptr == s1.data() + 4);
+        REQUIRE(n == 255);
+        fres = from_chars(s1.data(), s1.data() + 2, n);
+        REQUIRE(fres.ptr == s1.data() + 2);
+        REQUIRE(n == 0);
+        fres = from_chars(s1.data(), s1.data() + s1.size(), n, 62);
+        REQUIRE(n == integer{"00ffG", 62});
+        REQUIRE(n != integer{"00FFG", 62});
+
+        // Invalid input.
+        n = 42;
+        for (const std::string s : {"", "-", "+1", " 1", "x", "-a"}) {
+            fres = from_chars(s.data(), s.data() + s.size(), n);
+            REQUIRE(fres.ec == std::errc::invalid_argument);
+            REQUIRE(fres.ptr == s.data());
+            REQUIRE(n == 42);
+        }
+        REQUIRE_THROWS_PREDICATE(from_chars(s1.data(), s1.data() + s1.size(), n, 0), std::invalid_argument,
+                                 [](const std::invalid_argument &ex) {
+                                     return std::string(ex.what())
+                                            == "Invalid base for the conversion of chars to an integer: the base "
+                                               "must be between 2 and 62, but a value of 0 was provided instead";
+                                 });
+
+        // Random testing against the GMP conversions, in all bases.
+        detail::mpz_raii tmp;
+        for (int base = 2; base <= 62; ++base) {
+            for (unsigned nl = 0; nl < 2u * S::value + 3u; ++nl) {
+                for (int i = 0; i < ntries / 50; ++i) {
+                    random_integer(tmp, nl, rng);
+                    if (i % 2 == 1) {
+                        mpz_neg(&tmp.m_mpz, &tmp.m_mpz);
+                    }
+                    const integer ref{&tmp.m_mpz};
+                    const auto str = detail::mpz_to_str(&tmp.m_mpz, base);
+
+                    res = to_chars(b, e, ref, base);
+                    REQUIRE(res.ec == std::errc{});
+                    REQUIRE(std::string(b, res.ptr) == str);
+                    REQUIRE(ref.to_string(base) == str);
+
+                    // Exact and insufficient buffer sizes.
+                    res = to_chars(b, b + str.size(), ref, base);
+                    REQUIRE(res.ec == std::errc{});
+                    REQUIRE(std::string(b, res.ptr) == str);
+                    res = to_chars(b, b + str.size() - 1u, ref, base);
+                    REQUIRE(res.ec == std::errc::value_too_large);
+                    REQUIRE(res.ptr == b + str.size() - 1u);
+
+                    n = integer{};
+                    fres = from_chars(str.data(), str.data() + str.size(), n, base);
+                    REQUIRE(fres.ec == std::errc{});
+                    REQUIRE(fres.ptr == str.data() + str.size());
+                    REQUIRE(n == ref);
+                    REQUIRE(n.is_static() == ref.is_static());
+                }
+            }
+        }
+
+        // Large values.
+        random_integer(tmp, 100, rng);
+        const integer big{&tmp.m_mpz};
+        const auto big_str = big.to_string();
+        n = integer{};
+        fres = from_chars(big_str.data(), big_str.data() + big_str.size(), n);
+        REQUIRE(fres.ptr == big_str.data() + big_str.size());
+        REQUIRE(n == big);
+        res = to_chars(b, e, -big, 3);
+        REQUIRE(std::string(b, res.ptr) == (-big).to_string(3));
+    }
+};
+
+TEST_CASE("integer chars")
+{
+    tuple_for_each(sizes{}, chars_tester{});
+}
+
+struct pow2_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+
+        std::vector<char> buf(10000);
+        auto *const b = buf.data();
+
+        // Long values in the power of 2 bases, including the
+        // uppercase hex output of the stream operator.
+        detail::mpz_raii tmp;
+        for (int base : {2, 4, 8, 16, 32}) {
+            for (unsigned nl : {1u, 2u, 5u, 17u, 64u}) {
+                for (int i = 0; i < ntries / 50; ++i) {
+                    random_integer(tmp, nl, rng);
+                    if (i % 2 == 1) {
+                        mpz_neg(&tmp.m_mpz, &tmp.m_mpz);
+                    }
+                    const integer n{&tmp.m_mpz};
+                    const auto str = detail::mpz_to_str(&tmp.m_mpz, base);
+
+                    REQUIRE(n.to_string(base) == str);
+                    const auto res = to_chars(b, b + str.size(), n, base);
+                    REQUIRE(res.ec == std::errc{});
+                    REQUIRE(std::string(b, res.ptr) == str);
+
+                    auto upper = str;
+                    std::transform(upper.begin(), upper.end(), upper.begin(),
+                                   [](char c) { return static_cast<char>(std::toupper(c)); });
+                    integer m;
+                    const auto fres = from_chars(upper.data(), upper.data() + upper.size(), m, base);
+                    REQUIRE(fres.ptr == upper.data() + upper.size());
+                    REQUIRE(m == n);
+
+                    if (base == 16) {
+                        std::ostringstream oss;
+                        oss << std::hex << std::uppercase << std::showbase << n;
+                        if (n.sgn() == 0) {
+                            REQUIRE(oss.str() == "0");
+                        } else if (n.sgn() < 0) {
+                            REQUIRE(oss.str() == "-0X" + upper.substr(1));
+                        } else {
+                            REQUIRE(oss.str() == "0X" + upper);
+                        }
+                        std::ostringstream oss2;
+                        oss2 << std::hex << n;
+                        REQUIRE(oss2.str() == str);
+                    }
+                }
+            }
+        }
+
+        // Leading zeroes and digits spanning multiple limbs.
+        integer m;
+        const std::string s0 = "000001234567012345670123456701234567";
+        from_chars(s0.data(), s0.data() + s0.size(), m, 8);
+        REQUIRE(m == integer{"1234567012345670123456701234567", 8});
+        const std::string s1 = "0000";
+        from_chars(s1.data(), s1.data() + s1.size(), m, 32);
+        REQUIRE(m == 0);
+        const std::string s2 = "1vvvvvvvvvvvvvvvvvvvvvvvvv";
+        from_chars(s2.data(), s2.data() + s2.size(), m, 32);
+        REQUIRE(m == integer{s2, 32});
+        const std::string s3 = "00000000000000000000000000000000000000000000ffffffffffffffff0123456789abcdef12";
+        from_chars(s3.data(), s3.data() + s3.size(), m, 16);
+        REQUIRE(m == integer{s3, 16});
+    }
+};
+
+TEST_CASE("integer chars pow2")
+{
+    tuple_for_each(sizes{}, pow2_tester{});
+}
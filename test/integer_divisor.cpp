@@ -0,0 +1,206 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const int ntries = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+struct divisor_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using divisor = integer_divisor<S::value>;
+        integer q, r;
+
+        // Zero divisor.
+        REQUIRE_THROWS_PREDICATE(divisor{integer{}}, zero_division_error, [](const zero_division_error &ex) {
+            return std::string(ex.what()) == "Cannot construct an integer divisor from zero";
+        });
+
+        // Plain divisibility test.
+        REQUIRE(divisible_p(integer{0}, integer{0}));
+        REQUIRE(!divisible_p(integer{1}, integer{0}));
+        REQUIRE(divisible_p(integer{6}, integer{3}));
+        REQUIRE(divisible_p(integer{-6}, integer{3}));
+        REQUIRE(!divisible_p(integer{7}, integer{-3}));
+
+        // A few simple tests.
+        const divisor d3{integer{3}}, dm3{integer{-3}}, d12{integer{12}};
+        REQUIRE(d3.get_divisor() == 3);
+        REQUIRE(dm3.get_divisor() == -3);
+
+        tdiv_qr(q, r, integer{7}, d3);
+        REQUIRE(q == 2);
+        REQUIRE(r == 1);
+        tdiv_qr(q, r, integer{-7}, d3);
+        REQUIRE(q == -2);
+        REQUIRE(r == -1);
+        tdiv_qr(q, r, integer{7}, dm3);
+        REQUIRE(q == -2);
+        REQUIRE(r == 1);
+        tdiv_qr(q, r, integer{-7}, dm3);
+        REQUIRE(q == 2);
+        REQUIRE(r == -1);
+        tdiv_qr(q, r, integer{0}, dm3);
+        REQUIRE(q == 0);
+        REQUIRE(r == 0);
+        tdiv_qr(q, r, integer{2}, d3);
+        REQUIRE(q == 0);
+        REQUIRE(r == 2);
+        REQUIRE_THROWS_PREDICATE(tdiv_qr(q, q, integer{7}, d3), std::invalid_argument,
+                                 [](const std::invalid_argument &ex) {
+                                     return std::string(ex.what())
+                                            == "When performing a division with remainder, the quotient 'q' and the "
+                                               "remainder 'r' must be distinct objects";
+                                 });
+
+        REQUIRE(&tdiv_q(q, integer{7}, d3) == &q);
+        REQUIRE(q == 2);
+        tdiv_q(q, integer{-7}, dm3);
+        REQUIRE(q == 2);
+        tdiv_q(q, integer{-7}, d3);
+        REQUIRE(q == -2);
+
+        REQUIRE(divisible_p(integer{0}, d3));
+        REQUIRE(divisible_p(integer{6}, d3));
+        REQUIRE(divisible_p(integer{-6}, dm3));
+        REQUIRE(!divisible_p(integer{7}, d3));
+        REQUIRE(divisible_p(integer{36}, d12));
+        REQUIRE(!divisible_p(integer{30}, d12));
+        REQUIRE(!divisible_p(integer{18}, d12));
+        REQUIRE(!divisible_p(integer{-8}, d12));
+
+        // Random testing.
+        integer n, m, q_ref, r_ref;
+        detail::mpz_raii tmp;
+        std::uniform_int_distribution<int> sdist(0, 1);
+
+        auto random_int = [&](integer &x, unsigned nl) {
+            random_integer(tmp, nl, rng);
+            x = &tmp.m_mpz;
+            if (sdist(rng)) {
+                x.neg();
+            }
+            if (x.is_static() && sdist(rng)) {
+                // Promote sometimes, if possible.
+                x.promote();
+            }
+        };
+
+        // Run a variety of tests with dividends with x limbs and divisors with y limbs.
+        auto random_xy = [&](unsigned x, unsigned y) {
+            for (int i = 0; i < ntries; ++i) {
+                random_int(m, y);
+                if (m.is_zero()) {
+                    continue;
+                }
+                const divisor d{m};
+
+                random_int(n, x);
+                if (sdist(rng)) {
+                    // Make sure we test the divisibility test
+                    // with values that are actually divisible.
+                    random_int(q, x > y ? x - y : 0u);
+                    n = q * m;
+                }
+
+                tdiv_qr(q_ref, r_ref, n, m);
+                if (sdist(rng) && sdist(rng)) {
+                    // Reset the return values every once in a while.
+                    q = integer{};
+                    r = integer{};
+                }
+                tdiv_qr(q, r, n, d);
+                REQUIRE(q == q_ref);
+                REQUIRE(r == r_ref);
+
+                tdiv_q(q, n, d);
+                REQUIRE(q == q_ref);
+
+                REQUIRE(divisible_p(n, d) == r_ref.is_zero());
+                REQUIRE(divisible_p(n, m) == r_ref.is_zero());
+
+                // Overlapping arguments.
+                auto n_old(n);
+                tdiv_qr(n, r, n, d);
+                REQUIRE(n == q_ref);
+                REQUIRE(r == r_ref);
+                n = n_old;
+                tdiv_qr(q, n, n, d);
+                REQUIRE(q == q_ref);
+                REQUIRE(n == r_ref);
+                n = n_old;
+                tdiv_q(n, n, d);
+                REQUIRE(n == q_ref);
+            }
+        };
+
+        for (unsigned x = 0; x <= 4u; ++x) {
+            for (unsigned y = 1; y <= 3u; ++y) {
+                random_xy(x, y);
+            }
+        }
+
+        // Divisors and dividends at the edges of the normalisation.
+        const integer lmax{GMP_NUMB_MAX}, lhigh{::mp_limb_t(1) << (GMP_NUMB_BITS - 1)};
+        const std::vector<integer> edge_vals{integer{1},
+                                             integer{2},
+                                             lhigh,
+                                             lmax,
+                                             integer{1} << GMP_NUMB_BITS,
+                                             lhigh << GMP_NUMB_BITS,
+                                             (lmax << GMP_NUMB_BITS) + lmax};
+        for (const auto &dv : edge_vals) {
+            for (const auto &dd : {dv, -dv}) {
+                const divisor d{dd};
+                for (const auto &nv : edge_vals) {
+                    for (const auto &nn : {nv, -nv, nv - 1, nv + 1}) {
+                        tdiv_qr(q_ref, r_ref, nn, dd);
+                        tdiv_qr(q, r, nn, d);
+                        REQUIRE(q == q_ref);
+                        REQUIRE(r == r_ref);
+                        tdiv_q(q, nn, d);
+                        REQUIRE(q == q_ref);
+                        REQUIRE(divisible_p(nn, d) == r_ref.is_zero());
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_CASE("integer_divisor")
+{
+    tuple_for_each(sizes{}, divisor_tester{});
+}
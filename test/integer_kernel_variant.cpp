@@ -0,0 +1,94 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 4>,
+                         std::integral_constant<std::size_t, 6>, std::integral_constant<std::size_t, 8>>;
+
+static const int ntries = 200;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+TEST_CASE("integer_get_kernel_variant")
+{
+    const auto v = integer_get_kernel_variant();
+    REQUIRE((v == integer_kernel_variant::generic || v == integer_kernel_variant::bmi2_adx));
+#if !defined(MPPP_HAVE_ADX_KERNELS)
+    REQUIRE(v == integer_kernel_variant::generic);
+#endif
+    // The variant is fixed at load time.
+    REQUIRE(integer_get_kernel_variant() == v);
+}
+
+struct kernel_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        integer n1, n2, ret;
+        detail::mpz_raii m1, m2, mret;
+        std::uniform_int_distribution<int> sdist(0, 1);
+
+        auto random_int = [&](integer &n, detail::mpz_raii &m, unsigned x) {
+            random_integer(m, x, rng);
+            if (sdist(rng)) {
+                mpz_neg(&m.m_mpz, &m.m_mpz);
+            }
+            n = &m.m_mpz;
+        };
+
+        // Check the multiplication primitives for all the combinations
+        // of operand sizes whose product may fit in static storage.
+        for (unsigned x = 1; x <= S::value; ++x) {
+            for (unsigned y = 1; x + y <= S::value + 1u; ++y) {
+                for (int i = 0; i < ntries; ++i) {
+                    random_int(n1, m1, x);
+                    random_int(n2, m2, y);
+
+                    mul(ret, n1, n2);
+                    mpz_mul(&mret.m_mpz, &m1.m_mpz, &m2.m_mpz);
+                    REQUIRE(ret == integer{&mret.m_mpz});
+
+                    sqr(ret, n1);
+                    mpz_mul(&mret.m_mpz, &m1.m_mpz, &m1.m_mpz);
+                    REQUIRE(ret == integer{&mret.m_mpz});
+
+                    random_int(ret, mret, x);
+                    addmul(ret, n1, n2);
+                    mpz_addmul(&mret.m_mpz, &m1.m_mpz, &m2.m_mpz);
+                    REQUIRE(ret == integer{&mret.m_mpz});
+
+                    submul(ret, n1, n2);
+                    mpz_submul(&mret.m_mpz, &m1.m_mpz, &m2.m_mpz);
+                    REQUIRE(ret == integer{&mret.m_mpz});
+                }
+            }
+        }
+    }
+};
+
+TEST_CASE("integer kernels")
+{
+    tuple_for_each(sizes{}, kernel_tester{});
+}
@@ -8,6 +8,7 @@
 
 #include <initializer_list>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include <mp++/config.hpp>
@@ -588,3 +589,35 @@ TEST_CASE("integer_literals_init_list")
     REQUIRE(v[1] == 2);
     REQUIRE(v[2] == 3);
 }
+
+// The literals spanning multiple limbs are computed only once,
+// and each evaluation returns a distinct copy.
+TEST_CASE("integer_literals_cache")
+{
+    for (int i = 0; i < 10; ++i) {
+        auto n = 123456789012345678901234567890123456789012345678901234567890_z1;
+        REQUIRE(n == integer<1>{"123456789012345678901234567890123456789012345678901234567890"});
+        n += 1;
+        auto m = 0x123456789abcdef0123456789abcdef0123456789abcdef_z2;
+        REQUIRE(m == integer<2>{"123456789abcdef0123456789abcdef0123456789abcdef", 16});
+        m = 0;
+    }
+
+    // Concurrent evaluations.
+    std::vector<int> flags(4, 0);
+    auto func = [&flags](unsigned n) {
+        for (int i = 0; i < 100; ++i) {
+            if (1234567890123456789012345678901234567890123456789012345678901_z2
+                != integer<2>{"1234567890123456789012345678901234567890123456789012345678901"}) {
+                return;
+            }
+        }
+        flags[n] = 1;
+    };
+    std::thread t0(func, 0u), t1(func, 1u), t2(func, 2u), t3(func, 3u);
+    t0.join();
+    t1.join();
+    t2.join();
+    t3.join();
+    REQUIRE(flags == std::vector<int>(4, 1));
+}
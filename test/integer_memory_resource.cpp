@@ -0,0 +1,277 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+#include <memory_resource>
+
+#endif
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 6>>;
+
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+// A memory resource keeping track of the allocations.
+struct counting_resource final : std::pmr::memory_resource {
+    std::size_t n_allocs = 0;
+    std::size_t n_live = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) final
+    {
+        ++n_allocs;
+        ++n_live;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final
+    {
+        --n_live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final
+    {
+        return this == &other;
+    }
+};
+
+struct memory_resource_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+
+        const integer big = integer{1} << (S::value * GMP_NUMB_BITS + 1u);
+
+        counting_resource cr;
+        {
+            integer_memory_resource_scope scope(&cr);
+            // Static integers do not allocate.
+            integer n{42};
+            n *= 2;
+            REQUIRE(cr.n_allocs == 0u);
+            // Dynamic integers, including reallocations.
+            std::vector<integer> v;
+            for (int i = 0; i < 10; ++i) {
+                v.emplace_back(integer_bitcnt_t(100 * GMP_NUMB_BITS));
+                v.back() = big + i;
+                v.back() <<= 1000u * static_cast<unsigned>(i);
+            }
+            REQUIRE(cr.n_allocs != 0u);
+            REQUIRE(cr.n_live != 0u);
+            for (int i = 0; i < 10; ++i) {
+                REQUIRE(v[static_cast<std::size_t>(i)] >> (1000u * static_cast<unsigned>(i)) == big + i);
+            }
+            v.clear();
+            REQUIRE(cr.n_live == 0u);
+
+            // The integers created within the scope can outlive the scope.
+            n = big * 3;
+        }
+        const auto n_allocs = cr.n_allocs;
+        {
+            // Allocations outside the scope do not use the resource.
+            integer m{integer_bitcnt_t(100 * GMP_NUMB_BITS)};
+            m = big * 5;
+        }
+        REQUIRE(cr.n_allocs == n_allocs);
+
+        // Nested scopes.
+        counting_resource cr2;
+        {
+            integer_memory_resource_scope scope(&cr);
+            integer n1{integer_bitcnt_t(200 * GMP_NUMB_BITS)};
+            {
+                integer_memory_resource_scope scope2(&cr2);
+                integer n2{integer_bitcnt_t(200 * GMP_NUMB_BITS)};
+                REQUIRE(cr2.n_live == 1u);
+                // Reallocations use the resource the limbs were allocated from.
+                n1 = big;
+                n1 <<= 100000u;
+                REQUIRE(cr2.n_live == 1u);
+                REQUIRE(cr.n_live == 1u);
+            }
+            REQUIRE(cr2.n_live == 0u);
+            integer n3{integer_bitcnt_t(200 * GMP_NUMB_BITS)};
+            REQUIRE(cr.n_live == 2u);
+        }
+        REQUIRE(cr.n_live == 0u);
+        REQUIRE(cr2.n_allocs == 1u);
+
+        // The limbs allocated from a resource never end up in the integer cache.
+        {
+            counting_resource cr3;
+            free_integer_caches();
+            std::vector<integer> v;
+            {
+                integer_memory_resource_scope scope(&cr3);
+                for (int i = 0; i < 10; ++i) {
+                    v.emplace_back(integer_bitcnt_t(100 * GMP_NUMB_BITS));
+                }
+                REQUIRE(cr3.n_live == 10u);
+            }
+            v.clear();
+            REQUIRE(cr3.n_live == 0u);
+        }
+
+        // A monotonic resource.
+        std::vector<char> buffer(1u << 16);
+        std::pmr::monotonic_buffer_resource mr(buffer.data(), buffer.size());
+        {
+            integer_memory_resource_scope scope(&mr);
+            integer acc{1};
+            for (int i = 1; i < 100; ++i) {
+                acc *= big + i;
+            }
+            integer cmp_acc{1};
+            {
+                integer_memory_resource_scope scope2(std::pmr::new_delete_resource());
+                for (int i = 1; i < 100; ++i) {
+                    cmp_acc *= big + i;
+                }
+            }
+            REQUIRE(acc == cmp_acc);
+        }
+        mr.release();
+
+        // The thread-local temporaries used in the implementation
+        // never draw memory from a resource.
+        {
+            const auto hval = integer{1} << 997;
+            const auto hstr = (hval * 3 + 1).to_string();
+            const auto check_ops = [&]() {
+                REQUIRE(integer{std::ldexp(1., 997)} == hval);
+                REQUIRE(integer{hstr} == hval * 3 + 1);
+                integer tmp;
+                tmp = -std::ldexp(3., 997);
+                REQUIRE(tmp == -3 * hval);
+                REQUIRE(pow_ui(integer{3}, 1000) == integer{"3"} * pow_ui(integer{3}, 999));
+                integer f1, f2;
+                REQUIRE(fac_ui(f1, 300) == fac_ui(f2, 299) * 300);
+                REQUIRE(bin_ui(integer{300}, 150) == bin_ui(integer{299}, 149) + bin_ui(integer{299}, 150));
+                REQUIRE(nextprime(hval) > hval);
+                REQUIRE(root(tmp, hval * hval, 2));
+                REQUIRE(tmp == hval);
+                REQUIRE(gcd(hval * 3, hval * 5) == hval);
+                REQUIRE(lcm(hval * 3, hval * 5) == hval * 15);
+                REQUIRE(sqrm(hval + 1, hval) == 1);
+                REQUIRE(divexact(hval * 7, hval) == 7);
+            };
+
+            // The resource holds no memory once the integers created
+            // within the scope have been destroyed.
+            counting_resource cr4;
+            {
+                integer_memory_resource_scope scope(&cr4);
+                check_ops();
+            }
+            REQUIRE(cr4.n_allocs != 0u);
+            REQUIRE(cr4.n_live == 0u);
+
+            // The resource can be released, and its memory overwritten,
+            // without affecting later computations.
+            std::vector<unsigned char> buffer2(1u << 16);
+            std::pmr::monotonic_buffer_resource mr2(buffer2.data(), buffer2.size());
+            {
+                integer_memory_resource_scope scope(&mr2);
+                check_ops();
+            }
+            mr2.release();
+            std::fill(buffer2.begin(), buffer2.end(), static_cast<unsigned char>(0));
+            check_ops();
+            {
+                integer_memory_resource_scope scope(&mr2);
+                check_ops();
+            }
+        }
+
+        // The binding is per-thread.
+        {
+            integer_memory_resource_scope scope(&cr);
+            const auto cur_allocs = cr.n_allocs;
+            std::thread t([&big]() { std::vector<integer> v(10, big); });
+            t.join();
+            REQUIRE(cr.n_allocs == cur_allocs);
+
+            // Integers allocated from a resource and destroyed in another thread.
+            // NOTE: use integers larger than the arrays in the integer cache.
+            std::vector<integer> v;
+            for (int i = 0; i < 10; ++i) {
+                v.push_back(big << 70000u);
+            }
+            const auto cur_live = cr.n_live;
+            REQUIRE(cur_live >= 10u);
+            std::thread t2([](std::vector<integer>) {}, std::move(v));
+            t2.join();
+            REQUIRE(cr.n_live == cur_live - 10u);
+        }
+        REQUIRE(cr.n_live == 0u);
+
+        REQUIRE_THROWS_AS(integer_memory_resource_scope(nullptr), std::invalid_argument);
+    }
+};
+
+// The cached values of the integer literals never draw from a resource,
+// even if the literal is first used within a scope.
+void literal_tester()
+{
+    const auto lit = []() { return 1234567890123456789012345678901234567890123456789012345678901234567890_z1; };
+    const integer<1> cmp{"1234567890123456789012345678901234567890123456789012345678901234567890"};
+
+    std::vector<unsigned char> buffer(1u << 16);
+    std::pmr::monotonic_buffer_resource mr(buffer.data(), buffer.size());
+    {
+        integer_memory_resource_scope scope(&mr);
+        REQUIRE(lit() == cmp);
+    }
+    mr.release();
+    std::fill(buffer.begin(), buffer.end(), static_cast<unsigned char>(0xff));
+    REQUIRE(lit() == cmp);
+    {
+        integer_memory_resource_scope scope(&mr);
+        REQUIRE(lit() == cmp);
+    }
+}
+
+#endif
+
+TEST_CASE("integer memory resource")
+{
+    // NOTE: this needs to be called before
+    // any GMP memory allocation.
+    enable_integer_memory_resources();
+    REQUIRE(integer_memory_resources_enabled());
+    // Enabling again is a no-op.
+    enable_integer_memory_resources();
+    REQUIRE(integer_memory_resources_enabled());
+
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+    tuple_for_each(sizes{}, memory_resource_tester{});
+    literal_tester();
+#endif
+}
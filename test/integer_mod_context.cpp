@@ -0,0 +1,219 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const int ntries = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+struct mod_context_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using ctx_t = mod_context<S::value>;
+        integer ret;
+
+        // Zero modulus.
+        REQUIRE_THROWS_PREDICATE(ctx_t{integer{}}, zero_division_error, [](const zero_division_error &ex) {
+            return std::string(ex.what()) == "Cannot construct a modular arithmetic context with a zero modulus";
+        });
+
+        // A few simple tests.
+        const ctx_t c7{integer{7}};
+        REQUIRE(c7.get_mod() == 7);
+        REQUIRE(c7.is_montgomery() == (GMP_NAIL_BITS == 0));
+        REQUIRE(ctx_t{integer{-7}}.get_mod() == 7);
+
+        mulm(ret, integer{3}, integer{5}, c7);
+        REQUIRE(ret == 1);
+        REQUIRE(mulm(integer{3}, integer{5}, c7) == 1);
+        REQUIRE(mulm(integer{-3}, integer{5}, c7) == 6);
+        REQUIRE(mulm(integer{-3}, integer{-5}, c7) == 1);
+        REQUIRE(mulm(integer{0}, integer{-5}, c7) == 0);
+        REQUIRE(mulm(integer{7}, integer{5}, c7) == 0);
+        REQUIRE(mulm(integer{8}, integer{9}, c7) == 2);
+
+        sqrm(ret, integer{-2}, c7);
+        REQUIRE(ret == 4);
+        REQUIRE(sqrm(integer{-2}, c7) == 4);
+        REQUIRE(sqrm(integer{0}, c7) == 0);
+
+        powm(ret, integer{3}, integer{4}, c7);
+        REQUIRE(ret == 4);
+        REQUIRE(powm(integer{3}, integer{4}, c7) == 4);
+        REQUIRE(powm(integer{3}, integer{0}, c7) == 1);
+        REQUIRE(powm(integer{0}, integer{0}, c7) == 1);
+        REQUIRE(powm(integer{0}, integer{5}, c7) == 0);
+        REQUIRE(powm(integer{-3}, integer{3}, c7) == 1);
+        REQUIRE(powm(integer{3}, integer{-1}, c7) == 5);
+        REQUIRE(powm(integer{3}, integer{-2}, c7) == 4);
+        REQUIRE(powm(integer{3}, integer{4}, integer{7}) == 4);
+        REQUIRE(powm(integer{3}, integer{4}, integer{-7}) == 4);
+        REQUIRE(powm(integer{3}, integer{4}, integer{8}) == 1);
+        REQUIRE(powm(integer{3}, integer{-1}, integer{8}) == 3);
+        REQUIRE_THROWS_PREDICATE(powm(integer{0}, integer{4}, integer{0}), zero_division_error,
+                                 [](const zero_division_error &ex) {
+                                     return std::string(ex.what())
+                                            == "Cannot construct a modular arithmetic context with a zero modulus";
+                                 });
+        REQUIRE_THROWS_PREDICATE(powm(integer{0}, integer{-1}, c7), zero_division_error,
+                                 [](const zero_division_error &ex) {
+                                     return std::string(ex.what())
+                                            == "Cannot raise the non-invertible value 0 to a negative power modulo 7";
+                                 });
+        REQUIRE_THROWS_PREDICATE(powm(integer{2}, integer{-3}, integer{4}), zero_division_error,
+                                 [](const zero_division_error &ex) {
+                                     return std::string(ex.what())
+                                            == "Cannot raise the non-invertible value 2 to a negative power modulo 4";
+                                 });
+
+        // Modulus 1 and 2.
+        const ctx_t c1{integer{1}}, c2{integer{2}};
+        REQUIRE(mulm(integer{3}, integer{5}, c1) == 0);
+        REQUIRE(sqrm(integer{3}, c1) == 0);
+        REQUIRE(powm(integer{3}, integer{0}, c1) == 0);
+        REQUIRE(powm(integer{3}, integer{5}, c1) == 0);
+        REQUIRE(!c2.is_montgomery());
+        REQUIRE(mulm(integer{3}, integer{5}, c2) == 1);
+        REQUIRE(sqrm(integer{-3}, c2) == 1);
+        REQUIRE(powm(integer{3}, integer{5}, c2) == 1);
+        REQUIRE(powm(integer{4}, integer{5}, c2) == 0);
+
+        // Multi-exponentiation.
+        const std::vector<integer> bases = {integer{2}, integer{3}, integer{-5}},
+                                   exps = {integer{10}, integer{1}, integer{-1}};
+        multi_powm(ret, bases.data(), exps.data(), 0, c7);
+        REQUIRE(ret == 1);
+        multi_powm(ret, bases.data(), exps.data(), 1, c7);
+        REQUIRE(ret == 2);
+        multi_powm(ret, bases.data(), exps.data(), 3, c7);
+        // 2**10 * 3 * (-5)**-1 == 2 * 3 * 4 mod 7.
+        REQUIRE(ret == 3);
+
+        // Random testing.
+        integer a, b, m, e;
+        detail::mpz_raii tmp, ref;
+        std::uniform_int_distribution<int> sdist(0, 1);
+
+        auto random_int = [&](integer &n, unsigned x) {
+            random_integer(tmp, x, rng);
+            n = &tmp.m_mpz;
+            if (sdist(rng)) {
+                n.neg();
+            }
+            if (n.is_static() && sdist(rng)) {
+                // Promote sometimes, if possible.
+                n.promote();
+            }
+        };
+
+        // Run a variety of tests with operands with x limbs and modulus with y limbs.
+        auto random_xy = [&](unsigned x, unsigned y) {
+            for (int i = 0; i < ntries; ++i) {
+                random_int(m, y);
+                if (m.is_zero()) {
+                    continue;
+                }
+                if (sdist(rng)) {
+                    // Make sure we test the Montgomery path.
+                    m |= 1;
+                }
+                const ctx_t ctx{m};
+                REQUIRE(ctx.is_montgomery() == (GMP_NAIL_BITS == 0 && m.odd_p() && m.size() <= S::value));
+
+                random_int(a, x);
+                random_int(b, x);
+
+                // mulm.
+                mulm(ret, a, b, ctx);
+                mpz_mul(&ref.m_mpz, a.get_mpz_view(), b.get_mpz_view());
+                mpz_mod(&ref.m_mpz, &ref.m_mpz, m.get_mpz_view());
+                REQUIRE(ret == integer{&ref.m_mpz});
+                REQUIRE(mulm(a, b, ctx) == ret);
+
+                // In-place.
+                auto a_old(a);
+                mulm(a, a, b, ctx);
+                REQUIRE(a == ret);
+                a = a_old;
+
+                // sqrm.
+                sqrm(ret, a, ctx);
+                REQUIRE(ret == sqrm(a, m));
+                REQUIRE(sqrm(a, ctx) == ret);
+
+                // powm.
+                random_int(e, 1);
+                if (sdist(rng)) {
+                    e.abs();
+                }
+                mpz_gcd(&ref.m_mpz, a.get_mpz_view(), m.get_mpz_view());
+                if (e.sgn() < 0 && mpz_cmp_ui(&ref.m_mpz, 1u) != 0) {
+                    REQUIRE_THROWS_AS(powm(a, e, ctx), zero_division_error);
+                    continue;
+                }
+                powm(ret, a, e, ctx);
+                mpz_powm(&ref.m_mpz, a.get_mpz_view(), e.get_mpz_view(), m.get_mpz_view());
+                REQUIRE(ret == integer{&ref.m_mpz});
+                REQUIRE(powm(a, e, ctx) == ret);
+                REQUIRE(powm(a, e, m) == ret);
+
+                // multi_powm.
+                e.abs();
+                const std::vector<integer> mb = {a, b, a + b}, me = {e, e + 1, e * 3};
+                multi_powm(ret, mb.data(), me.data(), mb.size(), ctx);
+                REQUIRE(ret == (powm(a, e, ctx) * powm(b, e + 1, ctx) * powm(a + b, e * 3, ctx)) % ctx.get_mod());
+            }
+        };
+
+        random_xy(0, 1);
+        random_xy(1, 1);
+        random_xy(2, 1);
+
+        random_xy(1, 2);
+        random_xy(2, 2);
+        random_xy(3, 2);
+
+        random_xy(2, 3);
+        random_xy(3, 3);
+        random_xy(4, 3);
+
+        random_xy(3, 4);
+        random_xy(4, 4);
+        random_xy(5, 4);
+    }
+};
+
+TEST_CASE("mod_context")
+{
+    tuple_for_each(sizes{}, mod_context_tester{});
+}
@@ -0,0 +1,207 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 6>>;
+
+static const int ntries = 100;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+// GMP memory functions which record the threads performing
+// allocations, in order to check how many threads are used in a conversion.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static std::mutex alloc_mutex;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static std::set<std::thread::id> alloc_threads;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static void *(*orig_alloc)(std::size_t) = nullptr;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static void *(*orig_realloc)(void *, std::size_t, std::size_t) = nullptr;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static void (*orig_free)(void *, std::size_t) = nullptr;
+
+static void record_thread()
+{
+    std::lock_guard<std::mutex> lock(alloc_mutex);
+    alloc_threads.insert(std::this_thread::get_id());
+}
+
+static void *recording_alloc(std::size_t size)
+{
+    record_thread();
+    return orig_alloc(size);
+}
+
+static void *recording_realloc(void *p, std::size_t old_size, std::size_t new_size)
+{
+    record_thread();
+    return orig_realloc(p, old_size, new_size);
+}
+
+// The representation of an mpz via mpz_get_str().
+static std::string gmp_to_str(const detail::mpz_struct_t *m, int base)
+{
+    std::vector<char> buf(mpz_sizeinbase(m, base) + 2u);
+    mpz_get_str(buf.data(), base, m);
+    return buf.data();
+}
+
+struct par_conv_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+
+        detail::mpz_raii tmp, cmp;
+        for (unsigned nthreads : {2u, 3u, 4u, 8u}) {
+            set_integer_parallel_conversion(4, nthreads);
+            for (int base : {3, 10, 36, 62}) {
+                for (unsigned nl : {1u, 4u, 5u, 17u, 100u, 500u}) {
+                    for (int i = 0; i < ntries / 10; ++i) {
+                        random_integer(tmp, nl, rng);
+                        if (i % 2 == 1) {
+                            mpz_neg(&tmp.m_mpz, &tmp.m_mpz);
+                        }
+                        const auto str = gmp_to_str(&tmp.m_mpz, base);
+
+                        // Printing.
+                        const integer n{&tmp.m_mpz};
+                        REQUIRE(n.to_string(base) == str);
+                        std::vector<char> buf(str.size());
+                        const auto res = to_chars(buf.data(), buf.data() + buf.size(), n, base);
+                        REQUIRE(res.ec == std::errc{});
+                        REQUIRE(std::string(buf.data(), res.ptr) == str);
+                        if (base == 10) {
+                            std::ostringstream oss;
+                            oss << n;
+                            REQUIRE(oss.str() == str);
+                        }
+
+                        // Parsing.
+                        REQUIRE(integer{str, base} == n);
+                        // With leading zeroes.
+                        if (i % 2 == 0) {
+                            REQUIRE(integer{std::string(200, '0') + str, base} == n);
+                        } else {
+                            REQUIRE(integer{"-" + std::string(200, '0') + str.substr(1), base} == n);
+                        }
+                    }
+                }
+            }
+
+            // Strings which are not made exclusively of digits are left to GMP.
+            random_integer(tmp, 50, rng);
+            auto str = gmp_to_str(&tmp.m_mpz, 10);
+            str.insert(str.begin() + 100, ' ');
+            REQUIRE(integer{str} == integer{&tmp.m_mpz});
+            str[200] = 'a';
+            REQUIRE_THROWS_AS(integer{str}, std::invalid_argument);
+            str = std::string(1000, '0');
+            REQUIRE(integer{str} == 0);
+            REQUIRE(integer{"-" + str} == 0);
+            str = "0x" + gmp_to_str(&tmp.m_mpz, 16);
+            REQUIRE(integer{str, 0} == integer{&tmp.m_mpz});
+
+            // Values whose high half is zero.
+            mpz_ui_pow_ui(&tmp.m_mpz, 10, 5000);
+            mpz_sub_ui(&tmp.m_mpz, &tmp.m_mpz, 1);
+            REQUIRE(integer{&tmp.m_mpz}.to_string() == std::string(5000, '9'));
+            REQUIRE(integer{std::string(5000, '9')} == integer{&tmp.m_mpz});
+            mpz_set_ui(&cmp.m_mpz, 1);
+            mpz_mul_2exp(&cmp.m_mpz, &cmp.m_mpz, 10000);
+            REQUIRE(integer{&cmp.m_mpz}.to_string(7) == gmp_to_str(&cmp.m_mpz, 7));
+        }
+    }
+};
+
+TEST_CASE("integer parallel conversion")
+{
+    // The default settings.
+    REQUIRE(get_integer_parallel_conversion() == std::make_pair(std::size_t(1) << 15, 0u));
+
+    tuple_for_each(sizes{}, par_conv_tester{});
+
+    // A single thread disables the parallel conversion.
+    set_integer_parallel_conversion(4, 1);
+    REQUIRE(get_integer_parallel_conversion() == std::make_pair(std::size_t(4), 1u));
+    detail::mpz_raii tmp;
+    random_integer(tmp, 20, rng);
+    const auto str = gmp_to_str(&tmp.m_mpz, 10);
+    REQUIRE(integer<1>{&tmp.m_mpz}.to_string() == str);
+    REQUIRE(integer<1>{str} == integer<1>{&tmp.m_mpz});
+
+    set_integer_parallel_conversion(std::size_t(1) << 15, 0);
+}
+
+TEST_CASE("integer parallel conversion max threads")
+{
+    ::mp_get_memory_functions(&orig_alloc, &orig_realloc, &orig_free);
+    ::mp_set_memory_functions(recording_alloc, recording_realloc, orig_free);
+
+    detail::mpz_raii tmp;
+    random_integer(tmp, 20000, rng);
+    const auto str = gmp_to_str(&tmp.m_mpz, 10);
+    const integer<1> n{&tmp.m_mpz};
+
+    const auto nthreads = [](const std::set<std::thread::id> &s) {
+        // NOTE: the calling thread might not appear in the set.
+        return s.size() + static_cast<std::size_t>(s.count(std::this_thread::get_id()) == 0u);
+    };
+
+    // The number of threads used in a conversion, including the calling
+    // thread, must never exceed max_threads.
+    for (unsigned max_threads : {2u, 3u, 4u, 5u, 8u}) {
+        set_integer_parallel_conversion(4, max_threads);
+
+        {
+            std::lock_guard<std::mutex> lock(alloc_mutex);
+            alloc_threads.clear();
+        }
+        REQUIRE(n.to_string() == str);
+        {
+            std::lock_guard<std::mutex> lock(alloc_mutex);
+            REQUIRE(nthreads(alloc_threads) <= max_threads);
+            alloc_threads.clear();
+        }
+        REQUIRE(integer<1>{str} == n);
+        {
+            std::lock_guard<std::mutex> lock(alloc_mutex);
+            REQUIRE(nthreads(alloc_threads) <= max_threads);
+        }
+    }
+
+    ::mp_set_memory_functions(orig_alloc, orig_realloc, orig_free);
+    set_integer_parallel_conversion(std::size_t(1) << 15, 0);
+}
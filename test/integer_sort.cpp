@@ -0,0 +1,161 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>>;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+template <typename T>
+using sort_t = decltype(mppp::integer_sort(std::declval<T>(), std::declval<T>()));
+
+template <typename T, typename = void>
+struct has_sort : std::false_type {
+};
+
+template <typename T>
+struct has_sort<T, detail::void_t<sort_t<T>>> : std::true_type {
+};
+
+struct sort_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+
+        // Type traits.
+        REQUIRE(has_sort<integer *>::value);
+        REQUIRE(has_sort<typename std::vector<integer>::iterator>::value);
+        REQUIRE(!has_sort<const integer *>::value);
+        REQUIRE(!has_sort<typename std::list<integer>::iterator>::value);
+        REQUIRE(!has_sort<int *>::value);
+
+        detail::mpz_raii tmp;
+        std::uniform_int_distribution<int> sdist(0, 1);
+        auto random_int = [&](unsigned nlimbs) {
+            random_integer(tmp, nlimbs, rng);
+            integer retval{&tmp.m_mpz};
+            if (sdist(rng)) {
+                retval.neg();
+            }
+            return retval;
+        };
+
+        // Check the sorting of v against std::sort(). If all the
+        // values are static, they must remain static.
+        auto check = [](std::vector<integer> v) {
+            auto cmp = v;
+            const auto all_static = std::all_of(v.begin(), v.end(), [](const integer &n) { return n.is_static(); });
+            std::sort(cmp.begin(), cmp.end());
+            mppp::integer_sort(v.begin(), v.end());
+            REQUIRE(v == cmp);
+            if (all_static) {
+                REQUIRE(std::all_of(v.begin(), v.end(), [](const integer &n) { return n.is_static(); }));
+            }
+        };
+
+        // Empty and small ranges.
+        check({});
+        check({integer{-1}});
+        check({integer{3}, integer{-1}, integer{0}});
+
+        for (auto n : {100u, 1000u, 10000u}) {
+            // Values of increasing size.
+            for (unsigned nlimbs = 0; nlimbs <= S::value; ++nlimbs) {
+                std::vector<integer> v;
+                std::uniform_int_distribution<unsigned> ldist(0, nlimbs);
+                for (auto i = 0u; i < n; ++i) {
+                    v.push_back(random_int(ldist(rng)));
+                }
+                check(v);
+
+                // Non-negative values only.
+                for (auto &x : v) {
+                    x.abs();
+                }
+                check(v);
+
+                // Negative values only.
+                for (auto &x : v) {
+                    x.neg();
+                }
+                check(v);
+
+                // Values with a small span and an offset.
+                const auto offset = random_int(nlimbs);
+                for (auto &x : v) {
+                    x = offset + integer{static_cast<int>(rng() % 1000u)} - 500;
+                }
+                if (std::all_of(v.begin(), v.end(), [](const integer &x) { return x.is_static(); })) {
+                    check(v);
+                }
+
+                // Add some dynamic values.
+                v[0] = random_int(S::value + 1u);
+                v[1].promote();
+                check(v);
+            }
+
+            // All equal values.
+            check(std::vector<integer>(n, integer{-42}));
+            check(std::vector<integer>(n, integer{}));
+
+            // Minimum and maximum static values.
+            std::vector<integer> v;
+            const auto max = (integer{1} << (S::value * GMP_NUMB_BITS)) - 1;
+            for (auto i = 0u; i < n; ++i) {
+                v.push_back(sdist(rng) ? max : -max);
+                v.push_back(random_int(S::value));
+            }
+            check(v);
+        }
+
+        // Pointers and other random-access containers.
+        std::vector<integer> v;
+        for (auto i = 0; i < 1000; ++i) {
+            v.push_back(random_int(1));
+        }
+        std::deque<integer> d(v.begin(), v.end());
+        mppp::integer_sort(d.begin(), d.end());
+        mppp::integer_sort(v.data(), v.data() + v.size());
+        REQUIRE(std::equal(v.begin(), v.end(), d.begin()));
+        REQUIRE(std::is_sorted(v.begin(), v.end()));
+
+        // The using-declaration idiom must still resolve to std::sort().
+        v = {integer{3}, integer{-1}, integer{2}};
+        using std::sort;
+        sort(v.begin(), v.end());
+        REQUIRE(v == std::vector<integer>{integer{-1}, integer{2}, integer{3}});
+    }
+};
+
+TEST_CASE("integer sort")
+{
+    tuple_for_each(sizes{}, sort_tester{});
+}
@@ -32,7 +32,7 @@ using namespace mppp_test;
 
 using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
                          std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
-                         std::integral_constant<std::size_t, 10>>;
+                         std::integral_constant<std::size_t, 8>, std::integral_constant<std::size_t, 10>>;
 
 static const int ntries = 1000;
 
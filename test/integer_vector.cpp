@@ -0,0 +1,179 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/integer_vector.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>>;
+
+// NOTE: larger than the block size used in the implementation.
+static const std::size_t vsize = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+struct vector_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using ivec = integer_vector<S::value>;
+
+        // Basic API.
+        ivec v0;
+        REQUIRE(v0.size() == 0u);
+        ivec v1(3);
+        REQUIRE(v1.size() == 3u);
+        REQUIRE(v1.get(0) == 0);
+        REQUIRE(v1.get(2) == 0);
+        REQUIRE(v1.is_static(2));
+
+        ivec v2{integer{1}, integer{-2}, integer{3}};
+        REQUIRE(v2.size() == 3u);
+        REQUIRE(v2.get(0) == 1);
+        REQUIRE(v2.get(1) == -2);
+        REQUIRE(v2.get(2) == 3);
+        REQUIRE(v2.get(1).is_static());
+
+        // Elements which do not fit in static storage.
+        const integer big = integer{1} << (S::value * GMP_NUMB_BITS + 1u);
+        v2.set(1, -big);
+        REQUIRE(!v2.is_static(1));
+        REQUIRE(v2.get(1) == -big);
+        v2.push_back(big);
+        REQUIRE(v2.size() == 4u);
+        REQUIRE(v2.get(3) == big);
+        v2.set(1, integer{5});
+        REQUIRE(v2.is_static(1));
+        REQUIRE(v2.get(1) == 5);
+        v2.resize(3);
+        v2.resize(4);
+        REQUIRE(v2.get(3) == 0);
+        REQUIRE(v2.is_static(3));
+
+        // Dynamic integers which fit in static storage.
+        integer d{42};
+        d.promote();
+        v2.set(0, d);
+        REQUIRE(v2.is_static(0));
+        REQUIRE(v2.get(0) == 42);
+        REQUIRE(v2.get(0).is_static());
+
+        // Construction from a range.
+        const std::vector<int> vint{1, 2, -3};
+        ivec v3(vint.begin(), vint.end());
+        REQUIRE(v3.size() == 3u);
+        REQUIRE(v3.get(2) == -3);
+
+        // Error handling.
+        REQUIRE_THROWS_PREDICATE(v3.get(3), std::out_of_range, [](const std::out_of_range &ex) {
+            return std::string(ex.what()) == "Cannot access the element at index 3 of an integer vector of size 3";
+        });
+        REQUIRE_THROWS_PREDICATE(v3.set(4, integer{}), std::out_of_range, [](const std::out_of_range &ex) {
+            return std::string(ex.what()) == "Cannot access the element at index 4 of an integer vector of size 3";
+        });
+        REQUIRE_THROWS_AS(v3.is_static(3), std::out_of_range);
+        REQUIRE_THROWS_PREDICATE(add(v0, v2, v3), std::invalid_argument, [](const std::invalid_argument &ex) {
+            return std::string(ex.what())
+                   == "Cannot perform an elementwise operation on integer vectors of different sizes 4 and 3";
+        });
+
+        // Random testing.
+        std::vector<integer> va, vb;
+        detail::mpz_raii tmp;
+        std::uniform_int_distribution<unsigned> ldist(0, S::value + 1u);
+        std::uniform_int_distribution<int> sdist(0, 1);
+        auto random_int = [&]() {
+            random_integer(tmp, ldist(rng), rng);
+            integer retval{&tmp.m_mpz};
+            if (sdist(rng)) {
+                retval.neg();
+            }
+            return retval;
+        };
+        for (std::size_t i = 0; i < vsize; ++i) {
+            va.push_back(random_int());
+            vb.push_back(random_int());
+        }
+        // Make sure we have some cancellation in the subtraction.
+        vb[0] = va[0];
+
+        const ivec a(va.begin(), va.end()), b(vb.begin(), vb.end());
+        ivec r, c;
+
+        add(r, a, b);
+        REQUIRE(r.size() == vsize);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(r.get(i) == va[i] + vb[i]);
+        }
+        sub(r, a, b);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(r.get(i) == va[i] - vb[i]);
+        }
+        mul(r, a, b);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(r.get(i) == va[i] * vb[i]);
+        }
+        for (auto s : {0u, 1u, 13u, unsigned(GMP_NUMB_BITS) - 1u, unsigned(GMP_NUMB_BITS), 200u}) {
+            REQUIRE(&mul_2exp(r, a, s) == &r);
+            for (std::size_t i = 0; i < vsize; ++i) {
+                REQUIRE(r.get(i) == (va[i] << s));
+            }
+        }
+
+        // Overlapping arguments.
+        c = a;
+        REQUIRE(&add(c, c, b) == &c);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(c.get(i) == va[i] + vb[i]);
+        }
+        c = b;
+        sub(c, a, c);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(c.get(i) == va[i] - vb[i]);
+        }
+        c = a;
+        mul(c, c, c);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(c.get(i) == va[i] * va[i]);
+        }
+        c = a;
+        mul_2exp(c, c, 3);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(c.get(i) == (va[i] << 3u));
+        }
+        sub(c, c, c);
+        for (std::size_t i = 0; i < vsize; ++i) {
+            REQUIRE(c.get(i) == 0);
+            REQUIRE(c.is_static(i));
+        }
+    }
+};
+
+TEST_CASE("integer_vector")
+{
+    tuple_for_each(sizes{}, vector_tester{});
+}
@@ -23,6 +23,16 @@ class Test01(unittest.TestCase):
         self.assertTrue(p.test_int2_conversion(-123213123211233232321312321321)
                         == -123213123211233232321312321321)
 
+        # Test values around the boundaries of Python digits and GMP limbs,
+        # and large values.
+        import random
+        for nbits in [29, 30, 31, 32, 33, 59, 60, 61, 63, 64, 65, 127, 128, 129, 1000, 10000, 100000]:
+            for n in [2**nbits - 1, 2**nbits, 2**nbits + 1, random.getrandbits(nbits)]:
+                self.assertTrue(p.test_int1_conversion(n) == n)
+                self.assertTrue(p.test_int1_conversion(-n) == -n)
+                self.assertTrue(p.test_int2_conversion(n) == n)
+                self.assertTrue(p.test_int2_conversion(-n) == -n)
+
         self.assertTrue(p.test_rat1_conversion(F(0)) == 0)
         self.assertTrue(p.test_rat1_conversion(F(-1)) == -1)
         self.assertTrue(p.test_rat1_conversion(F(1)) == 1)
@@ -0,0 +1,220 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <mp++/config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/mpfr.hpp>
+#include <mp++/real.hpp>
+
+#include "catch.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+
+// The smallest precision which does not fit in the static storage.
+static const auto dprec = static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u);
+
+TEST_CASE("real cache")
+{
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    REQUIRE(get_real_cache_limits() == std::make_pair(std::size_t(16), std::size_t(20)));
+
+    // Start from an empty cache.
+    free_real_cache();
+    reset_real_cache_stats();
+    REQUIRE(get_real_cache_stats().hits == 0u);
+    REQUIRE(get_real_cache_stats().misses == 0u);
+    REQUIRE(get_real_cache_stats().evictions == 0u);
+
+    // Reals in static storage do not use the cache.
+    {
+        real r{1, dprec - 1};
+    }
+    REQUIRE(get_real_cache_stats().misses == 0u);
+
+    // Misses, then hits reusing the same significand.
+    const ::mp_limb_t *ptr = nullptr;
+    {
+        real r{1, dprec};
+        ptr = r.get_mpfr_t()->_mpfr_d;
+        REQUIRE(get_real_cache_stats().misses == 1u);
+    }
+    {
+        real r{-2, dprec + 10};
+        REQUIRE(r.get_mpfr_t()->_mpfr_d == ptr);
+        REQUIRE(r == -2);
+        REQUIRE(r.get_prec() == dprec + 10);
+        REQUIRE(get_real_cache_stats().hits == 1u);
+    }
+    // A reused significand is set to a positive NaN.
+    {
+        real r{real_kind::inf, -1, dprec};
+        REQUIRE(r.signbit());
+    }
+    {
+        real r;
+        r.set_prec(dprec);
+        REQUIRE(r.get_mpfr_t()->_mpfr_d == ptr);
+        REQUIRE(r.nan_p());
+        REQUIRE(!r.signbit());
+    }
+    REQUIRE(get_real_cache_stats().hits == 3u);
+    REQUIRE(get_real_cache_stats().misses == 1u);
+    REQUIRE(get_real_cache_stats().evictions == 0u);
+
+    // A significand is cached under the number of limbs of the
+    // current precision, which may be smaller than the allocated size.
+    {
+        real r{1, dprec + GMP_NUMB_BITS};
+        r.set_prec(dprec);
+        r = 3;
+    }
+    {
+        real r{1, dprec};
+        real r2{1, dprec};
+        REQUIRE(r + r2 == 2);
+        r.set_prec(dprec + 2 * GMP_NUMB_BITS);
+        r = 4;
+        REQUIRE(r == 4);
+    }
+
+    // Temporaries in the arithmetic operators and functions reuse the memory.
+    const real a{"1.1", 512}, b{"-2.3", 512};
+    for (int i = 0; i < 100; ++i) {
+        if (i == 1) {
+            // The first iteration fills the cache.
+            reset_real_cache_stats();
+        }
+        auto r = a * b + sqrt(abs(b)) / a - sin(a);
+        REQUIRE(!r.is_static());
+        REQUIRE(r.get_prec() == 512);
+        REQUIRE(r == a * b + sqrt(abs(b)) / a - sin(a));
+    }
+    REQUIRE(get_real_cache_stats().misses == 0u);
+    REQUIRE(get_real_cache_stats().hits > 0u);
+
+    // When the cache is full, the significands are freed.
+    set_real_cache_limits(real::ssize + 1u, 2);
+    REQUIRE(get_real_cache_limits() == std::make_pair(real::ssize + 1u, std::size_t(2)));
+    reset_real_cache_stats();
+    {
+        std::vector<real> v(5, real{1, dprec});
+    }
+    REQUIRE(get_real_cache_stats().evictions == 4u);
+    {
+        std::vector<real> v(5, real{1, dprec});
+    }
+    REQUIRE(get_real_cache_stats().hits == 2u);
+    REQUIRE(get_real_cache_stats().misses == 10u);
+    // Significands larger than the limit are not cached.
+    reset_real_cache_stats();
+    {
+        real r{1, dprec + GMP_NUMB_BITS};
+    }
+    REQUIRE(get_real_cache_stats().misses == 1u);
+    REQUIRE(get_real_cache_stats().evictions == 0u);
+    {
+        real r{1, dprec + GMP_NUMB_BITS};
+    }
+    REQUIRE(get_real_cache_stats().hits == 0u);
+    REQUIRE(get_real_cache_stats().misses == 2u);
+
+    // Disable the cache.
+    set_real_cache_limits(0, 0);
+    reset_real_cache_stats();
+    {
+        real r{1, dprec};
+    }
+    {
+        real r{1, dprec};
+    }
+    REQUIRE(get_real_cache_stats().hits == 0u);
+    REQUIRE(get_real_cache_stats().misses == 2u);
+
+    // Invalid limits.
+    REQUIRE_THROWS_AS(set_real_cache_limits(65, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(set_real_cache_limits(2, static_cast<std::size_t>(-1)), std::overflow_error);
+    REQUIRE(get_real_cache_limits() == std::make_pair(std::size_t(0), std::size_t(0)));
+
+    // Larger limits than the defaults.
+    set_real_cache_limits(64, 1000);
+    auto fill = [](::mpfr_prec_t p) {
+        std::vector<real> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.emplace_back(i, p);
+        }
+    };
+    fill(64 * GMP_NUMB_BITS);
+    reset_real_cache_stats();
+    fill(63 * GMP_NUMB_BITS + 1);
+    REQUIRE(get_real_cache_stats().hits == 1000u);
+    REQUIRE(get_real_cache_stats().misses == 0u);
+    free_real_cache();
+    {
+        real r{1, 64 * GMP_NUMB_BITS};
+    }
+    REQUIRE(get_real_cache_stats().misses == 1u);
+
+    set_real_cache_limits(16, 20);
+    reset_real_cache_stats();
+#else
+    free_real_cache();
+    set_real_cache_limits(1, 1);
+    REQUIRE(get_real_cache_limits() == std::make_pair(std::size_t(0), std::size_t(0)));
+    REQUIRE(get_real_cache_stats().hits == 0u);
+#endif
+}
+
+TEST_CASE("real cache threads")
+{
+    // Reals created and destroyed in multiple threads, with
+    // significands moved across threads.
+    std::vector<real> v(100, real{1, dprec});
+    std::atomic<bool> flag{true};
+    auto func = [&v, &flag](unsigned n) {
+        std::mt19937 rng(n);
+        std::uniform_int_distribution<::mpfr_prec_t> pdist(2, 8 * GMP_NUMB_BITS);
+        std::vector<real> w;
+        for (int i = 0; i < 1000; ++i) {
+            const auto p = pdist(rng);
+            w.emplace_back(i, p);
+            w.back() = w.back() * 2 + real{1, p};
+            if (i % 3 == 0) {
+                w.pop_back();
+            }
+        }
+        for (auto j = 0u; j < 25u; ++j) {
+            w.push_back(std::move(v[n * 25u + j]));
+        }
+        for (auto j = 0u; j < 25u; ++j) {
+            if (w[w.size() - 25u + j] != 1) {
+                flag.store(false);
+            }
+        }
+        free_real_cache();
+    };
+
+    std::thread t0(func, 0u);
+    std::thread t1(func, 1u);
+    std::thread t2(func, 2u);
+    std::thread t3(func, 3u);
+    t0.join();
+    t1.join();
+    t2.join();
+    t3.join();
+    REQUIRE(flag.load());
+}
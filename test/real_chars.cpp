@@ -0,0 +1,246 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <mp++/config.hpp>
+
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(MPPP_WITH_FMT)
+
+#include <fmt/core.h>
+
+#endif
+
+#include <mp++/detail/mpfr.hpp>
+#include <mp++/real.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+static const int ntries = 1000;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+// Helper to convert a real via to_chars() with the given format and precision.
+static std::string to_chars_str(const real &r, real_chars_format fmt, int precision = -1)
+{
+    std::vector<char> buf(10000);
+    const auto res = to_chars(buf.data(), buf.data() + buf.size(), r, fmt, precision);
+    REQUIRE(res.ec == std::errc{});
+    return std::string(buf.data(), res.ptr);
+}
+
+TEST_CASE("real to_chars base")
+{
+    std::vector<char> buf(10000);
+    auto *const b = buf.data();
+    auto *const e = buf.data() + buf.size();
+
+    // Check the consistency with to_string().
+    std::uniform_real_distribution<double> dist(-1E10, 1E10);
+    for (auto base : {2, 8, 10, 16, 36, 62}) {
+        for (::mpfr_prec_t prec : {::mpfr_prec_t(2), ::mpfr_prec_t(53), ::mpfr_prec_t(113), ::mpfr_prec_t(1024)}) {
+            for (const auto &x : {real{0, prec}, real{-0., prec}, real{1, prec}, real{-1, prec},
+                                  real{"nan", prec}, real{"-inf", prec}, real{"inf", prec}}) {
+                const auto res = to_chars(b, e, x, base);
+                REQUIRE(res.ec == std::errc{});
+                REQUIRE(std::string(b, res.ptr) == x.to_string(base));
+            }
+            for (auto i = 0; i < ntries / 10; ++i) {
+                auto x = real{dist(rng), prec};
+                mul_2si(x, x, static_cast<long>(rng() % 200u) - 100);
+                const auto res = to_chars(b, e, x, base);
+                REQUIRE(res.ec == std::errc{});
+                REQUIRE(std::string(b, res.ptr) == x.to_string(base));
+            }
+        }
+    }
+
+    // Insufficient space.
+    for (const auto &x : {real{-123, 53}, real{"-inf", 53}, real{1, 4096}}) {
+        const auto str = x.to_string();
+        for (std::size_t i = 0; i < str.size(); ++i) {
+            const auto res = to_chars(b, b + i, x);
+            REQUIRE(res.ec == std::errc::value_too_large);
+            REQUIRE(res.ptr == b + i);
+        }
+        const auto res = to_chars(b, b + str.size(), x);
+        REQUIRE(res.ec == std::errc{});
+        REQUIRE(res.ptr == b + str.size());
+    }
+
+    // Invalid bases.
+    REQUIRE_THROWS_PREDICATE(
+        to_chars(b, e, real{1}, 1), std::invalid_argument, [](const std::invalid_argument &ex) {
+            return ex.what()
+                   == std::string("Cannot convert a real to a string in base 1: the base must be in the [2,62] range");
+        });
+    REQUIRE_THROWS_PREDICATE(
+        to_chars(b, e, real{1}, 63), std::invalid_argument, [](const std::invalid_argument &ex) {
+            return ex.what()
+                   == std::string("Cannot convert a real to a string in base 63: the base must be in the [2,62] range");
+        });
+
+    // Invalid format.
+    REQUIRE_THROWS_PREDICATE(to_chars(b, e, real{1}, static_cast<real_chars_format>(-1)), std::invalid_argument,
+                             [](const std::invalid_argument &ex) {
+                                 return ex.what()
+                                        == std::string("Invalid format for the conversion of a real to chars");
+                             });
+
+#if defined(MPPP_WITH_FMT)
+    // The fmt formatter, both with a local buffer and with a string.
+    for (const auto &x : {real{-1.1, 53}, real{"1.1", 512}, real{"1.1", 4096}, real{"nan", 53}}) {
+        REQUIRE(fmt::format("{}", x) == x.to_string());
+        REQUIRE(fmt::format("foo {} bar", x) == "foo " + x.to_string() + " bar");
+    }
+#endif
+}
+
+TEST_CASE("real to_chars scientific")
+{
+    // A negative precision gives the to_string() format.
+    REQUIRE(to_chars_str(real{-1.1, 53}, real_chars_format::scientific) == real{-1.1, 53}.to_string());
+    REQUIRE(to_chars_str(real{1, 113}, real_chars_format::scientific) == real{1, 113}.to_string());
+
+    REQUIRE(to_chars_str(real{1.5, 53}, real_chars_format::scientific, 3) == "1.500e+00");
+    REQUIRE(to_chars_str(real{123.456, 53}, real_chars_format::scientific, 2) == "1.23e+02");
+    REQUIRE(to_chars_str(real{-0.125, 53}, real_chars_format::scientific, 1) == "-1.2e-01");
+    REQUIRE(to_chars_str(real{0.375, 53}, real_chars_format::scientific, 1) == "3.8e-01");
+    REQUIRE(to_chars_str(real{2.5, 53}, real_chars_format::scientific, 0) == "2e+00");
+    REQUIRE(to_chars_str(real{3.5, 53}, real_chars_format::scientific, 0) == "4e+00");
+    REQUIRE(to_chars_str(real{-9.75, 53}, real_chars_format::scientific, 0) == "-1e+01");
+    REQUIRE(to_chars_str(real{1E300, 53}, real_chars_format::scientific, 0) == "1e+300");
+    REQUIRE(to_chars_str(real{-1E-300, 53}, real_chars_format::scientific, 1) == "-1.0e-300");
+    REQUIRE(to_chars_str(real{0, 53}, real_chars_format::scientific, 2) == "0.00e+00");
+    REQUIRE(to_chars_str(real{-0., 53}, real_chars_format::scientific, 0) == "-0e+00");
+    REQUIRE(to_chars_str(real{"nan", 53}, real_chars_format::scientific, 2) == "nan");
+    REQUIRE(to_chars_str(real{"-inf", 53}, real_chars_format::scientific, 2) == "-inf");
+
+    // Insufficient space.
+    char buf[7];
+    auto res = to_chars(buf, buf + 7, real{123.456, 53}, real_chars_format::scientific, 2);
+    REQUIRE(res.ec == std::errc::value_too_large);
+    REQUIRE(res.ptr == buf + 7);
+    res = to_chars(buf, buf + 7, real{1.5, 53}, real_chars_format::scientific, 1);
+    REQUIRE(res.ec == std::errc{});
+    REQUIRE(std::string(buf, res.ptr) == "1.5e+00");
+}
+
+TEST_CASE("real to_chars fixed")
+{
+    REQUIRE(to_chars_str(real{1.5, 53}, real_chars_format::fixed, 0) == "2");
+    REQUIRE(to_chars_str(real{2.5, 53}, real_chars_format::fixed, 0) == "2");
+    REQUIRE(to_chars_str(real{0.5, 53}, real_chars_format::fixed, 0) == "0");
+    REQUIRE(to_chars_str(real{-0.5, 53}, real_chars_format::fixed, 0) == "-0");
+    REQUIRE(to_chars_str(real{0.75, 53}, real_chars_format::fixed, 0) == "1");
+    REQUIRE(to_chars_str(real{-0.75, 53}, real_chars_format::fixed, 0) == "-1");
+    REQUIRE(to_chars_str(real{123.456, 53}, real_chars_format::fixed, 2) == "123.46");
+    REQUIRE(to_chars_str(real{-123.456, 53}, real_chars_format::fixed, 5) == "-123.45600");
+    REQUIRE(to_chars_str(real{0.001234, 53}, real_chars_format::fixed, 5) == "0.00123");
+    REQUIRE(to_chars_str(real{0.0001, 53}, real_chars_format::fixed, 2) == "0.00");
+    REQUIRE(to_chars_str(real{0.009, 53}, real_chars_format::fixed, 2) == "0.01");
+    REQUIRE(to_chars_str(real{0.03, 53}, real_chars_format::fixed, 1) == "0.0");
+    REQUIRE(to_chars_str(real{0.07, 53}, real_chars_format::fixed, 1) == "0.1");
+    REQUIRE(to_chars_str(real{9.99, 53}, real_chars_format::fixed, 1) == "10.0");
+    REQUIRE(to_chars_str(real{1E20, 53}, real_chars_format::fixed, 0) == "100000000000000000000");
+    REQUIRE(to_chars_str(real{1E20, 53}, real_chars_format::fixed, 1) == "100000000000000000000.0");
+    REQUIRE(to_chars_str(real{0, 53}, real_chars_format::fixed, 3) == "0.000");
+    REQUIRE(to_chars_str(real{-0., 53}, real_chars_format::fixed, 2) == "-0.00");
+    REQUIRE(to_chars_str(real{0, 53}, real_chars_format::fixed, 0) == "0");
+    REQUIRE(to_chars_str(real{"inf", 53}, real_chars_format::fixed, 2) == "inf");
+
+    // With a negative precision, the round-tripping digits are
+    // written in positional notation.
+    std::uniform_real_distribution<double> dist(-1E10, 1E10);
+    for (::mpfr_prec_t prec : {::mpfr_prec_t(2), ::mpfr_prec_t(53), ::mpfr_prec_t(256)}) {
+        for (auto i = 0; i < ntries / 10; ++i) {
+            auto x = real{dist(rng), prec};
+            mul_2si(x, x, static_cast<long>(rng() % 100u) - 50);
+            const auto str = to_chars_str(x, real_chars_format::fixed);
+            REQUIRE(str.find('e') == std::string::npos);
+            REQUIRE(real{str, prec} == x);
+        }
+    }
+
+    // Insufficient space.
+    char buf[4];
+    auto res = to_chars(buf, buf + 4, real{1E20, 53}, real_chars_format::fixed, 0);
+    REQUIRE(res.ec == std::errc::value_too_large);
+    REQUIRE(res.ptr == buf + 4);
+    res = to_chars(buf, buf + 4, real{0.0001, 53}, real_chars_format::fixed, 3);
+    REQUIRE(res.ec == std::errc::value_too_large);
+    REQUIRE(res.ptr == buf + 4);
+    res = to_chars(buf, buf + 4, real{0.0001, 53}, real_chars_format::fixed, 2);
+    REQUIRE(res.ec == std::errc{});
+    REQUIRE(std::string(buf, res.ptr) == "0.00");
+}
+
+TEST_CASE("real to_chars shortest")
+{
+    REQUIRE(to_chars_str(real{0.1, 53}, real_chars_format::shortest) == "1e-1");
+    REQUIRE(to_chars_str(real{1.5, 53}, real_chars_format::shortest) == "1.5");
+    REQUIRE(to_chars_str(real{-1, 53}, real_chars_format::shortest) == "-1");
+    REQUIRE(to_chars_str(real{100, 53}, real_chars_format::shortest) == "1e+2");
+    REQUIRE(to_chars_str(real{123.456, 53}, real_chars_format::shortest) == "1.23456e+2");
+    REQUIRE(to_chars_str(real{1. / 3, 53}, real_chars_format::shortest) == "3.333333333333333e-1");
+    REQUIRE(to_chars_str(real{0, 53}, real_chars_format::shortest) == "0");
+    REQUIRE(to_chars_str(real{-0., 53}, real_chars_format::shortest) == "-0");
+    REQUIRE(to_chars_str(real{"-nan", 53}, real_chars_format::shortest) == "nan");
+    REQUIRE(to_chars_str(real{"-inf", 53}, real_chars_format::shortest) == "-inf");
+
+    // The precision is ignored.
+    REQUIRE(to_chars_str(real{0.1, 53}, real_chars_format::shortest, 10) == "1e-1");
+
+    // Check the round trip, and that the representation is never
+    // longer than the one produced by to_string().
+    std::uniform_real_distribution<double> dist(-1E10, 1E10);
+    for (::mpfr_prec_t prec : {::mpfr_prec_t(2), ::mpfr_prec_t(24), ::mpfr_prec_t(53), ::mpfr_prec_t(113),
+                               ::mpfr_prec_t(1024)}) {
+        for (auto i = 0; i < ntries / 10; ++i) {
+            auto x = real{dist(rng), prec};
+            mul_2si(x, x, static_cast<long>(rng() % 1000u) - 500);
+            const auto str = to_chars_str(x, real_chars_format::shortest);
+            REQUIRE(real{str, prec} == x);
+            REQUIRE(str.size() <= x.to_string().size());
+        }
+    }
+
+    // For double-precision values, the number of significant digits
+    // is at most max_digits10.
+    for (auto i = 0; i < ntries; ++i) {
+        const auto x = real{dist(rng), 53};
+        const auto str = to_chars_str(x, real_chars_format::shortest);
+        const auto mant = str.substr(0, str.find('e'));
+        std::size_t nd = 0;
+        for (auto c : mant) {
+            nd += static_cast<std::size_t>(c >= '0' && c <= '9');
+        }
+        REQUIRE(nd <= static_cast<std::size_t>(std::numeric_limits<double>::max_digits10));
+    }
+
+    // Insufficient space.
+    char buf[4];
+    auto res = to_chars(buf, buf + 4, real{123.456, 53}, real_chars_format::shortest);
+    REQUIRE(res.ec == std::errc::value_too_large);
+    REQUIRE(res.ptr == buf + 4);
+    res = to_chars(buf, buf + 4, real{-1.5, 53}, real_chars_format::shortest);
+    REQUIRE(res.ec == std::errc{});
+    REQUIRE(std::string(buf, res.ptr) == "-1.5");
+}
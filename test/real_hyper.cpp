@@ -168,4 +168,52 @@ TEST_CASE("real hyper")
     REQUIRE(cop.get_prec() == detail::real_deduce_precision(0) * 3);
     REQUIRE(sop == sinh(real{2, detail::real_deduce_precision(0) * 3}));
     REQUIRE(cop == cosh(real{2, detail::real_deduce_precision(0) * 3}));
+
+    // Stealing from an rvalue op.
+    sop = real{1, 10};
+    cop = real{2, 1000};
+    real op{3, 1000};
+    const auto *op_ptr = op.get_mpfr_t()->_mpfr_d;
+    sinh_cosh(sop, cop, std::move(op));
+    REQUIRE(sop.get_prec() == 1000);
+    REQUIRE(cop.get_prec() == 1000);
+    REQUIRE(sop == sinh(real{3, 1000}));
+    REQUIRE(cop == cosh(real{3, 1000}));
+    REQUIRE(sop.get_mpfr_t()->_mpfr_d == op_ptr);
+    // Check op was swapped for sop.
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op == 1);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op.get_prec() == 10);
+
+    // An rvalue op which is also a return value is not stolen.
+    sop = real{1, 10};
+    cop = real{3, 1000};
+    sinh_cosh(sop, cop, std::move(cop));
+    REQUIRE(sop.get_prec() == 1000);
+    REQUIRE(cop.get_prec() == 1000);
+    REQUIRE(sop == sinh(real{3, 1000}));
+    REQUIRE(cop == cosh(real{3, 1000}));
+
+    // The overload returning a pair.
+    auto p0 = sinh_cosh(real{3});
+    REQUIRE(p0.first.get_prec() == detail::real_deduce_precision(0));
+    REQUIRE(p0.second.get_prec() == detail::real_deduce_precision(0));
+    REQUIRE(p0.first == sinh(real{3}));
+    REQUIRE(p0.second == cosh(real{3}));
+    const real cop0{3, 1000};
+    auto p1 = sinh_cosh(cop0);
+    REQUIRE(p1.first.get_prec() == 1000);
+    REQUIRE(p1.second.get_prec() == 1000);
+    REQUIRE(p1.first == sinh(cop0));
+    REQUIRE(p1.second == cosh(cop0));
+    REQUIRE(cop0 == 3);
+    op = real{3, 1000};
+    op_ptr = op.get_mpfr_t()->_mpfr_d;
+    auto p2 = sinh_cosh(std::move(op));
+    REQUIRE(p2.first == p1.first);
+    REQUIRE(p2.second == p1.second);
+    REQUIRE(p2.first.get_mpfr_t()->_mpfr_d == op_ptr);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(!op.is_valid());
 }
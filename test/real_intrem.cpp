@@ -11,6 +11,7 @@
 #include <utility>
 
 #include <mp++/config.hpp>
+#include <mp++/detail/gmp.hpp>
 #include <mp++/integer.hpp>
 #include <mp++/real.hpp>
 
@@ -69,6 +70,9 @@ TEST_CASE("real trunc")
     REQUIRE(r0.trunc() == -1);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -129,6 +133,9 @@ TEST_CASE("real ceil")
     REQUIRE(r0.ceil() == -1);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -189,6 +196,9 @@ TEST_CASE("real floor")
     REQUIRE(r0.floor() == -2);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -257,6 +267,9 @@ TEST_CASE("real round")
     REQUIRE(r0.round() == -3);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -337,6 +350,9 @@ TEST_CASE("real roundeven")
     REQUIRE(r0.roundeven() == -4);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -405,6 +421,9 @@ TEST_CASE("real frac")
     REQUIRE(r0.frac() == -1.999 + 1);
     // The binary function.
     real tmp{45.67, 50};
+    // NOTE: put r0 in dynamic storage, so that the stealing
+    // can be checked via the pointer to the significand.
+    r0 = real{0, static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS + 1u)};
     r0.set_prec(4);
     // NOLINTNEXTLINE(llvm-qualified-auto, readability-qualified-auto)
     auto tmp_ptr = r0.get_mpfr_t()->_mpfr_d;
@@ -482,6 +501,57 @@ TEST_CASE("real modf")
     REQUIRE(iop.get_prec() == detail::real_deduce_precision(0) * 3);
     REQUIRE(fop == 2);
     REQUIRE(iop == 0);
+
+    // Stealing from an rvalue op.
+    iop = real{1, 10};
+    fop = real{2, 1000};
+    real op{"3.25", 1000};
+    const auto *op_ptr = op.get_mpfr_t()->_mpfr_d;
+    modf(iop, fop, std::move(op));
+    REQUIRE(iop.get_prec() == 1000);
+    REQUIRE(fop.get_prec() == 1000);
+    REQUIRE(iop == 3);
+    REQUIRE(fop == .25);
+    REQUIRE(iop.get_mpfr_t()->_mpfr_d == op_ptr);
+    // Check op was swapped for iop.
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op == 1);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op.get_prec() == 10);
+
+    // An rvalue op which is also a return value is not stolen.
+    iop = real{1, 10};
+    fop = real{"3.25", 1000};
+    modf(iop, fop, std::move(fop));
+    REQUIRE(iop.get_prec() == 1000);
+    REQUIRE(fop.get_prec() == 1000);
+    REQUIRE(iop == 3);
+    REQUIRE(fop == .25);
+
+    // The overload returning a pair.
+    auto p0 = modf(real{"3.25", 64});
+    REQUIRE(p0.first.get_prec() == 64);
+    REQUIRE(p0.second.get_prec() == 64);
+    REQUIRE(p0.first == 3);
+    REQUIRE(p0.second == .25);
+    const real cop0{"3.25", 1000};
+    auto p1 = modf(cop0);
+    REQUIRE(p1.first.get_prec() == 1000);
+    REQUIRE(p1.second.get_prec() == 1000);
+    REQUIRE(p1.first == 3);
+    REQUIRE(p1.second == .25);
+    REQUIRE(cop0 == 3.25);
+    op = real{"3.25", 1000};
+    op_ptr = op.get_mpfr_t()->_mpfr_d;
+    auto p2 = modf(std::move(op));
+    REQUIRE(p2.first == p1.first);
+    REQUIRE(p2.second == p1.second);
+    REQUIRE(p2.first.get_mpfr_t()->_mpfr_d == op_ptr);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(!op.is_valid());
+    REQUIRE_THROWS_PREDICATE(modf(real{"nan", 10}), std::domain_error, [](const std::domain_error &ex) {
+        return ex.what() == std::string{"In the real modf() function, the input argument cannot be NaN"};
+    });
 }
 
 TEST_CASE("real fmod")
@@ -0,0 +1,262 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <mp++/config.hpp>
+
+#include <random>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/lazy.hpp>
+#include <mp++/real.hpp>
+
+#if defined(MPPP_WITH_MPC)
+#include <mp++/complex.hpp>
+#endif
+
+#include "catch.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+template <typename T>
+using lazy_t = decltype(lazy(std::declval<T>()));
+
+template <typename T, typename U>
+using lazy_add_t = decltype(std::declval<T>() + std::declval<U>());
+
+template <typename T, typename U>
+using lazy_mul_t = decltype(std::declval<T>() * std::declval<U>());
+
+template <typename T>
+static T horner(const T *a, const T &x)
+{
+    return eval((((((lazy(a[6]) * x + a[5]) * x + a[4]) * x + a[3]) * x + a[2]) * x + a[1]) * x + a[0]);
+}
+
+TEST_CASE("real lazy type traits")
+{
+    const real x{1}, y{2};
+
+    REQUIRE(is_lazy_expr<decltype(lazy(x))>::value);
+    REQUIRE(is_lazy_expr<decltype(lazy(x) + y)>::value);
+    REQUIRE(is_lazy_expr<decltype(x * lazy(y))>::value);
+    REQUIRE(is_lazy_expr<decltype(-(lazy(x) / y))>::value);
+    REQUIRE(is_lazy_expr<decltype(lazy(x) - lazy(y))>::value);
+    REQUIRE(!is_lazy_expr<real>::value);
+    REQUIRE(!is_lazy_expr<int>::value);
+    // The usual operators are not affected.
+    REQUIRE(std::is_same<real, decltype(x + y)>::value);
+    REQUIRE(std::is_same<real, decltype(eval(lazy(x) + y))>::value);
+    REQUIRE(std::is_same<real &, decltype(eval(std::declval<real &>(), lazy(x) + y))>::value);
+
+    // Lazy expressions cannot refer to rvalues.
+    using term_t = decltype(lazy(x));
+    REQUIRE(detail::is_detected<lazy_t, const real &>::value);
+    REQUIRE(detail::is_detected<lazy_t, real &>::value);
+    REQUIRE(!detail::is_detected<lazy_t, real>::value);
+    REQUIRE(!detail::is_detected<lazy_t, const real>::value);
+    REQUIRE(detail::is_detected<lazy_mul_t, term_t, const real &>::value);
+    REQUIRE(detail::is_detected<lazy_mul_t, real &, term_t>::value);
+    REQUIRE(!detail::is_detected<lazy_mul_t, term_t, real>::value);
+    REQUIRE(!detail::is_detected<lazy_mul_t, real, term_t>::value);
+    REQUIRE(!detail::is_detected<lazy_add_t, term_t, const real>::value);
+    REQUIRE(!detail::is_detected<lazy_add_t, real, decltype(lazy(x) * y)>::value);
+    // Rvalue lazy expressions are fine.
+    REQUIRE(detail::is_detected<lazy_add_t, decltype(lazy(x) * y), term_t>::value);
+}
+
+TEST_CASE("real lazy eval")
+{
+    const real a{3, 64}, b{-5, 64}, c{7, 100};
+
+    // Basic operations.
+    REQUIRE(eval(lazy(a)) == 3);
+    REQUIRE(eval(lazy(a) + b) == -2);
+    REQUIRE(eval(a - lazy(b)) == 8);
+    REQUIRE(eval(lazy(a) * b) == -15);
+    REQUIRE(eval(lazy(b) / a) == real{-5, 64} / real{3, 64});
+    REQUIRE(eval(-lazy(a)) == -3);
+    REQUIRE(eval(-(lazy(a) * b)) == 15);
+    REQUIRE(eval(lazy(a) * b + c) == -8);
+    REQUIRE(eval(c + lazy(a) * b) == -8);
+    REQUIRE(eval(lazy(a) * b - c) == -22);
+    REQUIRE(eval(c - lazy(a) * b) == 22);
+    REQUIRE(eval(lazy(a) * b + lazy(c) * a) == 6);
+    REQUIRE(eval(lazy(a) * b - lazy(c) * a) == -36);
+    REQUIRE(eval((lazy(a) + b) * (lazy(c) - a) / (lazy(b) - c)) == real{-8, 100} / 12 * -1);
+    REQUIRE(eval(-(lazy(a) + b) - -(lazy(c) * c)) == 51);
+
+    // The precision is the largest precision in the expression.
+    REQUIRE(eval(lazy(a) * b).get_prec() == 64);
+    REQUIRE(eval(lazy(a) * b + c).get_prec() == 100);
+    REQUIRE(eval(-lazy(c)).get_prec() == 100);
+    real r{1, 200};
+    REQUIRE(&eval(r, lazy(a) + b) == &r);
+    REQUIRE(r == -2);
+    REQUIRE(r.get_prec() == 64);
+    r = real{1, 10};
+    eval(r, lazy(a) + c);
+    REQUIRE(r == 10);
+    REQUIRE(r.get_prec() == 100);
+    r = real{1, 10};
+    eval(r, lazy(a));
+    REQUIRE(r == 3);
+    REQUIRE(r.get_prec() == 64);
+
+    // The intermediate results are computed with the precision
+    // of the expression, and products are fused with additions and subtractions.
+    const real third{real{1, 10} / 3};
+    const real big{1, 200};
+    REQUIRE(eval(lazy(third) * third + big) == fma(third, third, big));
+    REQUIRE(eval(lazy(third) * third - big) == fms(third, third, big));
+    REQUIRE(eval(big - lazy(third) * third) == -fms(third, third, big));
+    const real one{1, 10}, three{3, 10};
+    REQUIRE(eval(lazy(one) / three + big) == real{1, 200} / 3 + 1);
+    REQUIRE(eval(lazy(one) / three + big) != one / three + big);
+
+    // Random testing against the eager evaluation with the same precision
+    // and the same fusions.
+    std::uniform_real_distribution<double> rdist(-100., 100.);
+    for (auto p : {::mpfr_prec_t(53), ::mpfr_prec_t(200), ::mpfr_prec_t(1000)}) {
+        for (int i = 0; i < 100; ++i) {
+            const real x{rdist(rng), p}, y{rdist(rng), p}, z{rdist(rng), p}, w{rdist(rng), p};
+            REQUIRE(eval((lazy(x) + y) * z) == (x + y) * z);
+            REQUIRE(eval((lazy(x) + y) / (lazy(z) - w)) == (x + y) / (z - w));
+            REQUIRE(eval(lazy(x) * y + z) == fma(x, y, z));
+            REQUIRE(eval(lazy(x) * y + lazy(z) * w) == fma(x, y, z * w));
+            REQUIRE(eval((lazy(x) * y + z) * w - x) == fms(fma(x, y, z), w, x));
+            REQUIRE(eval(-((lazy(x) - y) * (lazy(z) + w))) == -((x - y) * (z + w)));
+            REQUIRE(eval(lazy(x) / y - lazy(z) / w) == x / y - z / w);
+
+            const real coeffs[] = {x, y, z, w, x, y, z};
+            REQUIRE(horner(coeffs, w) == fma(fma(fma(fma(fma(fma(z, w, y), w, x), w, w), w, z), w, y), w, x));
+        }
+    }
+}
+
+TEST_CASE("real lazy aliasing")
+{
+    std::uniform_real_distribution<double> rdist(-100., 100.);
+    for (auto p : {::mpfr_prec_t(53), ::mpfr_prec_t(500)}) {
+        for (int i = 0; i < 100; ++i) {
+            const real x0{rdist(rng), p}, y0{rdist(rng), p}, z0{rdist(rng), p};
+            real x, y{y0}, z{z0};
+
+            // The destination appears in the expression.
+            x = x0;
+            eval(x, lazy(x) * y + z);
+            REQUIRE(x == fma(x0, y0, z0));
+            x = x0;
+            eval(x, lazy(y) * z + x);
+            REQUIRE(x == fma(y0, z0, x0));
+            x = x0;
+            eval(x, lazy(y) * x - z);
+            REQUIRE(x == fms(y0, x0, z0));
+            x = x0;
+            eval(x, (lazy(x) + y) * (lazy(z) - x));
+            REQUIRE(x == (x0 + y0) * (z0 - x0));
+            x = x0;
+            eval(x, (lazy(y) + z) * x);
+            REQUIRE(x == (y0 + z0) * x0);
+            x = x0;
+            eval(x, x * (lazy(y) + z));
+            REQUIRE(x == x0 * (y0 + z0));
+            x = x0;
+            eval(x, (lazy(y) + z) / (lazy(x) - y) + (lazy(x) * x));
+            REQUIRE(x == fma(x0, x0, (y0 + z0) / (x0 - y0)));
+            x = x0;
+            eval(x, -(lazy(x) + x));
+            REQUIRE(x == -(x0 + x0));
+            x = x0;
+            eval(x, z - (lazy(y) + x) * (lazy(x) - z));
+            REQUIRE(x == -fms(y0 + x0, x0 - z0, z0));
+            x = x0;
+            eval(x, lazy(x));
+            REQUIRE(x == x0);
+
+            // A destination with a lower precision.
+            x = real{x0, p / 2};
+            eval(x, lazy(x) * y + z);
+            REQUIRE(x.get_prec() == p);
+            REQUIRE(x == fma(real{x0, p / 2}, y0, z0));
+        }
+    }
+}
+
+TEST_CASE("real lazy allocations")
+{
+    // Horner's scheme into a destination with the
+    // correct precision does not need any temporary.
+    const auto p = ::mpfr_prec_t(512);
+    real a[7];
+    for (int i = 0; i < 7; ++i) {
+        a[i] = real{i + 1, p};
+    }
+    const real x{3, p};
+    real r{0, p};
+
+    reset_real_cache_stats();
+    eval(r, (((((lazy(a[6]) * x + a[5]) * x + a[4]) * x + a[3]) * x + a[2]) * x + a[1]) * x + a[0]);
+    REQUIRE(get_real_cache_stats().hits == 0u);
+    REQUIRE(get_real_cache_stats().misses == 0u);
+    REQUIRE(r == 1 + 3 * (2 + 3 * (3 + 3 * (4 + 3 * (5 + 3 * (6 + 3 * 7))))));
+    REQUIRE(r == horner(a, x));
+
+    // Expressions needing temporaries.
+    reset_real_cache_stats();
+    eval(r, (lazy(a[0]) + a[1]) * (lazy(a[2]) + a[3]));
+    REQUIRE(r == 21);
+#if defined(MPPP_HAVE_THREAD_LOCAL)
+    REQUIRE(get_real_cache_stats().hits + get_real_cache_stats().misses == 1u);
+#endif
+}
+
+#if defined(MPPP_WITH_MPC)
+
+TEST_CASE("complex lazy")
+{
+    const complex a{1, 2}, b{3, -4}, c{real{"1.5", 100}, real{2, 100}};
+
+    REQUIRE(is_lazy_expr<decltype(lazy(a) * b)>::value);
+    REQUIRE(std::is_same<complex, decltype(eval(lazy(a) * b))>::value);
+    REQUIRE(!detail::is_detected<lazy_t, complex>::value);
+    REQUIRE(!detail::is_detected<lazy_mul_t, decltype(lazy(a)), complex>::value);
+    REQUIRE(!detail::is_detected<lazy_mul_t, complex, decltype(lazy(a))>::value);
+
+    REQUIRE(eval(lazy(a) + b) == a + b);
+    REQUIRE(eval(lazy(a) - b) == a - b);
+    REQUIRE(eval(lazy(a) * b) == a * b);
+    REQUIRE(eval(lazy(a) / b) == a / b);
+    REQUIRE(eval(-lazy(a)) == -a);
+    REQUIRE(eval(lazy(a) * b + c) == fma(a, b, c));
+    REQUIRE(eval(c + lazy(a) * b) == fma(a, b, c));
+    REQUIRE(eval(lazy(a) * b - c) == complex{a * b, complex_prec_t(100)} - c);
+    REQUIRE(eval(c - lazy(a) * b) == c - complex{a * b, complex_prec_t(100)});
+    REQUIRE(eval(lazy(a) * b + c).get_prec() == 100);
+
+    complex r{a};
+    eval(r, lazy(r) * b + r);
+    REQUIRE(r == fma(a, b, a));
+    r = a;
+    eval(r, (lazy(b) + c) * (lazy(r) - b));
+    REQUIRE(r == (b + c) * (a - b));
+    REQUIRE(r.get_prec() == 100);
+
+    const complex coeffs[] = {a, b, c, a, b, c, a};
+    REQUIRE(horner(coeffs, b)
+            == fma(fma(fma(fma(fma(fma(coeffs[6], b, coeffs[5]), b, coeffs[4]), b, coeffs[3]), b, coeffs[2]), b,
+                       coeffs[1]),
+                   b, coeffs[0]));
+}
+
+#endif
@@ -6,19 +6,59 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <mp++/config.hpp>
+#include <mp++/integer.hpp>
 #include <mp++/real.hpp>
 
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+#include <memory_resource>
+
+#endif
+
 #include "catch.hpp"
 #include "test_utils.hpp"
 
 // NOLINTNEXTLINE(google-build-using-namespace)
 using namespace mppp;
 
+#if defined(MPPP_HAVE_MEMORY_RESOURCE)
+
+// The cached values of the real literals never draw from a memory resource,
+// even if the literal is first used within a scope.
+// NOTE: this test case needs to run first, as enable_integer_memory_resources()
+// must be called before any GMP memory allocation.
+TEST_CASE("real_literals_memory_resource")
+{
+    enable_integer_memory_resources();
+
+    const auto lit = []() { return 1.234567890123456789012345678901234567890123456789e-30_r1024; };
+    const real cmp{"1.234567890123456789012345678901234567890123456789e-30", 1024};
+
+    std::vector<unsigned char> buffer(1u << 16);
+    std::pmr::monotonic_buffer_resource mr(buffer.data(), buffer.size());
+    {
+        integer_memory_resource_scope scope(&mr);
+        REQUIRE(lit() == cmp);
+    }
+    mr.release();
+    std::fill(buffer.begin(), buffer.end(), static_cast<unsigned char>(0xff));
+    REQUIRE(lit() == cmp);
+    {
+        integer_memory_resource_scope scope(&mr);
+        REQUIRE(lit() == cmp);
+    }
+}
+
+#endif
+
 TEST_CASE("real_literals_tests")
 {
     REQUIRE(std::is_same<real, decltype(123_r128)>::value);
@@ -146,3 +186,36 @@ TEST_CASE("real_literals_tests")
         return ia.what() == std::string("A real cannot be constructed from binary or octal literals");
     });
 }
+
+// The literals are parsed only once, and each
+// evaluation returns a distinct copy.
+TEST_CASE("real_literals_cache")
+{
+    for (int i = 0; i < 10; ++i) {
+        auto r = 1.1_r256;
+        REQUIRE(r == real{"1.1", 256});
+        REQUIRE(r.get_prec() == 256);
+        r += 1;
+        r.set_prec(10);
+        auto r2 = 1.1_r512;
+        REQUIRE(r2 == real{"1.1", 512});
+        r2 = 0;
+    }
+
+    // Concurrent evaluations.
+    std::vector<int> flags(4, 0);
+    auto func = [&flags](unsigned n) {
+        for (int i = 0; i < 100; ++i) {
+            if (2.3_r1024 != real{"2.3", 1024}) {
+                return;
+            }
+        }
+        flags[n] = 1;
+    };
+    std::thread t0(func, 0u), t1(func, 1u), t2(func, 2u), t3(func, 3u);
+    t0.join();
+    t1.join();
+    t2.join();
+    t3.join();
+    REQUIRE(flags == std::vector<int>(4, 1));
+}
@@ -2122,3 +2122,74 @@ TEST_CASE("real incdec")
     r0--;
     REQUIRE(r0.get_prec() == detail::real_deduce_precision(1));
 }
+
+// Check the mixed-mode arithmetic operations between reals and x
+// against the same operations with x converted to real.
+template <typename T>
+static void check_mixed_ops(const T &x, const real &a)
+{
+    const real xr{x};
+
+    auto check = [](const real &r1, const real &r2) {
+        REQUIRE(r1.get_prec() == r2.get_prec());
+        REQUIRE(((r1.nan_p() && r2.nan_p()) || r1 == r2));
+    };
+
+    check(a + x, a + xr);
+    check(x + a, xr + a);
+    check(a - x, a - xr);
+    check(x - a, xr - a);
+    check(a * x, a * xr);
+    check(x * a, xr * a);
+    check(a / x, a / xr);
+    check(x / a, xr / a);
+
+    real b{a};
+    b += x;
+    check(b, a + xr);
+    b = a;
+    b -= x;
+    check(b, a - xr);
+    b = a;
+    b *= x;
+    check(b, a * xr);
+    b = a;
+    b /= x;
+    check(b, a / xr);
+}
+
+TEST_CASE("real mixed direct ops")
+{
+    const real reals[] = {real{"1.1", 10}, real{"-2.3", 200}, real{0, 64}, real{real_kind::inf, -1, 100}};
+
+    for (const auto &a : reals) {
+        // long doubles, with and without an exact double representation.
+        check_mixed_ops(1.5l, a);
+        check_mixed_ops(-0.l, a);
+        check_mixed_ops(1.l / 3, a);
+        check_mixed_ops(static_cast<long double>(detail::nl_min<double>()) / 3, a);
+        check_mixed_ops(detail::nl_max<long double>(), a);
+        check_mixed_ops(-std::numeric_limits<long double>::infinity(), a);
+        check_mixed_ops(std::numeric_limits<long double>::quiet_NaN(), a);
+
+        // integers, with and without a representation as a long.
+        check_mixed_ops(int_t{42}, a);
+        check_mixed_ops(int_t{-42}, a);
+        check_mixed_ops(int_t{}, a);
+        check_mixed_ops(int_t{1} << 70, a);
+        check_mixed_ops(-(int_t{1} << 70), a);
+        check_mixed_ops(rat_t{-3, 4}, a);
+#if defined(MPPP_HAVE_GCC_INT128)
+        check_mixed_ops(__int128_t{1} << 100, a);
+        check_mixed_ops(-(__int128_t{1} << 100), a);
+#endif
+
+#if defined(MPPP_WITH_QUADMATH)
+        check_mixed_ops(real128{"1.5"}, a);
+        check_mixed_ops(real128{1} / 3, a);
+        check_mixed_ops(real128_max(), a);
+        check_mixed_ops(-real128_inf(), a);
+        check_mixed_ops(real128_nan(), a);
+#endif
+    }
+}
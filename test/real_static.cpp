@@ -0,0 +1,410 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <mp++/config.hpp>
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/mpfr.hpp>
+#include <mp++/real.hpp>
+
+#if defined(MPPP_WITH_MPC)
+#include <mp++/complex.hpp>
+#endif
+
+#include "catch.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cert-msc32-c, cert-msc51-cpp, cppcoreguidelines-avoid-non-const-global-variables)
+static std::mt19937 rng;
+
+// The largest precision fitting in the static storage.
+static const auto sprec = static_cast<::mpfr_prec_t>(real::ssize * GMP_NUMB_BITS);
+
+TEST_CASE("real static storage")
+{
+    REQUIRE(real::ssize == 4u);
+
+    // Constructors.
+    REQUIRE(real{}.is_static());
+    REQUIRE(real{1.5}.is_static());
+    REQUIRE(real{1, sprec}.is_static());
+    REQUIRE(!real{1, sprec + 1}.is_static());
+    REQUIRE(real{"1.1", 113}.is_static());
+    REQUIRE(real{real_kind::inf, -1, sprec}.is_static());
+    const real big{1, sprec + 1};
+    REQUIRE(real{big, sprec}.is_static());
+    REQUIRE(real{big, sprec} == 1);
+    // Move construction with a custom precision keeps dynamic storage.
+    REQUIRE(!real{real{1, sprec + 1}, 64}.is_static());
+
+    // Values in static and dynamic storage must agree.
+    std::uniform_real_distribution<double> rdist(-100., 100.);
+    for (auto p : {::mpfr_prec_t(2), ::mpfr_prec_t(53), ::mpfr_prec_t(113), sprec - 1, sprec}) {
+        for (int i = 0; i < 100; ++i) {
+            const auto x = rdist(rng), y = rdist(rng);
+            const real a{x, p}, b{y, p};
+            REQUIRE(a.is_static());
+            auto a_d = real{x, sprec + 1}, b_d = real{y, sprec + 1};
+            a_d.prec_round(p);
+            b_d.prec_round(p);
+            REQUIRE(!a_d.is_static());
+            REQUIRE(a_d == a);
+            auto ret = a * b + sqrt(abs(a));
+            REQUIRE(ret.is_static());
+            REQUIRE(ret.get_prec() == p);
+            REQUIRE(ret == a_d * b_d + sqrt(abs(a_d)));
+        }
+    }
+
+    // Copy and move construction.
+    real r0{"1.1", 113};
+    real r1{r0};
+    REQUIRE(r1.is_static());
+    REQUIRE(r1 == r0);
+    real r2{std::move(r1)};
+    REQUIRE(r2.is_static());
+    REQUIRE(r2 == r0);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(!r1.is_valid());
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(!r1.is_static());
+    r1 = r2;
+    REQUIRE(r1.is_static());
+    REQUIRE(r1 == r0);
+    real r3{std::move(r2), 200};
+    REQUIRE(r3.is_static());
+    REQUIRE(r3 == r0);
+    real r4{std::move(r3), sprec + 100};
+    REQUIRE(!r4.is_static());
+    REQUIRE(r4 == r0);
+    real r5{std::move(r4), 64};
+    REQUIRE(!r5.is_static());
+    REQUIRE(r5 == real{r0, 64});
+
+    // Move assignment and swap, with all the combinations of storage types.
+    const real s0{"1.3", 100}, s1{"-2.7", 150}, d0{"4.5", sprec + 10}, d1{"-0.1", sprec + 20};
+    for (const auto *x : {&s0, &s1, &d0, &d1}) {
+        for (const auto *y : {&s0, &s1, &d0, &d1}) {
+            auto a = *x, b = *y;
+            swap(a, b);
+            REQUIRE(a.is_static() == y->is_static());
+            REQUIRE(b.is_static() == x->is_static());
+            REQUIRE(a == *y);
+            REQUIRE(b == *x);
+            REQUIRE(a.get_prec() == y->get_prec());
+            REQUIRE(b.get_prec() == x->get_prec());
+
+            auto c = *x, d = *y;
+            c = std::move(d);
+            REQUIRE(c.is_static() == y->is_static());
+            REQUIRE(c == *y);
+
+            // Move assignment into a moved-from object.
+            auto e = std::move(c);
+            // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+            c = real{*x};
+            REQUIRE(c.is_static() == x->is_static());
+            REQUIRE(c == *x);
+            REQUIRE(e == *y);
+
+            // Copy assignment moves the destination to dynamic storage
+            // only if the precision does not fit in static storage.
+            a = *x;
+            b = *y;
+            REQUIRE(a == *x);
+            REQUIRE(b == *y);
+            REQUIRE(a.is_static() == (x->is_static() && y->is_static()));
+            REQUIRE(b.is_static() == (x->is_static() && y->is_static()));
+        }
+    }
+
+    // Self move and self swap.
+    auto s2 = s0;
+    s2 = std::move(s2);
+    REQUIRE(s2.is_static());
+    REQUIRE(s2 == s0);
+    swap(s2, s2);
+    REQUIRE(s2.is_static());
+    REQUIRE(s2 == s0);
+
+    // set_prec().
+    real r6{1, 10};
+    r6.set_prec(sprec);
+    REQUIRE(r6.is_static());
+    REQUIRE(r6.nan_p());
+    REQUIRE(r6.get_prec() == sprec);
+    r6 = 3;
+    r6.set_prec(sprec + 1);
+    REQUIRE(!r6.is_static());
+    REQUIRE(r6.nan_p());
+    REQUIRE(r6.get_prec() == sprec + 1);
+    // Dynamic storage is never demoted.
+    r6.set_prec(10);
+    REQUIRE(!r6.is_static());
+    REQUIRE(r6.get_prec() == 10);
+
+    // prec_round().
+    const real third = real{1, sprec + 100} / 3;
+    real r7{third, sprec};
+    REQUIRE(r7.is_static());
+    r7.prec_round(64);
+    REQUIRE(r7.is_static());
+    REQUIRE(r7 == real{third, 64});
+    REQUIRE(r7.get_prec() == 64);
+    r7.prec_round(sprec);
+    REQUIRE(r7.is_static());
+    REQUIRE(r7 == real{third, 64});
+    r7.prec_round(sprec + 64);
+    REQUIRE(!r7.is_static());
+    REQUIRE(r7 == real{third, 64});
+    REQUIRE(r7.get_prec() == sprec + 64);
+    // Rounding down in static storage must match MPFR.
+    for (int i = 0; i < 100; ++i) {
+        const auto x = rdist(rng);
+        for (auto p : {::mpfr_prec_t(2), ::mpfr_prec_t(20), ::mpfr_prec_t(70), sprec - 1}) {
+            real a{x, sprec}, b{x, sprec + 1};
+            b.set_prec(sprec);
+            b.set(x);
+            REQUIRE(!b.is_static());
+            a.prec_round(p);
+            b.prec_round(p);
+            REQUIRE(a.is_static());
+            REQUIRE(a == b);
+            REQUIRE(a.get_prec() == p);
+        }
+    }
+    // Special values, including their sign.
+    for (auto k : {real_kind::nan, real_kind::inf, real_kind::zero}) {
+        for (auto sign : {1, -1}) {
+            real a{k, sign, 64};
+            const auto sb = a.signbit();
+            a.prec_round(100);
+            REQUIRE(a.is_static());
+            REQUIRE(a.signbit() == sb);
+            REQUIRE(a.nan_p() == (k == real_kind::nan));
+            REQUIRE(a.inf_p() == (k == real_kind::inf));
+            REQUIRE(a.zero_p() == (k == real_kind::zero));
+            a.prec_round(sprec + 1);
+            REQUIRE(!a.is_static());
+            REQUIRE(a.get_prec() == sprec + 1);
+            REQUIRE(a.signbit() == sb);
+            REQUIRE(a.nan_p() == (k == real_kind::nan));
+            REQUIRE(a.inf_p() == (k == real_kind::inf));
+            REQUIRE(a.zero_p() == (k == real_kind::zero));
+        }
+    }
+
+    // Operations which steal from their arguments, mixing static and dynamic storage.
+    real r8{1, 10}, a0{"1.5", 100};
+    add(r8, std::move(a0), real{"2.5", 64});
+    REQUIRE(r8 == 4);
+    REQUIRE(r8.is_static());
+    REQUIRE(r8.get_prec() == 100);
+    r8 = real{1, sprec + 1};
+    a0 = real{"1.5", 100};
+    add(r8, std::move(a0), real{"2.5", 64});
+    REQUIRE(r8 == 4);
+    REQUIRE(r8.get_prec() == 100);
+    r8 = real{1, 10};
+    a0 = real{"1.5", sprec + 2};
+    add(r8, std::move(a0), real{"2.5", 64});
+    REQUIRE(r8 == 4);
+    REQUIRE(!r8.is_static());
+    REQUIRE(r8.get_prec() == sprec + 2);
+    auto r9 = sin(real{"1.5", 100}) + real{"2.5", 64};
+    REQUIRE(r9.is_static());
+    REQUIRE(r9 == sin(real{"1.5", 100}) + 2.5);
+
+    // Vectors of reals.
+    std::vector<real> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.emplace_back(i, i % 3 ? ::mpfr_prec_t(64) : sprec + 1);
+    }
+    v.erase(v.begin());
+    v.insert(v.begin() + 10, real{-1});
+    v.shrink_to_fit();
+    for (int i = 0; i < 1000; ++i) {
+        const auto n = i < 10 ? i + 1 : (i == 10 ? -1 : i);
+        REQUIRE(v[static_cast<decltype(v.size())>(i)] == n);
+        if (i != 10) {
+            REQUIRE(v[static_cast<decltype(v.size())>(i)].is_static() == (n % 3 != 0));
+        }
+    }
+
+    // Serialisation.
+    const real r10{"-1.1", 200};
+    std::vector<char> buffer;
+    r10.binary_save(buffer);
+    real r11;
+    r11.binary_load(buffer);
+    REQUIRE(r11.is_static());
+    REQUIRE(r11 == r10);
+    REQUIRE(r11.get_prec() == 200);
+
+#if !defined(_MSC_VER) || defined(__clang__)
+    // Construction from mpfr_t yields dynamic storage.
+    ::mpfr_t m;
+    ::mpfr_init2(m, 64);
+    mpfr_set_ui(m, 42u, MPFR_RNDN);
+    real r12{std::move(m)};
+    REQUIRE(!r12.is_static());
+    REQUIRE(r12 == 42);
+    r12 = real{43, 64};
+    REQUIRE(r12.is_static());
+    REQUIRE(r12 == 43);
+#endif
+}
+
+TEST_CASE("real static storage swap")
+{
+    // swap() between reals in static and dynamic storage: the significand
+    // of the real in static storage always points to the object itself, while
+    // the significand of the real in dynamic storage changes owner without copies.
+    const real s0{"1.3", 100}, d0{"4.5", sprec + 10};
+    real a = s0, b = d0;
+    const auto *b_ptr = b.get_mpfr_t()->_mpfr_d;
+    swap(a, b);
+    REQUIRE(!a.is_static());
+    REQUIRE(b.is_static());
+    REQUIRE(a.get_mpfr_t()->_mpfr_d == b_ptr);
+    REQUIRE(a == d0);
+    REQUIRE(b == s0);
+    REQUIRE(a.get_prec() == sprec + 10);
+    REQUIRE(b.get_prec() == 100);
+
+    // The swapped values are independent from each other, and they can
+    // be modified and resized.
+    a += 1;
+    b += 1;
+    REQUIRE(a == d0 + 1);
+    REQUIRE(b == s0 + 1);
+    b.prec_round(sprec);
+    REQUIRE(b.is_static());
+    REQUIRE(b == s0 + 1);
+    b.prec_round(sprec + 1);
+    REQUIRE(!b.is_static());
+    REQUIRE(b == s0 + 1);
+
+    // Swap back and forth, also via std::swap().
+    a = s0;
+    b = d0;
+    swap(a, b);
+    swap(b, a);
+    REQUIRE(a.is_static());
+    REQUIRE(!b.is_static());
+    REQUIRE(b.get_mpfr_t()->_mpfr_d == b_ptr);
+    REQUIRE(a == s0);
+    REQUIRE(b == d0);
+    std::swap(a, b);
+    REQUIRE(!a.is_static());
+    REQUIRE(b.is_static());
+    REQUIRE(a == d0);
+    REQUIRE(b == s0);
+
+    // Swap with a moved-from real.
+    real c{std::move(a)};
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    swap(a, b);
+    REQUIRE(a.is_static());
+    REQUIRE(a == s0);
+    REQUIRE(!b.is_valid());
+    REQUIRE(!b.is_static());
+    b = c;
+    REQUIRE(b == d0);
+}
+
+TEST_CASE("real static storage raw access")
+{
+    // The MPFR functions which do not reallocate the significand can
+    // be invoked on the mutable pointer of a real in static storage.
+    real r{1, 113};
+    const auto *ptr = r.get_mpfr_t()->_mpfr_d;
+    mpfr_set_ui(r._get_mpfr_t(), 42u, MPFR_RNDN);
+    ::mpfr_mul_2ui(r._get_mpfr_t(), r.get_mpfr_t(), 3u, MPFR_RNDN);
+    ::mpfr_sqrt(r._get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDN);
+    REQUIRE(r.is_static());
+    REQUIRE(r.get_mpfr_t()->_mpfr_d == ptr);
+    REQUIRE(r.get_prec() == 113);
+    REQUIRE(r == sqrt(real{336, 113}));
+
+    // mpfr_set_prec(), mpfr_prec_round(), mpfr_swap() and mpfr_clear() must not
+    // be invoked on the mutable pointer of a real in static storage: the member
+    // functions are to be used instead, and they preserve the storage invariants.
+    r.set_prec(64);
+    REQUIRE(r.is_static());
+    REQUIRE(r.get_mpfr_t()->_mpfr_d == ptr);
+    REQUIRE(r.get_prec() == 64);
+    mpfr_set_ui(r._get_mpfr_t(), 3u, MPFR_RNDN);
+    r.prec_round(sprec + 1);
+    REQUIRE(!r.is_static());
+    REQUIRE(r == 3);
+    REQUIRE(r.get_prec() == sprec + 1);
+
+    // On a real in dynamic storage, the raw MPFR functions are allowed.
+    ::mpfr_prec_round(r._get_mpfr_t(), sprec + 100, MPFR_RNDN);
+    REQUIRE(!r.is_static());
+    REQUIRE(r == 3);
+    real d{5, sprec + 1};
+    ::mpfr_swap(r._get_mpfr_t(), d._get_mpfr_t());
+    REQUIRE(r == 5);
+    REQUIRE(d == 3);
+    REQUIRE(r.get_prec() == sprec + 1);
+    REQUIRE(d.get_prec() == sprec + 100);
+    ::mpfr_set_prec(d._get_mpfr_t(), 10);
+    REQUIRE(!d.is_static());
+    REQUIRE(d.nan_p());
+    REQUIRE(d.get_prec() == 10);
+
+    // A real constructed from the mpfr_t of a real in static
+    // storage gets its own static storage.
+    const real s{"1.1", 100};
+    const real s_copy{s.get_mpfr_t()};
+    REQUIRE(s_copy.is_static());
+    REQUIRE(s_copy == s);
+    REQUIRE(s_copy.get_mpfr_t()->_mpfr_d != s.get_mpfr_t()->_mpfr_d);
+}
+
+#if defined(MPPP_WITH_MPC)
+
+TEST_CASE("real static storage complex")
+{
+    // Complex values created from reals in static storage.
+    const complex c0{real{"1.5", 100}, real{"-2.5", 100}};
+    REQUIRE(c0.get_prec() == 100);
+    REQUIRE(c0 == complex{1.5, -2.5});
+    const complex c1{1.5};
+    REQUIRE(c1 == 1.5);
+
+    // Assignment of reals in static storage via the re/im refs.
+    complex c2{1, 2, complex_prec_t(sprec + 10)};
+    {
+        complex::re_ref re{c2};
+        *re = real{"3.5", 64};
+        REQUIRE(re->is_static());
+    }
+    {
+        complex::im_ref im{c2};
+        *im = real{"-4.5", 64};
+    }
+    REQUIRE(c2.get_prec() == 64);
+    REQUIRE(c2 == complex{3.5, -4.5});
+
+    // Moving out the real and imaginary parts.
+    auto p = std::move(c2).get_real_imag();
+    REQUIRE(p.first == 3.5);
+    REQUIRE(p.second == -4.5);
+}
+
+#endif
@@ -173,6 +173,54 @@ TEST_CASE("real trig")
     REQUIRE(sop == sin(real{2, detail::real_deduce_precision(0) * 3}));
     REQUIRE(cop == cos(real{2, detail::real_deduce_precision(0) * 3}));
 
+    // Stealing from an rvalue op.
+    sop = real{1, 10};
+    cop = real{2, 1000};
+    real op{3, 1000};
+    const auto *op_ptr = op.get_mpfr_t()->_mpfr_d;
+    sin_cos(sop, cop, std::move(op));
+    REQUIRE(sop.get_prec() == 1000);
+    REQUIRE(cop.get_prec() == 1000);
+    REQUIRE(sop == sin(real{3, 1000}));
+    REQUIRE(cop == cos(real{3, 1000}));
+    REQUIRE(sop.get_mpfr_t()->_mpfr_d == op_ptr);
+    // Check op was swapped for sop.
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op == 1);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(op.get_prec() == 10);
+
+    // An rvalue op which is also a return value is not stolen.
+    sop = real{1, 10};
+    cop = real{3, 1000};
+    sin_cos(sop, cop, std::move(cop));
+    REQUIRE(sop.get_prec() == 1000);
+    REQUIRE(cop.get_prec() == 1000);
+    REQUIRE(sop == sin(real{3, 1000}));
+    REQUIRE(cop == cos(real{3, 1000}));
+
+    // The overload returning a pair.
+    auto p0 = sin_cos(real{3});
+    REQUIRE(p0.first.get_prec() == detail::real_deduce_precision(0));
+    REQUIRE(p0.second.get_prec() == detail::real_deduce_precision(0));
+    REQUIRE(p0.first == sin(real{3}));
+    REQUIRE(p0.second == cos(real{3}));
+    const real cop0{3, 1000};
+    auto p1 = sin_cos(cop0);
+    REQUIRE(p1.first.get_prec() == 1000);
+    REQUIRE(p1.second.get_prec() == 1000);
+    REQUIRE(p1.first == sin(cop0));
+    REQUIRE(p1.second == cos(cop0));
+    REQUIRE(cop0 == 3);
+    op = real{3, 1000};
+    op_ptr = op.get_mpfr_t()->_mpfr_d;
+    auto p2 = sin_cos(std::move(op));
+    REQUIRE(p2.first == p1.first);
+    REQUIRE(p2.second == p1.second);
+    REQUIRE(p2.first.get_mpfr_t()->_mpfr_d == op_ptr);
+    // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move, hicpp-invalid-access-moved)
+    REQUIRE(!op.is_valid());
+
     // atan2.
     r0 = real{12, 450};
     atan2(r0, real{4}, real{5});
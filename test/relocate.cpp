@@ -0,0 +1,154 @@
+// Copyright 2016-2023 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+#include <mp++/relocate.hpp>
+
+#if defined(MPPP_WITH_MPFR)
+#include <mp++/real.hpp>
+#endif
+
+#if defined(MPPP_WITH_MPC)
+#include <mp++/complex.hpp>
+#endif
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp;
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 6>>;
+
+template <typename T>
+using relocate_t = decltype(mppp::relocate(std::declval<T *>(), std::declval<T *>(), std::declval<T *>()));
+
+template <typename T, typename = void>
+struct has_relocate : std::false_type {
+};
+
+template <typename T>
+struct has_relocate<T, detail::void_t<relocate_t<T>>> : std::true_type {
+};
+
+struct throwing_move {
+    throwing_move() = default;
+    throwing_move(throwing_move &&) noexcept(false) {}
+};
+
+TEST_CASE("is_trivially_relocatable")
+{
+    REQUIRE(is_trivially_relocatable<int>::value);
+    REQUIRE(is_trivially_relocatable<double>::value);
+    REQUIRE(!is_trivially_relocatable<std::string>::value);
+    REQUIRE(is_trivially_relocatable<integer<1>>::value);
+    REQUIRE(is_trivially_relocatable<integer<3>>::value);
+    REQUIRE(is_trivially_relocatable<rational<1>>::value);
+    REQUIRE(is_trivially_relocatable<rational<3>>::value);
+#if defined(MPPP_WITH_MPFR)
+    REQUIRE(!is_trivially_relocatable<real>::value);
+#endif
+#if defined(MPPP_WITH_MPC)
+    REQUIRE(is_trivially_relocatable<complex>::value);
+#endif
+
+    REQUIRE(has_relocate<int>::value);
+    REQUIRE(has_relocate<std::string>::value);
+    REQUIRE(has_relocate<integer<1>>::value);
+#if defined(MPPP_WITH_MPFR)
+    REQUIRE(has_relocate<real>::value);
+#endif
+    REQUIRE(!has_relocate<throwing_move>::value);
+}
+
+struct relocate_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+
+        const integer big = integer{1} << (S::value * GMP_NUMB_BITS + 1u);
+
+        std::vector<integer> v;
+        for (int i = 0; i < 100; ++i) {
+            v.push_back(i % 2 ? integer{-i} : big + i);
+        }
+        const auto cmp = v;
+
+        // Relocation into uninitialised storage.
+        std::allocator<integer> alloc;
+        auto *src = alloc.allocate(v.size());
+        auto *dst = alloc.allocate(v.size());
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            ::new (static_cast<void *>(src + i)) integer(v[i]);
+        }
+        REQUIRE(mppp::relocate(src, src + v.size(), dst) == dst + v.size());
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            REQUIRE(dst[i] == cmp[i]);
+            REQUIRE(dst[i].is_static() == cmp[i].is_static());
+        }
+
+        // Overlapping relocation, as in the removal of the first element.
+        dst[0].~integer();
+        REQUIRE(mppp::relocate(dst + 1, dst + v.size(), dst) == dst + v.size() - 1u);
+        for (std::size_t i = 0; i + 1u < v.size(); ++i) {
+            REQUIRE(dst[i] == cmp[i + 1u]);
+        }
+        for (std::size_t i = 0; i + 1u < v.size(); ++i) {
+            dst[i].~integer();
+        }
+        alloc.deallocate(src, v.size());
+        alloc.deallocate(dst, v.size());
+
+        // Vector growth and erasure.
+        std::vector<rational> vr;
+        for (int i = 0; i < 1000; ++i) {
+            vr.emplace_back(big + i, i + 1);
+        }
+        vr.erase(vr.begin());
+        vr.insert(vr.begin() + 10, rational{1, 2});
+        vr.shrink_to_fit();
+        REQUIRE(vr.size() == 1000u);
+        REQUIRE(vr[0] == rational{big + 1, 2});
+        REQUIRE(vr[10] == rational{1, 2});
+        REQUIRE(vr[999] == rational{big + 999, 1000});
+    }
+};
+
+TEST_CASE("relocate")
+{
+    tuple_for_each(sizes{}, relocate_tester{});
+
+    // Non-trivially relocatable types.
+    std::allocator<std::string> alloc;
+    auto *src = alloc.allocate(2);
+    auto *dst = alloc.allocate(2);
+    ::new (static_cast<void *>(src)) std::string("hello");
+    ::new (static_cast<void *>(src + 1)) std::string(100, 'a');
+    REQUIRE(mppp::relocate(src, src + 2, dst) == dst + 2);
+    REQUIRE(dst[0] == "hello");
+    REQUIRE(dst[1] == std::string(100, 'a'));
+    dst[0].~basic_string();
+    dst[1].~basic_string();
+    alloc.deallocate(src, 2);
+    alloc.deallocate(dst, 2);
+}